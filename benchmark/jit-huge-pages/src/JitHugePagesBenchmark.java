@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class JitHugePagesBenchmark {
+    // Odd, so that the walk visits every method once per round, and large, so that consecutive
+    // calls land on different pages of the code cache.
+    private static final int STRIDE = 1021;
+
+    public static int result;
+
+    public void timeCallManyMethodsInOrder(int count) {
+        int x = 0;
+        for (int i = 0; i < count; ++i) {
+            for (int index = 0; index < ManyMethods.COUNT; ++index) {
+                x = ManyMethods.call(index, x);
+            }
+        }
+        result = x;
+    }
+
+    public void timeCallManyMethodsScattered(int count) {
+        int x = 0;
+        for (int i = 0; i < count; ++i) {
+            int index = 0;
+            for (int j = 0; j < ManyMethods.COUNT; ++j) {
+                x = ManyMethods.call(index, x);
+                index = (index + STRIDE) % ManyMethods.COUNT;
+            }
+        }
+        result = x;
+    }
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class RegisterAllocationBenchmark {
+    private static final int SIZE = 1024;
+
+    private static final int[] ints = new int[SIZE];
+    private static final long[] longs = new long[SIZE];
+    private static final double[] doubles = new double[SIZE];
+
+    public static long result;
+    public static double doubleResult;
+
+    interface Callee {
+        int call(int value);
+    }
+
+    // More receiver types than the inline caches inline, so that the calls stay calls.
+    private static final Callee[] callees = {
+        value -> value + 1,
+        value -> value ^ 3,
+        value -> value >> 1,
+        value -> value * 5,
+        value -> value - 7,
+    };
+
+    static {
+        for (int i = 0; i < SIZE; ++i) {
+            ints[i] = i * 31 + 7;
+            longs[i] = i * 0x9E3779B97F4A7C15L;
+            doubles[i] = i * 0.5 + 1.0;
+        }
+    }
+
+    // More accumulators than there are core registers on most architectures.
+    public void timeIntAccumulators(int count) {
+        int a0 = 0, a1 = 1, a2 = 2, a3 = 3, a4 = 4, a5 = 5, a6 = 6, a7 = 7;
+        int a8 = 8, a9 = 9, a10 = 10, a11 = 11, a12 = 12, a13 = 13, a14 = 14, a15 = 15;
+        for (int n = 0; n < count; ++n) {
+            for (int i = 0; i < SIZE; ++i) {
+                int v = ints[i];
+                a0 += v; a1 ^= v; a2 += v >> 1; a3 |= v; a4 += v << 2; a5 -= v; a6 += a0;
+                a7 ^= a1; a8 += a2; a9 -= a3; a10 += a4; a11 ^= a5; a12 += a6; a13 -= a7;
+                a14 += a8 ^ a9; a15 += a10 - a11;
+            }
+        }
+        result = a0 + a1 + a2 + a3 + a4 + a5 + a6 + a7 + a8 + a9 + a10 + a11 + a12 + a13 + a14
+            + a15;
+    }
+
+    // The same for the floating point registers.
+    public void timeDoubleAccumulators(int count) {
+        double d0 = 0, d1 = 1, d2 = 2, d3 = 3, d4 = 4, d5 = 5, d6 = 6, d7 = 7;
+        double d8 = 8, d9 = 9, d10 = 10, d11 = 11, d12 = 12, d13 = 13, d14 = 14, d15 = 15;
+        double d16 = 16, d17 = 17;
+        for (int n = 0; n < count; ++n) {
+            for (int i = 0; i < SIZE; ++i) {
+                double v = doubles[i];
+                d0 += v; d1 *= 1.0001; d2 += v * d0; d3 -= v; d4 += d1; d5 += d2 * 0.5;
+                d6 -= d3; d7 += d4; d8 += d5 - d6; d9 += d7; d10 -= d8; d11 += d9 * v;
+                d12 += d10; d13 -= d11; d14 += d12; d15 += d13; d16 += d14 * v; d17 += d15;
+            }
+        }
+        doubleResult = d0 + d1 + d2 + d3 + d4 + d5 + d6 + d7 + d8 + d9 + d10 + d11 + d12 + d13
+            + d14 + d15 + d16 + d17;
+    }
+
+    // Values live across a call in an inner loop, which the allocator should keep in callee
+    // saved registers, and spill outside of the inner loop if it has to.
+    public void timeLiveAcrossCalls(int count) {
+        long sum = 0;
+        for (int n = 0; n < count; ++n) {
+            int x = n, y = n + 1, z = n + 2, w = n + 3, u = n + 4, t = n + 5;
+            for (int j = 0; j < 4; ++j) {
+                for (int i = 0; i < SIZE; ++i) {
+                    sum += callees[i % callees.length].call(ints[i]) + x * y + z * w + u * t;
+                    x += i; y ^= i; z -= i; w += j; u ^= j; t += x;
+                }
+            }
+        }
+        result = sum;
+    }
+
+    // Intrinsics with fixed register inputs and outputs, or temporaries, in a loop.
+    public void timeIntrinsics(int count) {
+        long sum = 0;
+        int bits = 0;
+        int max = 0;
+        double d = 0.0;
+        for (int n = 0; n < count; ++n) {
+            for (int i = 0; i < SIZE; ++i) {
+                long v = longs[i];
+                bits += Long.bitCount(v) + Integer.numberOfLeadingZeros(ints[i]);
+                max = Math.max(max, Integer.reverse(ints[i]));
+                sum += Long.rotateLeft(v, i) ^ Long.reverseBytes(v);
+                d += Math.abs(doubles[i] - d) + Math.sqrt(doubles[i]);
+            }
+        }
+        result = sum + bits + max;
+        doubleResult = d;
+    }
+}
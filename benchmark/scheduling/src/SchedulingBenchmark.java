@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class SchedulingBenchmark {
+    private static final int SIZE = 1024;
+
+    private static final int[] ints = new int[SIZE];
+    private static final int[] indexes = new int[SIZE];
+    private static final long[] longs = new long[SIZE];
+    private static final double[] doubles = new double[SIZE];
+    private static final Node[] nodes = new Node[SIZE];
+
+    public static long result;
+    public static double doubleResult;
+
+    static class Node {
+        int value;
+        Node next;
+    }
+
+    static {
+        for (int i = 0; i < SIZE; ++i) {
+            ints[i] = i * 31 + 7;
+            // A permutation of the indexes, so that the gathers don't follow the array order.
+            indexes[i] = (i * 397) % SIZE;
+            longs[i] = i * 0x9E3779B97F4A7C15L;
+            doubles[i] = i * 0.5 + 1.0;
+            nodes[i] = new Node();
+            nodes[i].value = i;
+        }
+        for (int i = 0; i < SIZE; ++i) {
+            nodes[i].next = nodes[indexes[i]];
+        }
+    }
+
+    // Loads feeding multiplications, with a loop carried add.
+    public void timeIntMulAdd(int count) {
+        int sum = 0;
+        for (int n = 0; n < count; ++n) {
+            for (int i = 1; i < SIZE; ++i) {
+                sum += ints[i] * ints[i - 1] + (ints[i] >> 3);
+            }
+        }
+        result = sum;
+    }
+
+    // Divisions, whose latency can be overlapped with the loads and additions of the next ones.
+    public void timeIntDivRem(int count) {
+        int sum = 0;
+        for (int n = 0; n < count; ++n) {
+            for (int i = 0; i < SIZE; ++i) {
+                int value = ints[i];
+                sum += value / (i | 1) + value % 13;
+            }
+        }
+        result = sum;
+    }
+
+    // Two independent long multiply chains.
+    public void timeLongMulChains(int count) {
+        long a = 1;
+        long b = 3;
+        for (int n = 0; n < count; ++n) {
+            for (int i = 0; i < SIZE; ++i) {
+                long value = longs[i];
+                a = a * value + i;
+                b = b * (value ^ i) - a;
+            }
+        }
+        result = a + b;
+    }
+
+    // Floating point divisions and multiplications of loaded values.
+    public void timeDoubleDivMul(int count) {
+        double sum = 0.0;
+        for (int n = 0; n < count; ++n) {
+            for (int i = 1; i < SIZE; ++i) {
+                sum += doubles[i] / doubles[i - 1] + doubles[i] * 0.25;
+            }
+        }
+        doubleResult = sum;
+    }
+
+    // Indirect loads through an index array.
+    public void timeGather(int count) {
+        int sum = 0;
+        for (int n = 0; n < count; ++n) {
+            for (int i = 0; i < SIZE; ++i) {
+                sum += ints[indexes[i]] * 3 + ints[i];
+            }
+        }
+        result = sum;
+    }
+
+    // Field loads interleaved with array loads and stores.
+    public void timeFieldsAndArrays(int count) {
+        int sum = 0;
+        for (int n = 0; n < count; ++n) {
+            for (int i = 0; i < SIZE; ++i) {
+                Node node = nodes[i];
+                int value = node.value + node.next.value;
+                indexes[i] = (indexes[i] + value) & (SIZE - 1);
+                sum += value;
+            }
+        }
+        result = sum;
+    }
+}
@@ -79,9 +79,11 @@ CompilerOptions::CompilerOptions()
       count_hotness_in_compiled_code_(false),
       resolve_startup_const_strings_(false),
       initialize_app_image_classes_(false),
+      partial_load_store_elimination_(false),
       check_profiled_methods_(ProfileMethodsCheck::kNone),
       max_image_block_size_(std::numeric_limits<uint32_t>::max()),
       register_allocation_strategy_(RegisterAllocator::kRegisterAllocatorDefault),
+      graph_color_for_speed_(false),
       passes_to_run_(nullptr) {
 }
 
@@ -118,12 +120,17 @@ bool CompilerOptions::ParseDumpInitFailures(const std::string& option, std::stri
 
 bool CompilerOptions::ParseRegisterAllocationStrategy(const std::string& option,
                                                       std::string* error_msg) {
+  graph_color_for_speed_ = false;
   if (option == "linear-scan") {
     register_allocation_strategy_ = RegisterAllocator::Strategy::kRegisterAllocatorLinearScan;
   } else if (option == "graph-color") {
     register_allocation_strategy_ = RegisterAllocator::Strategy::kRegisterAllocatorGraphColor;
+  } else if (option == "graph-color-for-speed") {
+    register_allocation_strategy_ = RegisterAllocator::Strategy::kRegisterAllocatorLinearScan;
+    graph_color_for_speed_ = true;
   } else {
-    *error_msg = "Unrecognized register allocation strategy. Try linear-scan, or graph-color.";
+    *error_msg = "Unrecognized register allocation strategy. "
+                 "Try linear-scan, graph-color, or graph-color-for-speed.";
     return false;
   }
   return true;
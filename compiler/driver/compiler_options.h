@@ -45,6 +45,7 @@ class Arm64RelativePatcherTest;
 }  // namespace linker
 
 class ArtMethod;
+class CompilerOptionsTest;
 class DexFile;
 enum class InstructionSet;
 class InstructionSetFeatures;
@@ -335,6 +336,12 @@ class CompilerOptions final {
   }
 
   RegisterAllocator::Strategy GetRegisterAllocationStrategy() const {
+    if (graph_color_for_speed_ &&
+        IsAotCompiler() &&
+        (compiler_filter_ == CompilerFilter::kSpeed ||
+         compiler_filter_ == CompilerFilter::kEverything)) {
+      return RegisterAllocator::Strategy::kRegisterAllocatorGraphColor;
+    }
     return register_allocation_strategy_;
   }
 
@@ -362,6 +369,10 @@ class CompilerOptions final {
     return resolve_startup_const_strings_;
   }
 
+  bool PartialLoadStoreElimination() const {
+    return partial_load_store_elimination_;
+  }
+
   ProfileMethodsCheck CheckProfiledMethodsCompiled() const {
     return check_profiled_methods_;
   }
@@ -481,6 +492,10 @@ class CompilerOptions final {
   // Whether we attempt to run class initializers for app image classes.
   bool initialize_app_image_classes_;
 
+  // Whether load-store elimination removes the allocations which escape only on some paths,
+  // by materializing them on these paths.
+  bool partial_load_store_elimination_;
+
   // When running profile-guided compilation, check that methods intended to be compiled end
   // up compiled and are not punted.
   ProfileMethodsCheck check_profiled_methods_;
@@ -490,6 +505,11 @@ class CompilerOptions final {
 
   RegisterAllocator::Strategy register_allocation_strategy_;
 
+  // Whether to use the graph coloring register allocator instead of
+  // `register_allocation_strategy_` for AOT compilation with the `speed` and
+  // `everything` filters, which trade compile time for fewer spills.
+  bool graph_color_for_speed_;
+
   // If not null, specifies optimization passes which will be run instead of defaults.
   // Note that passes_to_run_ is not checked for correctness and providing an incorrect
   // list of passes can lead to unexpected compiler behaviour. This is caused by dependencies
@@ -501,6 +521,7 @@ class CompilerOptions final {
   friend class Dex2Oat;
   friend class CommonCompilerDriverTest;
   friend class CommonCompilerTestImpl;
+  friend class CompilerOptionsTest;
   friend class jit::JitCompiler;
   friend class verifier::VerifierDepsTest;
   friend class linker::Arm64RelativePatcherTest;
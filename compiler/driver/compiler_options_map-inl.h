@@ -82,7 +82,8 @@ inline bool ReadCompilerOptions(Base& map, CompilerOptions* options, std::string
     options->dump_cfg_append_ = true;
   }
   if (map.Exists(Base::RegisterAllocationStrategy)) {
-    if (!options->ParseRegisterAllocationStrategy(*map.Get(Base::DumpInitFailures), error_msg)) {
+    if (!options->ParseRegisterAllocationStrategy(*map.Get(Base::RegisterAllocationStrategy),
+                                                  error_msg)) {
       return false;
     }
   }
@@ -93,6 +94,8 @@ inline bool ReadCompilerOptions(Base& map, CompilerOptions* options, std::string
   }
   map.AssignIfExists(Base::ResolveStartupConstStrings, &options->resolve_startup_const_strings_);
   map.AssignIfExists(Base::InitializeAppImageClasses, &options->initialize_app_image_classes_);
+  map.AssignIfExists(Base::PartialLoadStoreElimination,
+                     &options->partial_load_store_elimination_);
   if (map.Exists(Base::CheckProfiledMethods)) {
     options->check_profiled_methods_ = *map.Get(Base::CheckProfiledMethods);
   }
@@ -233,6 +236,9 @@ inline void AddCompilerOptionsArgumentParserOptions(Builder& b) {
 
       .Define("--register-allocation-strategy=_")
           .template WithType<std::string>()
+          .WithHelp("Select the register allocator: linear-scan (the default), graph-color, or\n"
+                    "graph-color-for-speed to use graph-color only with the speed and everything\n"
+                    "compiler filters, and linear-scan otherwise.")
           .IntoKey(Map::RegisterAllocationStrategy)
 
       .Define("--resolve-startup-const-strings=_")
@@ -247,6 +253,13 @@ inline void AddCompilerOptionsArgumentParserOptions(Builder& b) {
           .WithValueMap({{"false", false}, {"true", true}})
           .IntoKey(Map::InitializeAppImageClasses)
 
+      .Define("--partial-load-store-elimination=_")
+          .template WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .WithHelp("If true, load-store elimination also removes the allocations which escape\n"
+                    "only on some paths, and allocates them on these paths instead.")
+          .IntoKey(Map::PartialLoadStoreElimination)
+
       .Define("--verbose-methods=_")
           .template WithType<ParseStringList<','>>()
           .WithHelp("Restrict the dumped CFG data to methods whose name is listed.\n"
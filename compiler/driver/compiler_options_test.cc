@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "compiler_options.h"
+
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+#include "gtest/gtest.h"
+
+namespace art HIDDEN {
+
+class CompilerOptionsTest : public testing::Test {
+ protected:
+  static void SetJitCompiler(CompilerOptions* options) {
+    options->compiler_type_ = CompilerOptions::CompilerType::kJitCompiler;
+  }
+
+  // Parses `options` and returns the register allocator picked for the result.
+  static RegisterAllocator::Strategy GetStrategy(const std::vector<std::string>& options,
+                                                 bool jit = false) {
+    CompilerOptions compiler_options;
+    if (jit) {
+      SetJitCompiler(&compiler_options);
+    }
+    std::string error_msg;
+    bool success = compiler_options.ParseCompilerOptions(options,
+                                                         /*ignore_unrecognized=*/ false,
+                                                         &error_msg);
+    EXPECT_TRUE(success) << error_msg;
+    return compiler_options.GetRegisterAllocationStrategy();
+  }
+};
+
+TEST_F(CompilerOptionsTest, RegisterAllocationStrategy) {
+  EXPECT_EQ(RegisterAllocator::kRegisterAllocatorLinearScan,
+            GetStrategy({"--register-allocation-strategy=linear-scan"}));
+  EXPECT_EQ(RegisterAllocator::kRegisterAllocatorGraphColor,
+            GetStrategy({"--register-allocation-strategy=graph-color"}));
+  EXPECT_EQ(RegisterAllocator::kRegisterAllocatorGraphColor,
+            GetStrategy({"--register-allocation-strategy=graph-color",
+                         "--compiler-filter=verify"}));
+  // The last strategy wins.
+  EXPECT_EQ(RegisterAllocator::kRegisterAllocatorLinearScan,
+            GetStrategy({"--register-allocation-strategy=graph-color-for-speed",
+                         "--register-allocation-strategy=linear-scan",
+                         "--compiler-filter=speed"}));
+
+  CompilerOptions compiler_options;
+  std::string error_msg;
+  EXPECT_FALSE(compiler_options.ParseCompilerOptions({"--register-allocation-strategy=other"},
+                                                     /*ignore_unrecognized=*/ false,
+                                                     &error_msg));
+  EXPECT_NE(std::string::npos, error_msg.find("graph-color-for-speed")) << error_msg;
+}
+
+TEST_F(CompilerOptionsTest, GraphColorForSpeed) {
+  // Graph coloring for the AOT compiles with the speed and everything filters only.
+  EXPECT_EQ(RegisterAllocator::kRegisterAllocatorGraphColor,
+            GetStrategy({"--register-allocation-strategy=graph-color-for-speed",
+                         "--compiler-filter=speed"}));
+  EXPECT_EQ(RegisterAllocator::kRegisterAllocatorGraphColor,
+            GetStrategy({"--register-allocation-strategy=graph-color-for-speed",
+                         "--compiler-filter=everything"}));
+  EXPECT_EQ(RegisterAllocator::kRegisterAllocatorLinearScan,
+            GetStrategy({"--register-allocation-strategy=graph-color-for-speed",
+                         "--compiler-filter=speed-profile"}));
+  EXPECT_EQ(RegisterAllocator::kRegisterAllocatorLinearScan,
+            GetStrategy({"--register-allocation-strategy=graph-color-for-speed",
+                         "--compiler-filter=everything-profile"}));
+  EXPECT_EQ(RegisterAllocator::kRegisterAllocatorLinearScan,
+            GetStrategy({"--register-allocation-strategy=graph-color-for-speed",
+                         "--compiler-filter=verify"}));
+
+  // The JIT keeps linear scan, whatever the filter.
+  EXPECT_EQ(RegisterAllocator::kRegisterAllocatorLinearScan,
+            GetStrategy({"--register-allocation-strategy=graph-color-for-speed",
+                         "--compiler-filter=speed"},
+                        /*jit=*/ true));
+  EXPECT_EQ(RegisterAllocator::kRegisterAllocatorLinearScan,
+            GetStrategy({"--register-allocation-strategy=graph-color-for-speed",
+                         "--compiler-filter=everything"},
+                        /*jit=*/ true));
+}
+
+}  // namespace art
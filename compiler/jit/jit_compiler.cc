@@ -60,7 +60,7 @@ void JitCompiler::ParseCompilerOptions() {
     }
   }
   // Set to appropriate JIT compiler type.
-  compiler_options_->compiler_type_ = runtime->IsZygote()
+  compiler_options_->compiler_type_ = runtime->IsSharingJitCode()
       ? CompilerOptions::CompilerType::kSharedCodeJitCompiler
       : CompilerOptions::CompilerType::kJitCompiler;
   // JIT is never PIC, no matter what the runtime compiler options specify.
@@ -152,6 +152,10 @@ bool JitCompiler::GenerateDebugInfo() {
   return GetCompilerOptions().GetGenerateDebugInfo();
 }
 
+bool JitCompiler::GenerateAnyDebugInfo() {
+  return GetCompilerOptions().GenerateAnyDebugInfo();
+}
+
 std::vector<uint8_t> JitCompiler::PackElfFileForJIT(ArrayRef<const JITCodeEntry*> elf_files,
                                                     ArrayRef<const void*> removed_symbols,
                                                     bool compress,
@@ -55,6 +55,8 @@ class JitCompiler : public JitCompilerInterface {
 
   bool GenerateDebugInfo() override;
 
+  bool GenerateAnyDebugInfo() override;
+
   void ParseCompilerOptions() override;
 
   void TypesLoaded(mirror::Class**, size_t count) REQUIRES_SHARED(Locks::mutator_lock_) override;
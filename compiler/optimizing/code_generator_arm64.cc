@@ -1235,7 +1235,8 @@ void InstructionCodeGeneratorARM64::VisitMethodEntryHook(HMethodEntryHook* instr
   GenerateMethodEntryExitHook(instruction);
 }
 
-void CodeGeneratorARM64::MaybeIncrementHotness(bool is_frame_entry) {
+void CodeGeneratorARM64::MaybeIncrementHotness(HSuspendCheck* suspend_check,
+                                               bool is_frame_entry) {
   MacroAssembler* masm = GetVIXLAssembler();
   if (GetCompilerOptions().CountHotnessInCompiledCode()) {
     UseScratchRegisterScope temps(masm);
@@ -1254,8 +1255,24 @@ void CodeGeneratorARM64::MaybeIncrementHotness(bool is_frame_entry) {
   }
 
   if (GetGraph()->IsCompilingBaseline() && !Runtime::Current()->IsAotCompiler()) {
-    SlowPathCodeARM64* slow_path = new (GetScopedAllocator()) CompileOptimizedSlowPathARM64();
-    AddSlowPath(slow_path);
+    SlowPathCodeARM64* slow_path = nullptr;
+    if (suspend_check != nullptr && !suspend_check->IsNoOp()) {
+      // On a loop back edge, let the suspend check handle the counter, so that the runtime can
+      // also move the frame to the OSR version of the optimized code. The suspend check slow
+      // path branches back to the loop header. With implicit suspend checks, the slow path
+      // is only used for the counter.
+      slow_path = down_cast<SlowPathCodeARM64*>(suspend_check->GetSlowPath());
+      if (slow_path == nullptr) {
+        slow_path = new (GetScopedAllocator())
+            SuspendCheckSlowPathARM64(suspend_check, suspend_check->GetBlock());
+        suspend_check->SetSlowPath(slow_path);
+        AddSlowPath(slow_path);
+      }
+    } else {
+      suspend_check = nullptr;
+      slow_path = new (GetScopedAllocator()) CompileOptimizedSlowPathARM64();
+      AddSlowPath(slow_path);
+    }
     ProfilingInfo* info = GetGraph()->GetProfilingInfo();
     DCHECK(info != nullptr);
     DCHECK(!HasEmptyFrame());
@@ -1269,7 +1286,9 @@ void CodeGeneratorARM64::MaybeIncrementHotness(bool is_frame_entry) {
     __ Cbz(counter, slow_path->GetEntryLabel());
     __ Add(counter, counter, -1);
     __ Strh(counter, MemOperand(temp, ProfilingInfo::BaselineHotnessCountOffset().Int32Value()));
-    __ Bind(slow_path->GetExitLabel());
+    if (suspend_check == nullptr) {
+      __ Bind(slow_path->GetExitLabel());
+    }
   }
 }
 
@@ -1386,7 +1405,7 @@ void CodeGeneratorARM64::GenerateFrameEntry() {
       __ Str(wzr, MemOperand(sp, GetStackOffsetOfShouldDeoptimizeFlag()));
     }
   }
-  MaybeIncrementHotness(/* is_frame_entry= */ true);
+  MaybeIncrementHotness(/* suspend_check= */ nullptr, /* is_frame_entry= */ true);
   MaybeGenerateMarkingRegisterCheck(/* code= */ __LINE__);
 }
 
@@ -3679,7 +3698,7 @@ void InstructionCodeGeneratorARM64::HandleGoto(HInstruction* got, HBasicBlock* s
   HLoopInformation* info = block->GetLoopInformation();
 
   if (info != nullptr && info->IsBackEdge(*block) && info->HasSuspendCheck()) {
-    codegen_->MaybeIncrementHotness(/* is_frame_entry= */ false);
+    codegen_->MaybeIncrementHotness(info->GetSuspendCheck(), /* is_frame_entry= */ false);
     GenerateSuspendCheck(info->GetSuspendCheck(), successor);
     return;  // `GenerateSuspendCheck()` emitted the jump.
   }
@@ -4576,12 +4595,17 @@ void CodeGeneratorARM64::MaybeGenerateInlineCacheCheck(HInstruction* instruction
     DCHECK(info != nullptr);
     InlineCache* cache = info->GetInlineCache(instruction->GetDexPc());
     uint64_t address = reinterpret_cast64<uint64_t>(cache);
-    vixl::aarch64::Label done;
+    vixl::aarch64::Label done, miss;
     __ Mov(x8, address);
     __ Ldr(x9, MemOperand(x8, InlineCache::ClassesOffset().Int32Value()));
-    // Fast path for a monomorphic cache.
+    // Fast path for a monomorphic cache, which only counts the call.
     __ Cmp(klass, x9);
-    __ B(eq, &done);
+    __ B(ne, &miss);
+    __ Ldr(w9, MemOperand(x8, InlineCache::CountsOffset().Int32Value()));
+    __ Add(w9, w9, 1);
+    __ Str(w9, MemOperand(x8, InlineCache::CountsOffset().Int32Value()));
+    __ B(&done);
+    __ Bind(&miss);
     InvokeRuntime(kQuickUpdateInlineCache, instruction, instruction->GetDexPc());
     __ Bind(&done);
   }
@@ -3622,14 +3622,19 @@ void CodeGeneratorARMVIXL::MaybeGenerateInlineCacheCheck(HInstruction* instructi
     DCHECK(info != nullptr);
     InlineCache* cache = info->GetInlineCache(instruction->GetDexPc());
     uint32_t address = reinterpret_cast32<uint32_t>(cache);
-    vixl32::Label done;
+    vixl32::Label done, miss;
     UseScratchRegisterScope temps(GetVIXLAssembler());
     temps.Exclude(ip);
     __ Mov(r4, address);
     __ Ldr(ip, MemOperand(r4, InlineCache::ClassesOffset().Int32Value()));
-    // Fast path for a monomorphic cache.
+    // Fast path for a monomorphic cache, which only counts the call.
     __ Cmp(klass, ip);
-    __ B(eq, &done, /* is_far_target= */ false);
+    __ B(ne, &miss, /* is_far_target= */ false);
+    __ Ldr(ip, MemOperand(r4, InlineCache::CountsOffset().Int32Value()));
+    __ Add(ip, ip, 1);
+    __ Str(ip, MemOperand(r4, InlineCache::CountsOffset().Int32Value()));
+    __ B(&done);
+    __ Bind(&miss);
     InvokeRuntime(kQuickUpdateInlineCache, instruction, instruction->GetDexPc());
     __ Bind(&done);
   }
@@ -25,6 +25,12 @@ namespace x86_64 {
 // NOLINT on __ macro to suppress wrong warning/fix (misc-macro-parentheses) from clang-tidy.
 #define __ down_cast<X86_64Assembler*>(GetAssembler())->  // NOLINT
 
+// Whether the vector operation takes the full 256 bits of the YMM registers. This is the case of
+// all the vector operations when the code generator reports a SIMD register width of 32 bytes.
+static bool Is256BitVector(HVecOperation* instruction) {
+  return instruction->GetVectorNumberOfBytes() == 4 * kX86_64WordSize;
+}
+
 void LocationsBuilderX86_64::VisitVecReplicateScalar(HVecReplicateScalar* instruction) {
   LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
   HInstruction* input = instruction->InputAt(0);
@@ -55,12 +61,15 @@ void LocationsBuilderX86_64::VisitVecReplicateScalar(HVecReplicateScalar* instru
 }
 
 void InstructionCodeGeneratorX86_64::VisitVecReplicateScalar(HVecReplicateScalar* instruction) {
+  bool is_256 = Is256BitVector(instruction);
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
 
   bool cpu_has_avx = CpuHasAvxFeatureFlag();
   // Shorthand for any type of zero.
   if (IsZeroBitPattern(instruction->InputAt(0))) {
+    // The VEX.128 encoded vxorps also clears the upper half of the YMM register.
+    DCHECK(!is_256 || cpu_has_avx);
     cpu_has_avx ? __ vxorps(dst, dst, dst) : __ xorps(dst, dst);
     return;
   }
@@ -69,38 +78,46 @@ void InstructionCodeGeneratorX86_64::VisitVecReplicateScalar(HVecReplicateScalar
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
     case DataType::Type::kInt8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
+      DCHECK_EQ(is_256 ? 32u : 16u, instruction->GetVectorLength());
       __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /*64-bit*/ false);
+      if (is_256) {
+        __ vpbroadcastb(YmmRegister(dst), dst);
+        break;
+      }
       __ punpcklbw(dst, dst);
       __ punpcklwd(dst, dst);
       __ pshufd(dst, dst, Immediate(0));
       break;
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
+      DCHECK_EQ(is_256 ? 16u : 8u, instruction->GetVectorLength());
       __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /*64-bit*/ false);
+      if (is_256) {
+        __ vpbroadcastw(YmmRegister(dst), dst);
+        break;
+      }
       __ punpcklwd(dst, dst);
       __ pshufd(dst, dst, Immediate(0));
       break;
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
+      DCHECK_EQ(is_256 ? 8u : 4u, instruction->GetVectorLength());
       __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /*64-bit*/ false);
-      __ pshufd(dst, dst, Immediate(0));
+      is_256 ? __ vpbroadcastd(YmmRegister(dst), dst) : __ pshufd(dst, dst, Immediate(0));
       break;
     case DataType::Type::kInt64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
+      DCHECK_EQ(is_256 ? 4u : 2u, instruction->GetVectorLength());
       __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /*64-bit*/ true);
-      __ punpcklqdq(dst, dst);
+      is_256 ? __ vpbroadcastq(YmmRegister(dst), dst) : __ punpcklqdq(dst, dst);
       break;
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
+      DCHECK_EQ(is_256 ? 8u : 4u, instruction->GetVectorLength());
       DCHECK(locations->InAt(0).Equals(locations->Out()));
-      __ shufps(dst, dst, Immediate(0));
+      is_256 ? __ vbroadcastss(YmmRegister(dst), dst) : __ shufps(dst, dst, Immediate(0));
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
+      DCHECK_EQ(is_256 ? 4u : 2u, instruction->GetVectorLength());
       DCHECK(locations->InAt(0).Equals(locations->Out()));
-      __ shufpd(dst, dst, Immediate(0));
+      is_256 ? __ vbroadcastsd(YmmRegister(dst), dst) : __ shufpd(dst, dst, Immediate(0));
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
@@ -133,6 +150,7 @@ void LocationsBuilderX86_64::VisitVecExtractScalar(HVecExtractScalar* instructio
 }
 
 void InstructionCodeGeneratorX86_64::VisitVecExtractScalar(HVecExtractScalar* instruction) {
+  bool is_256 = Is256BitVector(instruction);
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   switch (instruction->GetPackedType()) {
@@ -144,17 +162,17 @@ void InstructionCodeGeneratorX86_64::VisitVecExtractScalar(HVecExtractScalar* in
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
       UNREACHABLE();
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
+      DCHECK_EQ(is_256 ? 8u : 4u, instruction->GetVectorLength());
       __ movd(locations->Out().AsRegister<CpuRegister>(), src, /*64-bit*/ false);
       break;
     case DataType::Type::kInt64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
+      DCHECK_EQ(is_256 ? 4u : 2u, instruction->GetVectorLength());
       __ movd(locations->Out().AsRegister<CpuRegister>(), src, /*64-bit*/ true);
       break;
     case DataType::Type::kFloat32:
     case DataType::Type::kFloat64:
       DCHECK_LE(2u, instruction->GetVectorLength());
-      DCHECK_LE(instruction->GetVectorLength(), 4u);
+      DCHECK_LE(instruction->GetVectorLength(), is_256 ? 8u : 4u);
       DCHECK(locations->InAt(0).Equals(locations->Out()));  // no code required
       break;
     default:
@@ -196,15 +214,22 @@ void LocationsBuilderX86_64::VisitVecReduce(HVecReduce* instruction) {
 }
 
 void InstructionCodeGeneratorX86_64::VisitVecReduce(HVecReduce* instruction) {
+  bool is_256 = Is256BitVector(instruction);
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   switch (instruction->GetPackedType()) {
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
+      DCHECK_EQ(is_256 ? 8u : 4u, instruction->GetVectorLength());
       switch (instruction->GetReductionKind()) {
         case HVecReduce::kSum:
-          __ movaps(dst, src);
+          if (is_256) {
+            // Add the upper half to the lower half first.
+            __ vextracti128(dst, YmmRegister(src), Immediate(1));
+            __ vpaddd(dst, dst, src);
+          } else {
+            __ movaps(dst, src);
+          }
           __ phaddd(dst, dst);
           __ phaddd(dst, dst);
           break;
@@ -216,12 +241,19 @@ void InstructionCodeGeneratorX86_64::VisitVecReduce(HVecReduce* instruction) {
       }
       break;
     case DataType::Type::kInt64: {
-      DCHECK_EQ(2u, instruction->GetVectorLength());
+      DCHECK_EQ(is_256 ? 4u : 2u, instruction->GetVectorLength());
       XmmRegister tmp = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
       switch (instruction->GetReductionKind()) {
         case HVecReduce::kSum:
-          __ movaps(tmp, src);
-          __ movaps(dst, src);
+          if (is_256) {
+            // Add the upper half to the lower half first.
+            __ vextracti128(tmp, YmmRegister(src), Immediate(1));
+            __ vpaddq(dst, tmp, src);
+            __ movaps(tmp, dst);
+          } else {
+            __ movaps(tmp, src);
+            __ movaps(dst, src);
+          }
           __ punpckhqdq(tmp, tmp);
           __ paddq(dst, tmp);
           break;
@@ -242,14 +274,15 @@ void LocationsBuilderX86_64::VisitVecCnv(HVecCnv* instruction) {
 }
 
 void InstructionCodeGeneratorX86_64::VisitVecCnv(HVecCnv* instruction) {
+  bool is_256 = Is256BitVector(instruction);
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   DataType::Type from = instruction->GetInputType();
   DataType::Type to = instruction->GetResultType();
   if (from == DataType::Type::kInt32 && to == DataType::Type::kFloat32) {
-    DCHECK_EQ(4u, instruction->GetVectorLength());
-    __ cvtdq2ps(dst, src);
+    DCHECK_EQ(is_256 ? 8u : 4u, instruction->GetVectorLength());
+    is_256 ? __ vcvtdq2ps(YmmRegister(dst), YmmRegister(src)) : __ cvtdq2ps(dst, src);
   } else {
     LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
   }
@@ -260,39 +293,72 @@ void LocationsBuilderX86_64::VisitVecNeg(HVecNeg* instruction) {
 }
 
 void InstructionCodeGeneratorX86_64::VisitVecNeg(HVecNeg* instruction) {
+  bool is_256 = Is256BitVector(instruction);
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  YmmRegister ymm_src(src);
+  YmmRegister ymm_dst(dst);
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
     case DataType::Type::kInt8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
+      DCHECK_EQ(is_256 ? 32u : 16u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vxorps(dst, dst, dst);  // also clears the upper half
+        __ vpsubb(ymm_dst, ymm_dst, ymm_src);
+        break;
+      }
       __ pxor(dst, dst);
       __ psubb(dst, src);
       break;
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
+      DCHECK_EQ(is_256 ? 16u : 8u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vxorps(dst, dst, dst);  // also clears the upper half
+        __ vpsubw(ymm_dst, ymm_dst, ymm_src);
+        break;
+      }
       __ pxor(dst, dst);
       __ psubw(dst, src);
       break;
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
+      DCHECK_EQ(is_256 ? 8u : 4u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vxorps(dst, dst, dst);  // also clears the upper half
+        __ vpsubd(ymm_dst, ymm_dst, ymm_src);
+        break;
+      }
       __ pxor(dst, dst);
       __ psubd(dst, src);
       break;
     case DataType::Type::kInt64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
+      DCHECK_EQ(is_256 ? 4u : 2u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vxorps(dst, dst, dst);  // also clears the upper half
+        __ vpsubq(ymm_dst, ymm_dst, ymm_src);
+        break;
+      }
       __ pxor(dst, dst);
       __ psubq(dst, src);
       break;
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
+      DCHECK_EQ(is_256 ? 8u : 4u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vxorps(dst, dst, dst);  // also clears the upper half
+        __ vsubps(ymm_dst, ymm_dst, ymm_src);
+        break;
+      }
       __ xorps(dst, dst);
       __ subps(dst, src);
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
+      DCHECK_EQ(is_256 ? 4u : 2u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vxorps(dst, dst, dst);  // also clears the upper half
+        __ vsubpd(ymm_dst, ymm_dst, ymm_src);
+        break;
+      }
       __ xorpd(dst, dst);
       __ subpd(dst, src);
       break;
@@ -304,19 +370,26 @@ void InstructionCodeGeneratorX86_64::VisitVecNeg(HVecNeg* instruction) {
 
 void LocationsBuilderX86_64::VisitVecAbs(HVecAbs* instruction) {
   CreateVecUnOpLocations(GetGraph()->GetAllocator(), instruction);
-  // Integral-abs requires a temporary for the comparison.
-  if (instruction->GetPackedType() == DataType::Type::kInt32) {
+  // Integral-abs requires a temporary for the comparison, unless vpabsd can be used.
+  if (instruction->GetPackedType() == DataType::Type::kInt32 && !Is256BitVector(instruction)) {
     instruction->GetLocations()->AddTemp(Location::RequiresFpuRegister());
   }
 }
 
 void InstructionCodeGeneratorX86_64::VisitVecAbs(HVecAbs* instruction) {
+  bool is_256 = Is256BitVector(instruction);
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  YmmRegister ymm_src(src);
+  YmmRegister ymm_dst(dst);
   switch (instruction->GetPackedType()) {
     case DataType::Type::kInt32: {
-      DCHECK_EQ(4u, instruction->GetVectorLength());
+      DCHECK_EQ(is_256 ? 8u : 4u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vpabsd(ymm_dst, ymm_src);
+        break;
+      }
       XmmRegister tmp = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
       __ movaps(dst, src);
       __ pxor(tmp, tmp);
@@ -326,13 +399,25 @@ void InstructionCodeGeneratorX86_64::VisitVecAbs(HVecAbs* instruction) {
       break;
     }
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
+      DCHECK_EQ(is_256 ? 8u : 4u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vpcmpeqb(ymm_dst, ymm_dst, ymm_dst);  // all ones
+        __ vpsrld(ymm_dst, ymm_dst, Immediate(1));
+        __ vandps(ymm_dst, ymm_dst, ymm_src);
+        break;
+      }
       __ pcmpeqb(dst, dst);  // all ones
       __ psrld(dst, Immediate(1));
       __ andps(dst, src);
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
+      DCHECK_EQ(is_256 ? 4u : 2u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vpcmpeqb(ymm_dst, ymm_dst, ymm_dst);  // all ones
+        __ vpsrlq(ymm_dst, ymm_dst, Immediate(1));
+        __ vandpd(ymm_dst, ymm_dst, ymm_src);
+        break;
+      }
       __ pcmpeqb(dst, dst);  // all ones
       __ psrlq(dst, Immediate(1));
       __ andpd(dst, src);
@@ -352,13 +437,24 @@ void LocationsBuilderX86_64::VisitVecNot(HVecNot* instruction) {
 }
 
 void InstructionCodeGeneratorX86_64::VisitVecNot(HVecNot* instruction) {
+  bool is_256 = Is256BitVector(instruction);
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  YmmRegister ymm_src(src);
+  YmmRegister ymm_dst(dst);
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool: {  // special case boolean-not
-      DCHECK_EQ(16u, instruction->GetVectorLength());
+      DCHECK_EQ(is_256 ? 32u : 16u, instruction->GetVectorLength());
       XmmRegister tmp = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
+      if (is_256) {
+        YmmRegister ymm_tmp(tmp);
+        __ vxorps(dst, dst, dst);  // also clears the upper half
+        __ vpcmpeqb(ymm_tmp, ymm_tmp, ymm_tmp);  // all ones
+        __ vpsubb(ymm_dst, ymm_dst, ymm_tmp);  // 32 x one
+        __ vpxor(ymm_dst, ymm_dst, ymm_src);
+        break;
+      }
       __ pxor(dst, dst);
       __ pcmpeqb(tmp, tmp);  // all ones
       __ psubb(dst, tmp);  // 16 x one
@@ -372,17 +468,32 @@ void InstructionCodeGeneratorX86_64::VisitVecNot(HVecNot* instruction) {
     case DataType::Type::kInt32:
     case DataType::Type::kInt64:
       DCHECK_LE(2u, instruction->GetVectorLength());
-      DCHECK_LE(instruction->GetVectorLength(), 16u);
+      DCHECK_LE(instruction->GetVectorLength(), is_256 ? 32u : 16u);
+      if (is_256) {
+        __ vpcmpeqb(ymm_dst, ymm_dst, ymm_dst);  // all ones
+        __ vpxor(ymm_dst, ymm_dst, ymm_src);
+        break;
+      }
       __ pcmpeqb(dst, dst);  // all ones
       __ pxor(dst, src);
       break;
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
+      DCHECK_EQ(is_256 ? 8u : 4u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vpcmpeqb(ymm_dst, ymm_dst, ymm_dst);  // all ones
+        __ vxorps(ymm_dst, ymm_dst, ymm_src);
+        break;
+      }
       __ pcmpeqb(dst, dst);  // all ones
       __ xorps(dst, src);
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
+      DCHECK_EQ(is_256 ? 4u : 2u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vpcmpeqb(ymm_dst, ymm_dst, ymm_dst);  // all ones
+        __ vxorpd(ymm_dst, ymm_dst, ymm_src);
+        break;
+      }
       __ pcmpeqb(dst, dst);  // all ones
       __ xorpd(dst, src);
       break;
@@ -446,6 +557,7 @@ void LocationsBuilderX86_64::VisitVecAdd(HVecAdd* instruction) {
 }
 
 void InstructionCodeGeneratorX86_64::VisitVecAdd(HVecAdd* instruction) {
+  bool is_256 = Is256BitVector(instruction);
   bool cpu_has_avx = CpuHasAvxFeatureFlag();
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
@@ -455,29 +567,53 @@ void InstructionCodeGeneratorX86_64::VisitVecAdd(HVecAdd* instruction) {
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
     case DataType::Type::kInt8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
-      cpu_has_avx ? __ vpaddb(dst, other_src, src) : __ paddb(dst, src);
+      DCHECK_EQ(is_256 ? 32u : 16u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vpaddb(YmmRegister(dst), YmmRegister(other_src), YmmRegister(src));
+      } else {
+        cpu_has_avx ? __ vpaddb(dst, other_src, src) : __ paddb(dst, src);
+      }
       break;
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      cpu_has_avx ? __ vpaddw(dst, other_src, src) : __ paddw(dst, src);
+      DCHECK_EQ(is_256 ? 16u : 8u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vpaddw(YmmRegister(dst), YmmRegister(other_src), YmmRegister(src));
+      } else {
+        cpu_has_avx ? __ vpaddw(dst, other_src, src) : __ paddw(dst, src);
+      }
       break;
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      cpu_has_avx ? __ vpaddd(dst, other_src, src) : __ paddd(dst, src);
+      DCHECK_EQ(is_256 ? 8u : 4u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vpaddd(YmmRegister(dst), YmmRegister(other_src), YmmRegister(src));
+      } else {
+        cpu_has_avx ? __ vpaddd(dst, other_src, src) : __ paddd(dst, src);
+      }
       break;
     case DataType::Type::kInt64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      cpu_has_avx ? __ vpaddq(dst, other_src, src) : __ paddq(dst, src);
+      DCHECK_EQ(is_256 ? 4u : 2u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vpaddq(YmmRegister(dst), YmmRegister(other_src), YmmRegister(src));
+      } else {
+        cpu_has_avx ? __ vpaddq(dst, other_src, src) : __ paddq(dst, src);
+      }
       break;
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      cpu_has_avx ? __ vaddps(dst, other_src, src) : __ addps(dst, src);
+      DCHECK_EQ(is_256 ? 8u : 4u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vaddps(YmmRegister(dst), YmmRegister(other_src), YmmRegister(src));
+      } else {
+        cpu_has_avx ? __ vaddps(dst, other_src, src) : __ addps(dst, src);
+      }
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      cpu_has_avx ? __ vaddpd(dst, other_src, src) : __ addpd(dst, src);
+      DCHECK_EQ(is_256 ? 4u : 2u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vaddpd(YmmRegister(dst), YmmRegister(other_src), YmmRegister(src));
+      } else {
+        cpu_has_avx ? __ vaddpd(dst, other_src, src) : __ addpd(dst, src);
+      }
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
@@ -490,26 +626,31 @@ void LocationsBuilderX86_64::VisitVecSaturationAdd(HVecSaturationAdd* instructio
 }
 
 void InstructionCodeGeneratorX86_64::VisitVecSaturationAdd(HVecSaturationAdd* instruction) {
+  bool is_256 = Is256BitVector(instruction);
   LocationSummary* locations = instruction->GetLocations();
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
-      __ paddusb(dst, src);
+      DCHECK_EQ(is_256 ? 32u : 16u, instruction->GetVectorLength());
+      is_256 ? __ vpaddusb(YmmRegister(dst), YmmRegister(dst), YmmRegister(src))
+             : __ paddusb(dst, src);
       break;
     case DataType::Type::kInt8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
-      __ paddsb(dst, src);
+      DCHECK_EQ(is_256 ? 32u : 16u, instruction->GetVectorLength());
+      is_256 ? __ vpaddsb(YmmRegister(dst), YmmRegister(dst), YmmRegister(src))
+             : __ paddsb(dst, src);
       break;
     case DataType::Type::kUint16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ paddusw(dst, src);
+      DCHECK_EQ(is_256 ? 16u : 8u, instruction->GetVectorLength());
+      is_256 ? __ vpaddusw(YmmRegister(dst), YmmRegister(dst), YmmRegister(src))
+             : __ paddusw(dst, src);
       break;
     case DataType::Type::kInt16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ paddsw(dst, src);
+      DCHECK_EQ(is_256 ? 16u : 8u, instruction->GetVectorLength());
+      is_256 ? __ vpaddsw(YmmRegister(dst), YmmRegister(dst), YmmRegister(src))
+             : __ paddsw(dst, src);
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
@@ -522,6 +663,7 @@ void LocationsBuilderX86_64::VisitVecHalvingAdd(HVecHalvingAdd* instruction) {
 }
 
 void InstructionCodeGeneratorX86_64::VisitVecHalvingAdd(HVecHalvingAdd* instruction) {
+  bool is_256 = Is256BitVector(instruction);
   LocationSummary* locations = instruction->GetLocations();
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
@@ -531,12 +673,14 @@ void InstructionCodeGeneratorX86_64::VisitVecHalvingAdd(HVecHalvingAdd* instruct
 
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
-      __ pavgb(dst, src);
+      DCHECK_EQ(is_256 ? 32u : 16u, instruction->GetVectorLength());
+      is_256 ? __ vpavgb(YmmRegister(dst), YmmRegister(dst), YmmRegister(src))
+             : __ pavgb(dst, src);
       break;
     case DataType::Type::kUint16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ pavgw(dst, src);
+      DCHECK_EQ(is_256 ? 16u : 8u, instruction->GetVectorLength());
+      is_256 ? __ vpavgw(YmmRegister(dst), YmmRegister(dst), YmmRegister(src))
+             : __ pavgw(dst, src);
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
@@ -553,6 +697,7 @@ void LocationsBuilderX86_64::VisitVecSub(HVecSub* instruction) {
 }
 
 void InstructionCodeGeneratorX86_64::VisitVecSub(HVecSub* instruction) {
+  bool is_256 = Is256BitVector(instruction);
   bool cpu_has_avx = CpuHasAvxFeatureFlag();
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
@@ -562,29 +707,53 @@ void InstructionCodeGeneratorX86_64::VisitVecSub(HVecSub* instruction) {
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
     case DataType::Type::kInt8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
-      cpu_has_avx ? __ vpsubb(dst, other_src, src) : __ psubb(dst, src);
+      DCHECK_EQ(is_256 ? 32u : 16u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vpsubb(YmmRegister(dst), YmmRegister(other_src), YmmRegister(src));
+      } else {
+        cpu_has_avx ? __ vpsubb(dst, other_src, src) : __ psubb(dst, src);
+      }
       break;
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      cpu_has_avx ? __ vpsubw(dst, other_src, src) : __ psubw(dst, src);
+      DCHECK_EQ(is_256 ? 16u : 8u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vpsubw(YmmRegister(dst), YmmRegister(other_src), YmmRegister(src));
+      } else {
+        cpu_has_avx ? __ vpsubw(dst, other_src, src) : __ psubw(dst, src);
+      }
       break;
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      cpu_has_avx ? __ vpsubd(dst, other_src, src) : __ psubd(dst, src);
+      DCHECK_EQ(is_256 ? 8u : 4u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vpsubd(YmmRegister(dst), YmmRegister(other_src), YmmRegister(src));
+      } else {
+        cpu_has_avx ? __ vpsubd(dst, other_src, src) : __ psubd(dst, src);
+      }
       break;
     case DataType::Type::kInt64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      cpu_has_avx ? __ vpsubq(dst, other_src, src) : __ psubq(dst, src);
+      DCHECK_EQ(is_256 ? 4u : 2u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vpsubq(YmmRegister(dst), YmmRegister(other_src), YmmRegister(src));
+      } else {
+        cpu_has_avx ? __ vpsubq(dst, other_src, src) : __ psubq(dst, src);
+      }
       break;
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      cpu_has_avx ? __ vsubps(dst, other_src, src) : __ subps(dst, src);
+      DCHECK_EQ(is_256 ? 8u : 4u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vsubps(YmmRegister(dst), YmmRegister(other_src), YmmRegister(src));
+      } else {
+        cpu_has_avx ? __ vsubps(dst, other_src, src) : __ subps(dst, src);
+      }
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      cpu_has_avx ? __ vsubpd(dst, other_src, src) : __ subpd(dst, src);
+      DCHECK_EQ(is_256 ? 4u : 2u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vsubpd(YmmRegister(dst), YmmRegister(other_src), YmmRegister(src));
+      } else {
+        cpu_has_avx ? __ vsubpd(dst, other_src, src) : __ subpd(dst, src);
+      }
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
@@ -597,26 +766,31 @@ void LocationsBuilderX86_64::VisitVecSaturationSub(HVecSaturationSub* instructio
 }
 
 void InstructionCodeGeneratorX86_64::VisitVecSaturationSub(HVecSaturationSub* instruction) {
+  bool is_256 = Is256BitVector(instruction);
   LocationSummary* locations = instruction->GetLocations();
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
-      __ psubusb(dst, src);
+      DCHECK_EQ(is_256 ? 32u : 16u, instruction->GetVectorLength());
+      is_256 ? __ vpsubusb(YmmRegister(dst), YmmRegister(dst), YmmRegister(src))
+             : __ psubusb(dst, src);
       break;
     case DataType::Type::kInt8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
-      __ psubsb(dst, src);
+      DCHECK_EQ(is_256 ? 32u : 16u, instruction->GetVectorLength());
+      is_256 ? __ vpsubsb(YmmRegister(dst), YmmRegister(dst), YmmRegister(src))
+             : __ psubsb(dst, src);
       break;
     case DataType::Type::kUint16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ psubusw(dst, src);
+      DCHECK_EQ(is_256 ? 16u : 8u, instruction->GetVectorLength());
+      is_256 ? __ vpsubusw(YmmRegister(dst), YmmRegister(dst), YmmRegister(src))
+             : __ psubusw(dst, src);
       break;
     case DataType::Type::kInt16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ psubsw(dst, src);
+      DCHECK_EQ(is_256 ? 16u : 8u, instruction->GetVectorLength());
+      is_256 ? __ vpsubsw(YmmRegister(dst), YmmRegister(dst), YmmRegister(src))
+             : __ psubsw(dst, src);
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
@@ -633,6 +807,7 @@ void LocationsBuilderX86_64::VisitVecMul(HVecMul* instruction) {
 }
 
 void InstructionCodeGeneratorX86_64::VisitVecMul(HVecMul* instruction) {
+  bool is_256 = Is256BitVector(instruction);
   bool cpu_has_avx = CpuHasAvxFeatureFlag();
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
@@ -642,20 +817,36 @@ void InstructionCodeGeneratorX86_64::VisitVecMul(HVecMul* instruction) {
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      cpu_has_avx ? __ vpmullw(dst, other_src, src) : __ pmullw(dst, src);
+      DCHECK_EQ(is_256 ? 16u : 8u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vpmullw(YmmRegister(dst), YmmRegister(other_src), YmmRegister(src));
+      } else {
+        cpu_has_avx ? __ vpmullw(dst, other_src, src) : __ pmullw(dst, src);
+      }
       break;
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      cpu_has_avx ? __ vpmulld(dst, other_src, src): __ pmulld(dst, src);
+      DCHECK_EQ(is_256 ? 8u : 4u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vpmulld(YmmRegister(dst), YmmRegister(other_src), YmmRegister(src));
+      } else {
+        cpu_has_avx ? __ vpmulld(dst, other_src, src) : __ pmulld(dst, src);
+      }
       break;
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      cpu_has_avx ? __ vmulps(dst, other_src, src) : __ mulps(dst, src);
+      DCHECK_EQ(is_256 ? 8u : 4u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vmulps(YmmRegister(dst), YmmRegister(other_src), YmmRegister(src));
+      } else {
+        cpu_has_avx ? __ vmulps(dst, other_src, src) : __ mulps(dst, src);
+      }
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      cpu_has_avx ? __ vmulpd(dst, other_src, src) : __ mulpd(dst, src);
+      DCHECK_EQ(is_256 ? 4u : 2u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vmulpd(YmmRegister(dst), YmmRegister(other_src), YmmRegister(src));
+      } else {
+        cpu_has_avx ? __ vmulpd(dst, other_src, src) : __ mulpd(dst, src);
+      }
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
@@ -672,6 +863,7 @@ void LocationsBuilderX86_64::VisitVecDiv(HVecDiv* instruction) {
 }
 
 void InstructionCodeGeneratorX86_64::VisitVecDiv(HVecDiv* instruction) {
+  bool is_256 = Is256BitVector(instruction);
   bool cpu_has_avx = CpuHasAvxFeatureFlag();
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
@@ -680,12 +872,20 @@ void InstructionCodeGeneratorX86_64::VisitVecDiv(HVecDiv* instruction) {
   DCHECK(cpu_has_avx || other_src == dst);
   switch (instruction->GetPackedType()) {
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      cpu_has_avx ? __ vdivps(dst, other_src, src) : __ divps(dst, src);
+      DCHECK_EQ(is_256 ? 8u : 4u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vdivps(YmmRegister(dst), YmmRegister(other_src), YmmRegister(src));
+      } else {
+        cpu_has_avx ? __ vdivps(dst, other_src, src) : __ divps(dst, src);
+      }
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      cpu_has_avx ? __ vdivpd(dst, other_src, src) : __ divpd(dst, src);
+      DCHECK_EQ(is_256 ? 4u : 2u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vdivpd(YmmRegister(dst), YmmRegister(other_src), YmmRegister(src));
+      } else {
+        cpu_has_avx ? __ vdivpd(dst, other_src, src) : __ divpd(dst, src);
+      }
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
@@ -698,43 +898,52 @@ void LocationsBuilderX86_64::VisitVecMin(HVecMin* instruction) {
 }
 
 void InstructionCodeGeneratorX86_64::VisitVecMin(HVecMin* instruction) {
+  bool is_256 = Is256BitVector(instruction);
   LocationSummary* locations = instruction->GetLocations();
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
-      __ pminub(dst, src);
+      DCHECK_EQ(is_256 ? 32u : 16u, instruction->GetVectorLength());
+      is_256 ? __ vpminub(YmmRegister(dst), YmmRegister(dst), YmmRegister(src))
+             : __ pminub(dst, src);
       break;
     case DataType::Type::kInt8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
-      __ pminsb(dst, src);
+      DCHECK_EQ(is_256 ? 32u : 16u, instruction->GetVectorLength());
+      is_256 ? __ vpminsb(YmmRegister(dst), YmmRegister(dst), YmmRegister(src))
+             : __ pminsb(dst, src);
       break;
     case DataType::Type::kUint16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ pminuw(dst, src);
+      DCHECK_EQ(is_256 ? 16u : 8u, instruction->GetVectorLength());
+      is_256 ? __ vpminuw(YmmRegister(dst), YmmRegister(dst), YmmRegister(src))
+             : __ pminuw(dst, src);
       break;
     case DataType::Type::kInt16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ pminsw(dst, src);
+      DCHECK_EQ(is_256 ? 16u : 8u, instruction->GetVectorLength());
+      is_256 ? __ vpminsw(YmmRegister(dst), YmmRegister(dst), YmmRegister(src))
+             : __ pminsw(dst, src);
       break;
     case DataType::Type::kUint32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ pminud(dst, src);
+      DCHECK_EQ(is_256 ? 8u : 4u, instruction->GetVectorLength());
+      is_256 ? __ vpminud(YmmRegister(dst), YmmRegister(dst), YmmRegister(src))
+             : __ pminud(dst, src);
       break;
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ pminsd(dst, src);
+      DCHECK_EQ(is_256 ? 8u : 4u, instruction->GetVectorLength());
+      is_256 ? __ vpminsd(YmmRegister(dst), YmmRegister(dst), YmmRegister(src))
+             : __ pminsd(dst, src);
       break;
     // Next cases are sloppy wrt 0.0 vs -0.0.
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ minps(dst, src);
+      DCHECK_EQ(is_256 ? 8u : 4u, instruction->GetVectorLength());
+      is_256 ? __ vminps(YmmRegister(dst), YmmRegister(dst), YmmRegister(src))
+             : __ minps(dst, src);
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      __ minpd(dst, src);
+      DCHECK_EQ(is_256 ? 4u : 2u, instruction->GetVectorLength());
+      is_256 ? __ vminpd(YmmRegister(dst), YmmRegister(dst), YmmRegister(src))
+             : __ minpd(dst, src);
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
@@ -747,43 +956,52 @@ void LocationsBuilderX86_64::VisitVecMax(HVecMax* instruction) {
 }
 
 void InstructionCodeGeneratorX86_64::VisitVecMax(HVecMax* instruction) {
+  bool is_256 = Is256BitVector(instruction);
   LocationSummary* locations = instruction->GetLocations();
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
-      __ pmaxub(dst, src);
+      DCHECK_EQ(is_256 ? 32u : 16u, instruction->GetVectorLength());
+      is_256 ? __ vpmaxub(YmmRegister(dst), YmmRegister(dst), YmmRegister(src))
+             : __ pmaxub(dst, src);
       break;
     case DataType::Type::kInt8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
-      __ pmaxsb(dst, src);
+      DCHECK_EQ(is_256 ? 32u : 16u, instruction->GetVectorLength());
+      is_256 ? __ vpmaxsb(YmmRegister(dst), YmmRegister(dst), YmmRegister(src))
+             : __ pmaxsb(dst, src);
       break;
     case DataType::Type::kUint16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ pmaxuw(dst, src);
+      DCHECK_EQ(is_256 ? 16u : 8u, instruction->GetVectorLength());
+      is_256 ? __ vpmaxuw(YmmRegister(dst), YmmRegister(dst), YmmRegister(src))
+             : __ pmaxuw(dst, src);
       break;
     case DataType::Type::kInt16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ pmaxsw(dst, src);
+      DCHECK_EQ(is_256 ? 16u : 8u, instruction->GetVectorLength());
+      is_256 ? __ vpmaxsw(YmmRegister(dst), YmmRegister(dst), YmmRegister(src))
+             : __ pmaxsw(dst, src);
       break;
     case DataType::Type::kUint32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ pmaxud(dst, src);
+      DCHECK_EQ(is_256 ? 8u : 4u, instruction->GetVectorLength());
+      is_256 ? __ vpmaxud(YmmRegister(dst), YmmRegister(dst), YmmRegister(src))
+             : __ pmaxud(dst, src);
       break;
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ pmaxsd(dst, src);
+      DCHECK_EQ(is_256 ? 8u : 4u, instruction->GetVectorLength());
+      is_256 ? __ vpmaxsd(YmmRegister(dst), YmmRegister(dst), YmmRegister(src))
+             : __ pmaxsd(dst, src);
       break;
     // Next cases are sloppy wrt 0.0 vs -0.0.
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ maxps(dst, src);
+      DCHECK_EQ(is_256 ? 8u : 4u, instruction->GetVectorLength());
+      is_256 ? __ vmaxps(YmmRegister(dst), YmmRegister(dst), YmmRegister(src))
+             : __ maxps(dst, src);
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      __ maxpd(dst, src);
+      DCHECK_EQ(is_256 ? 4u : 2u, instruction->GetVectorLength());
+      is_256 ? __ vmaxpd(YmmRegister(dst), YmmRegister(dst), YmmRegister(src))
+             : __ maxpd(dst, src);
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
@@ -800,6 +1018,7 @@ void LocationsBuilderX86_64::VisitVecAnd(HVecAnd* instruction) {
 }
 
 void InstructionCodeGeneratorX86_64::VisitVecAnd(HVecAnd* instruction) {
+  bool is_256 = Is256BitVector(instruction);
   bool cpu_has_avx = CpuHasAvxFeatureFlag();
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister other_src = locations->InAt(0).AsFpuRegister<XmmRegister>();
@@ -815,16 +1034,28 @@ void InstructionCodeGeneratorX86_64::VisitVecAnd(HVecAnd* instruction) {
     case DataType::Type::kInt32:
     case DataType::Type::kInt64:
       DCHECK_LE(2u, instruction->GetVectorLength());
-      DCHECK_LE(instruction->GetVectorLength(), 16u);
-      cpu_has_avx ? __ vpand(dst, other_src, src) : __ pand(dst, src);
+      DCHECK_LE(instruction->GetVectorLength(), is_256 ? 32u : 16u);
+      if (is_256) {
+        __ vpand(YmmRegister(dst), YmmRegister(other_src), YmmRegister(src));
+      } else {
+        cpu_has_avx ? __ vpand(dst, other_src, src) : __ pand(dst, src);
+      }
       break;
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      cpu_has_avx ? __ vandps(dst, other_src, src) : __ andps(dst, src);
+      DCHECK_EQ(is_256 ? 8u : 4u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vandps(YmmRegister(dst), YmmRegister(other_src), YmmRegister(src));
+      } else {
+        cpu_has_avx ? __ vandps(dst, other_src, src) : __ andps(dst, src);
+      }
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      cpu_has_avx ? __ vandpd(dst, other_src, src) : __ andpd(dst, src);
+      DCHECK_EQ(is_256 ? 4u : 2u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vandpd(YmmRegister(dst), YmmRegister(other_src), YmmRegister(src));
+      } else {
+        cpu_has_avx ? __ vandpd(dst, other_src, src) : __ andpd(dst, src);
+      }
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
@@ -841,6 +1072,7 @@ void LocationsBuilderX86_64::VisitVecAndNot(HVecAndNot* instruction) {
 }
 
 void InstructionCodeGeneratorX86_64::VisitVecAndNot(HVecAndNot* instruction) {
+  bool is_256 = Is256BitVector(instruction);
   bool cpu_has_avx = CpuHasAvxFeatureFlag();
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister other_src = locations->InAt(0).AsFpuRegister<XmmRegister>();
@@ -856,16 +1088,28 @@ void InstructionCodeGeneratorX86_64::VisitVecAndNot(HVecAndNot* instruction) {
     case DataType::Type::kInt32:
     case DataType::Type::kInt64:
       DCHECK_LE(2u, instruction->GetVectorLength());
-      DCHECK_LE(instruction->GetVectorLength(), 16u);
-      cpu_has_avx ? __ vpandn(dst, other_src, src) : __ pandn(dst, src);
+      DCHECK_LE(instruction->GetVectorLength(), is_256 ? 32u : 16u);
+      if (is_256) {
+        __ vpandn(YmmRegister(dst), YmmRegister(other_src), YmmRegister(src));
+      } else {
+        cpu_has_avx ? __ vpandn(dst, other_src, src) : __ pandn(dst, src);
+      }
       break;
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      cpu_has_avx ? __ vandnps(dst, other_src, src) : __ andnps(dst, src);
+      DCHECK_EQ(is_256 ? 8u : 4u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vandnps(YmmRegister(dst), YmmRegister(other_src), YmmRegister(src));
+      } else {
+        cpu_has_avx ? __ vandnps(dst, other_src, src) : __ andnps(dst, src);
+      }
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      cpu_has_avx ? __ vandnpd(dst, other_src, src) : __ andnpd(dst, src);
+      DCHECK_EQ(is_256 ? 4u : 2u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vandnpd(YmmRegister(dst), YmmRegister(other_src), YmmRegister(src));
+      } else {
+        cpu_has_avx ? __ vandnpd(dst, other_src, src) : __ andnpd(dst, src);
+      }
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
@@ -882,6 +1126,7 @@ void LocationsBuilderX86_64::VisitVecOr(HVecOr* instruction) {
 }
 
 void InstructionCodeGeneratorX86_64::VisitVecOr(HVecOr* instruction) {
+  bool is_256 = Is256BitVector(instruction);
   bool cpu_has_avx = CpuHasAvxFeatureFlag();
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister other_src = locations->InAt(0).AsFpuRegister<XmmRegister>();
@@ -897,16 +1142,28 @@ void InstructionCodeGeneratorX86_64::VisitVecOr(HVecOr* instruction) {
     case DataType::Type::kInt32:
     case DataType::Type::kInt64:
       DCHECK_LE(2u, instruction->GetVectorLength());
-      DCHECK_LE(instruction->GetVectorLength(), 16u);
-      cpu_has_avx ? __ vpor(dst, other_src, src) : __ por(dst, src);
+      DCHECK_LE(instruction->GetVectorLength(), is_256 ? 32u : 16u);
+      if (is_256) {
+        __ vpor(YmmRegister(dst), YmmRegister(other_src), YmmRegister(src));
+      } else {
+        cpu_has_avx ? __ vpor(dst, other_src, src) : __ por(dst, src);
+      }
       break;
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      cpu_has_avx ? __ vorps(dst, other_src, src) : __ orps(dst, src);
+      DCHECK_EQ(is_256 ? 8u : 4u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vorps(YmmRegister(dst), YmmRegister(other_src), YmmRegister(src));
+      } else {
+        cpu_has_avx ? __ vorps(dst, other_src, src) : __ orps(dst, src);
+      }
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      cpu_has_avx ? __ vorpd(dst, other_src, src) : __ orpd(dst, src);
+      DCHECK_EQ(is_256 ? 4u : 2u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vorpd(YmmRegister(dst), YmmRegister(other_src), YmmRegister(src));
+      } else {
+        cpu_has_avx ? __ vorpd(dst, other_src, src) : __ orpd(dst, src);
+      }
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
@@ -923,6 +1180,7 @@ void LocationsBuilderX86_64::VisitVecXor(HVecXor* instruction) {
 }
 
 void InstructionCodeGeneratorX86_64::VisitVecXor(HVecXor* instruction) {
+  bool is_256 = Is256BitVector(instruction);
   bool cpu_has_avx = CpuHasAvxFeatureFlag();
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister other_src = locations->InAt(0).AsFpuRegister<XmmRegister>();
@@ -938,16 +1196,28 @@ void InstructionCodeGeneratorX86_64::VisitVecXor(HVecXor* instruction) {
     case DataType::Type::kInt32:
     case DataType::Type::kInt64:
       DCHECK_LE(2u, instruction->GetVectorLength());
-      DCHECK_LE(instruction->GetVectorLength(), 16u);
-      cpu_has_avx ? __ vpxor(dst, other_src, src) : __ pxor(dst, src);
+      DCHECK_LE(instruction->GetVectorLength(), is_256 ? 32u : 16u);
+      if (is_256) {
+        __ vpxor(YmmRegister(dst), YmmRegister(other_src), YmmRegister(src));
+      } else {
+        cpu_has_avx ? __ vpxor(dst, other_src, src) : __ pxor(dst, src);
+      }
       break;
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      cpu_has_avx ? __ vxorps(dst, other_src, src) : __ xorps(dst, src);
+      DCHECK_EQ(is_256 ? 8u : 4u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vxorps(YmmRegister(dst), YmmRegister(other_src), YmmRegister(src));
+      } else {
+        cpu_has_avx ? __ vxorps(dst, other_src, src) : __ xorps(dst, src);
+      }
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      cpu_has_avx ? __ vxorpd(dst, other_src, src) : __ xorpd(dst, src);
+      DCHECK_EQ(is_256 ? 4u : 2u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vxorpd(YmmRegister(dst), YmmRegister(other_src), YmmRegister(src));
+      } else {
+        cpu_has_avx ? __ vxorpd(dst, other_src, src) : __ xorpd(dst, src);
+      }
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
@@ -978,6 +1248,7 @@ void LocationsBuilderX86_64::VisitVecShl(HVecShl* instruction) {
 }
 
 void InstructionCodeGeneratorX86_64::VisitVecShl(HVecShl* instruction) {
+  bool is_256 = Is256BitVector(instruction);
   LocationSummary* locations = instruction->GetLocations();
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   int32_t value = locations->InAt(1).GetConstant()->AsIntConstant()->GetValue();
@@ -985,16 +1256,19 @@ void InstructionCodeGeneratorX86_64::VisitVecShl(HVecShl* instruction) {
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ psllw(dst, Immediate(static_cast<int8_t>(value)));
+      DCHECK_EQ(is_256 ? 16u : 8u, instruction->GetVectorLength());
+      is_256 ? __ vpsllw(YmmRegister(dst), YmmRegister(dst), Immediate(static_cast<int8_t>(value)))
+             : __ psllw(dst, Immediate(static_cast<int8_t>(value)));
       break;
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ pslld(dst, Immediate(static_cast<int8_t>(value)));
+      DCHECK_EQ(is_256 ? 8u : 4u, instruction->GetVectorLength());
+      is_256 ? __ vpslld(YmmRegister(dst), YmmRegister(dst), Immediate(static_cast<int8_t>(value)))
+             : __ pslld(dst, Immediate(static_cast<int8_t>(value)));
       break;
     case DataType::Type::kInt64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      __ psllq(dst, Immediate(static_cast<int8_t>(value)));
+      DCHECK_EQ(is_256 ? 4u : 2u, instruction->GetVectorLength());
+      is_256 ? __ vpsllq(YmmRegister(dst), YmmRegister(dst), Immediate(static_cast<int8_t>(value)))
+             : __ psllq(dst, Immediate(static_cast<int8_t>(value)));
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
@@ -1007,6 +1281,7 @@ void LocationsBuilderX86_64::VisitVecShr(HVecShr* instruction) {
 }
 
 void InstructionCodeGeneratorX86_64::VisitVecShr(HVecShr* instruction) {
+  bool is_256 = Is256BitVector(instruction);
   LocationSummary* locations = instruction->GetLocations();
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   int32_t value = locations->InAt(1).GetConstant()->AsIntConstant()->GetValue();
@@ -1014,12 +1289,14 @@ void InstructionCodeGeneratorX86_64::VisitVecShr(HVecShr* instruction) {
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ psraw(dst, Immediate(static_cast<int8_t>(value)));
+      DCHECK_EQ(is_256 ? 16u : 8u, instruction->GetVectorLength());
+      is_256 ? __ vpsraw(YmmRegister(dst), YmmRegister(dst), Immediate(static_cast<int8_t>(value)))
+             : __ psraw(dst, Immediate(static_cast<int8_t>(value)));
       break;
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ psrad(dst, Immediate(static_cast<int8_t>(value)));
+      DCHECK_EQ(is_256 ? 8u : 4u, instruction->GetVectorLength());
+      is_256 ? __ vpsrad(YmmRegister(dst), YmmRegister(dst), Immediate(static_cast<int8_t>(value)))
+             : __ psrad(dst, Immediate(static_cast<int8_t>(value)));
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
@@ -1032,6 +1309,7 @@ void LocationsBuilderX86_64::VisitVecUShr(HVecUShr* instruction) {
 }
 
 void InstructionCodeGeneratorX86_64::VisitVecUShr(HVecUShr* instruction) {
+  bool is_256 = Is256BitVector(instruction);
   LocationSummary* locations = instruction->GetLocations();
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   int32_t value = locations->InAt(1).GetConstant()->AsIntConstant()->GetValue();
@@ -1039,16 +1317,19 @@ void InstructionCodeGeneratorX86_64::VisitVecUShr(HVecUShr* instruction) {
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ psrlw(dst, Immediate(static_cast<int8_t>(value)));
+      DCHECK_EQ(is_256 ? 16u : 8u, instruction->GetVectorLength());
+      is_256 ? __ vpsrlw(YmmRegister(dst), YmmRegister(dst), Immediate(static_cast<int8_t>(value)))
+             : __ psrlw(dst, Immediate(static_cast<int8_t>(value)));
       break;
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ psrld(dst, Immediate(static_cast<int8_t>(value)));
+      DCHECK_EQ(is_256 ? 8u : 4u, instruction->GetVectorLength());
+      is_256 ? __ vpsrld(YmmRegister(dst), YmmRegister(dst), Immediate(static_cast<int8_t>(value)))
+             : __ psrld(dst, Immediate(static_cast<int8_t>(value)));
       break;
     case DataType::Type::kInt64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      __ psrlq(dst, Immediate(static_cast<int8_t>(value)));
+      DCHECK_EQ(is_256 ? 4u : 2u, instruction->GetVectorLength());
+      is_256 ? __ vpsrlq(YmmRegister(dst), YmmRegister(dst), Immediate(static_cast<int8_t>(value)))
+             : __ psrlq(dst, Immediate(static_cast<int8_t>(value)));
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
@@ -1089,6 +1370,7 @@ void LocationsBuilderX86_64::VisitVecSetScalars(HVecSetScalars* instruction) {
 }
 
 void InstructionCodeGeneratorX86_64::VisitVecSetScalars(HVecSetScalars* instruction) {
+  bool is_256 = Is256BitVector(instruction);
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
 
@@ -1096,7 +1378,11 @@ void InstructionCodeGeneratorX86_64::VisitVecSetScalars(HVecSetScalars* instruct
 
   // Zero out all other elements first.
   bool cpu_has_avx = CpuHasAvxFeatureFlag();
-  cpu_has_avx ? __ vxorps(dst, dst, dst) : __ xorps(dst, dst);
+  if (is_256) {
+    __ vxorps(YmmRegister(dst), YmmRegister(dst), YmmRegister(dst));
+  } else {
+    cpu_has_avx ? __ vxorps(dst, dst, dst) : __ xorps(dst, dst);
+  }
 
   // Shorthand for any type of zero.
   if (IsZeroBitPattern(instruction->InputAt(0))) {
@@ -1113,19 +1399,19 @@ void InstructionCodeGeneratorX86_64::VisitVecSetScalars(HVecSetScalars* instruct
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
       UNREACHABLE();
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
+      DCHECK_EQ(is_256 ? 8u : 4u, instruction->GetVectorLength());
       __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>());
       break;
     case DataType::Type::kInt64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
+      DCHECK_EQ(is_256 ? 4u : 2u, instruction->GetVectorLength());
       __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>());  // is 64-bit
       break;
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
+      DCHECK_EQ(is_256 ? 8u : 4u, instruction->GetVectorLength());
       __ movss(dst, locations->InAt(0).AsFpuRegister<XmmRegister>());
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
+      DCHECK_EQ(is_256 ? 4u : 2u, instruction->GetVectorLength());
       __ movsd(dst, locations->InAt(0).AsFpuRegister<XmmRegister>());
       break;
     default:
@@ -1183,6 +1469,7 @@ void LocationsBuilderX86_64::VisitVecDotProd(HVecDotProd* instruction) {
 }
 
 void InstructionCodeGeneratorX86_64::VisitVecDotProd(HVecDotProd* instruction) {
+  bool is_256 = Is256BitVector(instruction);
   bool cpu_has_avx = CpuHasAvxFeatureFlag();
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister acc = locations->InAt(0).AsFpuRegister<XmmRegister>();
@@ -1190,9 +1477,12 @@ void InstructionCodeGeneratorX86_64::VisitVecDotProd(HVecDotProd* instruction) {
   XmmRegister right = locations->InAt(2).AsFpuRegister<XmmRegister>();
   switch (instruction->GetPackedType()) {
     case DataType::Type::kInt32: {
-      DCHECK_EQ(4u, instruction->GetVectorLength());
+      DCHECK_EQ(is_256 ? 8u : 4u, instruction->GetVectorLength());
       XmmRegister tmp = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
-      if (!cpu_has_avx) {
+      if (is_256) {
+        __ vpmaddwd(YmmRegister(tmp), YmmRegister(left), YmmRegister(right));
+        __ vpaddd(YmmRegister(acc), YmmRegister(acc), YmmRegister(tmp));
+      } else if (!cpu_has_avx) {
         __ movaps(tmp, right);
         __ pmaddwd(tmp, left);
         __ paddd(acc, tmp);
@@ -1257,13 +1547,16 @@ static Address VecAddress(LocationSummary* locations, size_t size, bool is_strin
 
 void LocationsBuilderX86_64::VisitVecLoad(HVecLoad* instruction) {
   CreateVecMemLocations(GetGraph()->GetAllocator(), instruction, /*is_load*/ true);
-  // String load requires a temporary for the compressed load.
-  if (mirror::kUseStringCompression && instruction->IsStringCharAt()) {
+  // String load requires a temporary for the compressed load, unless it can use vpmovzxbw.
+  if (mirror::kUseStringCompression &&
+      instruction->IsStringCharAt() &&
+      !Is256BitVector(instruction)) {
     instruction->GetLocations()->AddTemp(Location::RequiresFpuRegister());
   }
 }
 
 void InstructionCodeGeneratorX86_64::VisitVecLoad(HVecLoad* instruction) {
+  bool is_256 = Is256BitVector(instruction);
   LocationSummary* locations = instruction->GetLocations();
   size_t size = DataType::Size(instruction->GetPackedType());
   Address address = VecAddress(locations, size, instruction->IsStringCharAt());
@@ -1272,17 +1565,27 @@ void InstructionCodeGeneratorX86_64::VisitVecLoad(HVecLoad* instruction) {
   switch (instruction->GetPackedType()) {
     case DataType::Type::kInt16:  // (short) s.charAt(.) can yield HVecLoad/Int16/StringCharAt.
     case DataType::Type::kUint16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
+      DCHECK_EQ(is_256 ? 16u : 8u, instruction->GetVectorLength());
       // Special handling of compressed/uncompressed string load.
       if (mirror::kUseStringCompression && instruction->IsStringCharAt()) {
         NearLabel done, not_compressed;
-        XmmRegister tmp = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
         // Test compression bit.
         static_assert(static_cast<uint32_t>(mirror::StringCompressionFlag::kCompressed) == 0u,
                       "Expecting 0=compressed, 1=uncompressed");
         uint32_t count_offset = mirror::String::CountOffset().Uint32Value();
         __ testb(Address(locations->InAt(0).AsRegister<CpuRegister>(), count_offset), Immediate(1));
         __ j(kNotZero, &not_compressed);
+        if (is_256) {
+          // Zero extend 16 compressed bytes into 16 chars.
+          __ vpmovzxbw(YmmRegister(reg), VecAddress(locations, 1, instruction->IsStringCharAt()));
+          __ jmp(&done);
+          // Load 16 direct uncompressed chars.
+          __ Bind(&not_compressed);
+          __ vmovdqu(YmmRegister(reg), address);
+          __ Bind(&done);
+          return;
+        }
+        XmmRegister tmp = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
         // Zero extend 8 compressed bytes into 8 chars.
         __ movsd(reg, VecAddress(locations, 1, instruction->IsStringCharAt()));
         __ pxor(tmp, tmp);
@@ -1301,15 +1604,27 @@ void InstructionCodeGeneratorX86_64::VisitVecLoad(HVecLoad* instruction) {
     case DataType::Type::kInt32:
     case DataType::Type::kInt64:
       DCHECK_LE(2u, instruction->GetVectorLength());
-      DCHECK_LE(instruction->GetVectorLength(), 16u);
+      DCHECK_LE(instruction->GetVectorLength(), is_256 ? 32u : 16u);
+      if (is_256) {
+        __ vmovdqu(YmmRegister(reg), address);
+        break;
+      }
       is_aligned16 ? __ movdqa(reg, address) : __ movdqu(reg, address);
       break;
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
+      DCHECK_EQ(is_256 ? 8u : 4u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vmovups(YmmRegister(reg), address);
+        break;
+      }
       is_aligned16 ? __ movaps(reg, address) : __ movups(reg, address);
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
+      DCHECK_EQ(is_256 ? 4u : 2u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vmovupd(YmmRegister(reg), address);
+        break;
+      }
       is_aligned16 ? __ movapd(reg, address) : __ movupd(reg, address);
       break;
     default:
@@ -1323,6 +1638,7 @@ void LocationsBuilderX86_64::VisitVecStore(HVecStore* instruction) {
 }
 
 void InstructionCodeGeneratorX86_64::VisitVecStore(HVecStore* instruction) {
+  bool is_256 = Is256BitVector(instruction);
   LocationSummary* locations = instruction->GetLocations();
   size_t size = DataType::Size(instruction->GetPackedType());
   Address address = VecAddress(locations, size, /*is_string_char_at*/ false);
@@ -1337,15 +1653,27 @@ void InstructionCodeGeneratorX86_64::VisitVecStore(HVecStore* instruction) {
     case DataType::Type::kInt32:
     case DataType::Type::kInt64:
       DCHECK_LE(2u, instruction->GetVectorLength());
-      DCHECK_LE(instruction->GetVectorLength(), 16u);
+      DCHECK_LE(instruction->GetVectorLength(), is_256 ? 32u : 16u);
+      if (is_256) {
+        __ vmovdqu(address, YmmRegister(reg));
+        break;
+      }
       is_aligned16 ? __ movdqa(address, reg) : __ movdqu(address, reg);
       break;
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
+      DCHECK_EQ(is_256 ? 8u : 4u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vmovups(address, YmmRegister(reg));
+        break;
+      }
       is_aligned16 ? __ movaps(address, reg) : __ movups(address, reg);
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
+      DCHECK_EQ(is_256 ? 4u : 2u, instruction->GetVectorLength());
+      if (is_256) {
+        __ vmovupd(address, YmmRegister(reg));
+        break;
+      }
       is_aligned16 ? __ movapd(address, reg) : __ movupd(address, reg);
       break;
     default:
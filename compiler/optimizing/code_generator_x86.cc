@@ -2759,11 +2759,14 @@ void CodeGeneratorX86::MaybeGenerateInlineCacheCheck(HInstruction* instruction,
       CHECK_EQ(EBP, instruction->GetLocations()->GetTemp(temp_index).AsRegister<Register>());
     }
     Register temp = EBP;
-    NearLabel done;
+    NearLabel done, miss;
     __ movl(temp, Immediate(address));
-    // Fast path for a monomorphic cache.
+    // Fast path for a monomorphic cache, which only counts the call.
     __ cmpl(klass, Address(temp, InlineCache::ClassesOffset().Int32Value()));
-    __ j(kEqual, &done);
+    __ j(kNotEqual, &miss);
+    __ addl(Address(temp, InlineCache::CountsOffset().Int32Value()), Immediate(1));
+    __ jmp(&done);
+    __ Bind(&miss);
     GenerateInvokeRuntime(GetThreadOffset<kX86PointerSize>(kQuickUpdateInlineCache).Int32Value());
     __ Bind(&done);
   }
@@ -216,6 +216,7 @@ class ParallelMoveResolverX86_64 : public ParallelMoveResolverWithSwap {
   void Exchange64(CpuRegister reg, int mem);
   void Exchange64(XmmRegister reg, int mem);
   void Exchange128(XmmRegister reg, int mem);
+  void Exchange256(XmmRegister reg, int mem);
   void ExchangeMemory32(int mem1, int mem2);
   void ExchangeMemory64(int mem1, int mem2, int num_of_qwords);
 
@@ -437,8 +438,12 @@ class CodeGeneratorX86_64 : public CodeGenerator {
     return 1 * kX86_64WordSize;
   }
 
-  size_t GetSIMDRegisterWidth() const override {
-    return 2 * kX86_64WordSize;
+  size_t GetSIMDRegisterWidth() const override;
+
+  // Whether the SIMD values of the graph take the full 256 bits of the YMM registers, in which
+  // case the moves of FP registers must preserve their upper halves.
+  bool UsesYmmRegisters() const {
+    return GetGraph()->HasSIMD() && GetSIMDRegisterWidth() == 4 * kX86_64WordSize;
   }
 
   HGraphVisitor* GetLocationBuilder() override {
@@ -707,7 +712,9 @@ class CodeGeneratorX86_64 : public CodeGenerator {
   void GenerateExplicitNullCheck(HNullCheck* instruction) override;
   void MaybeGenerateInlineCacheCheck(HInstruction* instruction, CpuRegister cls);
 
-  void MaybeIncrementHotness(bool is_frame_entry);
+  // `suspend_check` is the suspend check of the loop when called on a loop back edge,
+  // null otherwise.
+  void MaybeIncrementHotness(HSuspendCheck* suspend_check, bool is_frame_entry);
 
   static void BlockNonVolatileXmmRegisters(LocationSummary* locations);
 
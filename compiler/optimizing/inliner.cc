@@ -72,6 +72,18 @@ static constexpr size_t kMaximumNumberOfPolymorphicRecursiveCalls = 0;
 // Controls the use of inline caches in AOT mode.
 static constexpr bool kUseAOTInlineCaches = true;
 
+// Minimum number of calls counted by a JIT inline cache for the frequencies of its receiver
+// types to be trusted.
+static constexpr uint32_t kMinimumCallsForReceiverFrequencies = 100;
+
+// Percentage of the calls a receiver type needs to be inlined at a polymorphic call site, once
+// the frequencies are trusted. Rarer types are left to the original invoke.
+static constexpr uint32_t kMinimumPolymorphicReceiverPercentage = 10;
+
+// Percentage of the calls the dominant receiver type needs to be inlined at a megamorphic call
+// site.
+static constexpr uint32_t kMinimumMegamorphicReceiverPercentage = 80;
+
 // Controls the use of inlining try catches.
 static constexpr bool kInlineTryCatches = true;
 
@@ -349,6 +361,36 @@ HInliner::InlineCacheType HInliner::GetInlineCacheType(
   }
 }
 
+// Sort the first `number_of_types` classes of the inline cache by decreasing number of calls,
+// and return how many of them reach `min_percentage` of `total_calls`. If not enough calls were
+// counted, the classes are left as is and all of them are returned.
+static size_t SortReceiverTypesByFrequency(
+    /*inout*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes,
+    /*inout*/uint32_t* counts,
+    size_t number_of_types,
+    uint64_t total_calls,
+    uint32_t min_percentage) REQUIRES_SHARED(Locks::mutator_lock_) {
+  if (total_calls < kMinimumCallsForReceiverFrequencies) {
+    return number_of_types;
+  }
+  // Insertion sort, there are at most InlineCache::kIndividualCacheSize types.
+  for (size_t i = 1; i < number_of_types; ++i) {
+    for (size_t j = i; j != 0 && counts[j - 1] < counts[j]; --j) {
+      ObjPtr<mirror::Object> klass = classes->GetReference(j);
+      classes->SetReference(j, classes->GetReference(j - 1));
+      classes->SetReference(j - 1, klass);
+      std::swap(counts[j], counts[j - 1]);
+    }
+  }
+  size_t number_of_frequent_types = 0;
+  while (number_of_frequent_types != number_of_types &&
+         static_cast<uint64_t>(counts[number_of_frequent_types]) * 100u >=
+             total_calls * min_percentage) {
+    ++number_of_frequent_types;
+  }
+  return number_of_frequent_types;
+}
+
 static inline ObjPtr<mirror::Class> GetMonomorphicType(
     const StackHandleScope<InlineCache::kIndividualCacheSize>& classes)
     REQUIRES_SHARED(Locks::mutator_lock_) {
@@ -364,9 +406,10 @@ ArtMethod* HInliner::FindMethodFromCHA(ArtMethod* resolved_method) {
     // No CHA-based devirtulization for AOT compiler (yet).
     return nullptr;
   }
-  if (Runtime::Current()->IsZygote()) {
+  if (Runtime::Current()->IsSharingJitCode()) {
     // No CHA-based devirtulization for Zygote, as it compiles with
-    // offline information.
+    // offline information. Code shared with forked processes can't be
+    // invalidated by them either.
     return nullptr;
   }
   if (outermost_graph_->IsCompilingOsr()) {
@@ -590,12 +633,19 @@ bool HInliner::TryInlineFromInlineCache(HInvoke* invoke_instruction)
   }
 
   StackHandleScope<InlineCache::kIndividualCacheSize> classes(Thread::Current());
+  // Profiles don't record how often each type was seen, so the counts stay zero for AOT.
+  uint32_t counts[InlineCache::kIndividualCacheSize] = {};
   // The Zygote JIT compiles based on a profile, so we shouldn't use runtime inline caches
   // for it.
   InlineCacheType inline_cache_type =
       (Runtime::Current()->IsAotCompiler() || Runtime::Current()->IsZygote())
           ? GetInlineCacheAOT(invoke_instruction, &classes)
-          : GetInlineCacheJIT(invoke_instruction, &classes);
+          : GetInlineCacheJIT(invoke_instruction, &classes, counts);
+  // Sum in 64 bits, the counts of a hot call site can each get close to the 32-bit limit.
+  uint64_t total_calls = 0u;
+  for (uint32_t count : counts) {
+    total_calls += count;
+  }
 
   switch (inline_cache_type) {
     case kInlineCacheNoData: {
@@ -616,7 +666,8 @@ bool HInliner::TryInlineFromInlineCache(HInvoke* invoke_instruction)
     case kInlineCacheMonomorphic: {
       MaybeRecordStat(stats_, MethodCompilationStat::kMonomorphicCall);
       if (UseOnlyPolymorphicInliningWithNoDeopt()) {
-        return TryInlinePolymorphicCall(invoke_instruction, classes);
+        return TryInlinePolymorphicCall(
+            invoke_instruction, classes, /* number_of_types= */ 1u, /* has_all_types= */ true);
       } else {
         return TryInlineMonomorphicCall(invoke_instruction, classes);
       }
@@ -624,16 +675,42 @@ bool HInliner::TryInlineFromInlineCache(HInvoke* invoke_instruction)
 
     case kInlineCachePolymorphic: {
       MaybeRecordStat(stats_, MethodCompilationStat::kPolymorphicCall);
-      return TryInlinePolymorphicCall(invoke_instruction, classes);
+      size_t number_of_types = InlineCache::kIndividualCacheSize - classes.RemainingSlots();
+      // Inline the most frequent types first, and leave the rare ones to the original invoke.
+      size_t number_of_frequent_types = SortReceiverTypesByFrequency(
+          &classes, counts, number_of_types, total_calls, kMinimumPolymorphicReceiverPercentage);
+      return TryInlinePolymorphicCall(invoke_instruction,
+                                      classes,
+                                      number_of_frequent_types,
+                                      number_of_frequent_types == number_of_types);
     }
 
     case kInlineCacheMegamorphic: {
-      LOG_FAIL_NO_STAT()
-          << "Interface or virtual call to "
-          << invoke_instruction->GetMethodReference().PrettyMethod()
-          << " is megamorphic and not inlined";
       MaybeRecordStat(stats_, MethodCompilationStat::kMegamorphicCall);
-      return false;
+      // The last entry of a megamorphic inline cache holds the last of the other types seen,
+      // and counts the calls for all of them, so it can't be the dominant type.
+      size_t number_of_dominant_types = SortReceiverTypesByFrequency(
+          &classes,
+          counts,
+          InlineCache::kIndividualCacheSize - 1u,
+          total_calls,
+          kMinimumMegamorphicReceiverPercentage);
+      if (total_calls < kMinimumCallsForReceiverFrequencies || number_of_dominant_types == 0u) {
+        LOG_FAIL_NO_STAT()
+            << "Interface or virtual call to "
+            << invoke_instruction->GetMethodReference().PrettyMethod()
+            << " is megamorphic and not inlined";
+        return false;
+      }
+      DCHECK_EQ(number_of_dominant_types, 1u);
+      if (!TryInlinePolymorphicCall(invoke_instruction,
+                                    classes,
+                                    number_of_dominant_types,
+                                    /* has_all_types= */ false)) {
+        return false;
+      }
+      MaybeRecordStat(stats_, MethodCompilationStat::kInlinedMegamorphicCall);
+      return true;
     }
 
     case kInlineCacheMissingTypes: {
@@ -649,7 +726,8 @@ bool HInliner::TryInlineFromInlineCache(HInvoke* invoke_instruction)
 
 HInliner::InlineCacheType HInliner::GetInlineCacheJIT(
     HInvoke* invoke_instruction,
-    /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes) {
+    /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes,
+    /*out*/uint32_t* counts) {
   DCHECK(codegen_->GetCompilerOptions().IsJitCompiler());
 
   ArtMethod* caller = graph_->GetArtMethod();
@@ -662,7 +740,8 @@ HInliner::InlineCacheType HInliner::GetInlineCacheJIT(
 
   Runtime::Current()->GetJit()->GetCodeCache()->CopyInlineCacheInto(
       *profiling_info->GetInlineCache(invoke_instruction->GetDexPc()),
-      classes);
+      classes,
+      counts);
   return GetInlineCacheType(*classes);
 }
 
@@ -952,11 +1031,16 @@ static void MaybeReplaceAndRemove(HInstruction* new_instruction, HInstruction* o
 
 bool HInliner::TryInlinePolymorphicCall(
     HInvoke* invoke_instruction,
-    const StackHandleScope<InlineCache::kIndividualCacheSize>& classes) {
+    const StackHandleScope<InlineCache::kIndividualCacheSize>& classes,
+    size_t number_of_types,
+    bool has_all_types) {
   DCHECK(invoke_instruction->IsInvokeVirtual() || invoke_instruction->IsInvokeInterface())
       << invoke_instruction->DebugName();
+  DCHECK_EQ(classes.NumberOfReferences(), InlineCache::kIndividualCacheSize);
+  DCHECK_NE(number_of_types, 0u);
+  DCHECK_LE(number_of_types, InlineCache::kIndividualCacheSize - classes.RemainingSlots());
 
-  if (TryInlinePolymorphicCallToSameTarget(invoke_instruction, classes)) {
+  if (has_all_types && TryInlinePolymorphicCallToSameTarget(invoke_instruction, classes)) {
     return true;
   }
 
@@ -965,8 +1049,6 @@ bool HInliner::TryInlinePolymorphicCall(
 
   bool all_targets_inlined = true;
   bool one_target_inlined = false;
-  DCHECK_EQ(classes.NumberOfReferences(), InlineCache::kIndividualCacheSize);
-  uint8_t number_of_types = InlineCache::kIndividualCacheSize - classes.RemainingSlots();
   for (size_t i = 0; i != number_of_types; ++i) {
     DCHECK(classes.GetReference(i) != nullptr);
     Handle<mirror::Class> handle =
@@ -989,7 +1071,7 @@ bool HInliner::TryInlinePolymorphicCall(
 
     // In monomorphic cases when UseOnlyPolymorphicInliningWithNoDeopt() is true, we call
     // `TryInlinePolymorphicCall` even though we are monomorphic.
-    const bool actually_monomorphic = number_of_types == 1;
+    const bool actually_monomorphic = has_all_types && number_of_types == 1;
     DCHECK_IMPLIES(actually_monomorphic, UseOnlyPolymorphicInliningWithNoDeopt());
 
     // We only want to limit recursive polymorphic cases, not monomorphic ones.
@@ -1022,6 +1104,7 @@ bool HInliner::TryInlinePolymorphicCall(
       // If we have inlined all targets before, and this receiver is the last seen,
       // we deoptimize instead of keeping the original invoke instruction.
       bool deoptimize = !UseOnlyPolymorphicInliningWithNoDeopt() &&
+          has_all_types &&
           all_targets_inlined &&
           (i + 1 == number_of_types);
 
@@ -35,11 +35,13 @@ class LoadStoreElimination : public HOptimization {
 
   LoadStoreElimination(HGraph* graph,
                        OptimizingCompilerStats* stats,
-                       const char* name = kLoadStoreEliminationPassName)
-      : HOptimization(graph, name, stats) {}
+                       const char* name = kLoadStoreEliminationPassName,
+                       bool enable_partial_lse = kEnablePartialLSE)
+      : HOptimization(graph, name, stats),
+        enable_partial_lse_(enable_partial_lse) {}
 
   bool Run() override {
-    return Run(kEnablePartialLSE);
+    return Run(enable_partial_lse_);
   }
 
   // Exposed for testing.
@@ -48,6 +50,9 @@ class LoadStoreElimination : public HOptimization {
   static constexpr const char* kLoadStoreEliminationPassName = "load_store_elimination";
 
  private:
+  // Whether Run() attempts partial load-store elimination.
+  const bool enable_partial_lse_;
+
   DISALLOW_COPY_AND_ASSIGN(LoadStoreElimination);
 };
 
@@ -16,8 +16,10 @@
 
 #include "loop_analysis.h"
 
+#include "arch/x86/instruction_set_features_x86.h"
 #include "base/bit_vector-inl.h"
 #include "code_generator.h"
+#include "driver/compiler_options.h"
 #include "induction_var_range.h"
 
 namespace art HIDDEN {
@@ -121,7 +123,7 @@ class ArchDefaultLoopHelper : public ArchNoOptsLoopHelper {
   }
 
  protected:
-  bool IsLoopTooBig(LoopAnalysisInfo* loop_analysis_info,
+  bool IsLoopTooBig(const LoopAnalysisInfo* loop_analysis_info,
                     size_t instr_threshold,
                     size_t bb_threshold) const {
     size_t instr_num = loop_analysis_info->GetNumberOfInstructions();
@@ -306,8 +308,19 @@ class X86_64LoopHelper : public ArchDefaultLoopHelper {
   // avoid excessive loop unrolling to ensure LSD (loop stream decoder) is operating efficiently.
   // This variable takes care that unrolled loop instructions should not exceed LSD size.
   // For Intel Atom processors (silvermont & goldmont), LSD size is 28
-  // TODO - identify architecture and LSD size at runtime
   static constexpr uint32_t kX86_64UnrolledMaxBodySizeInstr = 28;
+  // Cores with AVX2 (Haswell and later, Zen) have an LSD or a decoded uop cache of 56 uops and
+  // more, so they run bigger unrolled loops just as well.
+  static constexpr uint32_t kX86_64AVX2UnrolledMaxBodySizeInstr = 56;
+
+  // Loop's maximum instruction count. Loops with higher count will not be peeled/unrolled.
+  static constexpr uint32_t kX86_64ScalarHeuristicMaxBodySizeInstr = 40;
+  // Loop's maximum basic block count. Loops with higher count will not be peeled/unrolled.
+  static constexpr uint32_t kX86_64ScalarHeuristicMaxBodySizeBlocks = 8;
+
+  // Maximum number of a != b tests guarding a vector loop. Vector loops mostly process a few
+  // arrays, and the tests are a compare and a conditional move each.
+  static constexpr uint32_t kX86_64MaxVectorRuntimeTests = 4;
 
   // Loop's maximum basic block count. Loops with higher count will not be partial
   // unrolled (unknown iterations).
@@ -315,8 +328,50 @@ class X86_64LoopHelper : public ArchDefaultLoopHelper {
 
   uint32_t GetUnrollingFactor(HLoopInformation* loop_info, HBasicBlock* header) const;
 
+  // Maximum instruction count of the unrolled loops.
+  const uint32_t unrolled_max_body_size_instr_;
+
  public:
-  explicit X86_64LoopHelper(const CodeGenerator& codegen) : ArchDefaultLoopHelper(codegen) {}
+  explicit X86_64LoopHelper(const CodeGenerator& codegen)
+      : ArchDefaultLoopHelper(codegen),
+        unrolled_max_body_size_instr_(
+            codegen.GetCompilerOptions().GetInstructionSetFeatures()
+                ->AsX86InstructionSetFeatures()->HasAVX2()
+                    ? kX86_64AVX2UnrolledMaxBodySizeInstr
+                    : kX86_64UnrolledMaxBodySizeInstr) {}
+
+  // Unlike the default heuristics, don't reject the loops with long instructions, which use
+  // the 64-bit registers as any other.
+  bool IsLoopNonBeneficialForScalarOpts(LoopAnalysisInfo* loop_analysis_info) const override {
+    return IsLoopTooBig(loop_analysis_info,
+                        kX86_64ScalarHeuristicMaxBodySizeInstr,
+                        kX86_64ScalarHeuristicMaxBodySizeBlocks);
+  }
+
+  uint32_t GetScalarUnrollingFactor(const LoopAnalysisInfo* analysis_info) const override {
+    uint32_t desired_unrolling_factor =
+        ArchDefaultLoopHelper::GetScalarUnrollingFactor(analysis_info);
+    if (desired_unrolling_factor == LoopAnalysisInfo::kNoUnrollingFactor) {
+      return LoopAnalysisInfo::kNoUnrollingFactor;
+    }
+    // Loops within the default limits get unrolled as on the other targets. The bigger loops,
+    // which only the x86-64 limits accept, get unrolled if the unrolled loop still fits in the LSD.
+    if (!analysis_info->HasLongTypeInstructions() &&
+        !IsLoopTooBig(analysis_info,
+                      kScalarHeuristicMaxBodySizeInstr,
+                      kScalarHeuristicMaxBodySizeBlocks)) {
+      return desired_unrolling_factor;
+    }
+    HLoopInformation* loop_info = analysis_info->GetLoopInfo();
+    if (GetUnrollingFactor(loop_info, loop_info->GetHeader()) < desired_unrolling_factor) {
+      return LoopAnalysisInfo::kNoUnrollingFactor;
+    }
+    return desired_unrolling_factor;
+  }
+
+  uint32_t GetMaxVectorRuntimeTests() const override {
+    return kX86_64MaxVectorRuntimeTests;
+  }
 
   uint32_t GetSIMDUnrollingFactor(HBasicBlock* block,
                                   int64_t trip_count,
@@ -390,8 +445,11 @@ uint32_t X86_64LoopHelper::GetUnrollingFactor(HLoopInformation* loop_info,
 
   // Calculate actual unroll factor.
   uint32_t unrolling_factor = kX86_64MaxUnrollFactor;
-  uint32_t unrolling_inst = kX86_64UnrolledMaxBodySizeInstr;
+  uint32_t unrolling_inst = unrolled_max_body_size_instr_;
   // "-3" for one Goto instruction.
+  if (unrolling_inst < num_inst_header + 3) {
+    return 1;  // the header alone does not fit
+  }
   uint32_t desired_size = unrolling_inst - num_inst_header - 3;
   if (desired_size < (2 * num_inst_loop_body)) {
     return 1;
@@ -180,6 +180,12 @@ class ArchNoOptsLoopHelper : public ArenaObject<kArenaAllocOptimization> {
     return LoopAnalysisInfo::kNoUnrollingFactor;
   }
 
+  // Returns the maximum number of a != b runtime tests guarding a vector loop, which let the
+  // loop vectorize when the arrays it accesses may be the same.
+  //
+  // Returns 1 by default, should be overridden by particular target loop helper.
+  virtual uint32_t GetMaxVectorRuntimeTests() const { return 1u; }
+
  protected:
   const CodeGenerator& codegen_;
 };
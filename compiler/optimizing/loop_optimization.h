@@ -204,6 +204,7 @@ class HLoopOptimization : public HOptimization {
   //
 
   bool ShouldVectorize(LoopNode* node, HBasicBlock* block, int64_t trip_count);
+  bool TryAddVectorRuntimeTest(HInstruction* a, HInstruction* b);
   void Vectorize(LoopNode* node, HBasicBlock* block, HBasicBlock* exit, int64_t trip_count);
   void GenerateNewLoop(LoopNode* node,
                        HBasicBlock* block,
@@ -355,9 +356,10 @@ class HLoopOptimization : public HOptimization {
   uint32_t vector_static_peeling_factor_;
   const ArrayReference* vector_dynamic_peeling_candidate_;
 
-  // Dynamic data dependence test of the form a != b.
-  HInstruction* vector_runtime_test_a_;
-  HInstruction* vector_runtime_test_b_;
+  // Dynamic data dependence tests of the form a != b. The vector loop runs only if all of
+  // them pass, otherwise the cleanup loop runs all the iterations.
+  // Contents reside in phase-local heap memory.
+  ScopedArenaVector<std::pair<HInstruction*, HInstruction*>>* vector_runtime_tests_;
 
   // Mapping used during vectorization synthesis for both the scalar peeling/cleanup
   // loop (mode is kSequential) and the actual vector loop (mode is kVector). The data
@@ -275,7 +275,12 @@ ArenaVector<HOptimization*> ConstructOptimizations(
         opt = new (allocator) ConstructorFenceRedundancyElimination(graph, stats, pass_name);
         break;
       case OptimizationPass::kLoadStoreElimination:
-        opt = new (allocator) LoadStoreElimination(graph, stats, pass_name);
+        opt = new (allocator) LoadStoreElimination(
+            graph,
+            stats,
+            pass_name,
+            LoadStoreElimination::kEnablePartialLSE ||
+                codegen->GetCompilerOptions().PartialLoadStoreElimination());
         break;
       case OptimizationPass::kWriteBarrierElimination:
         opt = new (allocator) WriteBarrierElimination(graph, stats, pass_name);
@@ -558,6 +558,9 @@ bool OptimizingCompiler::RunArchOptimizations(HGraph* graph,
         OptDef(OptimizationPass::kInstructionSimplifierX86_64),
         OptDef(OptimizationPass::kSideEffectsAnalysis),
         OptDef(OptimizationPass::kGlobalValueNumbering, "GVN$after_arch"),
+        // Schedule before the memory operand generation, which relies on the order of the
+        // instructions to fold array lengths into the bounds checks.
+        OptDef(OptimizationPass::kScheduling),
         OptDef(OptimizationPass::kX86MemoryOperandGeneration)
       };
       return RunOptimizations(graph,
@@ -600,6 +603,18 @@ static void AllocateRegisters(HGraph* graph,
         RegisterAllocator::Create(&local_allocator, codegen, liveness, strategy);
     register_allocator->AllocateRegisters();
   }
+  if (stats != nullptr) {
+    // Count the values which needed a stack slot, to compare the register allocators with
+    // --dump-stats. Parameters and the current method already live on the stack.
+    for (size_t i = 0, e = liveness.GetNumberOfSsaValues(); i < e; ++i) {
+      HInstruction* instruction = liveness.GetInstructionFromSsaIndex(i);
+      if (instruction->GetLiveInterval()->HasSpillSlot() &&
+          !instruction->IsParameterValue() &&
+          !instruction->IsCurrentMethod()) {
+        MaybeRecordStat(stats, MethodCompilationStat::kSpilledValue);
+      }
+    }
+  }
 }
 
 // Strip pass name suffix to get optimization name.
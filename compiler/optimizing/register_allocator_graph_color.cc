@@ -41,6 +41,10 @@ static constexpr size_t kMaxGraphColoringAttemptsDebug = 100;
 // We always want to avoid spilling inside loops.
 static constexpr size_t kLoopSpillWeightMultiplier = 10;
 
+// Loops nested deeper than this do not increase the cost of a move any further, so that the
+// weights of the intervals in deep loop nests do not overflow.
+static constexpr size_t kMaxLoopDepthForSpillWeight = 8;
+
 // If we avoid moves in single jump blocks, we can avoid jumps to jumps.
 static constexpr size_t kSingleJumpBlockWeightMultiplier = 2;
 
@@ -83,7 +87,8 @@ static size_t CostForMoveAt(size_t position, const SsaLivenessAnalysis& liveness
   if (block->Dominates(block->GetGraph()->GetExitBlock())) {
     cost *= kDominatesExitBlockWeightMultiplier;
   }
-  for (size_t loop_depth = LoopDepthAt(block); loop_depth > 0; --loop_depth) {
+  size_t loop_depth = std::min(LoopDepthAt(block), kMaxLoopDepthForSpillWeight);
+  for (; loop_depth > 0; --loop_depth) {
     cost *= kLoopSpillWeightMultiplier;
   }
   return cost;
@@ -934,7 +939,8 @@ void RegisterAllocatorGraphColor::AddSafepointsFor(HInstruction* instruction) {
   LiveInterval* interval = instruction->GetLiveInterval();
   for (size_t safepoint_index = safepoints_.size(); safepoint_index > 0; --safepoint_index) {
     HInstruction* safepoint = safepoints_[safepoint_index - 1u];
-    size_t safepoint_position = safepoint->GetLifetimePosition();
+    // Implicit null checks are emitted at their use, so their safepoint is there too.
+    size_t safepoint_position = SafepointPosition::ComputePosition(safepoint);
 
     // Test that safepoints_ are ordered in the optimal way.
     DCHECK(safepoint_index == safepoints_.size() ||
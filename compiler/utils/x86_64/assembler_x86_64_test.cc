@@ -343,6 +343,60 @@ class AssemblerX86_64AVXTest : public AssemblerX86_64Test {
   x86_64::X86_64Assembler* CreateAssembler(ArenaAllocator* allocator) override {
     return new (allocator) x86_64::X86_64Assembler(allocator, instruction_set_features_.get());
   }
+
+  // Like RepeatFFF, for the VEX.256 operations on the full YMM registers.
+  std::string RepeatYYY(void (x86_64::X86_64Assembler::*f)(x86_64::YmmRegister,
+                                                           x86_64::YmmRegister,
+                                                           x86_64::YmmRegister),
+                        const std::string& mnemonic) {
+    std::ostringstream str;
+    for (x86_64::XmmRegister* reg1 : GetFPRegisters()) {
+      for (x86_64::XmmRegister* reg2 : GetFPRegisters()) {
+        for (x86_64::XmmRegister* reg3 : GetFPRegisters()) {
+          x86_64::YmmRegister dst(*reg1);
+          x86_64::YmmRegister src1(*reg2);
+          x86_64::YmmRegister src2(*reg3);
+          (GetAssembler()->*f)(dst, src1, src2);
+          str << mnemonic << " %" << src2 << ", %" << src1 << ", %" << dst << "\n";
+        }
+      }
+    }
+    return str.str();
+  }
+
+  // Like RepeatFF, for the VEX.256 operations taking a YMM or an XMM source.
+  template <typename Src>
+  std::string RepeatYF(void (x86_64::X86_64Assembler::*f)(x86_64::YmmRegister, Src),
+                       const std::string& mnemonic) {
+    std::ostringstream str;
+    for (x86_64::XmmRegister* reg1 : GetFPRegisters()) {
+      for (x86_64::XmmRegister* reg2 : GetFPRegisters()) {
+        x86_64::YmmRegister dst(*reg1);
+        Src src(reg2->AsFloatRegister());
+        (GetAssembler()->*f)(dst, src);
+        str << mnemonic << " %" << src << ", %" << dst << "\n";
+      }
+    }
+    return str.str();
+  }
+
+  // The VEX.256 shifts by an immediate.
+  std::string RepeatYYI(void (x86_64::X86_64Assembler::*f)(x86_64::YmmRegister,
+                                                           x86_64::YmmRegister,
+                                                           const x86_64::Immediate&),
+                        const std::string& mnemonic) {
+    std::ostringstream str;
+    for (x86_64::XmmRegister* reg1 : GetFPRegisters()) {
+      for (x86_64::XmmRegister* reg2 : GetFPRegisters()) {
+        x86_64::YmmRegister dst(*reg1);
+        x86_64::YmmRegister src(*reg2);
+        (GetAssembler()->*f)(dst, src, x86_64::Immediate(3));
+        str << mnemonic << " $3, %" << src << ", %" << dst << "\n";
+      }
+    }
+    return str.str();
+  }
+
  private:
   std::unique_ptr<const X86_64InstructionSetFeatures> instruction_set_features_;
 };
@@ -1889,6 +1943,358 @@ TEST_F(AssemblerX86_64AVXTest, VFmadd213sd) {
                       "vfmadd213sd %{reg3}, %{reg2}, %{reg1}"), "vfmadd213sd");
 }
 
+TEST_F(AssemblerX86_64AVXTest, VpaddbYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpaddb, "vpaddb"), "vpaddb_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpaddwYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpaddw, "vpaddw"), "vpaddw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpadddYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpaddd, "vpaddd"), "vpaddd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpaddqYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpaddq, "vpaddq"), "vpaddq_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpsubbYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpsubb, "vpsubb"), "vpsubb_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpsubwYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpsubw, "vpsubw"), "vpsubw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpsubdYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpsubd, "vpsubd"), "vpsubd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpsubqYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpsubq, "vpsubq"), "vpsubq_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpaddusbYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpaddusb, "vpaddusb"), "vpaddusb_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpaddsbYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpaddsb, "vpaddsb"), "vpaddsb_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpadduswYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpaddusw, "vpaddusw"), "vpaddusw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpaddswYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpaddsw, "vpaddsw"), "vpaddsw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpsubusbYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpsubusb, "vpsubusb"), "vpsubusb_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpsubsbYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpsubsb, "vpsubsb"), "vpsubsb_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpsubuswYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpsubusw, "vpsubusw"), "vpsubusw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpsubswYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpsubsw, "vpsubsw"), "vpsubsw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpmullwYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpmullw, "vpmullw"), "vpmullw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpmulldYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpmulld, "vpmulld"), "vpmulld_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpmaddwdYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpmaddwd, "vpmaddwd"), "vpmaddwd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpavgbYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpavgb, "vpavgb"), "vpavgb_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpavgwYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpavgw, "vpavgw"), "vpavgw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpminubYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpminub, "vpminub"), "vpminub_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpminsbYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpminsb, "vpminsb"), "vpminsb_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpminuwYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpminuw, "vpminuw"), "vpminuw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpminswYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpminsw, "vpminsw"), "vpminsw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpminudYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpminud, "vpminud"), "vpminud_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpminsdYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpminsd, "vpminsd"), "vpminsd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpmaxubYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpmaxub, "vpmaxub"), "vpmaxub_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpmaxsbYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpmaxsb, "vpmaxsb"), "vpmaxsb_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpmaxuwYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpmaxuw, "vpmaxuw"), "vpmaxuw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpmaxswYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpmaxsw, "vpmaxsw"), "vpmaxsw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpmaxudYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpmaxud, "vpmaxud"), "vpmaxud_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpmaxsdYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpmaxsd, "vpmaxsd"), "vpmaxsd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpandYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpand, "vpand"), "vpand_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpandnYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpandn, "vpandn"), "vpandn_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VporYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpor, "vpor"), "vpor_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpxorYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpxor, "vpxor"), "vpxor_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpcmpeqbYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpcmpeqb, "vpcmpeqb"), "vpcmpeqb_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VaddpsYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vaddps, "vaddps"), "vaddps_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VaddpdYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vaddpd, "vaddpd"), "vaddpd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VsubpsYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vsubps, "vsubps"), "vsubps_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VsubpdYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vsubpd, "vsubpd"), "vsubpd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VmulpsYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vmulps, "vmulps"), "vmulps_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VmulpdYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vmulpd, "vmulpd"), "vmulpd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VdivpsYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vdivps, "vdivps"), "vdivps_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VdivpdYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vdivpd, "vdivpd"), "vdivpd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VminpsYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vminps, "vminps"), "vminps_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VminpdYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vminpd, "vminpd"), "vminpd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VmaxpsYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vmaxps, "vmaxps"), "vmaxps_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VmaxpdYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vmaxpd, "vmaxpd"), "vmaxpd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VandpsYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vandps, "vandps"), "vandps_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VandpdYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vandpd, "vandpd"), "vandpd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VandnpsYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vandnps, "vandnps"), "vandnps_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VandnpdYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vandnpd, "vandnpd"), "vandnpd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VorpsYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vorps, "vorps"), "vorps_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VorpdYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vorpd, "vorpd"), "vorpd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VxorpsYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vxorps, "vxorps"), "vxorps_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VxorpdYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vxorpd, "vxorpd"), "vxorpd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpabsdYmm) {
+  DriverStr(RepeatYF<x86_64::YmmRegister>(&x86_64::X86_64Assembler::vpabsd, "vpabsd"),
+            "vpabsd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, Vcvtdq2psYmm) {
+  DriverStr(RepeatYF<x86_64::YmmRegister>(&x86_64::X86_64Assembler::vcvtdq2ps, "vcvtdq2ps"),
+            "vcvtdq2ps_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpbroadcastbYmm) {
+  DriverStr(RepeatYF<x86_64::XmmRegister>(&x86_64::X86_64Assembler::vpbroadcastb, "vpbroadcastb"),
+            "vpbroadcastb_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpbroadcastwYmm) {
+  DriverStr(RepeatYF<x86_64::XmmRegister>(&x86_64::X86_64Assembler::vpbroadcastw, "vpbroadcastw"),
+            "vpbroadcastw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpbroadcastdYmm) {
+  DriverStr(RepeatYF<x86_64::XmmRegister>(&x86_64::X86_64Assembler::vpbroadcastd, "vpbroadcastd"),
+            "vpbroadcastd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpbroadcastqYmm) {
+  DriverStr(RepeatYF<x86_64::XmmRegister>(&x86_64::X86_64Assembler::vpbroadcastq, "vpbroadcastq"),
+            "vpbroadcastq_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VbroadcastssYmm) {
+  DriverStr(RepeatYF<x86_64::XmmRegister>(&x86_64::X86_64Assembler::vbroadcastss, "vbroadcastss"),
+            "vbroadcastss_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VbroadcastsdYmm) {
+  DriverStr(RepeatYF<x86_64::XmmRegister>(&x86_64::X86_64Assembler::vbroadcastsd, "vbroadcastsd"),
+            "vbroadcastsd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpsllwYmm) {
+  DriverStr(RepeatYYI(&x86_64::X86_64Assembler::vpsllw, "vpsllw"), "vpsllw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpslldYmm) {
+  DriverStr(RepeatYYI(&x86_64::X86_64Assembler::vpslld, "vpslld"), "vpslld_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpsllqYmm) {
+  DriverStr(RepeatYYI(&x86_64::X86_64Assembler::vpsllq, "vpsllq"), "vpsllq_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpsrawYmm) {
+  DriverStr(RepeatYYI(&x86_64::X86_64Assembler::vpsraw, "vpsraw"), "vpsraw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpsradYmm) {
+  DriverStr(RepeatYYI(&x86_64::X86_64Assembler::vpsrad, "vpsrad"), "vpsrad_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpsrlwYmm) {
+  DriverStr(RepeatYYI(&x86_64::X86_64Assembler::vpsrlw, "vpsrlw"), "vpsrlw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpsrldYmm) {
+  DriverStr(RepeatYYI(&x86_64::X86_64Assembler::vpsrld, "vpsrld"), "vpsrld_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpsrlqYmm) {
+  DriverStr(RepeatYYI(&x86_64::X86_64Assembler::vpsrlq, "vpsrlq"), "vpsrlq_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VmovapsYmm) {
+  DriverStr(RepeatYF<x86_64::YmmRegister>(&x86_64::X86_64Assembler::vmovaps, "vmovaps"),
+            "vmovaps_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VmovYmmAddress) {
+  x86_64::YmmRegister ymm0(x86_64::XMM0);
+  x86_64::YmmRegister ymm9(x86_64::XMM9);
+  x86_64::Address low(x86_64::CpuRegister(x86_64::RDI), 16);
+  x86_64::Address high(
+      x86_64::CpuRegister(x86_64::R9), x86_64::CpuRegister(x86_64::R10), x86_64::TIMES_4, 8);
+  GetAssembler()->vmovups(ymm0, low);
+  GetAssembler()->vmovups(high, ymm9);
+  GetAssembler()->vmovupd(ymm9, low);
+  GetAssembler()->vmovupd(high, ymm0);
+  GetAssembler()->vmovdqu(ymm0, high);
+  GetAssembler()->vmovdqu(low, ymm9);
+  GetAssembler()->vpmovzxbw(ymm9, high);
+  GetAssembler()->vpmovzxbw(ymm0, low);
+  const char* expected =
+      "vmovups 16(%rdi), %ymm0\n"
+      "vmovups %ymm9, 8(%r9,%r10,4)\n"
+      "vmovupd 16(%rdi), %ymm9\n"
+      "vmovupd %ymm0, 8(%r9,%r10,4)\n"
+      "vmovdqu 8(%r9,%r10,4), %ymm0\n"
+      "vmovdqu %ymm9, 16(%rdi)\n"
+      "vpmovzxbw 8(%r9,%r10,4), %ymm9\n"
+      "vpmovzxbw 16(%rdi), %ymm0\n";
+  DriverStr(expected, "vmov_ymm_address");
+}
+
+TEST_F(AssemblerX86_64AVXTest, Vextracti128) {
+  std::ostringstream str;
+  for (x86_64::XmmRegister* reg1 : GetFPRegisters()) {
+    for (x86_64::XmmRegister* reg2 : GetFPRegisters()) {
+      x86_64::YmmRegister src(*reg2);
+      GetAssembler()->vextracti128(*reg1, src, x86_64::Immediate(1));
+      str << "vextracti128 $1, %" << src << ", %" << *reg1 << "\n";
+    }
+  }
+  DriverStr(str.str(), "vextracti128");
+}
+
+TEST_F(AssemblerX86_64AVXTest, Vzeroupper) {
+  GetAssembler()->vzeroupper();
+  DriverStr("vzeroupper\n", "vzeroupper");
+}
+
 TEST_F(AssemblerX86_64Test, Phaddw) {
   DriverStr(RepeatFF(&x86_64::X86_64Assembler::phaddw, "phaddw %{reg2}, %{reg1}"), "phaddw");
 }
@@ -67,7 +67,13 @@
   METRIC(YoungGcDuration, MetricsCounter)                           \
   METRIC(FullGcScannedBytes, MetricsCounter)                        \
   METRIC(FullGcFreedBytes, MetricsCounter)                          \
-  METRIC(FullGcDuration, MetricsCounter)
+  METRIC(FullGcDuration, MetricsCounter)                            \
+  METRIC(YoungGcSurvivalRate, MetricsHistogram, 20, 0, 100)         \
+  METRIC(FullGcSurvivalRate, MetricsHistogram, 20, 0, 100)          \
+  METRIC(YoungGcPromotedBytes, MetricsCounter)                      \
+  METRIC(JitQueueDepth, MetricsHistogram, 16, 0, 256)               \
+  METRIC(JitWarmupThreshold, MetricsGauge)                          \
+  METRIC(JitOptimizeThreshold, MetricsGauge)
 
 // Increasing counter metrics, reported as Value Metrics in delta increments.
 #define ART_VALUE_METRICS(METRIC)                              \
@@ -87,7 +93,8 @@
   METRIC(TotalBytesAllocatedDelta, MetricsDeltaCounter)        \
   METRIC(TotalGcCollectionTimeDelta, MetricsDeltaCounter)      \
   METRIC(YoungGcCountDelta, MetricsDeltaCounter)               \
-  METRIC(FullGcCountDelta, MetricsDeltaCounter)
+  METRIC(FullGcCountDelta, MetricsDeltaCounter)                \
+  METRIC(YoungGcPromotedBytesDelta, MetricsDeltaCounter)
 
 #define ART_METRICS(METRIC) \
   ART_EVENT_METRICS(METRIC) \
@@ -288,6 +295,8 @@ class MetricsBackend {
   friend class MetricsAccumulator;
   template <DatumId datum_id, typename T>
   friend class MetricsAverage;
+  template <DatumId datum_id, typename T>
+  friend class MetricsGauge;
   friend class ArtMetrics;
 };
 
@@ -547,6 +556,45 @@ class MetricsAccumulator final : MetricsBase<T> {
   friend class ArtMetrics;
 };
 
+// A metric which reports the last value it was given, e.g. the current value of a setting
+// which changes over time.
+template <DatumId datum_id, typename T = uint64_t>
+class MetricsGauge final : public MetricsBase<T> {
+ public:
+  using value_t = T;
+
+  explicit constexpr MetricsGauge(uint64_t value = 0) : value_{value} {
+    // Ensure we do not have any unnecessary data in this class.
+    // Adding intptr_t to accommodate vtable, and rounding up to incorporate
+    // padding.
+    static_assert(RoundUp(sizeof(*this), sizeof(uint64_t)) ==
+                  RoundUp(sizeof(intptr_t) + sizeof(value_t), sizeof(uint64_t)));
+  }
+
+  void Add(value_t value) override {
+    value_.store(value, std::memory_order::memory_order_relaxed);
+  }
+
+  void Report(const std::vector<MetricsBackend*>& backends) const {
+    for (MetricsBackend* backend : backends) {
+      backend->ReportCounter(datum_id, Value());
+    }
+  }
+
+ protected:
+  void Reset() { value_ = 0; }
+
+ private:
+  value_t Value() const { return value_.load(std::memory_order::memory_order_relaxed); }
+
+  bool IsNull() const override { return Value() == 0; }
+
+  std::atomic<value_t> value_;
+  static_assert(std::atomic<value_t>::is_always_lock_free);
+
+  friend class ArtMetrics;
+};
+
 // Base class for formatting metrics into different formats
 // (human-readable text, JSON, etc.)
 class MetricsFormatter {
@@ -112,6 +112,14 @@ TEST_F(MetricsTest, AccumulatorMetric) {
   EXPECT_EQ(CounterValue(accumulator), kMaxValue);
 }
 
+TEST_F(MetricsTest, GaugeMetric) {
+  MetricsGauge<DatumId::kJitWarmupThreshold> gauge;
+  EXPECT_EQ(CounterValue(gauge), 0u);
+  gauge.Add(100u);
+  gauge.Add(25u);
+  EXPECT_EQ(CounterValue(gauge), 25u);
+}
+
 TEST_F(MetricsTest, AverageMetric) {
   MetricsAverage<DatumId::kClassLoadingTotalTime, uint64_t> avg;
 
@@ -165,7 +165,7 @@ X86FeaturesUniquePtr X86InstructionSetFeatures::FromBitmap(uint32_t bitmap, bool
   bool has_SSE4_1 = (bitmap & kSse4_1Bitfield) != 0;
   bool has_SSE4_2 = (bitmap & kSse4_2Bitfield) != 0;
   bool has_AVX = (bitmap & kAvxBitfield) != 0;
-  bool has_AVX2 = (bitmap & kAvxBitfield) != 0;
+  bool has_AVX2 = (bitmap & kAvx2Bitfield) != 0;
   bool has_POPCNT = (bitmap & kPopCntBitfield) != 0;
   return Create(x86_64, has_SSSE3, has_SSE4_1, has_SSE4_2, has_AVX, has_AVX2, has_POPCNT);
 }
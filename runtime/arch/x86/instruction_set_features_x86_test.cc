@@ -209,4 +209,33 @@ TEST(X86InstructionSetFeaturesTest, X86FeaturesFromKabylakeVariant) {
 
   EXPECT_FALSE(x86_64_features->Equals(x86_features.get()));
 }
+
+TEST(X86InstructionSetFeaturesTest, X86FeaturesFromBitmap) {
+  // AVX and AVX2 are read from their own bits.
+  std::unique_ptr<const InstructionSetFeatures> avx_features(
+      InstructionSetFeatures::FromBitmap(InstructionSet::kX86_64, 47U));
+  EXPECT_STREQ("ssse3,sse4.1,sse4.2,avx,-avx2,popcnt",
+               avx_features->GetFeatureString().c_str());
+  EXPECT_EQ(avx_features->AsBitmap(), 47U);
+
+  std::unique_ptr<const InstructionSetFeatures> avx2_features(
+      InstructionSetFeatures::FromBitmap(InstructionSet::kX86_64, 63U));
+  EXPECT_STREQ("ssse3,sse4.1,sse4.2,avx,avx2,popcnt",
+               avx2_features->GetFeatureString().c_str());
+  EXPECT_EQ(avx2_features->AsBitmap(), 63U);
+
+  std::unique_ptr<const InstructionSetFeatures> avx2_only_features(
+      InstructionSetFeatures::FromBitmap(InstructionSet::kX86_64, 55U));
+  EXPECT_STREQ("ssse3,sse4.1,sse4.2,-avx,avx2,popcnt",
+               avx2_only_features->GetFeatureString().c_str());
+  EXPECT_EQ(avx2_only_features->AsBitmap(), 55U);
+  EXPECT_FALSE(avx2_only_features->Equals(avx2_features.get()));
+
+  std::unique_ptr<const InstructionSetFeatures> x86_avx2_features(
+      InstructionSetFeatures::FromBitmap(InstructionSet::kX86, 16U));
+  EXPECT_EQ(x86_avx2_features->GetInstructionSet(), InstructionSet::kX86);
+  EXPECT_STREQ("-ssse3,-sse4.1,-sse4.2,-avx,avx2,-popcnt",
+               x86_avx2_features->GetFeatureString().c_str());
+  EXPECT_EQ(x86_avx2_features->AsBitmap(), 16U);
+}
 }  // namespace art
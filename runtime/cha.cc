@@ -79,6 +79,18 @@ void ClassHierarchyAnalysis::RemoveDependentsWithMethodHeaders(
   }
 }
 
+void ClassHierarchyAnalysis::UpdateDependentMethodHeaders(
+    const std::unordered_map<OatQuickMethodHeader*, OatQuickMethodHeader*>& moved_headers) {
+  for (auto& entry : cha_dependency_map_) {
+    for (MethodAndMethodHeaderPair& dependent : entry.second) {
+      auto it = moved_headers.find(dependent.second);
+      if (it != moved_headers.end()) {
+        dependent.second = it->second;
+      }
+    }
+  }
+}
+
 void ClassHierarchyAnalysis::ResetSingleImplementationInHierarchy(ObjPtr<mirror::Class> klass,
                                                                   const LinearAlloc* alloc,
                                                                   const PointerSize pointer_size)
@@ -110,6 +110,12 @@ class ClassHierarchyAnalysis {
       const std::unordered_set<OatQuickMethodHeader*>& method_headers)
       REQUIRES(Locks::cha_lock_);
 
+  // Replace the OatQuickMethodHeaders of the dependents by the ones they are mapped to in
+  // `moved_headers`. This is used when compiled code is moved.
+  void UpdateDependentMethodHeaders(
+      const std::unordered_map<OatQuickMethodHeader*, OatQuickMethodHeader*>& moved_headers)
+      REQUIRES(Locks::cha_lock_);
+
   // If a given class belongs to a linear allocation that is about to be deleted, in all its
   // superclasses and superinterfaces reset SingleImplementation fields of their methods
   // that might be affected by the deletion.
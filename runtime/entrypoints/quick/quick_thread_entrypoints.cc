@@ -47,6 +47,13 @@ extern "C" void artTestSuspendFromCode(Thread* self) REQUIRES_SHARED(Locks::muta
   result.SetJ(0);
   Runtime::Current()->GetInstrumentation()->DeoptimizeIfNeeded(
       self, sp, DeoptimizationMethodType::kKeepDexPc, result, /* is_ref= */ false);
+
+  // Baseline compiled code also gets here when a loop got hot, so that the JIT can replace its
+  // frame by an OSR frame.
+  jit::Jit* jit = Runtime::Current()->GetJit();
+  if (jit != nullptr) {
+    jit->MaybeDoOnStackReplacementFromBaseline(self);
+  }
 }
 
 extern "C" void artImplicitSuspendFromCode(Thread* self) REQUIRES_SHARED(Locks::mutator_lock_) {
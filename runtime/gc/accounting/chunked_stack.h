@@ -0,0 +1,295 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_GC_ACCOUNTING_CHUNKED_STACK_H_
+#define ART_RUNTIME_GC_ACCOUNTING_CHUNKED_STACK_H_
+
+#include <sys/mman.h>  // For the PROT_* and MAP_* constants.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <android-base/logging.h>
+
+#include "atomic_stack.h"
+#include "base/atomic.h"
+#include "base/globals.h"
+#include "base/macros.h"
+#include "base/mem_map.h"
+#include "base/mutex.h"
+#include "stack_reference.h"
+#include "thread-current-inl.h"
+
+// A lock-free stack of fixed-size chunks of references. It is meant to back a
+// collector's mark stack: rather than reallocating and copying the mark stack
+// when it overflows, the collector spills part of it into chunks, and refills
+// it from them once it runs dry. The chunks can also be used to share work
+// between parallel GC threads: a thread with too much work publishes a chunk
+// with PushChunk() and an idle one takes it with StealChunk(). Both operations
+// are lock-free and may be called concurrently from any number of threads.
+//
+// Chunks are carved out of slabs which are mapped on demand and kept, madvised
+// away, across Reset(). Chunks are identified by their index so that the list
+// heads can carry a tag against the ABA problem.
+
+namespace art {
+namespace gc {
+namespace accounting {
+
+template <typename T>
+class ChunkedStack {
+ public:
+  class Chunk {
+   public:
+    // Number of references a chunk holds, such that a chunk takes a page.
+    static constexpr size_t kCapacity = 1021;
+
+    size_t Size() const {
+      return size_;
+    }
+    bool IsEmpty() const {
+      return size_ == 0;
+    }
+    bool IsFull() const {
+      return size_ == kCapacity;
+    }
+    void PushBack(T* value) REQUIRES_SHARED(Locks::mutator_lock_) {
+      DCHECK_LT(size_, kCapacity);
+      refs_[size_++].Assign(value);
+    }
+    T* PopBack() REQUIRES_SHARED(Locks::mutator_lock_) {
+      DCHECK_GT(size_, 0u);
+      return refs_[--size_].AsMirrorPtr();
+    }
+    StackReference<T>* Begin() {
+      return refs_;
+    }
+    StackReference<T>* End() {
+      return refs_ + size_;
+    }
+    void Clear() {
+      size_ = 0;
+    }
+
+   private:
+    // Index plus one of the next chunk in the list this chunk is on, 0 for none.
+    Atomic<uint32_t> next_;
+    // Index of this chunk.
+    uint32_t index_;
+    uint32_t size_;
+    StackReference<T> refs_[kCapacity];
+
+    friend class ChunkedStack;
+  };
+
+  static ChunkedStack* Create(const std::string& name) {
+    return new ChunkedStack(name);
+  }
+
+  ~ChunkedStack() {}
+
+  // Returns an empty chunk, which the caller owns until it is pushed or freed.
+  Chunk* AllocChunk() {
+    Chunk* chunk = PopList(&free_head_);
+    if (chunk == nullptr) {
+      chunk = AllocNewChunk();
+    }
+    chunk->size_ = 0;
+    return chunk;
+  }
+
+  // Returns a chunk obtained from AllocChunk() or StealChunk() to the pool.
+  void FreeChunk(Chunk* chunk) {
+    PushList(&free_head_, chunk);
+  }
+
+  // Publishes a chunk of references. The caller gives up the chunk.
+  void PushChunk(Chunk* chunk) {
+    DCHECK(!chunk->IsEmpty());
+    size_.fetch_add(chunk->Size(), std::memory_order_relaxed);
+    PushList(&full_head_, chunk);
+  }
+
+  // Takes the most recently published chunk, or returns null if there is none.
+  // Once done with the references, the caller must free the chunk.
+  Chunk* StealChunk() {
+    Chunk* chunk = PopList(&full_head_);
+    if (chunk != nullptr) {
+      size_.fetch_sub(chunk->Size(), std::memory_order_relaxed);
+    }
+    return chunk;
+  }
+
+  // Moves the top `count` references of `stack` to chunks, to make room on it
+  // without resizing it.
+  void SpillFrom(AtomicStack<T>* stack, size_t count) REQUIRES_SHARED(Locks::mutator_lock_) {
+    DCHECK_LE(count, stack->Size());
+    while (count > 0) {
+      Chunk* chunk = AllocChunk();
+      for (; count > 0 && !chunk->IsFull(); --count) {
+        chunk->PushBack(stack->PopBack());
+      }
+      PushChunk(chunk);
+    }
+  }
+
+  // Moves the references of a chunk to `stack`, which must have room for a
+  // full chunk. Returns false if there was no chunk to take.
+  bool RefillInto(AtomicStack<T>* stack) REQUIRES_SHARED(Locks::mutator_lock_) {
+    Chunk* chunk = StealChunk();
+    if (chunk == nullptr) {
+      return false;
+    }
+    DCHECK_LE(stack->Size() + chunk->Size(), stack->Capacity());
+    for (StackReference<T>* ref = chunk->Begin(); ref != chunk->End(); ++ref) {
+      stack->PushBack(ref->AsMirrorPtr());
+    }
+    FreeChunk(chunk);
+    return true;
+  }
+
+  // Whether there is no published chunk. Only precise when no other thread is
+  // pushing or stealing chunks.
+  bool IsEmpty() const {
+    return (full_head_.load(std::memory_order_relaxed) & kIndexMask) == 0;
+  }
+
+  // Number of references in the published chunks. Only precise when no other
+  // thread is pushing or stealing chunks.
+  size_t Size() const {
+    return size_.load(std::memory_order_relaxed);
+  }
+
+  // Drops all the chunks and releases their memory. Must not race with any
+  // other operation.
+  void Reset() {
+    MutexLock mu(Thread::Current(), lock_);
+    for (MemMap& slab : slabs_) {
+      slab.MadviseDontNeedAndZero();
+    }
+    full_head_.store(0, std::memory_order_relaxed);
+    free_head_.store(0, std::memory_order_relaxed);
+    size_.store(0, std::memory_order_relaxed);
+    num_chunks_ = 0;
+  }
+
+ private:
+  static constexpr size_t kChunkSize = kPageSize;
+  static_assert(sizeof(Chunk) <= kChunkSize, "Chunk does not fit in a page");
+  // Slabs are 1MB with 4KB pages.
+  static constexpr size_t kChunksPerSlab = 256;
+  // Enough for 256M references with 4KB pages.
+  static constexpr size_t kMaxSlabs = 1024;
+  // A list head holds the index plus one of the first chunk in the low half and
+  // a tag, bumped on every update, in the high half.
+  static constexpr uint64_t kIndexMask = 0xFFFFFFFFu;
+  static constexpr uint64_t kTagIncrement = kIndexMask + 1;
+
+  explicit ChunkedStack(const std::string& name)
+      : name_(name),
+        lock_("chunked stack lock", kGenericBottomLock),
+        num_chunks_(0),
+        full_head_(0),
+        free_head_(0),
+        size_(0) {
+    for (Atomic<Chunk*>& slab_begin : slab_begins_) {
+      slab_begin.store(nullptr, std::memory_order_relaxed);
+    }
+  }
+
+  Chunk* ChunkAt(uint32_t index) const {
+    Chunk* slab_begin = slab_begins_[index / kChunksPerSlab].load(std::memory_order_acquire);
+    DCHECK(slab_begin != nullptr);
+    return reinterpret_cast<Chunk*>(
+        reinterpret_cast<uint8_t*>(slab_begin) + (index % kChunksPerSlab) * kChunkSize);
+  }
+
+  void PushList(Atomic<uint64_t>* head, Chunk* chunk) {
+    uint64_t old_head = head->load(std::memory_order_relaxed);
+    uint64_t new_head;
+    do {
+      chunk->next_.store(old_head & kIndexMask, std::memory_order_relaxed);
+      new_head = ((old_head & ~kIndexMask) + kTagIncrement) | (chunk->index_ + 1);
+      // Release so that the contents of the chunk are visible to whoever pops it.
+    } while (!head->compare_exchange_weak(old_head, new_head, std::memory_order_release));
+  }
+
+  Chunk* PopList(Atomic<uint64_t>* head) {
+    uint64_t old_head = head->load(std::memory_order_acquire);
+    Chunk* chunk;
+    uint64_t new_head;
+    do {
+      uint32_t index = old_head & kIndexMask;
+      if (index == 0) {
+        return nullptr;
+      }
+      chunk = ChunkAt(index - 1);
+      // The chunk may have been popped and reused by another thread since we
+      // read the head, in which case the tag makes the exchange below fail.
+      new_head = ((old_head & ~kIndexMask) + kTagIncrement) |
+                 chunk->next_.load(std::memory_order_relaxed);
+    } while (!head->compare_exchange_weak(old_head, new_head, std::memory_order_acquire));
+    return chunk;
+  }
+
+  Chunk* AllocNewChunk() {
+    MutexLock mu(Thread::Current(), lock_);
+    uint32_t index = num_chunks_++;
+    size_t slab = index / kChunksPerSlab;
+    CHECK_LT(slab, kMaxSlabs) << "Chunked stack " << name_ << " overflowed";
+    if (slab == slabs_.size()) {
+      std::string error_msg;
+      MemMap mem_map = MemMap::MapAnonymous(name_.c_str(),
+                                            kChunksPerSlab * kChunkSize,
+                                            PROT_READ | PROT_WRITE,
+                                            /*low_4gb=*/ false,
+                                            &error_msg);
+      CHECK(mem_map.IsValid()) << "couldn't allocate chunked stack slab.\n" << error_msg;
+      slab_begins_[slab].store(reinterpret_cast<Chunk*>(mem_map.Begin()),
+                               std::memory_order_release);
+      slabs_.push_back(std::move(mem_map));
+    }
+    Chunk* chunk = ChunkAt(index);
+    chunk->index_ = index;
+    return chunk;
+  }
+
+  // Name of the stack, also used for the slabs.
+  const std::string name_;
+  // Guards the mapping of new slabs.
+  Mutex lock_;
+  std::vector<MemMap> slabs_ GUARDED_BY(lock_);
+  // Number of chunks ever handed out of the slabs since the last reset.
+  uint32_t num_chunks_ GUARDED_BY(lock_);
+  // Start of each slab, for the lock-free lookup of chunks by index.
+  Atomic<Chunk*> slab_begins_[kMaxSlabs];
+  // Heads of the lists of published and of free chunks.
+  Atomic<uint64_t> full_head_;
+  Atomic<uint64_t> free_head_;
+  // Number of references in the published chunks.
+  Atomic<size_t> size_;
+
+  DISALLOW_COPY_AND_ASSIGN(ChunkedStack);
+};
+
+using ObjectChunkedStack = ChunkedStack<mirror::Object>;
+
+}  // namespace accounting
+}  // namespace gc
+}  // namespace art
+
+#endif  // ART_RUNTIME_GC_ACCOUNTING_CHUNKED_STACK_H_
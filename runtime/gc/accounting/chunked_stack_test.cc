@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "chunked_stack.h"
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "common_runtime_test.h"
+#include "scoped_thread_state_change-inl.h"
+
+namespace art {
+namespace gc {
+namespace accounting {
+
+class ChunkedStackTest : public CommonRuntimeTest {
+ protected:
+  // The stacks never dereference the references, so any aligned value will do.
+  static mirror::Object* FakeObject(size_t i) {
+    return reinterpret_cast<mirror::Object*>((i + 1) * kObjectAlignment);
+  }
+  static size_t FakeObjectIndex(mirror::Object* obj) {
+    return reinterpret_cast<uintptr_t>(obj) / kObjectAlignment - 1;
+  }
+};
+
+TEST_F(ChunkedStackTest, SpillAndRefill) {
+  ScopedObjectAccess soa(Thread::Current());
+  constexpr size_t kCapacity = 4 * KB;
+  std::unique_ptr<ObjectStack> stack(ObjectStack::Create("test stack", kCapacity, kCapacity));
+  std::unique_ptr<ObjectChunkedStack> chunks(ObjectChunkedStack::Create("test chunks"));
+  EXPECT_TRUE(chunks->IsEmpty());
+  for (size_t i = 0; i < kCapacity; ++i) {
+    stack->PushBack(FakeObject(i));
+  }
+  ASSERT_TRUE(stack->IsFull());
+  chunks->SpillFrom(stack.get(), kCapacity / 2);
+  EXPECT_EQ(stack->Size(), kCapacity / 2);
+  EXPECT_EQ(chunks->Size(), kCapacity / 2);
+  EXPECT_FALSE(chunks->IsEmpty());
+  // Spill the rest too, then take everything back.
+  chunks->SpillFrom(stack.get(), kCapacity / 2);
+  EXPECT_TRUE(stack->IsEmpty());
+  std::vector<bool> seen(kCapacity, false);
+  while (!stack->IsEmpty() || chunks->RefillInto(stack.get())) {
+    size_t index = FakeObjectIndex(stack->PopBack());
+    ASSERT_LT(index, kCapacity);
+    EXPECT_FALSE(seen[index]);
+    seen[index] = true;
+  }
+  EXPECT_TRUE(chunks->IsEmpty());
+  EXPECT_EQ(chunks->Size(), 0u);
+  EXPECT_EQ(std::count(seen.begin(), seen.end(), true), static_cast<ptrdiff_t>(kCapacity));
+  // The stack can be used again after a reset.
+  chunks->Reset();
+  ObjectChunkedStack::Chunk* chunk = chunks->AllocChunk();
+  EXPECT_TRUE(chunk->IsEmpty());
+  chunk->PushBack(FakeObject(0));
+  chunks->PushChunk(chunk);
+  EXPECT_EQ(chunks->StealChunk(), chunk);
+  EXPECT_EQ(chunk->PopBack(), FakeObject(0));
+  chunks->FreeChunk(chunk);
+  EXPECT_EQ(chunks->StealChunk(), nullptr);
+}
+
+// Several threads publish chunks and steal each other's concurrently. Every
+// reference must come out exactly once.
+TEST_F(ChunkedStackTest, ConcurrentPushAndSteal) {
+  constexpr size_t kNumThreads = 4;
+  constexpr size_t kChunksPerThread = 2000;
+  constexpr size_t kRefsPerChunk = 16;
+  std::unique_ptr<ObjectChunkedStack> chunks(ObjectChunkedStack::Create("test chunks"));
+  std::vector<std::vector<size_t>> stolen(kNumThreads);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < kNumThreads; ++t) {
+    // The threads aren't attached to the runtime, and don't need the mutator
+    // lock as the references are never dereferenced.
+    threads.emplace_back([&, t]() NO_THREAD_SAFETY_ANALYSIS {
+      for (size_t i = 0; i < kChunksPerThread; ++i) {
+        ObjectChunkedStack::Chunk* chunk = chunks->AllocChunk();
+        for (size_t j = 0; j < kRefsPerChunk; ++j) {
+          chunk->PushBack(FakeObject((t * kChunksPerThread + i) * kRefsPerChunk + j));
+        }
+        chunks->PushChunk(chunk);
+        // Steal every other time so that the list both grows and shrinks.
+        if (i % 2 == 1) {
+          chunk = chunks->StealChunk();
+          ASSERT_TRUE(chunk != nullptr);
+          while (!chunk->IsEmpty()) {
+            stolen[t].push_back(FakeObjectIndex(chunk->PopBack()));
+          }
+          chunks->FreeChunk(chunk);
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  ScopedObjectAccess soa(Thread::Current());
+  constexpr size_t kTotalRefs = kNumThreads * kChunksPerThread * kRefsPerChunk;
+  EXPECT_EQ(chunks->Size(), kTotalRefs / 2);
+  std::vector<bool> seen(kTotalRefs, false);
+  for (ObjectChunkedStack::Chunk* chunk = chunks->StealChunk();
+       chunk != nullptr;
+       chunk = chunks->StealChunk()) {
+    while (!chunk->IsEmpty()) {
+      stolen[0].push_back(FakeObjectIndex(chunk->PopBack()));
+    }
+    chunks->FreeChunk(chunk);
+  }
+  for (const std::vector<size_t>& indices : stolen) {
+    for (size_t index : indices) {
+      ASSERT_LT(index, kTotalRefs);
+      EXPECT_FALSE(seen[index]) << index;
+      seen[index] = true;
+    }
+  }
+  EXPECT_EQ(std::count(seen.begin(), seen.end(), true), static_cast<ptrdiff_t>(kTotalRefs));
+  EXPECT_TRUE(chunks->IsEmpty());
+}
+
+}  // namespace accounting
+}  // namespace gc
+}  // namespace art
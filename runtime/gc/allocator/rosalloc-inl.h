@@ -62,7 +62,7 @@ inline bool RosAlloc::CanAllocFromThreadLocalRun(Thread* self, size_t size) {
   }
   size_t bracket_size;
   size_t idx = SizeToIndexAndBracketSize(size, &bracket_size);
-  DCHECK_LT(idx, kNumThreadLocalSizeBrackets);
+  DCHECK_LT(idx, kNumThreadLocalRunSizeBrackets);
   Run* thread_local_run = reinterpret_cast<Run*>(self->GetRosAllocRun(idx));
   if (kIsDebugBuild) {
     // Need the lock to prevent race conditions.
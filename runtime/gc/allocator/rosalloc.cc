@@ -558,7 +558,8 @@ RosAlloc::Run* RosAlloc::AllocRun(Thread* self, size_t idx) {
     new_run->size_bracket_idx_ = idx;
     DCHECK(!new_run->IsThreadLocal());
     DCHECK(!new_run->to_be_bulk_freed_);
-    if (kUsePrefetchDuringAllocRun && idx < kNumThreadLocalSizeBrackets) {
+    DCHECK(new_run->IsRemoteFreeListClosed());
+    if (kUsePrefetchDuringAllocRun && idx < kNumThreadLocalRunSizeBrackets) {
       // Take ownership of the cache lines if we are likely to be thread local run.
       if (kPrefetchNewRunDataByZeroing) {
         // Zeroing the data is sometimes faster than prefetching but it increases memory usage
@@ -660,7 +661,7 @@ void* RosAlloc::AllocFromRun(Thread* self, size_t size, size_t* bytes_allocated,
   size_t bracket_size;
   size_t idx = SizeToIndexAndBracketSize(size, &bracket_size);
   void* slot_addr;
-  if (LIKELY(idx < kNumThreadLocalSizeBrackets)) {
+  if (LIKELY(idx < kNumThreadLocalRunSizeBrackets)) {
     // Use a thread-local run.
     Run* thread_local_run = reinterpret_cast<Run*>(self->GetRosAllocRun(idx));
     // Allow invalid since this will always fail the allocation.
@@ -681,12 +682,17 @@ void* RosAlloc::AllocFromRun(Thread* self, size_t size, size_t* bytes_allocated,
       DCHECK(thread_local_run->IsFull());
       MutexLock mu(self, *size_bracket_locks_[idx]);
       bool is_all_free_after_merge;
-      // This is safe to do for the dedicated_full_run_ since the bitmaps are empty.
+      // Take the slots that BulkFree() pushed without the lock, and stop it from pushing more
+      // while we decide whether to keep the run.
+      // These are safe to do for the dedicated_full_run_ since the lists are empty and the remote
+      // free list is closed.
+      thread_local_run->MergeRemoteFreeListToThreadLocalFreeList(/* close= */ true);
       if (thread_local_run->MergeThreadLocalFreeListToFreeList(&is_all_free_after_merge)) {
         DCHECK_NE(thread_local_run, dedicated_full_run_);
         // Some slot got freed. Keep it.
         DCHECK(!thread_local_run->IsFull());
         DCHECK_EQ(is_all_free_after_merge, thread_local_run->IsAllFree());
+        thread_local_run->OpenRemoteFreeList();
       } else {
         // No slots got freed. Try to refill the thread-local run.
         DCHECK(thread_local_run->IsFull());
@@ -712,6 +718,7 @@ void* RosAlloc::AllocFromRun(Thread* self, size_t size, size_t* bytes_allocated,
         DCHECK(non_full_runs_[idx].find(thread_local_run) == non_full_runs_[idx].end());
         DCHECK(full_runs_[idx].find(thread_local_run) == full_runs_[idx].end());
         thread_local_run->SetIsThreadLocal(true);
+        thread_local_run->OpenRemoteFreeList();
         self->SetRosAllocRun(idx, thread_local_run);
         DCHECK(!thread_local_run->IsFull());
       }
@@ -772,7 +779,7 @@ size_t RosAlloc::FreeFromRun(Thread* self, void* ptr, Run* run) {
   }
   if (LIKELY(run->IsThreadLocal())) {
     // It's a thread-local run. Just mark the thread-local free bit map and return.
-    DCHECK_LT(run->size_bracket_idx_, kNumThreadLocalSizeBrackets);
+    DCHECK_LT(run->size_bracket_idx_, kNumThreadLocalRunSizeBrackets);
     DCHECK(non_full_runs_[idx].find(run) == non_full_runs_[idx].end());
     DCHECK(full_runs_[idx].find(run) == full_runs_[idx].end());
     run->AddToThreadLocalFreeList(ptr);
@@ -864,6 +871,7 @@ std::string RosAlloc::Run::Dump() {
          << " size_bracket_idx=" << idx
          << " is_thread_local=" << static_cast<int>(is_thread_local_)
          << " to_be_bulk_freed=" << static_cast<int>(to_be_bulk_freed_)
+         << " remote_free_list=" << remote_free_list_.load(std::memory_order_relaxed)
          << " free_list=" << FreeListToStr(&free_list_)
          << " bulk_free_list=" << FreeListToStr(&bulk_free_list_)
          << " thread_local_list=" << FreeListToStr(&thread_local_free_list_)
@@ -913,6 +921,47 @@ inline void RosAlloc::Run::MergeBulkFreeListToThreadLocalFreeList() {
   thread_local_free_list_.Merge(&bulk_free_list_);
 }
 
+inline bool RosAlloc::Run::PushBulkFreeListToRemoteFreeList() {
+  DCHECK(!IsBulkFreeListEmpty());
+  Slot* head = bulk_free_list_.Head();
+  Slot* tail = bulk_free_list_.Tail();
+  const uint32_t new_value =
+      reinterpret_cast<uintptr_t>(head) - reinterpret_cast<uintptr_t>(this);
+  DCHECK_GT(new_value, kRemoteFreeListEmpty);
+  uint32_t old_value = remote_free_list_.load(std::memory_order_relaxed);
+  do {
+    if (old_value == kRemoteFreeListClosed) {
+      // The run is no longer (or not yet) thread-local. Undo the link so that the caller can merge
+      // the bulk free list under the lock.
+      tail->Clear();
+      return false;
+    }
+    tail->SetNext(RemoteFreeListHead(old_value));
+    // Release so that the owner sees the zeroed slots.
+  } while (!remote_free_list_.compare_exchange_weak(old_value,
+                                                    new_value,
+                                                    std::memory_order_release,
+                                                    std::memory_order_relaxed));
+  bulk_free_list_.Reset();
+  return true;
+}
+
+inline void RosAlloc::Run::MergeRemoteFreeListToThreadLocalFreeList(bool close) {
+  if (IsRemoteFreeListClosed()) {
+    // Nothing to merge, and avoid writing to the shared dedicated_full_run_.
+    return;
+  }
+  DCHECK(IsThreadLocal());
+  uint32_t old_value = remote_free_list_.exchange(
+      close ? kRemoteFreeListClosed : kRemoteFreeListEmpty, std::memory_order_acquire);
+  for (Slot* slot = RemoteFreeListHead(old_value); slot != nullptr; ) {
+    Slot* next_slot = slot->Next();
+    slot->Clear();
+    thread_local_free_list_.Add(slot);
+    slot = next_slot;
+  }
+}
+
 inline void RosAlloc::Run::AddToThreadLocalFreeList(void* ptr) {
   DCHECK(IsThreadLocal());
   AddToFreeListShared(ptr, &thread_local_free_list_, __FUNCTION__);
@@ -986,6 +1035,13 @@ void RosAlloc::Run::InspectAllSlots(void (*handler)(void* start, void* end, size
       DCHECK_LT(slot_idx, num_slots);
       is_free[slot_idx] = true;
     }
+    for (Slot* slot = RemoteFreeListHead(remote_free_list_.load(std::memory_order_acquire));
+         slot != nullptr;
+         slot = slot->Next()) {
+      size_t slot_idx = SlotIndex(slot);
+      DCHECK_LT(slot_idx, num_slots);
+      is_free[slot_idx] = true;
+    }
   }
   for (size_t slot_idx = 0; slot_idx < num_slots; ++slot_idx) {
     uint8_t* slot_addr = slot_base + slot_idx * bracket_size;
@@ -1104,9 +1160,19 @@ size_t RosAlloc::BulkFree(Thread* self, void** ptrs, size_t num_ptrs) {
     run->to_be_bulk_freed_ = false;
 #endif
     size_t idx = run->size_bracket_idx_;
+    // For a thread-local run, hand the slots to the owner thread without taking the lock, which
+    // the owner may be holding to refill another run. This fails if the run stopped being
+    // thread-local, in which case we go through the lock as for any other run.
+    if (run->PushBulkFreeListToRemoteFreeList()) {
+      if (kTraceRosAlloc) {
+        LOG(INFO) << "RosAlloc::BulkFree() : Pushed slot(s) to a thread local run 0x"
+                  << std::hex << reinterpret_cast<intptr_t>(run);
+      }
+      continue;
+    }
     MutexLock brackets_mu(self, *size_bracket_locks_[idx]);
     if (run->IsThreadLocal()) {
-      DCHECK_LT(run->size_bracket_idx_, kNumThreadLocalSizeBrackets);
+      DCHECK_LT(run->size_bracket_idx_, kNumThreadLocalRunSizeBrackets);
       DCHECK(non_full_runs_[idx].find(run) == non_full_runs_[idx].end());
       DCHECK(full_runs_[idx].find(run) == full_runs_[idx].end());
       run->MergeBulkFreeListToThreadLocalFreeList();
@@ -1508,7 +1574,7 @@ void RosAlloc::SetFootprintLimit(size_t new_capacity) {
 size_t RosAlloc::RevokeThreadLocalRuns(Thread* thread) {
   Thread* self = Thread::Current();
   size_t free_bytes = 0U;
-  for (size_t idx = 0; idx < kNumThreadLocalSizeBrackets; idx++) {
+  for (size_t idx = 0; idx < kNumThreadLocalRunSizeBrackets; idx++) {
     MutexLock mu(self, *size_bracket_locks_[idx]);
     Run* thread_local_run = reinterpret_cast<Run*>(thread->GetRosAllocRun(idx));
     CHECK(thread_local_run != nullptr);
@@ -1529,6 +1595,9 @@ size_t RosAlloc::RevokeThreadLocalRuns(Thread* thread) {
       // case the free list wll be updated. If thread local run is false, GC thread will help
       // merge bulk free list in next BulkFree.
       // Thus no need to merge bulk free list to free list again here.
+      // The slots pushed to the remote free list by BulkFree without the lock are already counted
+      // as freed. Closing the list makes later bulk frees take the lock.
+      thread_local_run->MergeRemoteFreeListToThreadLocalFreeList(/* close= */ true);
       bool dont_care;
       thread_local_run->MergeThreadLocalFreeListToFreeList(&dont_care);
       thread_local_run->SetIsThreadLocal(false);
@@ -1571,7 +1640,7 @@ void RosAlloc::RevokeRun(Thread* self, size_t idx, Run* run) {
 void RosAlloc::RevokeThreadUnsafeCurrentRuns() {
   // Revoke the current runs which share the same idx as thread local runs.
   Thread* self = Thread::Current();
-  for (size_t idx = 0; idx < kNumThreadLocalSizeBrackets; ++idx) {
+  for (size_t idx = 0; idx < kNumThreadLocalRunSizeBrackets; ++idx) {
     MutexLock mu(self, *size_bracket_locks_[idx]);
     if (current_runs_[idx] != dedicated_full_run_) {
       RevokeRun(self, idx, current_runs_[idx]);
@@ -1599,7 +1668,7 @@ void RosAlloc::AssertThreadLocalRunsAreRevoked(Thread* thread) {
     Thread* self = Thread::Current();
     // Avoid race conditions on the bulk free bit maps with BulkFree() (GC).
     ReaderMutexLock wmu(self, bulk_free_lock_);
-    for (size_t idx = 0; idx < kNumThreadLocalSizeBrackets; idx++) {
+    for (size_t idx = 0; idx < kNumThreadLocalRunSizeBrackets; idx++) {
       MutexLock mu(self, *size_bracket_locks_[idx]);
       Run* thread_local_run = reinterpret_cast<Run*>(thread->GetRosAllocRun(idx));
       DCHECK(thread_local_run == nullptr || thread_local_run == dedicated_full_run_);
@@ -1616,7 +1685,7 @@ void RosAlloc::AssertAllThreadLocalRunsAreRevoked() {
     for (Thread* t : thread_list) {
       AssertThreadLocalRunsAreRevoked(t);
     }
-    for (size_t idx = 0; idx < kNumThreadLocalSizeBrackets; ++idx) {
+    for (size_t idx = 0; idx < kNumThreadLocalRunSizeBrackets; ++idx) {
       MutexLock brackets_mu(self, *size_bracket_locks_[idx]);
       CHECK_EQ(current_runs_[idx], dedicated_full_run_);
     }
@@ -1717,6 +1786,7 @@ void RosAlloc::Initialize() {
   DCHECK_LE(sizeof(Slot), bracketSizes[0]) << "sizeof(Slot) <= the smallest bracket size";
   // Check the invariants between the max bracket sizes and the number of brackets.
   DCHECK_EQ(kMaxThreadLocalBracketSize, bracketSizes[kNumThreadLocalSizeBrackets - 1]);
+  DCHECK_EQ(kMaxThreadLocalRunBracketSize, bracketSizes[kNumThreadLocalRunSizeBrackets - 1]);
   DCHECK_EQ(kMaxRegularBracketSize, bracketSizes[kNumRegularSizeBrackets - 1]);
 }
 
@@ -1842,7 +1912,7 @@ void RosAlloc::Verify() {
   }
   std::list<Thread*> threads = Runtime::Current()->GetThreadList()->GetList();
   for (Thread* thread : threads) {
-    for (size_t i = 0; i < kNumThreadLocalSizeBrackets; ++i) {
+    for (size_t i = 0; i < kNumThreadLocalRunSizeBrackets; ++i) {
       MutexLock brackets_mu(self, *size_bracket_locks_[i]);
       Run* thread_local_run = reinterpret_cast<Run*>(thread->GetRosAllocRun(i));
       CHECK(thread_local_run != nullptr);
@@ -1886,7 +1956,7 @@ void RosAlloc::Run::Verify(Thread* self, RosAlloc* rosalloc, bool running_on_mem
     std::list<Thread*> thread_list = Runtime::Current()->GetThreadList()->GetList();
     for (auto it = thread_list.begin(); it != thread_list.end(); ++it) {
       Thread* thread = *it;
-      for (size_t i = 0; i < kNumThreadLocalSizeBrackets; i++) {
+      for (size_t i = 0; i < kNumThreadLocalRunSizeBrackets; i++) {
         MutexLock mu(self, *rosalloc->size_bracket_locks_[i]);
         Run* thread_local_run = reinterpret_cast<Run*>(thread->GetRosAllocRun(i));
         if (thread_local_run == this) {
@@ -1904,6 +1974,8 @@ void RosAlloc::Run::Verify(Thread* self, RosAlloc* rosalloc, bool running_on_mem
     CHECK(IsThreadLocalFreeListEmpty())
         << "A non-thread-local run's thread local free list isn't empty "
         << Dump();
+    CHECK(IsRemoteFreeListClosed())
+        << "A non-thread-local run's remote free list isn't closed " << Dump();
     // Check if it's a current run for the size bracket.
     bool is_current_run = false;
     for (size_t i = 0; i < kNumOfSizeBrackets; i++) {
@@ -1959,6 +2031,13 @@ void RosAlloc::Run::Verify(Thread* self, RosAlloc* rosalloc, bool running_on_mem
       DCHECK_LT(slot_idx, num_slots);
       is_free[slot_idx] = true;
     }
+    for (Slot* slot = RemoteFreeListHead(remote_free_list_.load(std::memory_order_acquire));
+         slot != nullptr;
+         slot = slot->Next()) {
+      size_t slot_idx = SlotIndex(slot);
+      DCHECK_LT(slot_idx, num_slots);
+      is_free[slot_idx] = true;
+    }
   }
   for (size_t slot_idx = 0; slot_idx < num_slots; ++slot_idx) {
     uint8_t* slot_addr = slot_base + slot_idx * bracket_size;
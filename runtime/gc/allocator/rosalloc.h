@@ -29,6 +29,7 @@
 #include <android-base/logging.h>
 
 #include "base/allocator.h"
+#include "base/atomic.h"
 #include "base/bit_utils.h"
 #include "base/mem_map.h"
 #include "base/mutex.h"
@@ -320,6 +321,8 @@ class RosAlloc {
   // +-------------------+
   // | to_be_bulk_freed  |
   // +-------------------+
+  // | remote free list  |
+  // +-------------------+
   // |                   |
   // | free list         |
   // |                   |
@@ -354,7 +357,12 @@ class RosAlloc {
     uint8_t is_thread_local_;           // True if this run is used as a thread-local run.
     bool to_be_bulk_freed_;             // Used within BulkFree() to flag a run that's involved with
                                         // a bulk free.
-    uint32_t padding_ ATTRIBUTE_UNUSED;
+    // The slots that BulkFree() freed into a thread-local run without taking the size bracket lock.
+    // Holds kRemoteFreeListClosed, kRemoteFreeListEmpty, or the offset from the run of the first
+    // slot of the list. It is 32 bits so that it fits in what used to be padding, keeping the
+    // header size unchanged. The list is closed, and BulkFree() takes the lock, whenever the run
+    // isn't thread-local.
+    Atomic<uint32_t> remote_free_list_;
     // Use a tailless free list for free_list_ so that the alloc fast path does not manage the tail.
     SlotFreeList<false> free_list_;
     SlotFreeList<true> bulk_free_list_;
@@ -418,6 +426,22 @@ class RosAlloc {
     // can write without a lock, and later acquire a lock once per run to merge the bulk free list
     // to the thread-local free list.
     void MergeBulkFreeListToThreadLocalFreeList();
+    // Push the bulk free list to the remote free list without a lock. Used in a bulk free instead
+    // of MergeBulkFreeListToThreadLocalFreeList(). Returns false, leaving the bulk free list as is,
+    // if the remote free list is closed.
+    bool PushBulkFreeListToRemoteFreeList();
+    // Merge the remote free list to the thread local free list, and close the remote free list if
+    // `close`. Requires the size bracket lock.
+    void MergeRemoteFreeListToThreadLocalFreeList(bool close);
+    // Open the remote free list of a run that just became thread-local.
+    void OpenRemoteFreeList() {
+      DCHECK(IsThreadLocal());
+      DCHECK_EQ(remote_free_list_.load(std::memory_order_relaxed), kRemoteFreeListClosed);
+      remote_free_list_.store(kRemoteFreeListEmpty, std::memory_order_relaxed);
+    }
+    bool IsRemoteFreeListClosed() const {
+      return remote_free_list_.load(std::memory_order_relaxed) == kRemoteFreeListClosed;
+    }
     // Allocates a slot in a run.
     ALWAYS_INLINE void* AllocSlot();
     // Frees a slot in a run. This is used in a non-bulk free.
@@ -458,6 +482,17 @@ class RosAlloc {
         REQUIRES(Locks::thread_list_lock_);
 
    private:
+    // Values of remote_free_list_ other than slot offsets. A zeroed header has a closed list.
+    static constexpr uint32_t kRemoteFreeListClosed = 0;
+    static constexpr uint32_t kRemoteFreeListEmpty = 1;
+
+    // Returns the first slot of the remote free list given the value of remote_free_list_.
+    Slot* RemoteFreeListHead(uint32_t value) const {
+      if (value == kRemoteFreeListClosed || value == kRemoteFreeListEmpty) {
+        return nullptr;
+      }
+      return reinterpret_cast<Slot*>(reinterpret_cast<uintptr_t>(this) + value);
+    }
     // The common part of AddToBulkFreeList() and AddToThreadLocalFreeList(). Returns the bracket
     // size.
     size_t AddToFreeListShared(void* ptr, SlotFreeList<true>* free_list, const char* caller_name);
@@ -538,9 +573,9 @@ class RosAlloc {
   }
   // Returns true if the given allocation size is for a thread local allocation.
   static bool IsSizeForThreadLocal(size_t size) {
-    bool is_size_for_thread_local = size <= kMaxThreadLocalBracketSize;
+    bool is_size_for_thread_local = size <= kMaxThreadLocalRunBracketSize;
     DCHECK(size > kLargeSizeThreshold ||
-           (is_size_for_thread_local == (SizeToIndex(size) < kNumThreadLocalSizeBrackets)));
+           (is_size_for_thread_local == (SizeToIndex(size) < kNumThreadLocalRunSizeBrackets)));
     return is_size_for_thread_local;
   }
   // Rounds up the size up the nearest bracket size.
@@ -659,15 +694,11 @@ class RosAlloc {
   // The default value for page_release_size_threshold_.
   static constexpr size_t kDefaultPageReleaseSizeThreshold = 4 * MB;
 
-  // We use thread-local runs for the size brackets whose indexes
-  // are less than this index. We use shared (current) runs for the rest.
-  // Sync this with the length of Thread::rosalloc_runs_.
+  // The size brackets whose indexes are less than this index have an 8-byte increment, and are the
+  // ones the compiled code allocates from thread-local runs without calling into the runtime.
   static constexpr size_t kNumThreadLocalSizeBrackets = 16;
-  static_assert(kNumThreadLocalSizeBrackets == kNumRosAllocThreadLocalSizeBracketsInThread,
-                "Mismatch between kNumThreadLocalSizeBrackets and "
-                "kNumRosAllocThreadLocalSizeBracketsInThread");
 
-  // The size of the largest bracket we use thread-local runs for.
+  // The size of the largest bracket with an 8-byte increment.
   // This should be equal to bracketSizes[kNumThreadLocalSizeBrackets - 1].
   static constexpr size_t kMaxThreadLocalBracketSize = 128;
 
@@ -679,6 +710,20 @@ class RosAlloc {
   // 1 KB and the 2 KB brackets. This should be equal to bracketSizes[kNumRegularSizeBrackets - 1].
   static constexpr size_t kMaxRegularBracketSize = 512;
 
+  // We use thread-local runs for the size brackets whose indexes are less than this index, which
+  // are all the regular brackets. The medium ones, above kMaxThreadLocalBracketSize, are allocated
+  // from the runtime rather than the compiled code, but still without the size bracket lock. We
+  // use shared (current) runs for the 1 KB and 2 KB brackets, whose runs span several pages.
+  // Sync this with the length of Thread::rosalloc_runs_.
+  static constexpr size_t kNumThreadLocalRunSizeBrackets = kNumRegularSizeBrackets;
+  static_assert(kNumThreadLocalRunSizeBrackets == kNumRosAllocThreadLocalSizeBracketsInThread,
+                "Mismatch between kNumThreadLocalRunSizeBrackets and "
+                "kNumRosAllocThreadLocalSizeBracketsInThread");
+
+  // The size of the largest bracket we use thread-local runs for.
+  // This should be equal to bracketSizes[kNumThreadLocalRunSizeBrackets - 1].
+  static constexpr size_t kMaxThreadLocalRunBracketSize = kMaxRegularBracketSize;
+
   // The bracket size increment for the thread-local brackets (<= kMaxThreadLocalBracketSize bytes).
   static constexpr size_t kThreadLocalBracketQuantumSize = 8;
 
@@ -100,7 +100,7 @@ inline mirror::Object* ConcurrentCopying::MarkImmuneSpace(Thread* const self,
     // true). Also, a mutator doesn't (need to) gray an immune object after GC has updated all
     // immune space objects (when updated_all_immune_objects_ is true).
     if (kIsDebugBuild) {
-      if (self == thread_running_gc_) {
+      if (self == thread_running_gc_ || IsParallelCopyingWorker(self)) {
         DCHECK(!kGrayImmuneObject ||
                updated_all_immune_objects_.load(std::memory_order_relaxed) ||
                gc_grays_immune_objects_);
@@ -136,7 +136,7 @@ inline mirror::Object* ConcurrentCopying::Mark(Thread* const self,
   DCHECK(heap_->collector_type_ == kCollectorTypeCC);
   if (kFromGCThread) {
     DCHECK(is_active_);
-    DCHECK_EQ(self, thread_running_gc_);
+    DCHECK(self == thread_running_gc_ || IsParallelCopyingWorker(self));
   } else if (UNLIKELY(kUseBakerReadBarrier && !is_active_)) {
     // In the lock word forward address state, the read barrier bits
     // in the lock word are part of the stored forwarding address and
@@ -162,7 +162,11 @@ inline mirror::Object* ConcurrentCopying::Mark(Thread* const self,
         mirror::Object* to_ref = GetFwdPtr(from_ref);
         if (to_ref == nullptr) {
           // It isn't marked yet. Mark it by copying it to the to-space.
-          to_ref = Copy(self, from_ref, holder, offset);
+          to_ref = Copy(self,
+                        from_ref,
+                        holder,
+                        offset,
+                        /*from_gc_worker=*/ kFromGCThread && self != thread_running_gc_);
         }
         // The copy should either be in a to-space region, or in the
         // non-moving space, if it could not fit in a to-space region.
@@ -27,6 +27,7 @@
 #include "class_root-inl.h"
 #include "debugger.h"
 #include "gc/accounting/atomic_stack.h"
+#include "gc/accounting/chunked_stack.h"
 #include "gc/accounting/heap_bitmap-inl.h"
 #include "gc/accounting/mod_union_table-inl.h"
 #include "gc/accounting/read_barrier_table.h"
@@ -35,6 +36,7 @@
 #include "gc/reference_processor.h"
 #include "gc/space/image_space.h"
 #include "gc/space/space-inl.h"
+#include "gc/survival_stats.h"
 #include "gc/verification.h"
 #include "image-inl.h"
 #include "intern_table.h"
@@ -45,6 +47,7 @@
 #include "scoped_thread_state_change-inl.h"
 #include "thread-inl.h"
 #include "thread_list.h"
+#include "thread_pool.h"
 #include "well_known_classes.h"
 
 namespace art {
@@ -62,6 +65,9 @@ static constexpr bool kDisallowReadBarrierDuringScan = kIsDebugBuild;
 // Slow path mark stack size, increase this if the stack is getting full and it is causing
 // performance problems.
 static constexpr size_t kReadBarrierMarkStackSize = 512 * KB;
+// Minimum number of references on the mark stacks to wake up the heap thread
+// pool for. Smaller amounts are processed by the GC thread alone.
+static constexpr size_t kMinimumParallelCopyingRefs = 1024;
 // Size (in the number of objects) of the sweep array free buffer.
 static constexpr size_t kSweepArrayChunkFreeSize = 1024;
 // Verify that there are no missing card marks.
@@ -80,6 +86,8 @@ ConcurrentCopying::ConcurrentCopying(Heap* heap,
       gc_mark_stack_(accounting::ObjectStack::Create("concurrent copying gc mark stack",
                                                      kDefaultGcMarkStackSize,
                                                      kDefaultGcMarkStackSize)),
+      gc_mark_stack_chunks_(accounting::ObjectChunkedStack::Create(
+          "concurrent copying gc mark stack chunks")),
       use_generational_cc_(use_generational_cc),
       young_gen_(young_gen),
       rb_mark_bit_stack_(accounting::ObjectStack::Create("rb copying gc mark stack",
@@ -88,6 +96,7 @@ ConcurrentCopying::ConcurrentCopying(Heap* heap,
       rb_mark_bit_stack_full_(false),
       mark_stack_lock_("concurrent copying mark stack lock", kMarkSweepMarkStackLock),
       thread_running_gc_(nullptr),
+      parallel_copying_(false),
       is_marking_(false),
       is_using_read_barrier_entrypoints_(false),
       is_active_(false),
@@ -102,8 +111,10 @@ ConcurrentCopying::ConcurrentCopying(Heap* heap,
       copied_live_bytes_ratio_sum_(0.f),
       gc_count_(0),
       reclaimed_bytes_ratio_sum_(0.f),
+      parallel_bytes_scanned_(0),
       cumulative_bytes_moved_(0),
       cumulative_objects_moved_(0),
+      survival_stats_(nullptr),
       skipped_blocks_lock_("concurrent copying bytes blocks lock", kMarkSweepMarkStackLock),
       measure_read_barrier_slow_path_(measure_read_barrier_slow_path),
       mark_from_read_barrier_measurements_(false),
@@ -225,6 +236,24 @@ void ConcurrentCopying::RunPhases() {
   Thread* self = Thread::Current();
   thread_running_gc_ = self;
   Locks::mutator_lock_->AssertNotHeld(self);
+  // The heap thread pool is used for parallel copying. Create it before taking
+  // the mutator lock as the workers can't attach while it is held. It is only
+  // needed when concurrent GC threads are requested.
+  Runtime* runtime = Runtime::Current();
+  if (heap_->GetThreadPool() == nullptr && !runtime->IsZygote() &&
+      !runtime->IsShuttingDown(self) && heap_->GetConcGCThreadCount() > 1) {
+    heap_->CreateThreadPool();
+    heap_->WaitForWorkersToBeCreated();
+    if (region_space_->IsNumaAware()) {
+      // Spread the workers over the NUMA nodes so that they evacuate objects
+      // into regions local to the node they run on.
+      const std::vector<ThreadPoolWorker*>& workers = heap_->GetThreadPool()->GetWorkers();
+      for (size_t i = 0; i < workers.size(); ++i) {
+        region_space_->BindThreadToNumaNode(workers[i]->GetThread(),
+                                            i % region_space_->GetNumaNodeCount());
+      }
+    }
+  }
   {
     ReaderMutexLock mu(self, *Locks::mutator_lock_);
     InitializePhase();
@@ -427,6 +456,10 @@ void ConcurrentCopying::InitializePhase() {
   bytes_moved_gc_thread_ = 0;
   objects_moved_gc_thread_ = 0;
   bytes_scanned_ = 0;
+  survival_stats_ = heap_->GetSurvivalStats()->IsEnabled() ? heap_->GetSurvivalStats() : nullptr;
+  if (survival_stats_ != nullptr) {
+    survival_stats_->StartCollection(young_gen_);
+  }
   GcCause gc_cause = GetCurrentIteration()->GetGcCause();
 
   force_evacuate_all_ = false;
@@ -1281,7 +1314,7 @@ void ConcurrentCopying::PushOntoLocalMarkStack(mirror::Object* ref) {
   }
   DCHECK_EQ(mark_stack_mode_.load(std::memory_order_relaxed), kMarkStackModeThreadLocal);
   if (UNLIKELY(gc_mark_stack_->IsFull())) {
-    ExpandGcMarkStack();
+    SpillGcMarkStack();
   }
   gc_mark_stack_->PushBack(ref);
 }
@@ -1300,7 +1333,7 @@ void ConcurrentCopying::ProcessMarkStackForMarkingAndComputeLiveBytes() {
     CHECK_EQ(pooled_mark_stacks_.size(), kMarkStackPoolSize);
   }
 
-  while (!gc_mark_stack_->IsEmpty()) {
+  while (!gc_mark_stack_->IsEmpty() || RefillGcMarkStack()) {
     mirror::Object* ref = gc_mark_stack_->PopBack();
     AddLiveBytesAndScanRef(ref);
   }
@@ -1830,18 +1863,42 @@ void ConcurrentCopying::IssueEmptyCheckpoint() {
   Locks::mutator_lock_->SharedLock(self);
 }
 
-void ConcurrentCopying::ExpandGcMarkStack() {
+void ConcurrentCopying::SpillGcMarkStack() {
   DCHECK(gc_mark_stack_->IsFull());
-  const size_t new_size = gc_mark_stack_->Capacity() * 2;
-  std::vector<StackReference<mirror::Object>> temp(gc_mark_stack_->Begin(),
-                                                   gc_mark_stack_->End());
-  gc_mark_stack_->Resize(new_size);
-  for (auto& ref : temp) {
-    gc_mark_stack_->PushBack(ref.AsMirrorPtr());
-  }
+  gc_mark_stack_chunks_->SpillFrom(gc_mark_stack_.get(), gc_mark_stack_->Size() / 2);
   DCHECK(!gc_mark_stack_->IsFull());
 }
 
+bool ConcurrentCopying::RefillGcMarkStack() {
+  return gc_mark_stack_chunks_->RefillInto(gc_mark_stack_.get());
+}
+
+accounting::ObjectStack* ConcurrentCopying::GetPooledMarkStack() {
+  accounting::ObjectStack* mark_stack;
+  if (!pooled_mark_stacks_.empty()) {
+    // Use a pooled mark stack.
+    mark_stack = pooled_mark_stacks_.back();
+    pooled_mark_stacks_.pop_back();
+  } else {
+    // None pooled. Create a new one.
+    mark_stack = accounting::ObjectStack::Create("thread local mark stack", 4 * KB, 4 * KB);
+  }
+  DCHECK(mark_stack != nullptr);
+  DCHECK(mark_stack->IsEmpty());
+  return mark_stack;
+}
+
+void ConcurrentCopying::RecycleMarkStack(accounting::ObjectStack* mark_stack) {
+  if (pooled_mark_stacks_.size() >= kMarkStackPoolSize) {
+    // The pool has enough. Delete it.
+    delete mark_stack;
+  } else {
+    // Otherwise, put it into the pool for later reuse.
+    mark_stack->Reset();
+    pooled_mark_stacks_.push_back(mark_stack);
+  }
+}
+
 void ConcurrentCopying::PushOntoMarkStack(Thread* const self, mirror::Object* to_ref) {
   CHECK_EQ(is_mark_stack_push_disallowed_.load(std::memory_order_relaxed), 0)
       << " " << to_ref << " " << mirror::Object::PrettyTypeOf(to_ref);
@@ -1852,7 +1909,7 @@ void ConcurrentCopying::PushOntoMarkStack(Thread* const self, mirror::Object* to
       // If GC-running thread, use the GC mark stack instead of a thread-local mark stack.
       CHECK(self->GetThreadLocalMarkStack() == nullptr);
       if (UNLIKELY(gc_mark_stack_->IsFull())) {
-        ExpandGcMarkStack();
+        SpillGcMarkStack();
       }
       gc_mark_stack_->PushBack(to_ref);
     } else {
@@ -1861,19 +1918,7 @@ void ConcurrentCopying::PushOntoMarkStack(Thread* const self, mirror::Object* to
       if (UNLIKELY(tl_mark_stack == nullptr || tl_mark_stack->IsFull())) {
         MutexLock mu(self, mark_stack_lock_);
         // Get a new thread local mark stack.
-        accounting::AtomicStack<mirror::Object>* new_tl_mark_stack;
-        if (!pooled_mark_stacks_.empty()) {
-          // Use a pooled mark stack.
-          new_tl_mark_stack = pooled_mark_stacks_.back();
-          pooled_mark_stacks_.pop_back();
-        } else {
-          // None pooled. Create a new one.
-          new_tl_mark_stack =
-              accounting::AtomicStack<mirror::Object>::Create(
-                  "thread local mark stack", 4 * KB, 4 * KB);
-        }
-        DCHECK(new_tl_mark_stack != nullptr);
-        DCHECK(new_tl_mark_stack->IsEmpty());
+        accounting::AtomicStack<mirror::Object>* new_tl_mark_stack = GetPooledMarkStack();
         new_tl_mark_stack->PushBack(to_ref);
         self->SetThreadLocalMarkStack(new_tl_mark_stack);
         if (tl_mark_stack != nullptr) {
@@ -1888,7 +1933,7 @@ void ConcurrentCopying::PushOntoMarkStack(Thread* const self, mirror::Object* to
     // Access the shared GC mark stack with a lock.
     MutexLock mu(self, mark_stack_lock_);
     if (UNLIKELY(gc_mark_stack_->IsFull())) {
-      ExpandGcMarkStack();
+      SpillGcMarkStack();
     }
     gc_mark_stack_->PushBack(to_ref);
   } else {
@@ -1905,7 +1950,7 @@ void ConcurrentCopying::PushOntoMarkStack(Thread* const self, mirror::Object* to
         << " cc->is_marking=" << is_marking_;
     // Access the GC mark stack without a lock.
     if (UNLIKELY(gc_mark_stack_->IsFull())) {
-      ExpandGcMarkStack();
+      SpillGcMarkStack();
     }
     gc_mark_stack_->PushBack(to_ref);
   }
@@ -2152,13 +2197,18 @@ bool ConcurrentCopying::ProcessMarkStackOnce() {
   MarkStackMode mark_stack_mode = mark_stack_mode_.load(std::memory_order_relaxed);
   if (mark_stack_mode == kMarkStackModeThreadLocal) {
     // Process the thread-local mark stacks and the GC mark stack.
-    count += ProcessThreadLocalMarkStacks(/* disable_weak_ref_access= */ false,
-                                          /* checkpoint_callback= */ nullptr,
-                                          [this] (mirror::Object* ref)
-                                              REQUIRES_SHARED(Locks::mutator_lock_) {
-                                            ProcessMarkStackRef(ref);
-                                          });
-    while (!gc_mark_stack_->IsEmpty()) {
+    const size_t thread_count = GetCopyingThreadCount();
+    if (thread_count > 1) {
+      count += ProcessMarkStacksParallel(thread_count);
+    } else {
+      count += ProcessThreadLocalMarkStacks(/* disable_weak_ref_access= */ false,
+                                            /* checkpoint_callback= */ nullptr,
+                                            [this] (mirror::Object* ref)
+                                                REQUIRES_SHARED(Locks::mutator_lock_) {
+                                              ProcessMarkStackRef(ref);
+                                            });
+    }
+    while (!gc_mark_stack_->IsEmpty() || RefillGcMarkStack()) {
       mirror::Object* to_ref = gc_mark_stack_->PopBack();
       ProcessMarkStackRef(to_ref);
       ++count;
@@ -2180,7 +2230,7 @@ bool ConcurrentCopying::ProcessMarkStackOnce() {
       {
         // Copy refs with lock. Note the number of refs should be small.
         MutexLock mu(thread_running_gc_, mark_stack_lock_);
-        if (gc_mark_stack_->IsEmpty()) {
+        if (gc_mark_stack_->IsEmpty() && !RefillGcMarkStack()) {
           break;
         }
         for (StackReference<mirror::Object>* p = gc_mark_stack_->Begin();
@@ -2203,7 +2253,7 @@ bool ConcurrentCopying::ProcessMarkStackOnce() {
       CHECK_EQ(pooled_mark_stacks_.size(), kMarkStackPoolSize);
     }
     // Process the GC mark stack in the exclusive mode. No need to take the lock.
-    while (!gc_mark_stack_->IsEmpty()) {
+    while (!gc_mark_stack_->IsEmpty() || RefillGcMarkStack()) {
       mirror::Object* to_ref = gc_mark_stack_->PopBack();
       ProcessMarkStackRef(to_ref);
       ++count;
@@ -2241,14 +2291,7 @@ size_t ConcurrentCopying::ProcessThreadLocalMarkStacks(bool disable_weak_ref_acc
     }
     {
       MutexLock mu(thread_running_gc_, mark_stack_lock_);
-      if (pooled_mark_stacks_.size() >= kMarkStackPoolSize) {
-        // The pool has enough. Delete it.
-        delete mark_stack;
-      } else {
-        // Otherwise, put it into the pool for later reuse.
-        mark_stack->Reset();
-        pooled_mark_stacks_.push_back(mark_stack);
-      }
+      RecycleMarkStack(mark_stack);
     }
   }
   if (disable_weak_ref_access) {
@@ -2259,7 +2302,130 @@ size_t ConcurrentCopying::ProcessThreadLocalMarkStacks(bool disable_weak_ref_acc
   return count;
 }
 
-inline void ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
+// Drains the revoked thread-local mark stacks, copying and scanning objects
+// like the GC thread does. References pushed by the task go to its own
+// thread-local mark stack, which is handed over to the other tasks through
+// `revoked_mark_stacks_` whenever it fills up.
+class ConcurrentCopying::ParallelCopyTask : public Task {
+ public:
+  explicit ParallelCopyTask(ConcurrentCopying* collector) : collector_(collector) {}
+
+  // The GC thread holds the mutator lock on behalf of the task.
+  void Run(Thread* self) override NO_THREAD_SAFETY_ANALYSIS {
+    uint64_t bytes_scanned = 0;
+    while (true) {
+      accounting::ObjectStack* mark_stack = nullptr;
+      {
+        MutexLock mu(self, collector_->mark_stack_lock_);
+        if (!collector_->revoked_mark_stacks_.empty()) {
+          mark_stack = collector_->revoked_mark_stacks_.back();
+          collector_->revoked_mark_stacks_.pop_back();
+        } else {
+          // Nothing left to take over, drain our own mark stack.
+          mark_stack = self->GetThreadLocalMarkStack();
+          self->SetThreadLocalMarkStack(nullptr);
+        }
+      }
+      if (mark_stack == nullptr) {
+        break;
+      }
+      for (StackReference<mirror::Object>* p = mark_stack->Begin(); p != mark_stack->End(); ++p) {
+        bytes_scanned += collector_->ProcessMarkStackRef</*kParallel=*/ true>(p->AsMirrorPtr());
+      }
+      MutexLock mu(self, collector_->mark_stack_lock_);
+      collector_->RecycleMarkStack(mark_stack);
+    }
+    if (self != collector_->thread_running_gc_) {
+      collector_->RegionSpace()->RevokeEvacTlab(self);
+    }
+    MutexLock mu(self, collector_->mark_stack_lock_);
+    collector_->parallel_bytes_scanned_ += bytes_scanned;
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  ConcurrentCopying* const collector_;
+};
+
+size_t ConcurrentCopying::GetCopyingThreadCount() const {
+  ThreadPool* thread_pool = heap_->GetThreadPool();
+  // Leave the CPUs to the foreground apps when in background.
+  if (thread_pool == nullptr || !Runtime::Current()->InJankPerceptibleProcessState()) {
+    return 1;
+  }
+  return std::min(heap_->GetConcGCThreadCount(), thread_pool->GetThreadCount());
+}
+
+bool ConcurrentCopying::IsParallelCopyingWorker(Thread* self) {
+  if (!parallel_copying_) {
+    return false;
+  }
+  for (ThreadPoolWorker* worker : heap_->GetThreadPool()->GetWorkers()) {
+    if (worker->GetThread() == self) {
+      return true;
+    }
+  }
+  return false;
+}
+
+size_t ConcurrentCopying::ProcessMarkStacksParallel(size_t thread_count) {
+  TimingLogger::ScopedTiming split(__FUNCTION__, GetTimings());
+  Thread* const self = Thread::Current();
+  DCHECK_EQ(self, thread_running_gc_);
+  // Collect the thread-local mark stacks. The GC mark stack is handed out in
+  // thread-local mark stack sized chunks too, so that the workers share all
+  // of the gray objects.
+  RevokeThreadLocalMarkStacks(/* disable_weak_ref_access= */ false,
+                              /* checkpoint_callback= */ nullptr);
+  size_t num_refs = 0;
+  {
+    MutexLock mu(self, mark_stack_lock_);
+    while (!gc_mark_stack_->IsEmpty() || RefillGcMarkStack()) {
+      accounting::ObjectStack* mark_stack = GetPooledMarkStack();
+      while (!mark_stack->IsFull() && !gc_mark_stack_->IsEmpty()) {
+        mark_stack->PushBack(gc_mark_stack_->PopBack());
+      }
+      revoked_mark_stacks_.push_back(mark_stack);
+    }
+    gc_mark_stack_->Reset();
+    for (accounting::ObjectStack* mark_stack : revoked_mark_stacks_) {
+      num_refs += mark_stack->Size();
+    }
+    parallel_bytes_scanned_ = 0;
+  }
+  if (num_refs == 0) {
+    return 0;
+  }
+  if (num_refs < kMinimumParallelCopyingRefs) {
+    // Not worth waking up the workers. References pushed by the GC thread end
+    // up on the GC mark stack, which the caller drains.
+    ParallelCopyTask task(this);
+    task.Run(self);
+  } else {
+    ThreadPool* thread_pool = heap_->GetThreadPool();
+    parallel_copying_ = true;
+    for (size_t i = 0; i < thread_count; ++i) {
+      thread_pool->AddTask(self, new ParallelCopyTask(this));
+    }
+    thread_pool->SetMaxActiveWorkers(thread_count);
+    thread_pool->StartWorkers(self);
+    // The GC thread doesn't take part as its pushes go to the GC mark stack,
+    // which the workers can't take over.
+    thread_pool->Wait(self, /* do_work= */ false, /* may_hold_locks= */ true);
+    thread_pool->StopWorkers(self);
+    thread_pool->SetMaxActiveWorkers(thread_pool->GetThreadCount());
+    parallel_copying_ = false;
+  }
+  MutexLock mu(self, mark_stack_lock_);
+  bytes_scanned_ += parallel_bytes_scanned_;
+  return num_refs;
+}
+
+template <bool kParallel>
+inline size_t ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
   DCHECK(!region_space_->IsInFromSpace(to_ref));
   size_t obj_size = 0;
   space::RegionSpace::RegionType rtype = region_space_->GetRegionType(to_ref);
@@ -2280,8 +2446,11 @@ inline void ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
   bool perform_scan = false;
   switch (rtype) {
     case space::RegionSpace::RegionType::kRegionTypeUnevacFromSpace:
-      // Mark the bitmap only in the GC thread here so that we don't need a CAS.
-      if (!kUseBakerReadBarrier || !region_space_bitmap_->Set(to_ref)) {
+      // Mark the bitmap only in the GC threads here so that we don't need a CAS
+      // unless several of them are at it.
+      if (!kUseBakerReadBarrier ||
+          !(kParallel ? region_space_bitmap_->AtomicTestAndSet(to_ref)
+                      : region_space_bitmap_->Set(to_ref))) {
         // It may be already marked if we accidentally pushed the same object twice due to the racy
         // bitmap read in MarkUnevacFromSpaceRegion.
         if (use_generational_cc_ && young_gen_) {
@@ -2303,7 +2472,11 @@ inline void ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
     case space::RegionSpace::RegionType::kRegionTypeToSpace:
       if (use_generational_cc_) {
         // Copied to to-space, set the bit so that the next GC can scan objects.
-        region_space_bitmap_->Set(to_ref);
+        if (kParallel) {
+          region_space_bitmap_->AtomicTestAndSet(to_ref);
+        } else {
+          region_space_bitmap_->Set(to_ref);
+        }
       }
       perform_scan = true;
       break;
@@ -2333,13 +2506,15 @@ inline void ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
           accounting::LargeObjectBitmap* los_bitmap =
               heap_->GetLargeObjectsSpace()->GetMarkBitmap();
           DCHECK(los_bitmap->HasAddress(to_ref));
-          // Only the GC thread could be setting the LOS bit map hence doesn't
-          // need to be atomically done.
-          perform_scan = !los_bitmap->Set(to_ref);
+          // Only the GC threads could be setting the LOS bit map hence doesn't
+          // need to be atomically done unless copying in parallel.
+          perform_scan = kParallel ? !los_bitmap->AtomicTestAndSet(to_ref)
+                                   : !los_bitmap->Set(to_ref);
         } else {
-          // Only the GC thread could be setting the non-moving space bit map
-          // hence doesn't need to be atomically done.
-          perform_scan = !mark_bitmap->Set(to_ref);
+          // Only the GC threads could be setting the non-moving space bit map
+          // hence doesn't need to be atomically done unless copying in parallel.
+          perform_scan = kParallel ? !mark_bitmap->AtomicTestAndSet(to_ref)
+                                   : !mark_bitmap->Set(to_ref);
         }
       } else {
         perform_scan = true;
@@ -2348,9 +2523,14 @@ inline void ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
   if (perform_scan) {
     obj_size = to_ref->SizeOf<kDefaultVerifyFlags>();
     if (use_generational_cc_ && young_gen_) {
-      Scan<true>(to_ref, obj_size);
+      Scan</*kNoUnEvac=*/ true, kParallel>(to_ref, obj_size);
     } else {
-      Scan<false>(to_ref, obj_size);
+      Scan</*kNoUnEvac=*/ false, kParallel>(to_ref, obj_size);
+    }
+    if (UNLIKELY(survival_stats_ != nullptr)) {
+      // Scan() updated the class reference, so this is the to-space class.
+      survival_stats_->RecordSurvivor(to_ref->GetClass<kVerifyNone, kWithoutReadBarrier>(),
+                                      obj_size);
     }
   }
   if (kUseBakerReadBarrier) {
@@ -2392,12 +2572,17 @@ inline void ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
 
   if (add_to_live_bytes) {
     // Add to the live bytes per unevacuated from-space. Note this code is always run by the
-    // GC-running thread (no synchronization required).
+    // GC-running thread (no synchronization required) unless copying in parallel.
     DCHECK(region_space_bitmap_->Test(to_ref));
     if (obj_size == 0) {
       obj_size = to_ref->SizeOf<kDefaultVerifyFlags>();
     }
-    region_space_->AddLiveBytes(to_ref, RoundUp(obj_size, space::RegionSpace::kAlignment));
+    if (kParallel) {
+      region_space_->AtomicAddLiveBytes(to_ref,
+                                        RoundUp(obj_size, space::RegionSpace::kAlignment));
+    } else {
+      region_space_->AddLiveBytes(to_ref, RoundUp(obj_size, space::RegionSpace::kAlignment));
+    }
   }
   if (ReadBarrier::kEnableToSpaceInvariantChecks) {
     CHECK(to_ref != nullptr);
@@ -2409,6 +2594,7 @@ inline void ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
         visitor,
         visitor);
   }
+  return perform_scan ? obj_size : 0;
 }
 
 class ConcurrentCopying::DisableWeakRefAccessCallback : public Closure {
@@ -2496,6 +2682,7 @@ void ConcurrentCopying::CheckEmptyMarkStack() {
     // Shared, GC-exclusive, or off.
     MutexLock mu(thread_running_gc_, mark_stack_lock_);
     CHECK(gc_mark_stack_->IsEmpty());
+    CHECK(gc_mark_stack_chunks_->IsEmpty());
     CHECK(revoked_mark_stacks_.empty());
     CHECK_EQ(pooled_mark_stacks_.size(), kMarkStackPoolSize);
   }
@@ -2654,7 +2841,12 @@ void ConcurrentCopying::MarkZygoteLargeObjects() {
 void ConcurrentCopying::SweepLargeObjects(bool swap_bitmaps) {
   TimingLogger::ScopedTiming split("SweepLargeObjects", GetTimings());
   if (heap_->GetLargeObjectsSpace() != nullptr) {
-    RecordFreeLOS(heap_->GetLargeObjectsSpace()->Sweep(swap_bitmaps));
+    // Unlike for copying, the GC thread sweeps along with the workers. A single thread, e.g. in
+    // background GCs, means the GC thread sweeps on its own.
+    const size_t thread_count = GetCopyingThreadCount();
+    RecordFreeLOS(heap_->GetLargeObjectsSpace()->Sweep(swap_bitmaps,
+                                                       heap_->GetThreadPool(),
+                                                       thread_count > 1 ? thread_count + 1 : 1));
   }
 }
 
@@ -2802,6 +2994,13 @@ void ConcurrentCopying::ReclaimPhase() {
     // Cleared bytes and objects, populated by the call to RegionSpace::ClearFromSpace below.
     uint64_t cleared_bytes;
     uint64_t cleared_objects;
+    if (survival_stats_ != nullptr) {
+      TimingLogger::ScopedTiming split4("RecordSurvival", GetTimings());
+      // Must run before ClearFromSpace() forgets the regions' ages and live bytes.
+      region_space_->RecordSurvival(survival_stats_, young_gen_);
+      survival_stats_->ResolveSampledClasses();
+      survival_stats_->FinishCollection(GetMetrics());
+    }
     {
       TimingLogger::ScopedTiming split4("ClearFromSpace", GetTimings());
       region_space_->ClearFromSpace(&cleared_bytes, &cleared_objects, /*clear_bitmap*/ !young_gen_);
@@ -3178,7 +3377,7 @@ class ConcurrentCopying::RefFieldsVisitor {
   void operator()(mirror::Object* obj, MemberOffset offset, bool /* is_static */)
       const ALWAYS_INLINE REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES_SHARED(Locks::heap_bitmap_lock_) {
-    collector_->Process<kNoUnEvac>(obj, offset);
+    collector_->Process<kNoUnEvac>(thread_, obj, offset);
   }
 
   void operator()(ObjPtr<mirror::Class> klass, ObjPtr<mirror::Reference> ref) const
@@ -3206,41 +3405,47 @@ class ConcurrentCopying::RefFieldsVisitor {
   Thread* const thread_;
 };
 
-template <bool kNoUnEvac>
+template <bool kNoUnEvac, bool kParallel>
 inline void ConcurrentCopying::Scan(mirror::Object* to_ref, size_t obj_size) {
   // Cannot have `kNoUnEvac` when Generational CC collection is disabled.
   DCHECK_IMPLIES(kNoUnEvac, use_generational_cc_);
+  Thread* const self = kParallel ? Thread::Current() : thread_running_gc_;
   if (kDisallowReadBarrierDuringScan && !Runtime::Current()->IsActiveTransaction()) {
     // Avoid all read barriers during visit references to help performance.
     // Don't do this in transaction mode because we may read the old value of an field which may
     // trigger read barriers.
-    Thread::Current()->ModifyDebugDisallowReadBarrier(1);
+    self->ModifyDebugDisallowReadBarrier(1);
   }
   if (obj_size == 0) {
     obj_size = to_ref->SizeOf<kDefaultVerifyFlags>();
   }
-  bytes_scanned_ += obj_size;
+  if (!kParallel) {
+    bytes_scanned_ += obj_size;
+  }
 
   DCHECK(!region_space_->IsInFromSpace(to_ref));
-  DCHECK_EQ(Thread::Current(), thread_running_gc_);
-  RefFieldsVisitor<kNoUnEvac> visitor(this, thread_running_gc_);
+  DCHECK_EQ(Thread::Current(), self);
+  DCHECK(self == thread_running_gc_ || IsParallelCopyingWorker(self));
+  RefFieldsVisitor<kNoUnEvac> visitor(this, self);
   // Disable the read barrier for a performance reason.
   to_ref->VisitReferences</*kVisitNativeRoots=*/true, kDefaultVerifyFlags, kWithoutReadBarrier>(
       visitor, visitor);
   if (kDisallowReadBarrierDuringScan && !Runtime::Current()->IsActiveTransaction()) {
-    thread_running_gc_->ModifyDebugDisallowReadBarrier(-1);
+    self->ModifyDebugDisallowReadBarrier(-1);
   }
 }
 
 template <bool kNoUnEvac>
-inline void ConcurrentCopying::Process(mirror::Object* obj, MemberOffset offset) {
+inline void ConcurrentCopying::Process(Thread* const self,
+                                       mirror::Object* obj,
+                                       MemberOffset offset) {
   // Cannot have `kNoUnEvac` when Generational CC collection is disabled.
   DCHECK_IMPLIES(kNoUnEvac, use_generational_cc_);
-  DCHECK_EQ(Thread::Current(), thread_running_gc_);
+  DCHECK_EQ(Thread::Current(), self);
   mirror::Object* ref = obj->GetFieldObject<
       mirror::Object, kVerifyNone, kWithoutReadBarrier, false>(offset);
   mirror::Object* to_ref = Mark</*kGrayImmuneObject=*/false, kNoUnEvac, /*kFromGCThread=*/true>(
-      thread_running_gc_,
+      self,
       ref,
       /*holder=*/ obj,
       offset);
@@ -3457,7 +3662,8 @@ mirror::Object* ConcurrentCopying::AllocateInSkippedBlock(Thread* const self, si
 mirror::Object* ConcurrentCopying::Copy(Thread* const self,
                                         mirror::Object* from_ref,
                                         mirror::Object* holder,
-                                        MemberOffset offset) {
+                                        MemberOffset offset,
+                                        bool from_gc_worker) {
   DCHECK(region_space_->IsInFromSpace(from_ref));
   // If the class pointer is null, the object is invalid. This could occur for a dangling pointer
   // from a previous GC that is either inside or outside the allocated region.
@@ -3479,8 +3685,16 @@ mirror::Object* ConcurrentCopying::Copy(Thread* const self,
   size_t bytes_allocated = 0U;
   size_t unused_size;
   bool fall_back_to_non_moving = false;
-  mirror::Object* to_ref = region_space_->AllocNonvirtual</*kForEvac=*/ true>(
-      region_space_alloc_size, &region_space_bytes_allocated, nullptr, &unused_size);
+  mirror::Object* to_ref = nullptr;
+  if (from_gc_worker) {
+    // Avoid contending with the other GC threads on the shared evacuation region.
+    to_ref = region_space_->AllocInEvacTlab(
+        self, region_space_alloc_size, &region_space_bytes_allocated);
+  }
+  if (to_ref == nullptr) {
+    to_ref = region_space_->AllocNonvirtual</*kForEvac=*/ true>(
+        region_space_alloc_size, &region_space_bytes_allocated, nullptr, &unused_size);
+  }
   bytes_allocated = region_space_bytes_allocated;
   if (LIKELY(to_ref != nullptr)) {
     DCHECK_EQ(region_space_alloc_size, region_space_bytes_allocated);
@@ -3595,6 +3809,9 @@ mirror::Object* ConcurrentCopying::Copy(Thread* const self,
         objects_moved_.fetch_add(1, std::memory_order_relaxed);
         bytes_moved_.fetch_add(bytes_allocated, std::memory_order_relaxed);
       }
+      if (UNLIKELY(survival_stats_ != nullptr)) {
+        region_space_->AddEvacuatedBytes(from_ref, bytes_allocated);
+      }
 
       if (LIKELY(!fall_back_to_non_moving)) {
         DCHECK(region_space_->IsInToSpace(to_ref));
@@ -3768,6 +3985,8 @@ void ConcurrentCopying::FinishPhase() {
     CHECK(revoked_mark_stacks_.empty());
     CHECK_EQ(pooled_mark_stacks_.size(), kMarkStackPoolSize);
   }
+  // Release the memory of the chunks the GC mark stack spilled into, if any.
+  gc_mark_stack_chunks_->Reset();
   // kVerifyNoMissingCardMarks relies on the region space cards not being cleared to avoid false
   // positives.
   if (!kVerifyNoMissingCardMarks && !use_generational_cc_) {
@@ -40,9 +40,13 @@ class Object;
 
 namespace gc {
 
+class SurvivalStats;
+
 namespace accounting {
 template<typename T> class AtomicStack;
 using ObjectStack = AtomicStack<mirror::Object>;
+template<typename T> class ChunkedStack;
+using ObjectChunkedStack = ChunkedStack<mirror::Object>;
 template <size_t kAlignment> class SpaceBitmap;
 using ContinuousSpaceBitmap = SpaceBitmap<kObjectAlignment>;
 class HeapBitmap;
@@ -172,15 +176,18 @@ class ConcurrentCopying : public GarbageCollector {
       REQUIRES(!mark_stack_lock_);
   // Returns a to-space copy of the from-space object from_ref, and atomically installs a
   // forwarding pointer. Ensures that the forwarding reference is visible to other threads before
-  // the returned to-space pointer becomes visible to them.
+  // the returned to-space pointer becomes visible to them. GC worker threads (`from_gc_worker`)
+  // copy into their own evacuation TLAB.
   mirror::Object* Copy(Thread* const self,
                        mirror::Object* from_ref,
                        mirror::Object* holder,
-                       MemberOffset offset)
+                       MemberOffset offset,
+                       bool from_gc_worker)
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!mark_stack_lock_, !skipped_blocks_lock_, !immune_gray_stack_lock_);
-  // Scan the reference fields of object `to_ref`.
-  template <bool kNoUnEvac>
+  // Scan the reference fields of object `to_ref`. With `kParallel` the caller
+  // is a GC worker thread and accounts for the scanned bytes itself.
+  template <bool kNoUnEvac, bool kParallel = false>
   void Scan(mirror::Object* to_ref, size_t obj_size = 0) REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!mark_stack_lock_);
   // Scan the reference fields of object 'obj' in the dirty cards during
@@ -192,7 +199,7 @@ class ConcurrentCopying : public GarbageCollector {
       REQUIRES(!mark_stack_lock_);
   // Process a field.
   template <bool kNoUnEvac>
-  void Process(mirror::Object* obj, MemberOffset offset)
+  void Process(Thread* const self, mirror::Object* obj, MemberOffset offset)
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!mark_stack_lock_ , !skipped_blocks_lock_, !immune_gray_stack_lock_);
   void VisitRoots(mirror::Object*** roots, size_t count, const RootInfo& info) override
@@ -213,8 +220,26 @@ class ConcurrentCopying : public GarbageCollector {
   void ProcessMarkStack() override REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!mark_stack_lock_);
   bool ProcessMarkStackOnce() REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!mark_stack_lock_);
-  void ProcessMarkStackRef(mirror::Object* to_ref) REQUIRES_SHARED(Locks::mutator_lock_)
+  // Process a reference popped off a mark stack. With `kParallel` it may be
+  // called by several GC threads at once. Returns the number of bytes scanned.
+  template <bool kParallel = false>
+  size_t ProcessMarkStackRef(mirror::Object* to_ref) REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!mark_stack_lock_);
+  // Number of threads, including the GC thread, to drain the thread-local mark
+  // stacks with. Returns 1 if copying is not to be done in parallel.
+  size_t GetCopyingThreadCount() const;
+  // Drain the revoked thread-local mark stacks and the GC mark stack using
+  // `thread_count` tasks on the heap thread pool. Returns the number of
+  // references processed.
+  size_t ProcessMarkStacksParallel(size_t thread_count) REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!mark_stack_lock_);
+  // Whether `self` is a heap thread pool worker copying objects on behalf of
+  // the GC thread. Only meant for debug checks.
+  bool IsParallelCopyingWorker(Thread* self);
+  // Get an empty mark stack from the pool, or allocate a new one.
+  accounting::ObjectStack* GetPooledMarkStack() REQUIRES(mark_stack_lock_);
+  // Return a processed mark stack to the pool, or delete it if the pool is full.
+  void RecycleMarkStack(accounting::ObjectStack* mark_stack) REQUIRES(mark_stack_lock_);
   void GrayAllDirtyImmuneObjects()
       REQUIRES(Locks::mutator_lock_)
       REQUIRES(!mark_stack_lock_);
@@ -297,7 +322,11 @@ class ConcurrentCopying : public GarbageCollector {
   void ReenableWeakRefAccess(Thread* self) REQUIRES_SHARED(Locks::mutator_lock_);
   void DisableMarking() REQUIRES_SHARED(Locks::mutator_lock_);
   void IssueDisableMarkingCheckpoint() REQUIRES_SHARED(Locks::mutator_lock_);
-  void ExpandGcMarkStack() REQUIRES_SHARED(Locks::mutator_lock_);
+  // Make room on the full GC mark stack by moving half of it to its chunks.
+  void SpillGcMarkStack() REQUIRES_SHARED(Locks::mutator_lock_);
+  // Move a spilled chunk back to the GC mark stack, which must have room for it. Returns false if
+  // there was none.
+  bool RefillGcMarkStack() REQUIRES_SHARED(Locks::mutator_lock_);
   mirror::Object* MarkNonMoving(Thread* const self,
                                 mirror::Object* from_ref,
                                 mirror::Object* holder = nullptr,
@@ -341,6 +370,8 @@ class ConcurrentCopying : public GarbageCollector {
   space::RegionSpace* region_space_;      // The underlying region space.
   std::unique_ptr<Barrier> gc_barrier_;
   std::unique_ptr<accounting::ObjectStack> gc_mark_stack_;
+  // Where the GC mark stack spills to when it is full. Accessed like the GC mark stack.
+  std::unique_ptr<accounting::ObjectChunkedStack> gc_mark_stack_chunks_;
 
   // If true, enable generational collection when using the Concurrent Copying
   // (CC) collector, i.e. use sticky-bit CC for minor collections and (full) CC
@@ -380,6 +411,9 @@ class ConcurrentCopying : public GarbageCollector {
   std::vector<accounting::ObjectStack*> pooled_mark_stacks_
       GUARDED_BY(mark_stack_lock_);
   Thread* thread_running_gc_;
+  // True while the heap thread pool workers are copying and scanning objects
+  // alongside the GC thread (see ProcessMarkStacksParallel).
+  bool parallel_copying_;
   bool is_marking_;                       // True while marking is ongoing.
   // True while we might dispatch on the read barrier entrypoints.
   bool is_using_read_barrier_entrypoints_;
@@ -438,8 +472,13 @@ class ConcurrentCopying : public GarbageCollector {
   size_t bytes_moved_gc_thread_;
   size_t objects_moved_gc_thread_;
   uint64_t bytes_scanned_;
+  // Bytes scanned by the GC worker threads. Kept separate from bytes_scanned_
+  // which is only accessed by the GC thread.
+  uint64_t parallel_bytes_scanned_ GUARDED_BY(mark_stack_lock_);
   uint64_t cumulative_bytes_moved_;
   uint64_t cumulative_objects_moved_;
+  // The heap's survival stats during a collection if -XX:GcSurvivalStats is set, null otherwise.
+  SurvivalStats* survival_stats_;
 
   // The skipped blocks are memory blocks/chucks that were copies of
   // objects that were unused due to lost races (cas failures) at
@@ -500,6 +539,7 @@ class ConcurrentCopying : public GarbageCollector {
   template <bool kConcurrent> class GrayImmuneObjectVisitor;
   class ImmuneSpaceScanObjVisitor;
   class LostCopyVisitor;
+  class ParallelCopyTask;
   template <bool kNoUnEvac> class RefFieldsVisitor;
   class RevokeThreadLocalMarkStackCheckpoint;
   class ScopedGcGraysImmuneObjects;
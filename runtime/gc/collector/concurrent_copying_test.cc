@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "concurrent_copying.h"
+
+#include "base/time_utils.h"
+#include "class_linker-inl.h"
+#include "common_runtime_test.h"
+#include "gc/heap.h"
+#include "handle_scope-inl.h"
+#include "mirror/class-inl.h"
+#include "mirror/object-inl.h"
+#include "mirror/object_array-alloc-inl.h"
+#include "mirror/object_array-inl.h"
+#include "mirror/string-inl.h"
+#include "scoped_thread_state_change-inl.h"
+
+namespace art {
+namespace gc {
+namespace collector {
+
+// Parameterized by the number of concurrent GC threads, which is the number of
+// heap thread pool workers evacuating objects in parallel.
+class ConcurrentCopyingTest : public CommonRuntimeTestWithParam<size_t> {
+ public:
+  ConcurrentCopyingTest() {
+    use_boot_image_ = true;  // Make the Runtime creation cheaper.
+  }
+
+  void SetUpRuntimeOptions(RuntimeOptions* options) override {
+    CommonRuntimeTestWithParam<size_t>::SetUpRuntimeOptions(options);
+    options->push_back(
+        std::make_pair("-XX:ConcGCThreads=" + std::to_string(GetParam()), nullptr));
+  }
+};
+
+TEST_P(ConcurrentCopyingTest, CopyObjectGraph) {
+  Heap* heap = Runtime::Current()->GetHeap();
+  if (heap->CurrentCollectorType() != kCollectorTypeCC) {
+    GTEST_SKIP() << "Concurrent copying collector is not in use";
+  }
+  constexpr size_t kNumArrays = 256;
+  constexpr size_t kArrayLength = 1024;
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+  StackHandleScope<2> hs(self);
+  Handle<mirror::Class> array_class(
+      hs.NewHandle(class_linker_->FindSystemClass(self, "[Ljava/lang/Object;")));
+  Handle<mirror::ObjectArray<mirror::Object>> root(hs.NewHandle(
+      mirror::ObjectArray<mirror::Object>::Alloc(self, array_class.Get(), kNumArrays)));
+  ASSERT_TRUE(root != nullptr);
+  size_t live_bytes = root->SizeOf();
+  for (size_t i = 0; i < kNumArrays; ++i) {
+    ObjPtr<mirror::ObjectArray<mirror::Object>> array =
+        mirror::ObjectArray<mirror::Object>::Alloc(self, array_class.Get(), kArrayLength);
+    ASSERT_TRUE(array != nullptr);
+    root->Set<false>(i, array);
+    live_bytes += array->SizeOf();
+    for (size_t j = 0; j < kArrayLength; ++j) {
+      ObjPtr<mirror::String> string =
+          mirror::String::AllocFromModifiedUtf8(self, std::to_string(i * kArrayLength + j).c_str());
+      ASSERT_TRUE(string != nullptr);
+      // Reload the array as the allocation may have moved it.
+      root->Get(i)->AsObjectArray<mirror::Object>()->Set<false>(j, string);
+      live_bytes += string->SizeOf();
+    }
+  }
+  uint64_t start_time = NanoTime();
+  {
+    ScopedThreadSuspension sts(self, ThreadState::kNative);
+    // An explicit GC evacuates all the regions.
+    heap->CollectGarbage(/* clear_soft_references= */ false);
+  }
+  uint64_t duration_ns = NanoTime() - start_time;
+  for (size_t i = 0; i < kNumArrays; ++i) {
+    ObjPtr<mirror::ObjectArray<mirror::Object>> array =
+        root->Get(i)->AsObjectArray<mirror::Object>();
+    ASSERT_EQ(array->GetLength(), static_cast<int32_t>(kArrayLength));
+    for (size_t j = 0; j < kArrayLength; ++j) {
+      ASSERT_EQ(array->Get(j)->AsString()->ToModifiedUtf8(),
+                std::to_string(i * kArrayLength + j));
+    }
+  }
+  LOG(INFO) << "ConcGCThreads=" << GetParam() << ": collected " << PrettySize(live_bytes)
+            << " of live objects in " << PrettyDuration(duration_ns) << " ("
+            << PrettySize(live_bytes * 1000000000 / std::max<uint64_t>(duration_ns, 1)) << "/s)";
+}
+
+INSTANTIATE_TEST_CASE_P(SingleThreaded,
+                        ConcurrentCopyingTest,
+                        testing::Values(0));
+INSTANTIATE_TEST_CASE_P(Parallel,
+                        ConcurrentCopyingTest,
+                        testing::Values(2, 4));
+
+}  // namespace collector
+}  // namespace gc
+}  // namespace art
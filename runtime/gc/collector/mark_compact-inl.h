@@ -20,26 +20,27 @@
 #include "gc/space/bump_pointer_space.h"
 #include "mark_compact.h"
 #include "mirror/object-inl.h"
+#include "thread-current-inl.h"
 
 namespace art {
 namespace gc {
 namespace collector {
 
+template <bool kParallel>
 inline void MarkCompact::UpdateClassAfterObjectMap(mirror::Object* obj) {
   mirror::Class* klass = obj->GetClass<kVerifyNone, kWithoutReadBarrier>();
-  // Track a class if it needs walking super-classes for visiting references or
-  // if it's higher in address order than its objects and is in moving space.
-  if (UNLIKELY(
-          (std::less<mirror::Object*>{}(obj, klass) && bump_pointer_space_->HasAddress(klass)) ||
-          (klass->GetReferenceInstanceOffsets<kVerifyNone>() == mirror::Class::kClassWalkSuper &&
-           walk_super_class_cache_ != klass))) {
+  const bool class_after_obj =
+      std::less<mirror::Object*>{}(obj, klass) && bump_pointer_space_->HasAddress(klass);
+  const bool walk_super =
+      klass->GetReferenceInstanceOffsets<kVerifyNone>() == mirror::Class::kClassWalkSuper;
+  auto update_maps = [this, obj, klass, walk_super]() REQUIRES_SHARED(Locks::mutator_lock_) {
     // Since this function gets invoked in the compaction pause as well, it is
     // preferable to store such super class separately rather than updating key
     // as the latter would require traversing the hierarchy for every object of 'klass'.
     auto ret1 = class_after_obj_hash_map_.try_emplace(ObjReference::FromMirrorPtr(klass),
                                                       ObjReference::FromMirrorPtr(obj));
     if (ret1.second) {
-      if (klass->GetReferenceInstanceOffsets<kVerifyNone>() == mirror::Class::kClassWalkSuper) {
+      if (walk_super) {
         // In this case we require traversing through the super class hierarchy
         // and find the super class at the highest address order.
         mirror::Class* highest_klass = bump_pointer_space_->HasAddress(klass) ? klass : nullptr;
@@ -62,10 +63,25 @@ inline void MarkCompact::UpdateClassAfterObjectMap(mirror::Object* obj) {
     } else if (std::less<mirror::Object*>{}(obj, ret1.first->second.AsMirrorPtr())) {
       ret1.first->second = ObjReference::FromMirrorPtr(obj);
     }
+  };
+  // Track a class if it needs walking super-classes for visiting references or
+  // if it's higher in address order than its objects and is in moving space.
+  if (kParallel) {
+    // The maps, as well as walk_super_class_cache_, are shared by all the
+    // marking threads.
+    if (UNLIKELY(class_after_obj || walk_super)) {
+      MutexLock mu(Thread::Current(), class_after_obj_map_lock_);
+      if (class_after_obj || walk_super_class_cache_ != klass) {
+        update_maps();
+      }
+    }
+  } else if (UNLIKELY(class_after_obj || (walk_super && walk_super_class_cache_ != klass))) {
+    update_maps();
   }
 }
 
 template <size_t kAlignment>
+template <bool kAtomic>
 inline uintptr_t MarkCompact::LiveWordsBitmap<kAlignment>::SetLiveWords(uintptr_t begin,
                                                                         size_t size) {
   const uintptr_t begin_bit_idx = MemRangeBitmap::BitIndexFromAddr(begin);
@@ -79,8 +95,16 @@ inline uintptr_t MarkCompact::LiveWordsBitmap<kAlignment>::SetLiveWords(uintptr_
   uintptr_t mask = Bitmap::BitIndexToMask(begin_bit_idx);
   // Bits that needs to be set in the first word, if it's not also the last word
   mask = ~(mask - 1);
+  // Only the first and the last words may be shared with other objects.
+  auto set_shared_word = [](uintptr_t* address, uintptr_t bits) ALWAYS_INLINE {
+    if (kAtomic) {
+      reinterpret_cast<Atomic<uintptr_t>*>(address)->fetch_or(bits, std::memory_order_relaxed);
+    } else {
+      *address |= bits;
+    }
+  };
   if (diff > 0) {
-    *begin_bm_address |= mask;
+    set_shared_word(begin_bm_address, mask);
     mask = ~0;
     // Even though memset can handle the (diff == 1) case but we should avoid the
     // overhead of a function call for this, highly likely (as most of the objects
@@ -91,7 +115,7 @@ inline uintptr_t MarkCompact::LiveWordsBitmap<kAlignment>::SetLiveWords(uintptr_
     }
   }
   uintptr_t end_mask = Bitmap::BitIndexToMask(end_bit_idx);
-  *end_bm_address |= mask & (end_mask | (end_mask - 1));
+  set_shared_word(end_bm_address, mask & (end_mask | (end_mask - 1)));
   return begin_bit_idx;
 }
 
@@ -283,6 +307,7 @@ inline bool MarkCompact::VerifyRootSingleUpdate(void* root,
                          << " stack_high_addr=" << stack_high_addr;
     }
     DCHECK(reinterpret_cast<uint8_t*>(old_ref) >= black_allocations_begin_ ||
+           reinterpret_cast<uint8_t*>(old_ref) < moving_space_begin_ ||
            live_words_bitmap_->Test(old_ref))
         << "ref=" << old_ref << " <" << mirror::Object::PrettyTypeOf(old_ref) << "> RootInfo ["
         << info << "]";
@@ -358,6 +383,11 @@ inline mirror::Object* MarkCompact::PostCompactAddressUnchecked(mirror::Object*
   if (reinterpret_cast<uint8_t*>(old_ref) >= black_allocations_begin_) {
     return PostCompactBlackObjAddr(old_ref);
   }
+  // Old-gen objects below the compacted portion of the moving space don't move
+  // in young-gen cycles.
+  if (reinterpret_cast<uint8_t*>(old_ref) < moving_space_begin_) {
+    return old_ref;
+  }
   if (kIsDebugBuild) {
     mirror::Object* from_ref = GetFromSpaceAddr(old_ref);
     DCHECK(live_words_bitmap_->Test(old_ref))
@@ -47,6 +47,7 @@
 #include "gc/collector_type.h"
 #include "gc/reference_processor.h"
 #include "gc/space/bump_pointer_space.h"
+#include "gc/survival_stats.h"
 #include "gc/task_processor.h"
 #include "gc/verification-inl.h"
 #include "jit/jit_code_cache.h"
@@ -285,6 +286,9 @@ static constexpr bool kCheckLocks = kDebugLocking;
 static constexpr bool kVerifyRootsMarked = kIsDebugBuild;
 // Two threads should suffice on devices.
 static constexpr size_t kMaxNumUffdWorkers = 2;
+// Parallel marking isn't worth the synchronization overhead for smaller
+// mark-stacks.
+static constexpr size_t kMinimumParallelMarkStackSize = 128;
 // Number of compaction buffers reserved for mutator threads in SIGBUS feature
 // case. It's extremely unlikely that we will ever have more than these number
 // of mutator threads trying to access the moving-space during one compaction
@@ -366,10 +370,13 @@ static bool IsSigbusFeatureAvailable() {
   return gUffdFeatures & UFFD_FEATURE_SIGBUS;
 }
 
-MarkCompact::MarkCompact(Heap* heap)
+MarkCompact::MarkCompact(Heap* heap, bool use_generational)
     : GarbageCollector(heap, "concurrent mark compact"),
       gc_barrier_(0),
       lock_("mark compact lock", kGenericBottomLock),
+      parallel_mark_tasks_(0),
+      idle_mark_tasks_(0),
+      class_after_obj_map_lock_("mark compact class-after-object map lock", kGenericBottomLock),
       bump_pointer_space_(heap->GetBumpPointerSpace()),
       moving_space_bitmap_(bump_pointer_space_->GetMarkBitmap()),
       moving_to_space_fd_(kFdUnused),
@@ -382,6 +389,15 @@ MarkCompact::MarkCompact(Heap* heap)
       uffd_initialized_(false),
       uffd_minor_fault_supported_(false),
       use_uffd_sigbus_(IsSigbusFeatureAvailable()),
+      use_generational_(use_generational),
+      young_gen_(false),
+      old_gen_end_(nullptr),
+      moving_space_begin_(bump_pointer_space_->Begin()),
+      old_gen_objects_(0),
+      full_gc_freed_bytes_(0),
+      full_gc_duration_ns_(0),
+      full_gc_count_(0),
+      survival_stats_(nullptr),
       minor_fault_initialized_(false),
       map_linear_alloc_shared_(false) {
   if (kIsDebugBuild) {
@@ -496,25 +512,68 @@ MarkCompact::MarkCompact(Heap* heap)
   // In most of the cases, we don't expect more than one LinearAlloc space.
   linear_alloc_spaces_data_.reserve(1);
 
-  // Initialize GC metrics.
-  metrics::ArtMetrics* metrics = GetMetrics();
-  // The mark-compact collector supports only full-heap collections at the moment.
-  gc_time_histogram_ = metrics->FullGcCollectionTime();
-  metrics_gc_count_ = metrics->FullGcCount();
-  metrics_gc_count_delta_ = metrics->FullGcCountDelta();
-  gc_throughput_histogram_ = metrics->FullGcThroughput();
-  gc_tracing_throughput_hist_ = metrics->FullGcTracingThroughput();
-  gc_throughput_avg_ = metrics->FullGcThroughputAvg();
-  gc_tracing_throughput_avg_ = metrics->FullGcTracingThroughputAvg();
-  gc_scanned_bytes_ = metrics->FullGcScannedBytes();
-  gc_scanned_bytes_delta_ = metrics->FullGcScannedBytesDelta();
-  gc_freed_bytes_ = metrics->FullGcFreedBytes();
-  gc_freed_bytes_delta_ = metrics->FullGcFreedBytesDelta();
-  gc_duration_ = metrics->FullGcDuration();
-  gc_duration_delta_ = metrics->FullGcDurationDelta();
+  // Initialize GC metrics. They are switched to the young-gen ones in
+  // SetYoungGen() for young-gen cycles.
+  SetYoungGen(/*young_gen=*/false);
   are_metrics_initialized_ = true;
 }
 
+void MarkCompact::SetYoungGen(bool young_gen) {
+  young_gen_ = young_gen && use_generational_ && old_gen_end_ != nullptr;
+  // Return type of these functions are different. And even though the base class
+  // is same, using ternary operator complains.
+  metrics::ArtMetrics* metrics = GetMetrics();
+  if (young_gen_) {
+    gc_time_histogram_ = metrics->YoungGcCollectionTime();
+    metrics_gc_count_ = metrics->YoungGcCount();
+    metrics_gc_count_delta_ = metrics->YoungGcCountDelta();
+    gc_throughput_histogram_ = metrics->YoungGcThroughput();
+    gc_tracing_throughput_hist_ = metrics->YoungGcTracingThroughput();
+    gc_throughput_avg_ = metrics->YoungGcThroughputAvg();
+    gc_tracing_throughput_avg_ = metrics->YoungGcTracingThroughputAvg();
+    gc_scanned_bytes_ = metrics->YoungGcScannedBytes();
+    gc_scanned_bytes_delta_ = metrics->YoungGcScannedBytesDelta();
+    gc_freed_bytes_ = metrics->YoungGcFreedBytes();
+    gc_freed_bytes_delta_ = metrics->YoungGcFreedBytesDelta();
+    gc_duration_ = metrics->YoungGcDuration();
+    gc_duration_delta_ = metrics->YoungGcDurationDelta();
+  } else {
+    gc_time_histogram_ = metrics->FullGcCollectionTime();
+    metrics_gc_count_ = metrics->FullGcCount();
+    metrics_gc_count_delta_ = metrics->FullGcCountDelta();
+    gc_throughput_histogram_ = metrics->FullGcThroughput();
+    gc_tracing_throughput_hist_ = metrics->FullGcTracingThroughput();
+    gc_throughput_avg_ = metrics->FullGcThroughputAvg();
+    gc_tracing_throughput_avg_ = metrics->FullGcTracingThroughputAvg();
+    gc_scanned_bytes_ = metrics->FullGcScannedBytes();
+    gc_scanned_bytes_delta_ = metrics->FullGcScannedBytesDelta();
+    gc_freed_bytes_ = metrics->FullGcFreedBytes();
+    gc_freed_bytes_delta_ = metrics->FullGcFreedBytesDelta();
+    gc_duration_ = metrics->FullGcDuration();
+    gc_duration_delta_ = metrics->FullGcDurationDelta();
+  }
+}
+
+void MarkCompact::ResetGenerations() {
+  if (old_gen_end_ != nullptr) {
+    moving_space_bitmap_->ClearRange(reinterpret_cast<mirror::Object*>(bump_pointer_space_->Begin()),
+                                     reinterpret_cast<mirror::Object*>(old_gen_end_));
+  }
+  old_gen_end_ = nullptr;
+  old_gen_objects_ = 0;
+}
+
+void MarkCompact::RecordFullGcIteration(const Iteration& iteration) {
+  full_gc_freed_bytes_ += iteration.GetFreedBytes() + iteration.GetFreedLargeObjectBytes();
+  full_gc_duration_ns_ += iteration.GetDurationNs();
+  full_gc_count_++;
+}
+
+uint64_t MarkCompact::GetEstimatedFullGcMeanThroughput() const {
+  // Add 1ms to prevent possible division by 0.
+  return (full_gc_freed_bytes_ * 1000) / (NsToMs(full_gc_duration_ns_) + 1);
+}
+
 void MarkCompact::AddLinearAllocSpaceData(uint8_t* begin, size_t len) {
   DCHECK_ALIGNED(begin, kPageSize);
   DCHECK_ALIGNED(len, kPageSize);
@@ -594,15 +653,44 @@ void MarkCompact::BindAndResetBitmaps() {
     } else {
       CHECK(!space->IsZygoteSpace());
       CHECK(!space->IsImageSpace());
-      // The card-table corresponding to bump-pointer and non-moving space can
-      // be cleared, because we are going to traverse all the reachable objects
-      // in these spaces. This card-table will eventually be used to track
-      // mutations while concurrent marking is going on.
-      card_table->ClearCardRange(space->Begin(), space->Limit());
+      if (young_gen_) {
+        // In a young-gen cycle the non-moving space and the old-gen portion of
+        // the moving space are not collected. Their dirty cards remember
+        // old-to-young references, so age them instead of clearing. Only the
+        // young-gen portion of the moving space is traversed fully.
+        uint8_t* young_gen_begin = space->Limit();
+        if (space == bump_pointer_space_) {
+          young_gen_begin = AlignUp(old_gen_end_, accounting::CardTable::kCardSize);
+          card_table->ClearCardRange(young_gen_begin, space->Limit());
+        }
+        card_table->ModifyCardsAtomic(
+            space->Begin(),
+            young_gen_begin,
+            [](uint8_t card) {
+              return (card == gc::accounting::CardTable::kCardClean)
+                  ? card
+                  : gc::accounting::CardTable::kCardAged;
+            },
+            /* card modified visitor */ VoidFunctor());
+      } else {
+        // The card-table corresponding to bump-pointer and non-moving space can
+        // be cleared, because we are going to traverse all the reachable objects
+        // in these spaces. This card-table will eventually be used to track
+        // mutations while concurrent marking is going on.
+        card_table->ClearCardRange(space->Begin(), space->Limit());
+      }
       if (space != bump_pointer_space_) {
         CHECK_EQ(space, heap_->GetNonMovingSpace());
         non_moving_space_ = space;
+        if (young_gen_) {
+          // Everything live in the non-moving space is treated as marked.
+          space->AsContinuousMemMapAllocSpace()->BindLiveToMarkBitmap();
+        }
         non_moving_space_bitmap_ = space->GetMarkBitmap();
+      } else if (use_generational_ && !young_gen_) {
+        // A full cycle collects the old-gen as well. Drop its mark-bits, which
+        // are retained across cycles in generational mode.
+        moving_space_bitmap_->Clear();
       }
     }
   }
@@ -634,6 +722,8 @@ void MarkCompact::InitializePhase() {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
   mark_stack_ = heap_->GetMarkStack();
   CHECK(mark_stack_->IsEmpty());
+  mark_stack_chunks_ = heap_->GetMarkStackChunks();
+  CHECK(mark_stack_chunks_->IsEmpty());
   immune_spaces_.Reset();
   moving_first_objs_count_ = 0;
   non_moving_first_objs_count_ = 0;
@@ -644,10 +734,25 @@ void MarkCompact::InitializePhase() {
   compaction_buffer_counter_.store(1, std::memory_order_relaxed);
   from_space_slide_diff_ = from_space_begin_ - bump_pointer_space_->Begin();
   black_allocations_begin_ = bump_pointer_space_->Limit();
+  moving_space_begin_ = bump_pointer_space_->Begin();
   walk_super_class_cache_ = nullptr;
+  survival_stats_ = heap_->GetSurvivalStats()->IsEnabled() ? heap_->GetSurvivalStats() : nullptr;
+  if (survival_stats_ != nullptr) {
+    survival_stats_->StartCollection(young_gen_);
+  }
   // TODO: Would it suffice to read it once in the constructor, which is called
   // in zygote process?
   pointer_size_ = Runtime::Current()->GetClassLinker()->GetImagePointerSize();
+  // The thread pool is used for parallel marking. Create it here as the
+  // workers can't attach while the mutator lock is held. Zygote deletes the
+  // pool after every GC, so it marks using the GC thread alone.
+  Runtime* runtime = Runtime::Current();
+  if (heap_->GetThreadPool() == nullptr && !runtime->IsZygote() &&
+      !runtime->IsShuttingDown(Thread::Current()) &&
+      std::max(heap_->GetParallelGCThreadCount(), heap_->GetConcGCThreadCount()) > 0) {
+    heap_->CreateThreadPool();
+    heap_->WaitForWorkersToBeCreated();
+  }
 }
 
 class MarkCompact::ThreadFlipVisitor : public Closure {
@@ -738,17 +843,22 @@ void MarkCompact::RunPhases() {
   GetHeap()->PostGcVerification(this);
 }
 
-void MarkCompact::InitMovingSpaceFirstObjects(const size_t vec_len) {
+void MarkCompact::InitMovingSpaceFirstObjects(const size_t vec_len,
+                                              const size_t start_page_idx) {
   // Find the first live word first.
-  size_t to_space_page_idx = 0;
+  size_t to_space_page_idx = start_page_idx;
   uint32_t offset_in_chunk_word;
   uint32_t offset;
   mirror::Object* obj;
   const uintptr_t heap_begin = moving_space_bitmap_->HeapBegin();
+  // The pages before start_page_idx aren't compacted in this cycle.
+  moving_first_objs_count_ = start_page_idx;
 
   size_t chunk_idx;
   // Find the first live word in the space
-  for (chunk_idx = 0; chunk_info_vec_[chunk_idx] == 0; chunk_idx++) {
+  for (chunk_idx = start_page_idx * (kPageSize / kOffsetChunkSize);
+       chunk_info_vec_[chunk_idx] == 0;
+       chunk_idx++) {
     if (chunk_idx > vec_len) {
       // We don't have any live data on the moving-space.
       return;
@@ -919,15 +1029,82 @@ class MarkCompact::ConcurrentCompactionGcTask : public SelfDeletingTask {
   size_t index_;
 };
 
+void MarkCompact::PrepareOldGenForCompaction() {
+  DCHECK(young_gen_);
+  uint8_t* const space_begin = bump_pointer_space_->Begin();
+  DCHECK_LE(old_gen_end_, black_allocations_begin_);
+  // Compaction works at page granularity. So start compacting from the page
+  // containing old_gen_end_, or an earlier one if an old-gen object straddles
+  // that page's beginning, as the objects below moving_space_begin_ must not
+  // be touched.
+  uint8_t* begin = AlignDown(old_gen_end_, kPageSize);
+  while (begin > space_begin) {
+    mirror::Object* obj = moving_space_bitmap_->FindPrecedingObject(
+        reinterpret_cast<uintptr_t>(begin - kAlignment));
+    DCHECK(obj != nullptr);
+    if (reinterpret_cast<uint8_t*>(obj) + obj->SizeOf<kDefaultVerifyFlags>() <= begin) {
+      break;
+    }
+    begin = AlignDown(reinterpret_cast<uint8_t*>(obj), kPageSize);
+  }
+  moving_space_begin_ = begin;
+  // The old-gen objects in [moving_space_begin_, old_gen_end_) are densely
+  // packed. Adding them to the liveness info ensures that they retain their
+  // addresses while the pages are compacted.
+  int32_t objects_in_range = 0;
+  moving_space_bitmap_->VisitMarkedRange(
+      reinterpret_cast<uintptr_t>(moving_space_begin_),
+      reinterpret_cast<uintptr_t>(old_gen_end_),
+      [this, &objects_in_range](mirror::Object* obj) REQUIRES_SHARED(Locks::mutator_lock_) {
+        UpdateLivenessInfo(obj, obj->SizeOf<kDefaultVerifyFlags>());
+        objects_in_range++;
+      });
+  // The remaining old-gen objects are neither discovered by marking nor
+  // freed.
+  old_gen_objects_ -= objects_in_range;
+  DCHECK_GE(old_gen_objects_, 0);
+  freed_objects_ -= old_gen_objects_;
+  // Every chunk below moving_space_begin_ is considered full so that the
+  // exclusive scan below computes identity post-compact addresses there.
+  std::fill_n(chunk_info_vec_, (moving_space_begin_ - space_begin) / kOffsetChunkSize,
+              kOffsetChunkSize);
+}
+
+void MarkCompact::RecordSurvival(uint8_t* live_end) {
+  uint8_t* const space_begin = bump_pointer_space_->Begin();
+  if (young_gen_) {
+    // The old-gen is densely packed and entirely live, so whatever lives past
+    // its end once compacted is what survived of the young-gen. All of it gets
+    // promoted.
+    size_t allocated = black_allocations_begin_ - old_gen_end_;
+    size_t survived = std::min<size_t>(live_end - std::min(live_end, old_gen_end_), allocated);
+    survival_stats_->RecordAge(/*age=*/ 0, allocated, survived);
+    survival_stats_->RecordPromotedBytes(survived);
+  } else {
+    // Full cycles can't tell the ages of the objects apart.
+    survival_stats_->RecordAge(SurvivalStats::kUnknownAge,
+                               black_allocations_begin_ - space_begin,
+                               live_end - space_begin);
+  }
+  survival_stats_->ResolveSampledClasses();
+  survival_stats_->FinishCollection(GetMetrics());
+}
+
 void MarkCompact::PrepareForCompaction() {
   uint8_t* space_begin = bump_pointer_space_->Begin();
   size_t vector_len = (black_allocations_begin_ - space_begin) / kOffsetChunkSize;
   DCHECK_LE(vector_len, vector_length_);
-  for (size_t i = 0; i < vector_len; i++) {
+  if (young_gen_) {
+    PrepareOldGenForCompaction();
+  } else {
+    old_gen_objects_ = 0;
+  }
+  const size_t start_page_idx = (moving_space_begin_ - space_begin) / kPageSize;
+  for (size_t i = (moving_space_begin_ - space_begin) / kOffsetChunkSize; i < vector_len; i++) {
     DCHECK_LE(chunk_info_vec_[i], kOffsetChunkSize);
     DCHECK_EQ(chunk_info_vec_[i], live_words_bitmap_->LiveBytesInBitmapWord(i));
   }
-  InitMovingSpaceFirstObjects(vector_len);
+  InitMovingSpaceFirstObjects(vector_len, start_page_idx);
   InitNonMovingSpaceFirstObjects();
 
   // TODO: We can do a lot of neat tricks with this offset vector to tune the
@@ -972,6 +1149,11 @@ void MarkCompact::PrepareForCompaction() {
   }
   post_compact_end_ = AlignUp(space_begin + total, kPageSize);
   CHECK_EQ(post_compact_end_, space_begin + moving_first_objs_count_ * kPageSize);
+  if (survival_stats_ != nullptr) {
+    // Marking is over and nothing has moved yet, so the sampled classes are
+    // still valid.
+    RecordSurvival(space_begin + total);
+  }
   black_objs_slide_diff_ = black_allocations_begin_ - post_compact_end_;
   // How do we handle compaction of heap portion used for allocations after the
   // marking-pause?
@@ -1017,7 +1199,10 @@ void MarkCompact::PrepareForCompaction() {
         heap_->CreateThreadPool(std::min(heap_->GetParallelGCThreadCount(), kMaxNumUffdWorkers));
         pool = heap_->GetThreadPool();
       }
-      size_t num_threads = pool->GetThreadCount();
+      // The pool may have more workers, for parallel marking, than there are
+      // compaction buffers.
+      size_t num_threads =
+          std::min(pool->GetThreadCount(), compaction_buffers_map_.Size() / kPageSize - 1);
       thread_pool_counter_ = num_threads;
       for (size_t i = 0; i < num_threads; i++) {
         pool->AddTask(thread_running_gc_, new ConcurrentCompactionGcTask(this, i + 1));
@@ -1320,6 +1505,7 @@ void MarkCompact::Sweep(bool swap_bitmaps) {
     heap_->MarkAllocStackAsLive(live_stack);
     live_stack->Reset();
     DCHECK(mark_stack_->IsEmpty());
+    DCHECK(mark_stack_chunks_->IsEmpty());
   }
   for (const auto& space : GetHeap()->GetContinuousSpaces()) {
     if (space->IsContinuousMemMapAllocSpace() && space != bump_pointer_space_) {
@@ -1337,7 +1523,7 @@ void MarkCompact::SweepLargeObjects(bool swap_bitmaps) {
   space::LargeObjectSpace* los = heap_->GetLargeObjectsSpace();
   if (los != nullptr) {
     TimingLogger::ScopedTiming split(__FUNCTION__, GetTimings());
-    RecordFreeLOS(los->Sweep(swap_bitmaps));
+    RecordFreeLOS(los->Sweep(swap_bitmaps, heap_->GetThreadPool(), GetMarkingThreadCount()));
   }
 }
 
@@ -1452,7 +1638,8 @@ void MarkCompact::VerifyObject(mirror::Object* ref, Callback& callback) const {
           << " post_compact_end=" << static_cast<void*>(post_compact_end_)
           << " pre_compact_klass=" << pre_compact_klass
           << " black_allocations_begin=" << static_cast<void*>(black_allocations_begin_);
-      CHECK(live_words_bitmap_->Test(pre_compact_klass));
+      CHECK(reinterpret_cast<uint8_t*>(pre_compact_klass) < moving_space_begin_ ||
+            live_words_bitmap_->Test(pre_compact_klass));
     }
     if (!IsValidObject(ref)) {
       std::ostringstream oss;
@@ -2154,8 +2341,11 @@ void MarkCompact::UpdateClassAfterObjMap() {
     ObjReference key = super_class_iter != super_class_after_class_hash_map_.end()
                        ? super_class_iter->second
                        : pair.first;
+    // Classes below moving_space_begin_ are not moved, and hence their
+    // from-space pages don't exist.
     if (std::less<mirror::Object*>{}(pair.second.AsMirrorPtr(), key.AsMirrorPtr()) &&
-        bump_pointer_space_->HasAddress(key.AsMirrorPtr())) {
+        bump_pointer_space_->HasAddress(key.AsMirrorPtr()) &&
+        reinterpret_cast<uint8_t*>(key.AsMirrorPtr()) >= moving_space_begin_) {
       auto [ret_iter, success] = class_after_obj_ordered_map_.try_emplace(key, pair.second);
       // It could fail only if the class 'key' has objects of its own, which are lower in
       // address order, as well of some of its derived class. In this case
@@ -2229,7 +2419,10 @@ void MarkCompact::CompactMovingSpace(uint8_t* page) {
   }
   DCHECK_EQ(pre_compact_page, black_allocations_begin_);
 
-  while (idx > 0) {
+  // Pages below moving_space_begin_ hold old-gen objects in young-gen cycles,
+  // which are not compacted.
+  const size_t first_page_idx = (moving_space_begin_ - bump_pointer_space_->Begin()) / kPageSize;
+  while (idx > first_page_idx) {
     idx--;
     to_space_end -= kPageSize;
     if (kMode == kMinorFaultMode) {
@@ -2245,7 +2438,7 @@ void MarkCompact::CompactMovingSpace(uint8_t* page) {
         });
     FreeFromSpacePages(idx, kMode);
   }
-  DCHECK_EQ(to_space_end, bump_pointer_space_->Begin());
+  DCHECK_EQ(to_space_end, moving_space_begin_);
 }
 
 void MarkCompact::UpdateNonMovingPage(mirror::Object* first, uint8_t* page) {
@@ -2658,6 +2851,67 @@ class MarkCompact::LinearAllocPageUpdater {
   bool last_page_touched_;
 };
 
+void MarkCompact::UpdateCardsForGenerations() {
+  TimingLogger::ScopedTiming t("(Paused)UpdateCardsForGenerations", GetTimings());
+  accounting::CardTable* const card_table = heap_->GetCardTable();
+  // Objects in the compacted portion of the moving space are part of the
+  // old-gen after this cycle. Those on dirty cards may have been written with
+  // references to black allocations, which remain in the young-gen. Aged cards
+  // only cover writes prior to the marking-pause, whose referents are all being
+  // promoted.
+  std::vector<mirror::Object*> dirty_objs;
+  {
+    WriterMutexLock wmu(thread_running_gc_, *Locks::heap_bitmap_lock_);
+    card_table->Scan</*kClearCard*/ false>(
+        moving_space_bitmap_,
+        moving_space_begin_,
+        black_allocations_begin_,
+        [this, card_table, &dirty_objs](mirror::Object* obj)
+            REQUIRES_SHARED(Locks::mutator_lock_) {
+          mirror::Object* new_addr = PostCompactAddressUnchecked(obj);
+          // Post-compact addresses are monotonic. So it suffices to compare
+          // with the last one to avoid duplicate cards.
+          if (dirty_objs.empty() ||
+              card_table->CardFromAddr(dirty_objs.back()) != card_table->CardFromAddr(new_addr)) {
+            dirty_objs.push_back(new_addr);
+          }
+        },
+        accounting::CardTable::kCardDirty);
+  }
+  // The same applies to the uncompacted old-gen.
+  auto retain_dirty_card = [](uint8_t card) {
+    return (card == accounting::CardTable::kCardDirty) ? card : accounting::CardTable::kCardClean;
+  };
+  card_table->ModifyCardsAtomic(bump_pointer_space_->Begin(),
+                                moving_space_begin_,
+                                retain_dirty_card,
+                                VoidFunctor());
+  card_table->ModifyCardsAtomic(non_moving_space_->Begin(),
+                                non_moving_space_->End(),
+                                retain_dirty_card,
+                                VoidFunctor());
+  card_table->ClearCardRange(moving_space_begin_, bump_pointer_space_->Limit());
+  for (mirror::Object* obj : dirty_objs) {
+    card_table->MarkCard(obj);
+  }
+}
+
+void MarkCompact::UpdateMovingSpaceOldGen() {
+  TimingLogger::ScopedTiming t("(Paused)UpdateMovingSpaceOldGen", GetTimings());
+  DCHECK(young_gen_);
+  // All old-to-young references are on dirty or aged cards. As
+  // UpdateCardsForGenerations() drops the aged cards, it must be called after
+  // this. Classes of these objects may be in the compacted portion, so this
+  // must also be called after KernelPreparation() and before compaction.
+  ImmuneSpaceUpdateObjVisitor visitor(this, /*visit_native_roots=*/false);
+  WriterMutexLock wmu(thread_running_gc_, *Locks::heap_bitmap_lock_);
+  heap_->GetCardTable()->Scan</*kClearCard*/ false>(moving_space_bitmap_,
+                                                    bump_pointer_space_->Begin(),
+                                                    moving_space_begin_,
+                                                    visitor,
+                                                    accounting::CardTable::kCardAged);
+}
+
 void MarkCompact::CompactionPause() {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
   Runtime* runtime = Runtime::Current();
@@ -2806,6 +3060,12 @@ void MarkCompact::CompactionPause() {
   }
   KernelPreparation();
   UpdateNonMovingSpace();
+  if (young_gen_) {
+    UpdateMovingSpaceOldGen();
+  }
+  if (use_generational_) {
+    UpdateCardsForGenerations();
+  }
   // fallback mode
   if (uffd_ == kFallbackMode) {
     CompactMovingSpace<kFallbackMode>(nullptr);
@@ -2871,11 +3131,17 @@ void MarkCompact::KernelPrepareRangeForUffd(uint8_t* to_addr,
 
 void MarkCompact::KernelPreparation() {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
-  uint8_t* moving_space_begin = bump_pointer_space_->Begin();
-  size_t moving_space_size = bump_pointer_space_->Capacity();
+  // In young-gen cycles only the portion starting from moving_space_begin_ is
+  // compacted. The old-gen below it stays mapped and accessible to mutators.
+  uint8_t* moving_space_begin = moving_space_begin_;
+  size_t moving_space_size =
+      bump_pointer_space_->Capacity() - (moving_space_begin - bump_pointer_space_->Begin());
   int mode = kCopyMode;
   size_t moving_space_register_sz;
   if (minor_fault_initialized_) {
+    // Minor-fault mode requires the shadow map to mirror the entire moving
+    // space, which isn't the case with partial compaction.
+    DCHECK(!use_generational_);
     moving_space_register_sz = (moving_first_objs_count_ + black_page_count_) * kPageSize;
     if (shadow_to_space_map_.IsValid()) {
       size_t shadow_size = shadow_to_space_map_.Size();
@@ -2919,7 +3185,7 @@ void MarkCompact::KernelPreparation() {
   }
 
   KernelPrepareRangeForUffd(moving_space_begin,
-                            from_space_begin_,
+                            moving_space_begin + from_space_slide_diff_,
                             moving_space_size,
                             moving_to_space_fd_,
                             shadow_addr);
@@ -3532,10 +3798,10 @@ void MarkCompact::CompactionPhase() {
   }
 
   size_t moving_space_size = bump_pointer_space_->Capacity();
-  UnregisterUffd(bump_pointer_space_->Begin(),
+  UnregisterUffd(moving_space_begin_,
                  minor_fault_initialized_ ?
                      (moving_first_objs_count_ + black_page_count_) * kPageSize :
-                     moving_space_size);
+                     moving_space_size - (moving_space_begin_ - bump_pointer_space_->Begin()));
 
   // Release all of the memory taken by moving-space's from-map
   if (minor_fault_initialized_) {
@@ -3661,19 +3927,27 @@ class MarkCompact::ThreadRootsVisitor : public RootVisitor {
                REQUIRES(Locks::heap_bitmap_lock_) {
     StackReference<mirror::Object>* start;
     StackReference<mirror::Object>* end;
+    bool pushed;
     {
       MutexLock mu(self_, mark_compact_->lock_);
-      // Loop here because even after expanding once it may not be sufficient to
-      // accommodate all references. It's almost impossible, but there is no harm
-      // in implementing it this way.
-      while (!mark_compact_->mark_stack_->BumpBack(idx_, &start, &end)) {
-        mark_compact_->ExpandMarkStack();
-      }
+      pushed = mark_compact_->mark_stack_->BumpBack(idx_, &start, &end);
     }
-    while (idx_ > 0) {
-      *start++ = roots_[--idx_];
+    if (pushed) {
+      while (idx_ > 0) {
+        *start++ = roots_[--idx_];
+      }
+      DCHECK_EQ(start, end);
+    } else {
+      // The mark-stack is full. Hand the roots over in chunks instead.
+      accounting::ObjectChunkedStack* chunks = mark_compact_->mark_stack_chunks_;
+      while (idx_ > 0) {
+        accounting::ObjectChunkedStack::Chunk* chunk = chunks->AllocChunk();
+        while (idx_ > 0 && !chunk->IsFull()) {
+          chunk->PushBack(roots_[--idx_].AsMirrorPtr());
+        }
+        chunks->PushChunk(chunk);
+      }
     }
-    DCHECK_EQ(start, end);
   }
 
   void Push(mirror::Object* obj) REQUIRES_SHARED(Locks::mutator_lock_)
@@ -3803,6 +4077,22 @@ void MarkCompact::UpdateAndMarkModUnion() {
 
 void MarkCompact::MarkReachableObjects() {
   UpdateAndMarkModUnion();
+  if (young_gen_) {
+    // The old-gen objects on dirty (now aged) cards are the roots for the
+    // young-gen, in addition to the immune spaces.
+    TimingLogger::ScopedTiming t("ScanOldGenCards", GetTimings());
+    accounting::CardTable* const card_table = heap_->GetCardTable();
+    card_table->Scan</*kClearCard*/ false>(moving_space_bitmap_,
+                                           bump_pointer_space_->Begin(),
+                                           old_gen_end_,
+                                           ScanObjectVisitor(this),
+                                           accounting::CardTable::kCardAged);
+    card_table->Scan</*kClearCard*/ false>(non_moving_space_bitmap_,
+                                           non_moving_space_->Begin(),
+                                           non_moving_space_->End(),
+                                           ScanObjectVisitor(this),
+                                           accounting::CardTable::kCardAged);
+  }
   // Recursively mark all the non-image bits set in the mark bitmap.
   ProcessMarkStack();
 }
@@ -3850,6 +4140,29 @@ void MarkCompact::ScanDirtyObjects(bool paused, uint8_t minimum_age) {
     TimingLogger::ScopedTiming t(name, GetTimings());
     ScanObjectVisitor visitor(this);
     const bool is_immune_space = space->IsZygoteSpace() || space->IsImageSpace();
+    // Beginning of the portion of the space whose cards can be cleared. In
+    // young-gen cycles the cards of the old-gen (the non-moving space and the
+    // old-gen portion of the moving space) must not be cleared as they are
+    // needed to find old-to-young references in future cycles. So only age
+    // them, visiting the objects on the cards that were dirty.
+    uint8_t* scan_begin = space->Begin();
+    if (young_gen_ && !is_immune_space) {
+      scan_begin = space == bump_pointer_space_
+                   ? AlignUp(old_gen_end_, accounting::CardTable::kCardSize)
+                   : space->End();
+      CardModifiedVisitor card_modified_visitor(this, space->GetMarkBitmap(), card_table);
+      card_table->ModifyCardsAtomic(space->Begin(),
+                                    scan_begin,
+                                    [](uint8_t card) {
+                                      return (card == gc::accounting::CardTable::kCardClean)
+                                              ? card
+                                              : gc::accounting::CardTable::kCardAged;
+                                    },
+                                    card_modified_visitor);
+      if (scan_begin >= space->End()) {
+        continue;
+      }
+    }
     if (paused) {
       DCHECK_EQ(minimum_age, gc::accounting::CardTable::kCardDirty);
       // We can clear the card-table for any non-immune space.
@@ -3861,7 +4174,7 @@ void MarkCompact::ScanDirtyObjects(bool paused, uint8_t minimum_age) {
                                               minimum_age);
       } else {
         card_table->Scan</*kClearCard*/true>(space->GetMarkBitmap(),
-                                             space->Begin(),
+                                             scan_begin,
                                              space->End(),
                                              visitor,
                                              minimum_age);
@@ -3893,7 +4206,7 @@ void MarkCompact::ScanDirtyObjects(bool paused, uint8_t minimum_age) {
                                         },
                                         card_modified_visitor);
         } else {
-          card_table->ModifyCardsAtomic(space->Begin(),
+          card_table->ModifyCardsAtomic(scan_begin,
                                         space->End(),
                                         AgeCardVisitor(),
                                         card_modified_visitor);
@@ -3944,7 +4257,15 @@ void MarkCompact::MarkingPhase() {
   DCHECK_EQ(thread_running_gc_, Thread::Current());
   WriterMutexLock mu(thread_running_gc_, *Locks::heap_bitmap_lock_);
   BindAndResetBitmaps();
-  MarkZygoteLargeObjects();
+  if (young_gen_) {
+    // Large objects are not collected in young-gen cycles.
+    space::LargeObjectSpace* const los = heap_->GetLargeObjectsSpace();
+    if (los != nullptr) {
+      los->CopyLiveToMarked();
+    }
+  } else {
+    MarkZygoteLargeObjects();
+  }
   MarkRoots(
         static_cast<VisitRootFlags>(kVisitRootFlagAllRoots | kVisitRootFlagStartLoggingNewRoots));
   MarkReachableObjects();
@@ -4017,26 +4338,38 @@ size_t MarkCompact::LiveWordsBitmap<kAlignment>::LiveBytesInBitmapWord(size_t ch
   return words * kAlignment;
 }
 
+template <bool kParallel>
 void MarkCompact::UpdateLivenessInfo(mirror::Object* obj, size_t obj_size) {
   DCHECK(obj != nullptr);
   DCHECK_EQ(obj_size, obj->SizeOf<kDefaultVerifyFlags>());
   uintptr_t obj_begin = reinterpret_cast<uintptr_t>(obj);
-  UpdateClassAfterObjectMap(obj);
+  UpdateClassAfterObjectMap<kParallel>(obj);
   size_t size = RoundUp(obj_size, kAlignment);
-  uintptr_t bit_index = live_words_bitmap_->SetLiveWords(obj_begin, size);
+  uintptr_t bit_index = live_words_bitmap_->SetLiveWords<kParallel>(obj_begin, size);
   size_t chunk_idx = (obj_begin - live_words_bitmap_->Begin()) / kOffsetChunkSize;
   // Compute the bit-index within the chunk-info vector word.
   bit_index %= kBitsPerVectorWord;
   size_t first_chunk_portion = std::min(size, (kBitsPerVectorWord - bit_index) * kAlignment);
+  // Only the first and the last chunks may be shared with other objects.
+  auto add_to_shared_chunk = [this](size_t idx, size_t bytes) ALWAYS_INLINE {
+    if (kParallel) {
+      reinterpret_cast<Atomic<uint32_t>*>(&chunk_info_vec_[idx])
+          ->fetch_add(bytes, std::memory_order_relaxed);
+    } else {
+      chunk_info_vec_[idx] += bytes;
+    }
+  };
 
-  chunk_info_vec_[chunk_idx++] += first_chunk_portion;
+  add_to_shared_chunk(chunk_idx++, first_chunk_portion);
   DCHECK_LE(first_chunk_portion, size);
   for (size -= first_chunk_portion; size > kOffsetChunkSize; size -= kOffsetChunkSize) {
     DCHECK_EQ(chunk_info_vec_[chunk_idx], 0u);
     chunk_info_vec_[chunk_idx++] = kOffsetChunkSize;
   }
-  chunk_info_vec_[chunk_idx] += size;
-  freed_objects_--;
+  add_to_shared_chunk(chunk_idx, size);
+  if (!kParallel) {
+    freed_objects_--;
+  }
 }
 
 template <bool kUpdateLiveWords>
@@ -4046,6 +4379,9 @@ void MarkCompact::ScanObject(mirror::Object* obj) {
   // here and pass that information to `UpdateLivenessInfo`.
   size_t obj_size = obj->SizeOf<kDefaultVerifyFlags>();
   bytes_scanned_ += obj_size;
+  if (UNLIKELY(survival_stats_ != nullptr)) {
+    survival_stats_->RecordSurvivor(obj->GetClass<kVerifyNone, kWithoutReadBarrier>(), obj_size);
+  }
 
   RefFieldsVisitor visitor(this);
   DCHECK(IsMarked(obj)) << "Scanning marked object " << obj << "\n" << heap_->DumpSpaces();
@@ -4055,31 +4391,266 @@ void MarkCompact::ScanObject(mirror::Object* obj) {
   obj->VisitReferences(visitor, visitor);
 }
 
+// Marking task executed by the heap's thread-pool workers as well as the GC
+// thread. Each task has a thread-local mark stack. The collector's mark-stack
+// and its chunks serve as the shared pool of work: a task publishes part of its
+// stack as a chunk when the local stack overflows or when other tasks are out
+// of work, and tasks which run out of work steal chunks, or take from the
+// mark-stack.
+class MarkCompact::ParallelMarkTask : public Task {
+ public:
+  explicit ParallelMarkTask(MarkCompact* mark_compact)
+      : mark_compact_(mark_compact),
+        mark_stack_pos_(0),
+        bytes_scanned_(0),
+        objects_scanned_(0),
+        moving_space_objects_(0) {}
+
+  // Capacity of the thread-local mark stack.
+  static constexpr size_t kMaxSize = 1 * KB;
+  // Maximum number of objects taken from, or handed over to idle tasks via, the
+  // shared mark-stack at a time.
+  static constexpr size_t kTransferSize = 128;
+  // Number of objects scanned between checks for idle tasks.
+  static constexpr size_t kIdleCheckInterval = 64;
+
+  void Run(Thread* self) override REQUIRES(Locks::heap_bitmap_lock_)
+                                  REQUIRES_SHARED(Locks::mutator_lock_) {
+    bool idle = false;
+    uint32_t backoff_count = 0;
+    {
+      MutexLock mu(self, mark_compact_->lock_);
+      mark_compact_->parallel_mark_tasks_++;
+    }
+    while (true) {
+      while (mark_stack_pos_ > 0) {
+        ScanObject(mark_stack_[--mark_stack_pos_].AsMirrorPtr());
+      }
+      // Busy tasks can steal without the lock. Idle ones must take the lock to
+      // leave the idle state together with taking work, or the others could
+      // conclude that marking is complete.
+      if (!idle && StealChunk()) {
+        continue;
+      }
+      {
+        MutexLock mu(self, mark_compact_->lock_);
+        accounting::ObjectStack* shared_stack = mark_compact_->mark_stack_;
+        if (StealChunk()) {
+          if (idle) {
+            idle = false;
+            mark_compact_->idle_mark_tasks_.fetch_sub(1, std::memory_order_relaxed);
+          }
+          backoff_count = 0;
+          continue;
+        }
+        if (!shared_stack->IsEmpty()) {
+          for (size_t count = std::min(shared_stack->Size(), kTransferSize); count > 0; count--) {
+            mark_stack_[mark_stack_pos_++].Assign(shared_stack->PopBack());
+          }
+          if (idle) {
+            idle = false;
+            mark_compact_->idle_mark_tasks_.fetch_sub(1, std::memory_order_relaxed);
+          }
+          backoff_count = 0;
+          continue;
+        }
+        if (!idle) {
+          idle = true;
+          mark_compact_->idle_mark_tasks_.fetch_add(1, std::memory_order_relaxed);
+        }
+        // Only non-idle tasks can add work to the shared mark-stack. So if all
+        // the tasks are idle, then marking is complete.
+        if (mark_compact_->idle_mark_tasks_.load(std::memory_order_relaxed) ==
+            mark_compact_->parallel_mark_tasks_) {
+          mark_compact_->bytes_scanned_ += bytes_scanned_;
+          mark_compact_->freed_objects_ -= moving_space_objects_;
+          break;
+        }
+      }
+      BackOff(backoff_count++);
+    }
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  class RefFieldsVisitor {
+   public:
+    ALWAYS_INLINE explicit RefFieldsVisitor(ParallelMarkTask* task) : task_(task) {}
+
+    ALWAYS_INLINE void operator()(mirror::Object* obj,
+                                  MemberOffset offset,
+                                  bool is_static ATTRIBUTE_UNUSED) const
+        REQUIRES(Locks::heap_bitmap_lock_)
+        REQUIRES_SHARED(Locks::mutator_lock_) {
+      task_->MarkObject(obj->GetFieldObject<mirror::Object>(offset), obj, offset);
+    }
+
+    void operator()(ObjPtr<mirror::Class> klass, ObjPtr<mirror::Reference> ref) const
+        REQUIRES(Locks::heap_bitmap_lock_)
+        REQUIRES_SHARED(Locks::mutator_lock_) {
+      task_->mark_compact_->DelayReferenceReferent(klass, ref);
+    }
+
+    void VisitRootIfNonNull(mirror::CompressedReference<mirror::Object>* root) const
+        REQUIRES(Locks::heap_bitmap_lock_)
+        REQUIRES_SHARED(Locks::mutator_lock_) {
+      if (!root->IsNull()) {
+        VisitRoot(root);
+      }
+    }
+
+    void VisitRoot(mirror::CompressedReference<mirror::Object>* root) const
+        REQUIRES(Locks::heap_bitmap_lock_)
+        REQUIRES_SHARED(Locks::mutator_lock_) {
+      task_->MarkObject(root->AsMirrorPtr(), nullptr, MemberOffset(0));
+    }
+
+   private:
+    ParallelMarkTask* const task_;
+  };
+
+  ALWAYS_INLINE void MarkObject(mirror::Object* obj, mirror::Object* holder, MemberOffset offset)
+      REQUIRES(Locks::heap_bitmap_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    if (obj != nullptr &&
+        mark_compact_->MarkObjectNonNullNoPush</*kParallel*/true>(obj, holder, offset)) {
+      if (UNLIKELY(mark_stack_pos_ == kMaxSize)) {
+        TransferToSharedStack(kMaxSize / 2);
+      }
+      mark_stack_[mark_stack_pos_++].Assign(obj);
+    }
+  }
+
+  void ScanObject(mirror::Object* obj) REQUIRES(Locks::heap_bitmap_lock_)
+                                       REQUIRES_SHARED(Locks::mutator_lock_) {
+    DCHECK(mark_compact_->IsMarked(obj)) << "Scanning unmarked object " << obj;
+    size_t obj_size = obj->SizeOf<kDefaultVerifyFlags>();
+    bytes_scanned_ += obj_size;
+    if (UNLIKELY(mark_compact_->survival_stats_ != nullptr)) {
+      mark_compact_->survival_stats_->RecordSurvivor(
+          obj->GetClass<kVerifyNone, kWithoutReadBarrier>(), obj_size);
+    }
+    if (mark_compact_->moving_space_bitmap_->HasAddress(obj)) {
+      mark_compact_->UpdateLivenessInfo</*kParallel*/true>(obj, obj_size);
+      moving_space_objects_++;
+    }
+    RefFieldsVisitor visitor(this);
+    obj->VisitReferences(visitor, visitor);
+    // Share work with idle tasks, if any.
+    if (UNLIKELY(++objects_scanned_ % kIdleCheckInterval == 0 &&
+                 mark_stack_pos_ > kTransferSize &&
+                 mark_compact_->idle_mark_tasks_.load(std::memory_order_relaxed) > 0)) {
+      TransferToSharedStack(kTransferSize);
+    }
+  }
+
+  // Publish 'count' entries from the top of the thread-local mark stack as
+  // chunks for other tasks to steal.
+  void TransferToSharedStack(size_t count) REQUIRES(Locks::heap_bitmap_lock_)
+                                           REQUIRES_SHARED(Locks::mutator_lock_) {
+    DCHECK_LE(count, mark_stack_pos_);
+    accounting::ObjectChunkedStack* chunks = mark_compact_->mark_stack_chunks_;
+    while (count > 0) {
+      accounting::ObjectChunkedStack::Chunk* chunk = chunks->AllocChunk();
+      for (; count > 0 && !chunk->IsFull(); count--) {
+        chunk->PushBack(mark_stack_[--mark_stack_pos_].AsMirrorPtr());
+      }
+      chunks->PushChunk(chunk);
+    }
+  }
+
+  // Move the references of a published chunk, if any, to the empty
+  // thread-local mark stack.
+  bool StealChunk() REQUIRES_SHARED(Locks::mutator_lock_) {
+    static_assert(accounting::ObjectChunkedStack::Chunk::kCapacity <= kMaxSize,
+                  "A chunk must fit in the thread-local mark stack");
+    DCHECK_EQ(mark_stack_pos_, 0u);
+    accounting::ObjectChunkedStack* chunks = mark_compact_->mark_stack_chunks_;
+    accounting::ObjectChunkedStack::Chunk* chunk = chunks->StealChunk();
+    if (chunk == nullptr) {
+      return false;
+    }
+    mark_stack_pos_ = chunk->Size();
+    std::copy(chunk->Begin(), chunk->End(), mark_stack_);
+    chunks->FreeChunk(chunk);
+    return true;
+  }
+
+  MarkCompact* const mark_compact_;
+  // Thread-local mark stack.
+  StackReference<mirror::Object> mark_stack_[kMaxSize];
+  size_t mark_stack_pos_;
+  uint64_t bytes_scanned_;
+  size_t objects_scanned_;
+  // Number of objects in the moving space which are found to be live by this
+  // task.
+  int32_t moving_space_objects_;
+};
+
+size_t MarkCompact::GetMarkingThreadCount() const {
+  ThreadPool* thread_pool = heap_->GetThreadPool();
+  // Leave the CPUs to the foreground apps when in background.
+  if (thread_pool == nullptr || !Runtime::Current()->InJankPerceptibleProcessState()) {
+    return 1;
+  }
+  const bool paused = Locks::mutator_lock_->IsExclusiveHeld(thread_running_gc_);
+  size_t thread_count =
+      paused ? heap_->GetParallelGCThreadCount() : heap_->GetConcGCThreadCount();
+  return std::min(thread_count, thread_pool->GetThreadCount()) + 1;
+}
+
+void MarkCompact::ProcessMarkStackParallel(size_t thread_count) {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  Thread* self = Thread::Current();
+  ThreadPool* thread_pool = heap_->GetThreadPool();
+  {
+    MutexLock mu(self, lock_);
+    parallel_mark_tasks_ = 0;
+    idle_mark_tasks_.store(0, std::memory_order_relaxed);
+  }
+  // Tasks start with an empty local stack and pick up the work from the
+  // mark-stack.
+  for (size_t i = 0; i < thread_count; i++) {
+    thread_pool->AddTask(self, new ParallelMarkTask(this));
+  }
+  thread_pool->SetMaxActiveWorkers(thread_count - 1);
+  thread_pool->StartWorkers(self);
+  thread_pool->Wait(self, /*do_work=*/true, /*may_hold_locks=*/true);
+  thread_pool->StopWorkers(self);
+  // Concurrent compaction requires all the workers to be active.
+  thread_pool->SetMaxActiveWorkers(thread_pool->GetThreadCount());
+  CHECK(mark_stack_->IsEmpty());
+  CHECK(mark_stack_chunks_->IsEmpty());
+}
+
 // Scan anything that's on the mark stack.
 void MarkCompact::ProcessMarkStack() {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  const size_t thread_count = GetMarkingThreadCount();
+  if (thread_count > 1 &&
+      mark_stack_->Size() + mark_stack_chunks_->Size() >= kMinimumParallelMarkStackSize) {
+    ProcessMarkStackParallel(thread_count);
+    return;
+  }
   // TODO: try prefetch like in CMS
-  while (!mark_stack_->IsEmpty()) {
+  while (!mark_stack_->IsEmpty() || mark_stack_chunks_->RefillInto(mark_stack_)) {
     mirror::Object* obj = mark_stack_->PopBack();
     DCHECK(obj != nullptr);
     ScanObject</*kUpdateLiveWords*/ true>(obj);
   }
 }
 
-void MarkCompact::ExpandMarkStack() {
-  const size_t new_size = mark_stack_->Capacity() * 2;
-  std::vector<StackReference<mirror::Object>> temp(mark_stack_->Begin(),
-                                                   mark_stack_->End());
-  mark_stack_->Resize(new_size);
-  for (auto& ref : temp) {
-    mark_stack_->PushBack(ref.AsMirrorPtr());
-  }
-  DCHECK(!mark_stack_->IsFull());
+void MarkCompact::SpillMarkStack() {
+  DCHECK(mark_stack_->IsFull());
+  mark_stack_chunks_->SpillFrom(mark_stack_, mark_stack_->Size() / 2);
 }
 
 inline void MarkCompact::PushOnMarkStack(mirror::Object* obj) {
   if (UNLIKELY(mark_stack_->IsFull())) {
-    ExpandMarkStack();
+    SpillMarkStack();
   }
   mark_stack_->PushBack(obj);
 }
@@ -4187,6 +4758,9 @@ mirror::Object* MarkCompact::IsMarked(mirror::Object* obj) {
     if (compacting_) {
       if (is_black) {
         return PostCompactBlackObjAddr(obj);
+      } else if (reinterpret_cast<uint8_t*>(obj) < moving_space_begin_) {
+        // Old-gen objects are not collected, nor moved, in young-gen cycles.
+        return obj;
       } else if (live_words_bitmap_->Test(obj)) {
         return PostCompactOldObjAddr(obj);
       } else {
@@ -4234,6 +4808,23 @@ void MarkCompact::DelayReferenceReferent(ObjPtr<mirror::Class> klass,
   heap_->GetReferenceProcessor()->DelayReferenceReferent(klass, ref, this);
 }
 
+void MarkCompact::PromoteCompactedObjects() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  // The compacted objects are densely packed starting from moving_space_begin_.
+  // As with BumpPointerSpace::Walk(), a null class indicates the end.
+  uint8_t* addr = moving_space_begin_;
+  while (addr < post_compact_end_) {
+    mirror::Object* obj = reinterpret_cast<mirror::Object*>(addr);
+    if (obj->GetClass<kDefaultVerifyFlags, kWithoutReadBarrier>() == nullptr) {
+      break;
+    }
+    moving_space_bitmap_->Set(obj);
+    old_gen_objects_++;
+    addr += RoundUp(obj->SizeOf(), kAlignment);
+  }
+  old_gen_end_ = addr;
+}
+
 void MarkCompact::FinishPhase() {
   GetCurrentIteration()->SetScannedBytes(bytes_scanned_);
   bool is_zygote = Runtime::Current()->IsZygote();
@@ -4260,7 +4851,17 @@ void MarkCompact::FinishPhase() {
   // case we need to ensure that we don't assert on this bitmap afterwards.
   // Also, we would still need to clear it here again as we may have to use the
   // bitmap for black-allocations (see UpdateMovingSpaceBlackAllocations()).
-  moving_space_bitmap_->Clear();
+  if (use_generational_) {
+    // Retain the mark-bits of the old-gen below moving_space_begin_, and set
+    // them for the objects promoted in this cycle.
+    moving_space_bitmap_->ClearRange(
+        reinterpret_cast<mirror::Object*>(moving_space_begin_),
+        reinterpret_cast<mirror::Object*>(bump_pointer_space_->Limit()));
+    ReaderMutexLock mu(thread_running_gc_, *Locks::mutator_lock_);
+    PromoteCompactedObjects();
+  } else {
+    moving_space_bitmap_->Clear();
+  }
 
   if (UNLIKELY(is_zygote && IsValidFd(uffd_))) {
     heap_->DeleteThreadPool();
@@ -4270,7 +4871,9 @@ void MarkCompact::FinishPhase() {
     uffd_initialized_ = false;
   }
   CHECK(mark_stack_->IsEmpty());  // Ensure that the mark stack is empty.
+  CHECK(mark_stack_chunks_->IsEmpty());
   mark_stack_->Reset();
+  mark_stack_chunks_->Reset();
   DCHECK_EQ(thread_running_gc_, Thread::Current());
   if (kIsDebugBuild) {
     MutexLock mu(thread_running_gc_, lock_);
@@ -32,6 +32,7 @@
 #include "garbage_collector.h"
 #include "gc/accounting/atomic_stack.h"
 #include "gc/accounting/bitmap-inl.h"
+#include "gc/accounting/chunked_stack.h"
 #include "gc/accounting/heap_bitmap.h"
 #include "gc_root.h"
 #include "immune_spaces.h"
@@ -48,6 +49,7 @@ class DexCache;
 namespace gc {
 
 class Heap;
+class SurvivalStats;
 
 namespace space {
 class BumpPointerSpace;
@@ -70,7 +72,7 @@ class MarkCompact final : public GarbageCollector {
   static constexpr SigbusCounterType kSigbusCounterCompactionDoneMask =
       1u << (BitSizeOf<SigbusCounterType>() - 1);
 
-  explicit MarkCompact(Heap* heap);
+  MarkCompact(Heap* heap, bool use_generational);
 
   ~MarkCompact() {}
 
@@ -88,9 +90,28 @@ class MarkCompact final : public GarbageCollector {
   bool SigbusHandler(siginfo_t* info) REQUIRES(!lock_) NO_THREAD_SAFETY_ANALYSIS;
 
   GcType GetGcType() const override {
-    return kGcTypeFull;
+    return young_gen_ ? kGcTypeSticky : kGcTypeFull;
   }
 
+  // Select between a young-gen (sticky) and a full cycle for the next run.
+  // A young-gen cycle is only possible if generational mode is enabled and a
+  // previous cycle has established an old generation. Must be called before
+  // Run().
+  void SetYoungGen(bool young_gen);
+
+  bool IsGenerational() const { return use_generational_; }
+
+  // Forget the old generation, forcing the next cycle to be a full one. Called
+  // when the moving space is evacuated outside of this collector, e.g. when
+  // creating the zygote space.
+  void ResetGenerations() REQUIRES(Locks::mutator_lock_);
+
+  // Book-keeping of full cycles so that Heap can compare young-gen throughput
+  // against full-heap throughput of the same collector instance.
+  void RecordFullGcIteration(const Iteration& iteration);
+  uint64_t GetEstimatedFullGcMeanThroughput() const;
+  size_t NumberOfFullGcIterations() const { return full_gc_count_; }
+
   CollectorType GetCollectorType() const override {
     return kCollectorTypeCMC;
   }
@@ -135,7 +156,8 @@ class MarkCompact final : public GarbageCollector {
 
   mirror::Object* GetFromSpaceAddrFromBarrier(mirror::Object* old_ref) {
     CHECK(compacting_);
-    if (live_words_bitmap_->HasAddress(old_ref)) {
+    if (live_words_bitmap_->HasAddress(old_ref) &&
+        reinterpret_cast<uint8_t*>(old_ref) >= moving_space_begin_) {
       return GetFromSpaceAddr(old_ref);
     }
     return old_ref;
@@ -196,7 +218,9 @@ class MarkCompact final : public GarbageCollector {
     // Return offset (within the indexed chunk-info) of the nth live word.
     uint32_t FindNthLiveWordOffset(size_t chunk_idx, uint32_t n) const;
     // Sets all bits in the bitmap corresponding to the given range. Also
-    // returns the bit-index of the first word.
+    // returns the bit-index of the first word. The atomic version is required
+    // when other threads may concurrently set bits of neighboring objects.
+    template <bool kAtomic = false>
     ALWAYS_INLINE uintptr_t SetLiveWords(uintptr_t begin, size_t size);
     // Count number of live words upto the given bit-index. This is to be used
     // to compute the post-compact address of an old reference.
@@ -306,6 +330,9 @@ class MarkCompact final : public GarbageCollector {
   // Compute offsets (in chunk_info_vec_) and other data structures required
   // during concurrent compaction.
   void PrepareForCompaction() REQUIRES_SHARED(Locks::mutator_lock_);
+  // Report the cycle to the heap's survival stats. 'live_end' is where the
+  // moving space's live objects end once compacted.
+  void RecordSurvival(uint8_t* live_end) REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Copy kPageSize live bytes starting from 'offset' (within the moving space),
   // which must be within 'obj', into the kPageSize sized memory pointed by 'addr'.
@@ -335,6 +362,18 @@ class MarkCompact final : public GarbageCollector {
       REQUIRES_SHARED(Locks::mutator_lock_);
   // Update all the references in the non-moving space.
   void UpdateNonMovingSpace() REQUIRES_SHARED(Locks::mutator_lock_);
+  // Update references in the old-gen portion of the moving space that is not
+  // being compacted in a young-gen cycle. Only objects on dirty or aged cards
+  // can hold references to the young-gen, so the rest is skipped.
+  void UpdateMovingSpaceOldGen() REQUIRES(Locks::mutator_lock_);
+  // Move the dirty cards of the compacted portion of the moving space to the
+  // post-compact addresses of the objects they cover, and drop the aged cards
+  // in the old-gen. Maintains the invariant that every old-gen object holding a
+  // reference to the young-gen is on a dirty card after the GC.
+  void UpdateCardsForGenerations() REQUIRES(Locks::mutator_lock_);
+  // Set the mark-bits of the objects compacted in this cycle, which are part of
+  // the old-gen from now on, and compute the new old-gen end.
+  void PromoteCompactedObjects() REQUIRES_SHARED(Locks::mutator_lock_);
 
   // For all the pages in non-moving space, find the first object that overlaps
   // with the pages' start address, and store in first_objs_non_moving_space_ array.
@@ -344,7 +383,14 @@ class MarkCompact final : public GarbageCollector {
   // copied to the page. The offsets are relative to the moving-space's
   // beginning. Store the computed first-object and offset in first_objs_moving_space_
   // and pre_compact_offset_moving_space_ respectively.
-  void InitMovingSpaceFirstObjects(const size_t vec_len) REQUIRES_SHARED(Locks::mutator_lock_);
+  // 'start_page_idx' is the index of the first page to be compacted, which is
+  // non-zero only in young-gen cycles.
+  void InitMovingSpaceFirstObjects(const size_t vec_len, const size_t start_page_idx)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+  // In young-gen cycles, compute moving_space_begin_ and make the old-gen
+  // objects lying on the first compacted page(s) part of the liveness info so
+  // that they stay in place.
+  void PrepareOldGenForCompaction() REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Gather the info related to black allocations from bump-pointer space to
   // enable concurrent sliding of these pages.
@@ -406,7 +452,16 @@ class MarkCompact final : public GarbageCollector {
   // Go through all the objects in the mark-stack until it's empty.
   void ProcessMarkStack() override REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(Locks::heap_bitmap_lock_);
-  void ExpandMarkStack() REQUIRES_SHARED(Locks::mutator_lock_)
+  // Drain the mark-stack using 'thread_count' threads, including the calling
+  // one, from the heap's thread pool.
+  void ProcessMarkStackParallel(size_t thread_count)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(Locks::heap_bitmap_lock_);
+  // Number of threads, including the GC thread, to be used for marking.
+  size_t GetMarkingThreadCount() const REQUIRES_SHARED(Locks::mutator_lock_);
+  // Make room on the full mark-stack by moving half of it to the mark-stack
+  // chunks.
+  void SpillMarkStack() REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(Locks::heap_bitmap_lock_);
 
   // Scan object for references. If kUpdateLivewords is true then set bits in
@@ -421,7 +476,10 @@ class MarkCompact final : public GarbageCollector {
 
   // Update the live-words bitmap as well as add the object size to the
   // chunk-info vector. Both are required for computation of post-compact addresses.
-  // Also updates freed_objects_ counter.
+  // Also updates freed_objects_ counter. The parallel version is safe to be
+  // invoked concurrently by marking threads, and leaves updating the
+  // freed_objects_ counter to the caller.
+  template <bool kParallel = false>
   void UpdateLivenessInfo(mirror::Object* obj, size_t obj_size)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -504,7 +562,9 @@ class MarkCompact final : public GarbageCollector {
 
   bool IsValidFd(int fd) const { return fd >= 0; }
   // Add/update <class, obj> pair if class > obj and obj is the lowest address
-  // object of class.
+  // object of class. The parallel version synchronizes on
+  // class_after_obj_map_lock_.
+  template <bool kParallel = false>
   ALWAYS_INLINE void UpdateClassAfterObjectMap(mirror::Object* obj)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -535,7 +595,20 @@ class MarkCompact final : public GarbageCollector {
   // when collecting thread-stack roots using checkpoint. Otherwise, we use it
   // to synchronize on updated_roots_ in debug-builds.
   Mutex lock_;
+  // Also serves as the shared pool of work for parallel marking, in which case
+  // it's guarded by lock_.
   accounting::ObjectStack* mark_stack_;
+  // Where the mark-stack spills to when it is full. Parallel-marking tasks also
+  // use it to share work without taking lock_.
+  accounting::ObjectChunkedStack* mark_stack_chunks_;
+  // Number of parallel-marking tasks which have started, and of those which
+  // are idle. Marking terminates when all started tasks are idle and the
+  // mark-stack is empty.
+  size_t parallel_mark_tasks_ GUARDED_BY(lock_);
+  Atomic<size_t> idle_mark_tasks_;
+  // Guards the class-after-object maps when updated by parallel-marking
+  // tasks.
+  Mutex class_after_obj_map_lock_;
   // Special bitmap wherein all the bits corresponding to an object are set.
   // TODO: make LiveWordsBitmap encapsulated in this class rather than a
   // pointer. We tend to access its members in performance-sensitive
@@ -753,6 +826,31 @@ class MarkCompact final : public GarbageCollector {
   // Flag indicating if we should use sigbus signals instead of threads to
   // handle userfaults.
   const bool use_uffd_sigbus_;
+  // True if generational mode is enabled, i.e. young-gen cycles, which compact
+  // only the objects allocated since the previous GC, are possible.
+  const bool use_generational_;
+  // True if the current cycle is a young-gen one. Set in SetYoungGen().
+  bool young_gen_;
+  // End of the old-gen in the moving space. Objects in [Begin, old_gen_end_)
+  // survived at least one GC and are densely packed. Null if there is no
+  // valid old-gen, in which case the next cycle must be a full one.
+  uint8_t* old_gen_end_;
+  // Beginning of the portion of the moving space compacted in this cycle.
+  // Same as the space's Begin() for full cycles. Objects below it are not
+  // moved and are treated as marked.
+  uint8_t* moving_space_begin_;
+  // Number of objects in the old-gen below moving_space_begin_. Required to
+  // compute freed_objects_ in young-gen cycles as these objects are never
+  // discovered by marking.
+  int32_t old_gen_objects_;
+  // Freed-bytes and duration of full cycles, used by Heap to decide between
+  // young-gen and full cycles.
+  int64_t full_gc_freed_bytes_;
+  uint64_t full_gc_duration_ns_;
+  size_t full_gc_count_;
+  // The heap's survival stats during a cycle if -XX:GcSurvivalStats is set,
+  // null otherwise.
+  SurvivalStats* survival_stats_;
   // For non-zygote processes this flag indicates if the spaces are ready to
   // start using userfaultfd's minor-fault feature. This initialization involves
   // starting to use shmem (memfd_create) for the userfaultfd protected spaces.
@@ -770,6 +868,7 @@ class MarkCompact final : public GarbageCollector {
   template<size_t kBufferSize> class ThreadRootsVisitor;
   class CardModifiedVisitor;
   class RefFieldsVisitor;
+  class ParallelMarkTask;
   template <bool kCheckBegin, bool kCheckEnd> class RefsUpdateVisitor;
   class ArenaPoolPageUpdater;
   class ClassLoaderRootsUpdater;
@@ -777,6 +876,8 @@ class MarkCompact final : public GarbageCollector {
   class ImmuneSpaceUpdateObjVisitor;
   class ConcurrentCompactionGcTask;
 
+  friend class MarkCompactTest;  // For old_gen_end_.
+
   DISALLOW_IMPLICIT_CONSTRUCTORS(MarkCompact);
 };
 
@@ -0,0 +1,236 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mark_compact.h"
+
+#include "class_linker-inl.h"
+#include "common_runtime_test.h"
+#include "gc/heap.h"
+#include "handle_scope-inl.h"
+#include "mirror/class-inl.h"
+#include "mirror/object-inl.h"
+#include "mirror/object_array-alloc-inl.h"
+#include "mirror/object_array-inl.h"
+#include "mirror/string-inl.h"
+#include "scoped_thread_state_change-inl.h"
+
+namespace art {
+namespace gc {
+namespace collector {
+
+class MarkCompactTest : public CommonRuntimeTest {
+ public:
+  MarkCompactTest() {
+    use_boot_image_ = true;  // Make the Runtime creation cheaper.
+  }
+
+  void SetUpRuntimeOptions(RuntimeOptions* options) override {
+    CommonRuntimeTest::SetUpRuntimeOptions(options);
+    options->push_back(std::make_pair("-Xgc:generational_cmc", nullptr));
+  }
+
+ protected:
+  // Runs a young-gen cycle and returns true if the collector didn't have to
+  // fall back to a full one.
+  static bool CollectYoungGen(Thread* self) REQUIRES_SHARED(Locks::mutator_lock_) {
+    Heap* heap = Runtime::Current()->GetHeap();
+    {
+      ScopedThreadSuspension sts(self, ThreadState::kNative);
+      heap->CollectGarbageInternal(kGcTypeSticky,
+                                   kGcCauseExplicit,
+                                   /* clear_soft_references= */ false,
+                                   Heap::GC_NUM_ANY);
+    }
+    return heap->MarkCompactCollector()->GetGcType() == kGcTypeSticky;
+  }
+
+  static bool IsInOldGen(ObjPtr<mirror::Object> obj) REQUIRES_SHARED(Locks::mutator_lock_) {
+    Heap* heap = Runtime::Current()->GetHeap();
+    uint8_t* addr = reinterpret_cast<uint8_t*>(obj.Ptr());
+    return heap->GetBumpPointerSpace()->HasAddress(obj.Ptr()) &&
+           addr < heap->MarkCompactCollector()->old_gen_end_;
+  }
+};
+
+TEST_F(MarkCompactTest, YoungGenPromotesSurvivors) {
+  Heap* heap = Runtime::Current()->GetHeap();
+  if (heap->CurrentCollectorType() != kCollectorTypeCMC ||
+      !heap->MarkCompactCollector()->IsGenerational()) {
+    GTEST_SKIP() << "Generational mark-compact collector is not in use";
+  }
+  constexpr size_t kNumStrings = 256;
+  constexpr size_t kNumGarbage = 1024;
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+  StackHandleScope<2> hs(self);
+  Handle<mirror::Class> array_class(
+      hs.NewHandle(class_linker_->FindSystemClass(self, "[Ljava/lang/Object;")));
+  Handle<mirror::ObjectArray<mirror::Object>> root(hs.NewHandle(
+      mirror::ObjectArray<mirror::Object>::Alloc(self, array_class.Get(), kNumStrings)));
+  ASSERT_TRUE(root != nullptr);
+  // A full cycle establishes the old-gen, which the root is part of afterwards.
+  {
+    ScopedThreadSuspension sts(self, ThreadState::kNative);
+    heap->CollectGarbage(/* clear_soft_references= */ false);
+  }
+  ASSERT_TRUE(IsInOldGen(root.Get()));
+
+  for (size_t i = 0; i < kNumStrings; ++i) {
+    ObjPtr<mirror::String> string =
+        mirror::String::AllocFromModifiedUtf8(self, std::to_string(i).c_str());
+    ASSERT_TRUE(string != nullptr);
+    ASSERT_FALSE(IsInOldGen(string));
+    root->Set<false>(i, string);
+  }
+  for (size_t i = 0; i < kNumGarbage; ++i) {
+    ASSERT_TRUE(mirror::String::AllocFromModifiedUtf8(self, "garbage") != nullptr);
+  }
+  ASSERT_TRUE(CollectYoungGen(self));
+  // The strings are reachable only through the old-gen root, i.e. the card
+  // table. They must have survived and been promoted.
+  EXPECT_TRUE(IsInOldGen(root.Get()));
+  for (size_t i = 0; i < kNumStrings; ++i) {
+    ObjPtr<mirror::Object> string = root->Get(i);
+    ASSERT_TRUE(IsInOldGen(string));
+    ASSERT_EQ(string->AsString()->ToModifiedUtf8(), std::to_string(i));
+  }
+  EXPECT_GE(heap->MarkCompactCollector()->GetCurrentIteration()->GetFreedObjects(), kNumGarbage);
+
+  // Replace half of the promoted strings with young ones, whose only
+  // references are on the cards dirtied since the last cycle. A further
+  // young-gen cycle must leave everything promoted so far in place.
+  for (size_t i = 0; i < kNumStrings; i += 2) {
+    ObjPtr<mirror::String> string =
+        mirror::String::AllocFromModifiedUtf8(self, std::to_string(i + kNumStrings).c_str());
+    ASSERT_TRUE(string != nullptr);
+    root->Set<false>(i, string);
+  }
+  ASSERT_TRUE(CollectYoungGen(self));
+  ASSERT_TRUE(CollectYoungGen(self));
+  for (size_t i = 0; i < kNumStrings; ++i) {
+    ObjPtr<mirror::Object> string = root->Get(i);
+    ASSERT_TRUE(IsInOldGen(string));
+    ASSERT_EQ(string->AsString()->ToModifiedUtf8(),
+              std::to_string(i % 2 == 0 ? i + kNumStrings : i));
+  }
+}
+
+// Parameterized by the number of GC threads, which is the number of heap
+// thread pool workers marking in parallel, both concurrently and in the pause.
+class MarkCompactParallelMarkingTest : public CommonRuntimeTestWithParam<size_t> {
+ public:
+  MarkCompactParallelMarkingTest() {
+    use_boot_image_ = true;  // Make the Runtime creation cheaper.
+  }
+
+  void SetUpRuntimeOptions(RuntimeOptions* options) override {
+    CommonRuntimeTestWithParam<size_t>::SetUpRuntimeOptions(options);
+    options->push_back(
+        std::make_pair("-XX:ConcGCThreads=" + std::to_string(GetParam()), nullptr));
+    options->push_back(
+        std::make_pair("-XX:ParallelGCThreads=" + std::to_string(GetParam()), nullptr));
+  }
+};
+
+TEST_P(MarkCompactParallelMarkingTest, MarkObjectGraph) {
+  Heap* heap = Runtime::Current()->GetHeap();
+  if (heap->CurrentCollectorType() != kCollectorTypeCMC) {
+    GTEST_SKIP() << "Mark-compact collector is not in use";
+  }
+  constexpr size_t kNumArrays = 256;
+  constexpr size_t kArrayLength = 1024;
+  constexpr size_t kNumShared = 16;
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+  StackHandleScope<3> hs(self);
+  Handle<mirror::Class> array_class(
+      hs.NewHandle(class_linker_->FindSystemClass(self, "[Ljava/lang/Object;")));
+  Handle<mirror::ObjectArray<mirror::Object>> root(hs.NewHandle(
+      mirror::ObjectArray<mirror::Object>::Alloc(self, array_class.Get(), kNumArrays)));
+  ASSERT_TRUE(root != nullptr);
+  // Strings referenced from every array, which the marking threads race to
+  // mark.
+  Handle<mirror::ObjectArray<mirror::Object>> shared(hs.NewHandle(
+      mirror::ObjectArray<mirror::Object>::Alloc(self, array_class.Get(), kNumShared)));
+  ASSERT_TRUE(shared != nullptr);
+  for (size_t i = 0; i < kNumShared; ++i) {
+    ObjPtr<mirror::String> string =
+        mirror::String::AllocFromModifiedUtf8(self, ("shared" + std::to_string(i)).c_str());
+    ASSERT_TRUE(string != nullptr);
+    shared->Set<false>(i, string);
+  }
+  // Every array but the first is reachable only from the previous one, making
+  // the graph deep as well as wide.
+  for (size_t i = 0; i < kNumArrays; ++i) {
+    ObjPtr<mirror::ObjectArray<mirror::Object>> array =
+        mirror::ObjectArray<mirror::Object>::Alloc(self, array_class.Get(), kArrayLength + 1);
+    ASSERT_TRUE(array != nullptr);
+    if (i == 0) {
+      root->Set<false>(0, array);
+    } else {
+      root->Get(i - 1)->AsObjectArray<mirror::Object>()->Set<false>(kArrayLength, array);
+      root->Set<false>(i, array);
+    }
+    for (size_t j = 0; j < kArrayLength; ++j) {
+      ObjPtr<mirror::Object> element;
+      if (j % 64 == 0) {
+        element = shared->Get((j / 64) % kNumShared);
+      } else {
+        element = mirror::String::AllocFromModifiedUtf8(
+            self, std::to_string(i * kArrayLength + j).c_str());
+        ASSERT_TRUE(element != nullptr);
+      }
+      // Reload the array as the allocation may have moved it.
+      root->Get(i)->AsObjectArray<mirror::Object>()->Set<false>(j, element);
+    }
+  }
+  // Only keep the head of the chain in the root.
+  for (size_t i = 1; i < kNumArrays; ++i) {
+    root->Set<false>(i, nullptr);
+  }
+  {
+    ScopedThreadSuspension sts(self, ThreadState::kNative);
+    heap->CollectGarbage(/* clear_soft_references= */ false);
+  }
+  ObjPtr<mirror::ObjectArray<mirror::Object>> array =
+      root->Get(0)->AsObjectArray<mirror::Object>();
+  for (size_t i = 0; i < kNumArrays; ++i) {
+    ASSERT_TRUE(array != nullptr);
+    ASSERT_EQ(array->GetLength(), static_cast<int32_t>(kArrayLength + 1));
+    for (size_t j = 0; j < kArrayLength; ++j) {
+      ObjPtr<mirror::Object> element = array->Get(j);
+      if (j % 64 == 0) {
+        ASSERT_EQ(element.Ptr(), shared->Get((j / 64) % kNumShared).Ptr());
+      } else {
+        ASSERT_EQ(element->AsString()->ToModifiedUtf8(), std::to_string(i * kArrayLength + j));
+      }
+    }
+    ObjPtr<mirror::Object> next = array->Get(kArrayLength);
+    array = next == nullptr ? nullptr : next->AsObjectArray<mirror::Object>();
+  }
+  EXPECT_TRUE(array == nullptr);
+}
+
+INSTANTIATE_TEST_CASE_P(SingleThreaded,
+                        MarkCompactParallelMarkingTest,
+                        testing::Values(0));
+INSTANTIATE_TEST_CASE_P(Parallel,
+                        MarkCompactParallelMarkingTest,
+                        testing::Values(2, 4));
+
+}  // namespace collector
+}  // namespace gc
+}  // namespace art
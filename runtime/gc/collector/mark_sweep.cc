@@ -32,6 +32,7 @@
 #include "base/time_utils.h"
 #include "base/timing_logger.h"
 #include "gc/accounting/card_table-inl.h"
+#include "gc/accounting/chunked_stack.h"
 #include "gc/accounting/heap_bitmap-inl.h"
 #include "gc/accounting/mod_union_table.h"
 #include "gc/accounting/space_bitmap-inl.h"
@@ -98,6 +99,7 @@ MarkSweep::MarkSweep(Heap* heap, bool is_concurrent, const std::string& name_pre
       current_space_bitmap_(nullptr),
       mark_bitmap_(nullptr),
       mark_stack_(nullptr),
+      mark_stack_chunks_(nullptr),
       gc_barrier_(new Barrier(0)),
       mark_stack_lock_("mark sweep mark stack lock", kMarkSweepMarkStackLock),
       is_concurrent_(is_concurrent),
@@ -117,6 +119,8 @@ void MarkSweep::InitializePhase() {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
   mark_stack_ = heap_->GetMarkStack();
   DCHECK(mark_stack_ != nullptr);
+  mark_stack_chunks_ = heap_->GetMarkStackChunks();
+  DCHECK(mark_stack_chunks_ != nullptr);
   immune_spaces_.Reset();
   no_reference_class_count_.store(0, std::memory_order_relaxed);
   normal_count_.store(0, std::memory_order_relaxed);
@@ -380,22 +384,17 @@ void MarkSweep::FindDefaultSpaceBitmap() {
       << heap_->DumpSpaces();
 }
 
-void MarkSweep::ExpandMarkStack() {
-  ResizeMarkStack(mark_stack_->Capacity() * 2);
-}
-
-void MarkSweep::ResizeMarkStack(size_t new_size) {
-  // Rare case, no need to have Thread::Current be a parameter.
+void MarkSweep::SpillMarkStack() {
   if (UNLIKELY(mark_stack_->Size() < mark_stack_->Capacity())) {
-    // Someone else acquired the lock and expanded the mark stack before us.
+    // Someone else acquired the lock and spilled the mark stack before us.
     return;
   }
-  std::vector<StackReference<mirror::Object>> temp(mark_stack_->Begin(), mark_stack_->End());
-  CHECK_LE(mark_stack_->Size(), new_size);
-  mark_stack_->Resize(new_size);
-  for (auto& obj : temp) {
-    mark_stack_->PushBack(obj.AsMirrorPtr());
-  }
+  // Unlike growing the mark stack, this copies a bounded amount and doesn't need a larger mapping.
+  mark_stack_chunks_->SpillFrom(mark_stack_, mark_stack_->Size() / 2);
+}
+
+bool MarkSweep::RefillMarkStack() {
+  return mark_stack_chunks_->RefillInto(mark_stack_);
 }
 
 mirror::Object* MarkSweep::MarkObject(mirror::Object* obj) {
@@ -408,7 +407,7 @@ inline void MarkSweep::MarkObjectNonNullParallel(mirror::Object* obj) {
   if (MarkObjectParallel(obj)) {
     MutexLock mu(Thread::Current(), mark_stack_lock_);
     if (UNLIKELY(mark_stack_->Size() >= mark_stack_->Capacity())) {
-      ExpandMarkStack();
+      SpillMarkStack();
     }
     // The object must be pushed on to the mark stack.
     mark_stack_->PushBack(obj);
@@ -531,7 +530,7 @@ inline void MarkSweep::PushOnMarkStack(mirror::Object* obj) {
   if (UNLIKELY(mark_stack_->Size() >= mark_stack_->Capacity())) {
     // Lock is not needed but is here anyways to please annotalysis.
     MutexLock mu(Thread::Current(), mark_stack_lock_);
-    ExpandMarkStack();
+    SpillMarkStack();
   }
   // The object must be pushed on to the mark stack.
   mark_stack_->PushBack(obj);
@@ -1336,7 +1335,8 @@ void MarkSweep::SweepLargeObjects(bool swap_bitmaps) {
   space::LargeObjectSpace* los = heap_->GetLargeObjectsSpace();
   if (los != nullptr) {
     TimingLogger::ScopedTiming split(__FUNCTION__, GetTimings());
-    RecordFreeLOS(los->Sweep(swap_bitmaps));
+    RecordFreeLOS(
+        los->Sweep(swap_bitmaps, heap_->GetThreadPool(), GetThreadCount(!IsConcurrent())));
   }
 }
 
@@ -1404,6 +1404,17 @@ void MarkSweep::ProcessMarkStackParallel(size_t thread_count) {
     thread_pool->AddTask(self, new MarkStackTask<false>(thread_pool, this, delta, it));
     it += delta;
   }
+  // Each spilled chunk makes a task of its own.
+  static_assert(accounting::ObjectChunkedStack::Chunk::kCapacity <=
+                    MarkStackTask<false>::kMaxSize,
+                "A chunk must fit in a task's mark stack");
+  for (accounting::ObjectChunkedStack::Chunk* chunk = mark_stack_chunks_->StealChunk();
+       chunk != nullptr;
+       chunk = mark_stack_chunks_->StealChunk()) {
+    thread_pool->AddTask(
+        self, new MarkStackTask<false>(thread_pool, this, chunk->Size(), chunk->Begin()));
+    mark_stack_chunks_->FreeChunk(chunk);
+  }
   thread_pool->SetMaxActiveWorkers(thread_count - 1);
   thread_pool->StartWorkers(self);
   thread_pool->Wait(self, true, true);
@@ -1419,7 +1430,7 @@ void MarkSweep::ProcessMarkStack(bool paused) {
   TimingLogger::ScopedTiming t(paused ? "(Paused)ProcessMarkStack" : __FUNCTION__, GetTimings());
   size_t thread_count = GetThreadCount(paused);
   if (kParallelProcessMarkStack && thread_count > 1 &&
-      mark_stack_->Size() >= kMinimumParallelMarkStackSize) {
+      mark_stack_->Size() + mark_stack_chunks_->Size() >= kMinimumParallelMarkStackSize) {
     ProcessMarkStackParallel(thread_count);
   } else {
     // TODO: Tune this.
@@ -1428,7 +1439,8 @@ void MarkSweep::ProcessMarkStack(bool paused) {
     for (;;) {
       mirror::Object* obj = nullptr;
       if (kUseMarkStackPrefetch) {
-        while (!mark_stack_->IsEmpty() && prefetch_fifo.size() < kFifoSize) {
+        while ((!mark_stack_->IsEmpty() || RefillMarkStack()) &&
+               prefetch_fifo.size() < kFifoSize) {
           mirror::Object* mark_stack_obj = mark_stack_->PopBack();
           DCHECK(mark_stack_obj != nullptr);
           __builtin_prefetch(mark_stack_obj);
@@ -1440,7 +1452,7 @@ void MarkSweep::ProcessMarkStack(bool paused) {
         obj = prefetch_fifo.front();
         prefetch_fifo.pop_front();
       } else {
-        if (mark_stack_->IsEmpty()) {
+        if (mark_stack_->IsEmpty() && !RefillMarkStack()) {
           break;
         }
         obj = mark_stack_->PopBack();
@@ -1496,7 +1508,9 @@ void MarkSweep::FinishPhase() {
         << " slowpath=" << mark_slowpath_count_.load(std::memory_order_relaxed);
   }
   CHECK(mark_stack_->IsEmpty());  // Ensure that the mark stack is empty.
+  CHECK(mark_stack_chunks_->IsEmpty());
   mark_stack_->Reset();
+  mark_stack_chunks_->Reset();
   Thread* const self = Thread::Current();
   ReaderMutexLock mu(self, *Locks::mutator_lock_);
   WriterMutexLock mu2(self, *Locks::heap_bitmap_lock_);
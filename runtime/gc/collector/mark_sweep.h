@@ -47,6 +47,8 @@ class Heap;
 namespace accounting {
 template<typename T> class AtomicStack;
 using ObjectStack = AtomicStack<mirror::Object>;
+template<typename T> class ChunkedStack;
+using ObjectChunkedStack = ChunkedStack<mirror::Object>;
 }  // namespace accounting
 
 namespace collector {
@@ -254,14 +256,14 @@ class MarkSweep : public GarbageCollector {
   void VerifySuspendedThreadRoots(std::ostream& os)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
-  // Expand mark stack to 2x its current size.
-  void ExpandMarkStack()
+  // Make room on the full mark stack by moving half of it to the mark stack chunks.
+  void SpillMarkStack()
       REQUIRES(mark_stack_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
-  void ResizeMarkStack(size_t new_size)
-      REQUIRES(mark_stack_lock_)
-      REQUIRES_SHARED(Locks::mutator_lock_);
+  // Move a spilled chunk back to the mark stack, which must have room for it. Returns false if
+  // there was none.
+  bool RefillMarkStack() REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Returns how many threads we should use for the current GC phase based on if we are paused,
   // whether or not we care about pauses.
@@ -313,6 +315,8 @@ class MarkSweep : public GarbageCollector {
   accounting::HeapBitmap* mark_bitmap_;
 
   accounting::ObjectStack* mark_stack_;
+  // Where the mark stack spills to when it is full.
+  accounting::ObjectChunkedStack* mark_stack_chunks_;
 
   // Every object inside the immune spaces is assumed to be marked. Immune spaces that aren't in the
   // immune region are handled by the normal marking logic.
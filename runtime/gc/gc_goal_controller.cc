@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gc_goal_controller.h"
+
+#include <algorithm>
+#include <ostream>
+
+#include "base/time_utils.h"
+
+namespace art {
+namespace gc {
+
+GcGoalController::GcGoalController(uint64_t pause_time_goal_ns, uint32_t cpu_goal_percent)
+    : pause_time_goal_ns_(pause_time_goal_ns),
+      cpu_goal_percent_(std::min(cpu_goal_percent, 100u)),
+      last_gc_end_time_ns_(0u),
+      gc_cpu_fraction_(0.0),
+      heap_growth_multiplier_(1.0),
+      concurrent_start_multiplier_(1.0),
+      sticky_gc_bias_(1.0),
+      missed_pause_goal_count_(0u),
+      gc_count_(0u) {}
+
+void GcGoalController::RecordGc(uint64_t end_time_ns,
+                                uint64_t duration_ns,
+                                uint64_t max_pause_ns) {
+  if (!IsEnabled()) {
+    return;
+  }
+  ++gc_count_;
+  if (cpu_goal_percent_ != 0 && last_gc_end_time_ns_ != 0 && end_time_ns > last_gc_end_time_ns_) {
+    // The GC ran during the interval since the previous one ended, so this is the fraction of
+    // that interval spent collecting.
+    double fraction = std::min(
+        1.0, static_cast<double>(duration_ns) / (end_time_ns - last_gc_end_time_ns_));
+    gc_cpu_fraction_ = gc_cpu_fraction_ * (1.0 - kCpuFractionSmoothing) +
+        fraction * kCpuFractionSmoothing;
+    const double goal = cpu_goal_percent_ / 100.0;
+    if (gc_cpu_fraction_ > goal) {
+      heap_growth_multiplier_ = std::min(heap_growth_multiplier_ * 1.2, kMaxHeapGrowthMultiplier);
+    } else if (gc_cpu_fraction_ < goal / 2) {
+      heap_growth_multiplier_ = std::max(heap_growth_multiplier_ / 1.1, 1.0);
+    }
+  }
+  last_gc_end_time_ns_ = end_time_ns;
+  if (pause_time_goal_ns_ != 0) {
+    if (max_pause_ns > pause_time_goal_ns_) {
+      ++missed_pause_goal_count_;
+      concurrent_start_multiplier_ =
+          std::min(concurrent_start_multiplier_ * 1.25, kMaxConcurrentStartMultiplier);
+      sticky_gc_bias_ = std::min(sticky_gc_bias_ * 1.1, kMaxStickyGcBias);
+    } else if (max_pause_ns < pause_time_goal_ns_ / 2) {
+      concurrent_start_multiplier_ = std::max(concurrent_start_multiplier_ / 1.1, 1.0);
+      sticky_gc_bias_ = std::max(sticky_gc_bias_ / 1.05, 1.0);
+    }
+  }
+}
+
+void GcGoalController::Dump(std::ostream& os) const {
+  if (!IsEnabled()) {
+    return;
+  }
+  os << "GC goals:";
+  if (pause_time_goal_ns_ != 0) {
+    os << " pause " << PrettyDuration(pause_time_goal_ns_) << " (missed "
+       << missed_pause_goal_count_ << "/" << gc_count_ << ")";
+  }
+  if (cpu_goal_percent_ != 0) {
+    os << " cpu " << cpu_goal_percent_ << "% (current " << gc_cpu_fraction_ * 100.0 << "%)";
+  }
+  os << " growth x" << heap_growth_multiplier_
+     << " concurrent start x" << concurrent_start_multiplier_
+     << " sticky bias x" << sticky_gc_bias_ << "\n";
+}
+
+}  // namespace gc
+}  // namespace art
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_GC_GC_GOAL_CONTROLLER_H_
+#define ART_RUNTIME_GC_GC_GOAL_CONTROLLER_H_
+
+#include <stdint.h>
+
+#include <iosfwd>
+
+#include "base/macros.h"
+
+namespace art {
+namespace gc {
+
+// Feedback controller for the -XX:GcPauseTimeGoalMs and -XX:GcCpuGoalPercent options. After
+// each GC the heap records the cycle's longest pause and its duration; the controller turns
+// these into multipliers that GrowForUtilization applies on top of the utilization based sizing:
+//  - When GC takes more than the CPU goal, the heap grows more so that collections run less
+//    often. Once GC is comfortably below the goal, the extra growth decays back.
+//  - When pauses exceed the pause goal, concurrent GCs start earlier so that they finish before
+//    mutators run out of memory and block, and sticky GCs are favored over full ones since their
+//    pauses are shorter.
+// All multipliers are 1.0 when no goal is set. Not thread safe; only used by the thread that
+// runs the GC.
+class GcGoalController {
+ public:
+  GcGoalController(uint64_t pause_time_goal_ns, uint32_t cpu_goal_percent);
+
+  bool IsEnabled() const {
+    return pause_time_goal_ns_ != 0 || cpu_goal_percent_ != 0;
+  }
+
+  // Record a finished GC cycle. `end_time_ns` is the NanoTime() at which it completed.
+  void RecordGc(uint64_t end_time_ns, uint64_t duration_ns, uint64_t max_pause_ns);
+
+  // Multiplier for the number of free bytes given to the heap after a GC.
+  double GetHeapGrowthMultiplier() const {
+    return heap_growth_multiplier_;
+  }
+
+  // Multiplier for the estimated bytes allocated during a concurrent GC, i.e. how early the
+  // next concurrent GC starts.
+  double GetConcurrentStartMultiplier() const {
+    return concurrent_start_multiplier_;
+  }
+
+  // Multiplier for the sticky GC throughput when choosing between sticky and full GCs.
+  double GetStickyGcBias() const {
+    return sticky_gc_bias_;
+  }
+
+  // Exponential moving average of the fraction of wall time spent in GC.
+  double GetGcCpuFraction() const {
+    return gc_cpu_fraction_;
+  }
+
+  void Dump(std::ostream& os) const;
+
+  static constexpr double kMaxHeapGrowthMultiplier = 4.0;
+  static constexpr double kMaxConcurrentStartMultiplier = 4.0;
+  static constexpr double kMaxStickyGcBias = 2.0;
+
+ private:
+  // Weight of the latest GC in the GC CPU fraction average.
+  static constexpr double kCpuFractionSmoothing = 0.3;
+
+  const uint64_t pause_time_goal_ns_;
+  const uint32_t cpu_goal_percent_;
+
+  uint64_t last_gc_end_time_ns_;
+  double gc_cpu_fraction_;
+  double heap_growth_multiplier_;
+  double concurrent_start_multiplier_;
+  double sticky_gc_bias_;
+  // Number of GCs which missed the pause time goal.
+  uint64_t missed_pause_goal_count_;
+  uint64_t gc_count_;
+
+  DISALLOW_COPY_AND_ASSIGN(GcGoalController);
+};
+
+}  // namespace gc
+}  // namespace art
+
+#endif  // ART_RUNTIME_GC_GC_GOAL_CONTROLLER_H_
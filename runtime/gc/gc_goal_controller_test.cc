@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gc_goal_controller.h"
+
+#include "base/time_utils.h"
+#include "gtest/gtest.h"
+
+namespace art {
+namespace gc {
+
+class GcGoalControllerTest : public testing::Test {};
+
+TEST_F(GcGoalControllerTest, DisabledByDefault) {
+  GcGoalController controller(0u, 0u);
+  EXPECT_FALSE(controller.IsEnabled());
+  for (uint64_t i = 1; i <= 10; ++i) {
+    controller.RecordGc(i * MsToNs(10), MsToNs(9), MsToNs(100));
+  }
+  EXPECT_EQ(controller.GetHeapGrowthMultiplier(), 1.0);
+  EXPECT_EQ(controller.GetConcurrentStartMultiplier(), 1.0);
+  EXPECT_EQ(controller.GetStickyGcBias(), 1.0);
+}
+
+TEST_F(GcGoalControllerTest, CpuGoal) {
+  GcGoalController controller(0u, 10u);
+  ASSERT_TRUE(controller.IsEnabled());
+  uint64_t now = MsToNs(1000);
+  // GC takes half of the time, well above the goal: the heap should grow.
+  for (size_t i = 0; i < 20; ++i) {
+    now += MsToNs(100);
+    controller.RecordGc(now, MsToNs(50), 0u);
+  }
+  EXPECT_GT(controller.GetGcCpuFraction(), 0.1);
+  EXPECT_EQ(controller.GetHeapGrowthMultiplier(), GcGoalController::kMaxHeapGrowthMultiplier);
+  // Pauses are not tracked without a pause goal.
+  EXPECT_EQ(controller.GetConcurrentStartMultiplier(), 1.0);
+  // GC becomes rare: the extra growth decays back.
+  for (size_t i = 0; i < 100; ++i) {
+    now += MsToNs(1000);
+    controller.RecordGc(now, MsToNs(1), 0u);
+  }
+  EXPECT_LT(controller.GetGcCpuFraction(), 0.05);
+  EXPECT_EQ(controller.GetHeapGrowthMultiplier(), 1.0);
+}
+
+TEST_F(GcGoalControllerTest, PauseGoal) {
+  GcGoalController controller(MsToNs(2), 0u);
+  ASSERT_TRUE(controller.IsEnabled());
+  uint64_t now = MsToNs(1000);
+  for (size_t i = 0; i < 3; ++i) {
+    now += MsToNs(100);
+    controller.RecordGc(now, MsToNs(10), MsToNs(5));
+  }
+  EXPECT_GT(controller.GetConcurrentStartMultiplier(), 1.0);
+  EXPECT_GT(controller.GetStickyGcBias(), 1.0);
+  EXPECT_LE(controller.GetStickyGcBias(), GcGoalController::kMaxStickyGcBias);
+  // Pauses around the goal keep the current adjustment.
+  double multiplier = controller.GetConcurrentStartMultiplier();
+  now += MsToNs(100);
+  controller.RecordGc(now, MsToNs(10), MsToNs(1) + MsToNs(1) / 2);
+  EXPECT_EQ(controller.GetConcurrentStartMultiplier(), multiplier);
+  // Short pauses let the adjustment decay.
+  for (size_t i = 0; i < 100; ++i) {
+    now += MsToNs(100);
+    controller.RecordGc(now, MsToNs(10), UsToNs(100));
+  }
+  EXPECT_EQ(controller.GetConcurrentStartMultiplier(), 1.0);
+  EXPECT_EQ(controller.GetStickyGcBias(), 1.0);
+  // The CPU goal is off.
+  EXPECT_EQ(controller.GetHeapGrowthMultiplier(), 1.0);
+}
+
+}  // namespace gc
+}  // namespace art
@@ -51,6 +51,7 @@
 #include "dex/dex_file-inl.h"
 #include "entrypoints/quick/quick_alloc_entrypoints.h"
 #include "gc/accounting/card_table-inl.h"
+#include "gc/accounting/chunked_stack.h"
 #include "gc/accounting/heap_bitmap-inl.h"
 #include "gc/accounting/mod_union_table-inl.h"
 #include "gc/accounting/read_barrier_table.h"
@@ -282,6 +283,8 @@ Heap::Heap(size_t initial_size,
            bool low_memory_mode,
            size_t long_pause_log_threshold,
            size_t long_gc_log_threshold,
+           uint64_t gc_pause_time_goal,
+           uint32_t gc_cpu_goal_percent,
            bool ignore_target_footprint,
            bool always_log_explicit_gcs,
            bool use_tlab,
@@ -295,9 +298,12 @@ Heap::Heap(size_t initial_size,
            bool measure_gc_performance,
            bool use_homogeneous_space_compaction_for_oom,
            bool use_generational_cc,
+           bool use_generational_cmc,
+           bool numa_aware_region_space,
            uint64_t min_interval_homogeneous_space_compaction_by_oom,
            bool dump_region_info_before_gc,
-           bool dump_region_info_after_gc)
+           bool dump_region_info_after_gc,
+           bool gc_survival_stats)
     : non_moving_space_(nullptr),
       rosalloc_space_(nullptr),
       dlmalloc_space_(nullptr),
@@ -312,6 +318,8 @@ Heap::Heap(size_t initial_size,
       low_memory_mode_(low_memory_mode),
       long_pause_log_threshold_(long_pause_log_threshold),
       long_gc_log_threshold_(long_gc_log_threshold),
+      goal_controller_(gc_pause_time_goal, gc_cpu_goal_percent),
+      survival_stats_(gc_survival_stats),
       process_cpu_start_time_ns_(ProcessCpuNanoTime()),
       pre_gc_last_process_cpu_time_ns_(process_cpu_start_time_ns_),
       post_gc_last_process_cpu_time_ns_(process_cpu_start_time_ns_),
@@ -392,8 +400,10 @@ Heap::Heap(size_t initial_size,
       max_gc_requested_(0u),
       pending_collector_transition_(nullptr),
       pending_heap_trim_(nullptr),
+      pending_large_object_release_(nullptr),
       use_homogeneous_space_compaction_for_oom_(use_homogeneous_space_compaction_for_oom),
       use_generational_cc_(use_generational_cc),
+      use_generational_cmc_(use_generational_cmc),
       running_collection_is_blocking_(false),
       blocking_gc_count_(0U),
       blocking_gc_time_(0U),
@@ -630,8 +640,10 @@ Heap::Heap(size_t initial_size,
     MemMap region_space_mem_map =
         space::RegionSpace::CreateMemMap(kRegionSpaceName, capacity_ * 2, request_begin);
     CHECK(region_space_mem_map.IsValid()) << "No region space mem map";
-    region_space_ = space::RegionSpace::Create(
-        kRegionSpaceName, std::move(region_space_mem_map), use_generational_cc_);
+    region_space_ = space::RegionSpace::Create(kRegionSpaceName,
+                                               std::move(region_space_mem_map),
+                                               use_generational_cc_,
+                                               numa_aware_region_space);
     AddSpace(region_space_);
   } else if (IsMovingGc(foreground_collector_type_)) {
     // Create bump pointer spaces.
@@ -734,6 +746,7 @@ Heap::Heap(size_t initial_size,
   num_bytes_allocated_.store(0, std::memory_order_relaxed);
   mark_stack_.reset(accounting::ObjectStack::Create("mark stack", kDefaultMarkStackSize,
                                                     kDefaultMarkStackSize));
+  mark_stack_chunks_.reset(accounting::ObjectChunkedStack::Create("mark stack chunks"));
   const size_t alloc_stack_capacity = max_allocation_stack_size_ + kAllocationStackReserveSize;
   allocation_stack_.reset(accounting::ObjectStack::Create(
       "allocation stack", max_allocation_stack_size_, alloc_stack_capacity));
@@ -775,7 +788,7 @@ Heap::Heap(size_t initial_size,
       garbage_collectors_.push_back(semi_space_collector_);
     }
     if (MayUseCollector(kCollectorTypeCMC)) {
-      mark_compact_ = new collector::MarkCompact(this);
+      mark_compact_ = new collector::MarkCompact(this, use_generational_cmc_);
       garbage_collectors_.push_back(mark_compact_);
     }
     if (MayUseCollector(kCollectorTypeCC)) {
@@ -1315,6 +1328,9 @@ void Heap::DumpGcPerformanceInfo(std::ostream& os) {
   os << "Total native bytes at last GC: "
      << old_native_bytes_allocated_.load(std::memory_order_relaxed) << "\n";
 
+  goal_controller_.Dump(os);
+  survival_stats_.Dump(os);
+
   BaseMutex::DumpAll(os);
 }
 
@@ -2257,6 +2273,9 @@ void Heap::ChangeCollector(CollectorType collector_type) {
         break;
       }
       case kCollectorTypeCMC: {
+        if (use_generational_cmc_) {
+          gc_plan_.push_back(collector::kGcTypeSticky);
+        }
         gc_plan_.push_back(collector::kGcTypeFull);
         if (use_tlab_) {
           ChangeAllocator(kAllocatorTypeTLAB);
@@ -2496,6 +2515,10 @@ void Heap::PreZygoteFork() {
         region_space_->GetMarkBitmap()->Clear();
       } else {
         bump_pointer_space_->GetMemMap()->Protect(PROT_READ | PROT_WRITE);
+        if (mark_compact_ != nullptr) {
+          // Evacuated everything out of the moving space, forget the old-gen.
+          mark_compact_->ResetGenerations();
+        }
       }
     }
     if (temp_space_ != nullptr) {
@@ -2775,6 +2798,8 @@ collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type,
         collector = semi_space_collector_;
         break;
       case kCollectorTypeCMC:
+        // The same collector instance performs both young-gen and full cycles.
+        mark_compact_->SetYoungGen(gc_type == collector::kGcTypeSticky);
         collector = mark_compact_;
         break;
       case kCollectorTypeCC:
@@ -2818,6 +2843,7 @@ collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type,
   collector->Run(gc_cause, clear_soft_references || runtime->IsZygote());
   IncrementFreedEver();
   RequestTrim(self);
+  RequestLargeObjectSpaceRelease(self);
   // Collect cleared references.
   SelfDeletingTask* clear = reference_processor_->CollectClearedReferences(self);
   // Grow the heap so that we know when to perform the next GC.
@@ -3700,8 +3726,17 @@ void Heap::GrowForUtilization(collector::GarbageCollector* collector_ran,
   uint64_t target_size, grow_bytes;
   collector::GcType gc_type = collector_ran->GetGcType();
   MutexLock mu(Thread::Current(), process_state_update_lock_);
+  if (goal_controller_.IsEnabled()) {
+    const std::vector<uint64_t>& pause_times = current_gc_iteration_.GetPauseTimes();
+    uint64_t max_pause = pause_times.empty()
+        ? 0u
+        : *std::max_element(pause_times.begin(), pause_times.end());
+    goal_controller_.RecordGc(NanoTime(), current_gc_iteration_.GetDurationNs(), max_pause);
+  }
   // Use the multiplier to grow more for foreground.
   const double multiplier = HeapGrowthMultiplier();
+  // Extra growth requested by the GC CPU goal; 1.0 without one.
+  const double goal_multiplier = goal_controller_.GetHeapGrowthMultiplier();
   if (gc_type != collector::kGcTypeSticky) {
     // Grow the heap for non sticky GC.
     uint64_t delta = bytes_allocated * (1.0 / GetTargetHeapUtilization() - 1.0);
@@ -3709,8 +3744,12 @@ void Heap::GrowForUtilization(collector::GarbageCollector* collector_ran,
         << " target_utilization_=" << target_utilization_;
     grow_bytes = std::min(delta, static_cast<uint64_t>(max_free_));
     grow_bytes = std::max(grow_bytes, static_cast<uint64_t>(min_free_));
+    grow_bytes = static_cast<uint64_t>(grow_bytes * goal_multiplier);
     target_size = bytes_allocated + static_cast<uint64_t>(grow_bytes * multiplier);
     next_gc_type_ = collector::kGcTypeSticky;
+    if (use_generational_cmc_ && collector_ran == mark_compact_) {
+      mark_compact_->RecordFullGcIteration(current_gc_iteration_);
+    }
   } else {
     collector::GcType non_sticky_gc_type = NonStickyGcType();
     // Find what the next non sticky collector will be.
@@ -3721,7 +3760,20 @@ void Heap::GrowForUtilization(collector::GarbageCollector* collector_ran,
       }
       CHECK(non_sticky_collector != nullptr);
     }
-    double sticky_gc_throughput_adjustment = GetStickyGcThroughputAdjustment(use_generational_cc_);
+    double sticky_gc_throughput_adjustment =
+        GetStickyGcThroughputAdjustment(use_generational_cc_ || use_generational_cmc_) *
+        goal_controller_.GetStickyGcBias();
+    // The CMC collector performs both young-gen and full cycles, so its mean
+    // throughput mixes the two. Compare against the full cycles only.
+    uint64_t non_sticky_throughput = 0;
+    size_t non_sticky_iterations = 0;
+    if (collector_ran == mark_compact_) {
+      non_sticky_throughput = mark_compact_->GetEstimatedFullGcMeanThroughput();
+      non_sticky_iterations = mark_compact_->NumberOfFullGcIterations();
+    } else {
+      non_sticky_throughput = non_sticky_collector->GetEstimatedMeanThroughput();
+      non_sticky_iterations = non_sticky_collector->NumberOfIterations();
+    }
 
     // If the throughput of the current sticky GC >= throughput of the non sticky collector, then
     // do another sticky collection next.
@@ -3731,15 +3783,15 @@ void Heap::GrowForUtilization(collector::GarbageCollector* collector_ran,
     // if the sticky GC throughput always remained >= the full/partial throughput.
     size_t target_footprint = target_footprint_.load(std::memory_order_relaxed);
     if (current_gc_iteration_.GetEstimatedThroughput() * sticky_gc_throughput_adjustment >=
-        non_sticky_collector->GetEstimatedMeanThroughput() &&
-        non_sticky_collector->NumberOfIterations() > 0 &&
+        non_sticky_throughput &&
+        non_sticky_iterations > 0 &&
         bytes_allocated <= (IsGcConcurrent() ? concurrent_start_bytes_ : target_footprint)) {
       next_gc_type_ = collector::kGcTypeSticky;
     } else {
       next_gc_type_ = non_sticky_gc_type;
     }
     // If we have freed enough memory, shrink the heap back down.
-    const size_t adjusted_max_free = static_cast<size_t>(max_free_ * multiplier);
+    const size_t adjusted_max_free = static_cast<size_t>(max_free_ * multiplier * goal_multiplier);
     if (bytes_allocated + adjusted_max_free < target_footprint) {
       target_size = bytes_allocated + adjusted_max_free;
       grow_bytes = max_free_;
@@ -3781,6 +3833,15 @@ void Heap::GrowForUtilization(collector::GarbageCollector* collector_ran,
       remaining_bytes = std::min(remaining_bytes, kMaxConcurrentRemainingBytes);
       remaining_bytes = std::max(remaining_bytes, kMinConcurrentRemainingBytes);
       size_t target_footprint = target_footprint_.load(std::memory_order_relaxed);
+      if (goal_controller_.GetConcurrentStartMultiplier() > 1.0) {
+        // Pauses are over the goal: start earlier so that the concurrent GC is done before the
+        // mutators run out of memory, but never earlier than halfway to the target footprint.
+        remaining_bytes = std::max(
+            remaining_bytes,
+            std::min(static_cast<size_t>(remaining_bytes *
+                                         goal_controller_.GetConcurrentStartMultiplier()),
+                     target_footprint / 2));
+      }
       if (UNLIKELY(remaining_bytes > target_footprint)) {
         // A never going to happen situation that from the estimated allocation rate we will exceed
         // the applications entire footprint with the given estimated allocation rate. Schedule
@@ -4035,6 +4096,44 @@ void Heap::RequestTrim(Thread* self) {
   task_processor_->AddTask(self, added_task);
 }
 
+class Heap::LargeObjectReleaseTask : public HeapTask {
+ public:
+  LargeObjectReleaseTask() : HeapTask(NanoTime()) { }
+  void Run(Thread* self) override {
+    gc::Heap* heap = Runtime::Current()->GetHeap();
+    // Clear first so that objects freed while we release get another task.
+    heap->ClearPendingLargeObjectRelease(self);
+    size_t released = heap->GetLargeObjectsSpace()->ReleasePendingPages(self);
+    VLOG(heap) << "Released " << PrettySize(released) << " of freed large objects";
+  }
+};
+
+void Heap::ClearPendingLargeObjectRelease(Thread* self) {
+  MutexLock mu(self, *pending_task_lock_);
+  pending_large_object_release_ = nullptr;
+}
+
+void Heap::RequestLargeObjectSpaceRelease(Thread* self) {
+  if (large_object_space_ == nullptr || large_object_space_->GetPendingReleaseBytes() == 0) {
+    return;
+  }
+  // The zygote releases right away so that the freed pages don't get inherited by the apps.
+  if (!CanAddHeapTask(self) || Runtime::Current()->IsZygote()) {
+    large_object_space_->ReleasePendingPages(self);
+    return;
+  }
+  LargeObjectReleaseTask* added_task = nullptr;
+  {
+    MutexLock mu(self, *pending_task_lock_);
+    if (pending_large_object_release_ != nullptr) {
+      return;
+    }
+    added_task = new LargeObjectReleaseTask();
+    pending_large_object_release_ = added_task;
+  }
+  task_processor_->AddTask(self, added_task);
+}
+
 void Heap::IncrementNumberOfBytesFreedRevoke(size_t freed_bytes_revoke) {
   size_t previous_num_bytes_freed_revoke =
       num_bytes_freed_revoke_.fetch_add(freed_bytes_revoke, std::memory_order_relaxed);
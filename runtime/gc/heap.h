@@ -37,7 +37,9 @@
 #include "gc/collector/mark_compact.h"
 #include "gc/collector_type.h"
 #include "gc/gc_cause.h"
+#include "gc/gc_goal_controller.h"
 #include "gc/space/large_object_space.h"
+#include "gc/survival_stats.h"
 #include "handle.h"
 #include "obj_ptr.h"
 #include "offsets.h"
@@ -78,6 +80,8 @@ class Verification;
 namespace accounting {
 template <typename T> class AtomicStack;
 using ObjectStack = AtomicStack<mirror::Object>;
+template <typename T> class ChunkedStack;
+using ObjectChunkedStack = ChunkedStack<mirror::Object>;
 class CardTable;
 class HeapBitmap;
 class ModUnionTable;
@@ -88,6 +92,7 @@ class RememberedSet;
 namespace collector {
 class ConcurrentCopying;
 class GarbageCollector;
+class MarkCompactTest;
 class MarkSweep;
 class SemiSpace;
 }  // namespace collector
@@ -215,6 +220,8 @@ class Heap {
        bool low_memory_mode,
        size_t long_pause_threshold,
        size_t long_gc_threshold,
+       uint64_t gc_pause_time_goal,
+       uint32_t gc_cpu_goal_percent,
        bool ignore_target_footprint,
        bool always_log_explicit_gcs,
        bool use_tlab,
@@ -228,9 +235,12 @@ class Heap {
        bool measure_gc_performance,
        bool use_homogeneous_space_compaction,
        bool use_generational_cc,
+       bool use_generational_cmc,
+       bool numa_aware_region_space,
        uint64_t min_interval_homogeneous_space_compaction_by_oom,
        bool dump_region_info_before_gc,
-       bool dump_region_info_after_gc);
+       bool dump_region_info_after_gc,
+       bool gc_survival_stats);
 
   ~Heap();
 
@@ -802,6 +812,9 @@ class Heap {
   TaskProcessor* GetTaskProcessor() {
     return task_processor_.get();
   }
+  SurvivalStats* GetSurvivalStats() {
+    return &survival_stats_;
+  }
 
   bool HasZygoteSpace() const {
     return zygote_space_ != nullptr;
@@ -856,6 +869,10 @@ class Heap {
   // Request an asynchronous trim.
   void RequestTrim(Thread* self) REQUIRES(!*pending_task_lock_);
 
+  // Request the pages of the large objects freed by the GC to be returned to the kernel, which is
+  // done right away if there is no heap task thread to do it in the background.
+  void RequestLargeObjectSpaceRelease(Thread* self) REQUIRES(!*pending_task_lock_);
+
   // Retrieve the current GC number, i.e. the number n such that we completed n GCs so far.
   // Provides acquire ordering, so that if we read this first, and then check whether a GC is
   // required, we know that the GC number read actually preceded the test.
@@ -997,6 +1014,7 @@ class Heap {
   class ConcurrentGCTask;
   class CollectorTransitionTask;
   class HeapTrimTask;
+  class LargeObjectReleaseTask;
   class TriggerPostForkCCGcTask;
   class ReduceTargetFootprintTask;
 
@@ -1061,6 +1079,10 @@ class Heap {
     return mark_stack_.get();
   }
 
+  accounting::ObjectChunkedStack* GetMarkStackChunks() {
+    return mark_stack_chunks_.get();
+  }
+
   // We don't force this to be inlined since it is a slow path.
   template <bool kInstrumented, typename PreFenceVisitor>
   mirror::Object* AllocLargeObject(Thread* self,
@@ -1227,6 +1249,7 @@ class Heap {
       REQUIRES(!*gc_complete_lock_, !*pending_task_lock_, !process_state_update_lock_);
 
   void ClearPendingTrim(Thread* self) REQUIRES(!*pending_task_lock_);
+  void ClearPendingLargeObjectRelease(Thread* self) REQUIRES(!*pending_task_lock_);
   void ClearPendingCollectorTransition(Thread* self) REQUIRES(!*pending_task_lock_);
 
   // What kind of concurrency behavior is the runtime after? Currently true for concurrent mark
@@ -1362,6 +1385,14 @@ class Heap {
   // If we get a GC longer than long GC log threshold, then we print out the GC after it finishes.
   const size_t long_gc_log_threshold_;
 
+  // Adjusts heap growth and GC scheduling for the -XX:GcPauseTimeGoalMs and -XX:GcCpuGoalPercent
+  // goals. Only updated by the GC thread in GrowForUtilization.
+  GcGoalController goal_controller_;
+
+  // Survival by age, promotion and survivor classes for -XX:GcSurvivalStats. Fed by the
+  // collectors.
+  SurvivalStats survival_stats_;
+
   // Starting time of the new process; meant to be used for measuring total process CPU time.
   uint64_t process_cpu_start_time_ns_;
 
@@ -1545,6 +1576,8 @@ class Heap {
 
   // Mark stack that we reuse to avoid re-allocating the mark stack.
   std::unique_ptr<accounting::ObjectStack> mark_stack_;
+  // Chunks that the mark stack spills into when full, rather than being resized.
+  std::unique_ptr<accounting::ObjectChunkedStack> mark_stack_chunks_;
 
   // Allocation stack, new allocations go here so that we can do sticky mark bits. This enables us
   // to use the live bitmap as the old mark bitmap.
@@ -1644,6 +1677,7 @@ class Heap {
   // Active tasks which we can modify (change target time, desired collector type, etc..).
   CollectorTransitionTask* pending_collector_transition_ GUARDED_BY(pending_task_lock_);
   HeapTrimTask* pending_heap_trim_ GUARDED_BY(pending_task_lock_);
+  LargeObjectReleaseTask* pending_large_object_release_ GUARDED_BY(pending_task_lock_);
 
   // Whether or not we use homogeneous space compaction to avoid OOM errors.
   bool use_homogeneous_space_compaction_for_oom_;
@@ -1653,6 +1687,12 @@ class Heap {
   // for major collections. Set in Heap constructor.
   const bool use_generational_cc_;
 
+  // If true, enable generational collection when using the Concurrent
+  // Mark-Compact (CMC) collector, i.e. use young-gen CMC, which only compacts
+  // the objects allocated since the previous GC, for minor collections and
+  // (full) CMC for major collections. Set in Heap constructor.
+  const bool use_generational_cmc_;
+
   // True if the currently running collection has made some thread wait.
   bool running_collection_is_blocking_ GUARDED_BY(gc_complete_lock_);
   // The number of blocking GC runs.
@@ -1723,6 +1763,7 @@ class Heap {
   friend class collector::GarbageCollector;
   friend class collector::ConcurrentCopying;
   friend class collector::MarkCompact;
+  friend class collector::MarkCompactTest;  // For CollectGarbageInternal.
   friend class collector::MarkSweep;
   friend class collector::SemiSpace;
   friend class GCCriticalSection;
@@ -40,6 +40,8 @@ namespace art {
 namespace gc {
 
 static constexpr bool kAsyncReferenceQueueAdd = false;
+// Whether GetReferent returns marked referents without taking reference_processor_lock_.
+static constexpr bool kMarkedReferentFastPath = true;
 
 ReferenceProcessor::ReferenceProcessor()
     : collector_(nullptr),
@@ -102,6 +104,25 @@ ObjPtr<mirror::Object> ReferenceProcessor::GetReferent(Thread* self,
   if (referent.IsNull()) {
     return referent;
   }
+  const bool other_read_barrier = !kUseBakerReadBarrier && gUseReadBarrier;
+  if (kMarkedReferentFastPath && !other_read_barrier &&
+      !reference->IsFinalizerReferenceInstance() &&
+      rp_state_.load(std::memory_order_acquire) == RpState::kInitMarkingDone) {
+    // Marking is done and nothing has been cleared or marked through finalizers yet, so the mark
+    // state predicts the return value as in the locked kInitMarkingDone case below. Re-load the
+    // referent for the same reason as there, and use the result only if the state didn't move on
+    // meanwhile, seqlock style. The release fence in ProcessReferences pairs with the acquire
+    // fence here: if IsMarked saw any marking through finalizers, the re-check sees the new state.
+    DCHECK(collector_ != nullptr);
+    referent = reference->GetReferent<kWithoutReadBarrier>();
+    ObjPtr<mirror::Object> forwarded_ref =
+        referent.IsNull() ? nullptr : collector_->IsMarked(referent.Ptr());
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (forwarded_ref != nullptr &&
+        rp_state_.load(std::memory_order_relaxed) == RpState::kInitMarkingDone) {
+      return forwarded_ref;
+    }
+  }
 
   bool started_trace = false;
   uint64_t start_millis;
@@ -118,9 +139,9 @@ ObjPtr<mirror::Object> ReferenceProcessor::GetReferent(Thread* self,
   // Keeping reference_processor_lock_ blocks the broadcast when we try to reenable the fast path.
   while (slow_path_required()) {
     DCHECK(collector_ != nullptr);
-    const bool other_read_barrier = !kUseBakerReadBarrier && gUseReadBarrier;
+    const RpState rp_state = rp_state_.load(std::memory_order_relaxed);
     if (UNLIKELY(reference->IsFinalizerReferenceInstance()
-                 || rp_state_ == RpState::kStarting /* too early to determine mark state */
+                 || rp_state == RpState::kStarting /* too early to determine mark state */
                  || (other_read_barrier && reference->IsPhantomReferenceInstance()))) {
       // Odd cases in which it doesn't hurt to just wait, or the wait is likely to be very brief.
 
@@ -137,14 +158,14 @@ ObjPtr<mirror::Object> ReferenceProcessor::GetReferent(Thread* self,
     }
     DCHECK(!reference->IsPhantomReferenceInstance());
 
-    if (rp_state_ == RpState::kInitClearingDone) {
+    if (rp_state == RpState::kInitClearingDone) {
       // Reachable references have their final referent values.
       break;
     }
     // Although reference processing is not done, we can always predict the correct return value
     // based on the current mark state. No additional marking from finalizers has been done, since
     // we hold reference_processor_lock_, which is required to advance to kInitClearingDone.
-    DCHECK(rp_state_ == RpState::kInitMarkingDone);
+    DCHECK(rp_state == RpState::kInitMarkingDone || rp_state == RpState::kClearingStarted);
     // Re-load and re-check referent, since the current one may have been read before we acquired
     // reference_lock. In particular a Reference.clear() call may have intervened. (b/33569625)
     referent = reference->GetReferent<kWithoutReadBarrier>();
@@ -192,7 +213,7 @@ void ReferenceProcessor::Setup(Thread* self,
   DCHECK(collector != nullptr);
   MutexLock mu(self, *Locks::reference_processor_lock_);
   collector_ = collector;
-  rp_state_ = RpState::kStarting;
+  rp_state_.store(RpState::kStarting, std::memory_order_relaxed);
   concurrent_ = concurrent;
   clear_soft_references_ = clear_soft_references;
 }
@@ -216,8 +237,9 @@ void ReferenceProcessor::ProcessReferences(Thread* self, TimingLogger* timings)
       // Weak ref access is enabled at Zygote compaction by SemiSpace (concurrent_ == false).
       CHECK_EQ(!self->GetWeakRefAccessEnabled(), concurrent_);
     }
-    DCHECK(rp_state_ == RpState::kStarting);
-    rp_state_ = RpState::kInitMarkingDone;
+    DCHECK(rp_state_.load(std::memory_order_relaxed) == RpState::kStarting);
+    // Publishes the mark state to GetReferent's fast path.
+    rp_state_.store(RpState::kInitMarkingDone, std::memory_order_release);
     condition_.Broadcast(self);
   }
   if (kIsDebugBuild && collector_->IsTransactionActive()) {
@@ -228,6 +250,10 @@ void ReferenceProcessor::ProcessReferences(Thread* self, TimingLogger* timings)
     DCHECK(finalizer_reference_queue_.IsEmpty());
     DCHECK(phantom_reference_queue_.IsEmpty());
   }
+  // Take GetReferent off its fast path before clearing anything. The fence orders the state
+  // change before the clearing and the marking through finalizers.
+  rp_state_.store(RpState::kClearingStarted, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
   // Clear all remaining soft and weak references with white referents.
   // This misses references only reachable through finalizers.
   soft_reference_queue_.ClearWhiteReferences(&cleared_references_, collector_);
@@ -238,7 +264,7 @@ void ReferenceProcessor::ProcessReferences(Thread* self, TimingLogger* timings)
     // then it is now safe to return, since it can only refer to marked objects. If it becomes
     // marked below, that is no longer guaranteed.
     MutexLock mu(self, *Locks::reference_processor_lock_);
-    rp_state_ = RpState::kInitClearingDone;
+    rp_state_.store(RpState::kInitClearingDone, std::memory_order_relaxed);
     // At this point, all mutator-accessible data is marked (black). Objects enqueued for
     // finalization will only be made available to the mutator via CollectClearedReferences after
     // we're fully done marking. Soft and WeakReferences accessible to the mutator have been
@@ -17,6 +17,7 @@
 #ifndef ART_RUNTIME_GC_REFERENCE_PROCESSOR_H_
 #define ART_RUNTIME_GC_REFERENCE_PROCESSOR_H_
 
+#include "base/atomic.h"
 #include "base/locks.h"
 #include "jni.h"
 #include "reference_queue.h"
@@ -67,8 +68,10 @@ class ReferenceProcessor {
   // GetReferent fast path as an optimization.
   void EnableSlowPath() REQUIRES_SHARED(Locks::mutator_lock_);
   void BroadcastForSlowPath(Thread* self);
-  // Decode the referent, may block if references are being processed. In the normal
-  // no-read-barrier or Baker-read-barrier cases, we assume reference is not a PhantomReference.
+  // Decode the referent, may block if references are being processed. Referents found marked
+  // after initial marking, but before any clearing, are returned without taking the lock. In the
+  // normal no-read-barrier or Baker-read-barrier cases, we assume reference is not a
+  // PhantomReference.
   ObjPtr<mirror::Object> GetReferent(Thread* self, ObjPtr<mirror::Reference> reference)
       REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!Locks::reference_processor_lock_);
   // Collects the cleared references and returns a task, to be executed after FinishGC, that will
@@ -106,9 +109,17 @@ class ReferenceProcessor {
   // it.
   collector::GarbageCollector* collector_;
   // Reference processor state. Only valid while weak reference processing is suspended.
-  // Used by GetReferent and friends to return early.
-  enum class RpState : uint8_t { kStarting, kInitMarkingDone, kInitClearingDone };
-  RpState rp_state_ GUARDED_BY(Locks::reference_processor_lock_);
+  // Used by GetReferent and friends to return early. kClearingStarted is set once soft and weak
+  // references with white referents start getting cleared.
+  enum class RpState : uint8_t {
+    kStarting,
+    kInitMarkingDone,
+    kClearingStarted,
+    kInitClearingDone,
+  };
+  // Only changed by the GC thread, and only under reference_processor_lock_ but for the move to
+  // kClearingStarted. GetReferent's fast path reads it without the lock.
+  Atomic<RpState> rp_state_;
   bool concurrent_;  // Running concurrently with mutator? Only used by GC thread.
   bool clear_soft_references_;  // Only used by GC thread.
 
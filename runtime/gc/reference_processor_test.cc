@@ -0,0 +1,254 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "reference_processor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include "base/time_utils.h"
+#include "common_runtime_test.h"
+#include "gc/heap.h"
+#include "handle_scope-inl.h"
+#include "jni/java_vm_ext.h"
+#include "mirror/class-alloc-inl.h"
+#include "mirror/class-inl.h"
+#include "mirror/object-inl.h"
+#include "mirror/object_array-alloc-inl.h"
+#include "mirror/object_array-inl.h"
+#include "mirror/reference-inl.h"
+#include "mirror/string-inl.h"
+#include "scoped_thread_state_change-inl.h"
+
+namespace art {
+namespace gc {
+
+class ReferenceProcessorTest : public CommonRuntimeTest {
+ protected:
+  ReferenceProcessorTest() {
+    use_boot_image_ = true;  // Make the Runtime creation cheaper.
+  }
+};
+
+// Calls Reference.get() on weak references with live referents from another
+// thread while the GC runs, and measures how long the calls stall.
+TEST_F(ReferenceProcessorTest, GetReferentStallTime) {
+  constexpr size_t kNumReferences = 1024;
+  constexpr size_t kNumGcs = 10;
+  constexpr size_t kBatchSize = 256;
+  Runtime* runtime = Runtime::Current();
+  Thread* self = Thread::Current();
+  jobject references_global;
+  jobject referents_global;
+  {
+    ScopedObjectAccess soa(self);
+    StackHandleScope<4> hs(self);
+    ClassLinker* class_linker = runtime->GetClassLinker();
+    Handle<mirror::Class> ref_class(hs.NewHandle(
+        class_linker->FindSystemClass(self, "Ljava/lang/ref/WeakReference;")));
+    ASSERT_TRUE(ref_class != nullptr);
+    Handle<mirror::Class> array_class(hs.NewHandle(
+        class_linker->FindSystemClass(self, "[Ljava/lang/Object;")));
+    ASSERT_TRUE(array_class != nullptr);
+    Handle<mirror::ObjectArray<mirror::Object>> references(hs.NewHandle(
+        mirror::ObjectArray<mirror::Object>::Alloc(self, array_class.Get(), kNumReferences)));
+    ASSERT_TRUE(references != nullptr);
+    // Keeps the referents strongly reachable.
+    Handle<mirror::ObjectArray<mirror::Object>> referents(hs.NewHandle(
+        mirror::ObjectArray<mirror::Object>::Alloc(self, array_class.Get(), kNumReferences)));
+    ASSERT_TRUE(referents != nullptr);
+    for (size_t i = 0; i < kNumReferences; ++i) {
+      ObjPtr<mirror::String> referent =
+          mirror::String::AllocFromModifiedUtf8(self, std::to_string(i).c_str());
+      ASSERT_TRUE(referent != nullptr);
+      referents->Set</* kTransactionActive= */ false>(i, referent);
+      ObjPtr<mirror::Reference> reference = ref_class->AllocObject(self)->AsReference();
+      ASSERT_TRUE(reference != nullptr);
+      reference->SetReferent</* kTransactionActive= */ false>(referents->Get(i));
+      references->Set</* kTransactionActive= */ false>(i, reference);
+    }
+    references_global = soa.Vm()->AddGlobalRef(self, references.Get());
+    referents_global = soa.Vm()->AddGlobalRef(self, referents.Get());
+  }
+
+  std::atomic<bool> done(false);
+  std::atomic<size_t> num_cleared(0);
+  uint64_t num_gets = 0;
+  uint64_t total_ns = 0;
+  uint64_t max_ns = 0;
+  std::thread reader([&]() {
+    CHECK(runtime->AttachCurrentThread("GetReferent stall test thread",
+                                       /* as_daemon= */ false,
+                                       /* thread_group= */ nullptr,
+                                       /* create_peer= */ false));
+    Thread* reader_self = Thread::Current();
+    ReferenceProcessor* rp = runtime->GetHeap()->GetReferenceProcessor();
+    while (!done.load(std::memory_order_relaxed)) {
+      // Release the mutator lock between batches so that the GC can make progress.
+      ScopedObjectAccess soa(reader_self);
+      ObjPtr<mirror::ObjectArray<mirror::Object>> references =
+          soa.Decode<mirror::ObjectArray<mirror::Object>>(references_global);
+      for (size_t i = 0; i < kBatchSize; ++i) {
+        ObjPtr<mirror::Reference> reference =
+            references->Get((num_gets + i) % kNumReferences)->AsReference();
+        uint64_t start = NanoTime();
+        ObjPtr<mirror::Object> referent = rp->GetReferent(reader_self, reference);
+        uint64_t duration = NanoTime() - start;
+        total_ns += duration;
+        max_ns = std::max(max_ns, duration);
+        if (referent == nullptr) {
+          num_cleared.fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+      num_gets += kBatchSize;
+    }
+    runtime->DetachCurrentThread();
+  });
+
+  uint64_t gc_start = NanoTime();
+  {
+    ScopedThreadSuspension sts(self, ThreadState::kNative);
+    for (size_t i = 0; i < kNumGcs; ++i) {
+      runtime->GetHeap()->CollectGarbage(/* clear_soft_references= */ false);
+    }
+  }
+  uint64_t gc_duration = NanoTime() - gc_start;
+  done.store(true, std::memory_order_relaxed);
+  reader.join();
+
+  // The referents were strongly reachable all along.
+  EXPECT_EQ(num_cleared.load(), 0u);
+  EXPECT_GT(num_gets, 0u);
+  LOG(INFO) << num_gets << " Reference.get() calls during " << kNumGcs << " GCs ("
+            << PrettyDuration(gc_duration) << "): mean "
+            << PrettyDuration(total_ns / std::max<uint64_t>(num_gets, 1))
+            << ", max " << PrettyDuration(max_ns);
+
+  ScopedObjectAccess soa(self);
+  soa.Vm()->DeleteGlobalRef(self, references_global);
+  soa.Vm()->DeleteGlobalRef(self, referents_global);
+}
+
+// Calls Reference.get() from another thread while the GC runs, on weak references whose
+// referents are reachable only through objects awaiting finalization. The referents get marked
+// when the GC marks through finalizers, after the weak references were cleared, and
+// Reference.get() must never return them once the GC is done.
+TEST_F(ReferenceProcessorTest, FinalizerReachableReferent) {
+  constexpr size_t kNumReferences = 256;
+  Runtime* runtime = Runtime::Current();
+  Thread* self = Thread::Current();
+  jobject references_global;
+  jobject finalizers_global;
+  {
+    ScopedObjectAccess soa(self);
+    StackHandleScope<5> hs(self);
+    ClassLinker* class_linker = runtime->GetClassLinker();
+    Handle<mirror::Class> ref_class(hs.NewHandle(
+        class_linker->FindSystemClass(self, "Ljava/lang/ref/WeakReference;")));
+    ASSERT_TRUE(ref_class != nullptr);
+    Handle<mirror::Class> finalizer_ref_class(hs.NewHandle(
+        class_linker->FindSystemClass(self, "Ljava/lang/ref/FinalizerReference;")));
+    ASSERT_TRUE(finalizer_ref_class != nullptr);
+    Handle<mirror::Class> array_class(hs.NewHandle(
+        class_linker->FindSystemClass(self, "[Ljava/lang/Object;")));
+    ASSERT_TRUE(array_class != nullptr);
+    Handle<mirror::ObjectArray<mirror::Object>> references(hs.NewHandle(
+        mirror::ObjectArray<mirror::Object>::Alloc(self, array_class.Get(), kNumReferences)));
+    ASSERT_TRUE(references != nullptr);
+    Handle<mirror::ObjectArray<mirror::Object>> finalizers(hs.NewHandle(
+        mirror::ObjectArray<mirror::Object>::Alloc(self, array_class.Get(), kNumReferences)));
+    ASSERT_TRUE(finalizers != nullptr);
+    for (size_t i = 0; i < kNumReferences; ++i) {
+      // The finalizable object, which holds the only strong reference to the referent.
+      ObjPtr<mirror::ObjectArray<mirror::Object>> holder =
+          mirror::ObjectArray<mirror::Object>::Alloc(self, array_class.Get(), 1);
+      ASSERT_TRUE(holder != nullptr);
+      finalizers->Set</* kTransactionActive= */ false>(i, holder);
+      ObjPtr<mirror::String> referent =
+          mirror::String::AllocFromModifiedUtf8(self, std::to_string(i).c_str());
+      ASSERT_TRUE(referent != nullptr);
+      finalizers->Get(i)->AsObjectArray<mirror::Object>()->Set</* kTransactionActive= */ false>(
+          0, referent);
+      ObjPtr<mirror::Reference> reference = ref_class->AllocObject(self)->AsReference();
+      ASSERT_TRUE(reference != nullptr);
+      reference->SetReferent</* kTransactionActive= */ false>(
+          finalizers->Get(i)->AsObjectArray<mirror::Object>()->Get(0));
+      references->Set</* kTransactionActive= */ false>(i, reference);
+      ObjPtr<mirror::Reference> finalizer_ref =
+          finalizer_ref_class->AllocObject(self)->AsReference();
+      ASSERT_TRUE(finalizer_ref != nullptr);
+      finalizer_ref->SetReferent</* kTransactionActive= */ false>(finalizers->Get(i));
+      finalizers->Set</* kTransactionActive= */ false>(i, finalizer_ref);
+    }
+    references_global = soa.Vm()->AddGlobalRef(self, references.Get());
+    finalizers_global = soa.Vm()->AddGlobalRef(self, finalizers.Get());
+  }
+
+  std::atomic<bool> done(false);
+  std::atomic<size_t> num_late_referents(0);
+  std::thread reader([&]() {
+    CHECK(runtime->AttachCurrentThread("GetReferent finalizer test thread",
+                                       /* as_daemon= */ false,
+                                       /* thread_group= */ nullptr,
+                                       /* create_peer= */ false));
+    Thread* reader_self = Thread::Current();
+    ReferenceProcessor* rp = runtime->GetHeap()->GetReferenceProcessor();
+    bool gc_done = false;
+    while (!gc_done) {
+      gc_done = done.load(std::memory_order_acquire);
+      ScopedObjectAccess soa(reader_self);
+      ObjPtr<mirror::ObjectArray<mirror::Object>> references =
+          soa.Decode<mirror::ObjectArray<mirror::Object>>(references_global);
+      for (size_t i = 0; i < kNumReferences; ++i) {
+        ObjPtr<mirror::Reference> reference = references->Get(i)->AsReference();
+        if (rp->GetReferent(reader_self, reference) != nullptr && gc_done) {
+          num_late_referents.fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+    }
+    runtime->DetachCurrentThread();
+  });
+
+  {
+    ScopedThreadSuspension sts(self, ThreadState::kNative);
+    runtime->GetHeap()->CollectGarbage(/* clear_soft_references= */ false);
+  }
+  done.store(true, std::memory_order_release);
+  reader.join();
+  EXPECT_EQ(num_late_referents.load(), 0u);
+
+  ScopedObjectAccess soa(self);
+  ReferenceProcessor* rp = runtime->GetHeap()->GetReferenceProcessor();
+  ObjPtr<mirror::ObjectArray<mirror::Object>> references =
+      soa.Decode<mirror::ObjectArray<mirror::Object>>(references_global);
+  ObjPtr<mirror::ObjectArray<mirror::Object>> finalizers =
+      soa.Decode<mirror::ObjectArray<mirror::Object>>(finalizers_global);
+  for (size_t i = 0; i < kNumReferences; ++i) {
+    EXPECT_TRUE(rp->GetReferent(self, references->Get(i)->AsReference()) == nullptr) << i;
+    // The finalizable object and the referent survived, for the finalizer to run.
+    ObjPtr<mirror::Object> holder =
+        finalizers->Get(i)->AsReference()->AsFinalizerReference()->GetZombie();
+    ASSERT_TRUE(holder != nullptr) << i;
+    ASSERT_EQ(holder->AsObjectArray<mirror::Object>()->Get(0)->AsString()->ToModifiedUtf8(),
+              std::to_string(i));
+  }
+  soa.Vm()->DeleteGlobalRef(self, references_global);
+  soa.Vm()->DeleteGlobalRef(self, finalizers_global);
+}
+
+}  // namespace gc
+}  // namespace art
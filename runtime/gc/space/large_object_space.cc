@@ -18,7 +18,10 @@
 
 #include <sys/mman.h>
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <vector>
 
 #include <android-base/logging.h>
 
@@ -35,6 +38,7 @@
 #include "scoped_thread_state_change-inl.h"
 #include "space-inl.h"
 #include "thread-current-inl.h"
+#include "thread_pool.h"
 
 namespace art {
 namespace gc {
@@ -114,7 +118,7 @@ LargeObjectSpace::LargeObjectSpace(const std::string& name, uint8_t* begin, uint
     : DiscontinuousSpace(name, kGcRetentionPolicyAlwaysCollect),
       lock_(lock_name, kAllocSpaceLock),
       num_bytes_allocated_(0), num_objects_allocated_(0), total_bytes_allocated_(0),
-      total_objects_allocated_(0), begin_(begin), end_(end) {
+      total_objects_allocated_(0), pending_release_bytes_(0), begin_(begin), end_(end) {
 }
 
 
@@ -201,10 +205,28 @@ size_t LargeObjectMapSpace::Free(Thread* self, mirror::Object* ptr) {
   size_t allocation_size = map_size;
   num_bytes_allocated_ -= allocation_size;
   --num_objects_allocated_;
+  // Leave the munmap to ReleasePendingPages().
+  pending_release_.push_back(std::move(it->second.mem_map));
+  pending_release_bytes_ += allocation_size;
   large_objects_.erase(it);
   return allocation_size;
 }
 
+size_t LargeObjectMapSpace::ReleasePendingPages(Thread* self) {
+  std::vector<MemMap> maps;
+  {
+    MutexLock mu(self, lock_);
+    maps.swap(pending_release_);
+    pending_release_bytes_ = 0;
+  }
+  size_t released = 0;
+  for (MemMap& mem_map : maps) {
+    released += mem_map.BaseSize();
+    mem_map.Reset();
+  }
+  return released;
+}
+
 size_t LargeObjectMapSpace::AllocationSize(mirror::Object* obj, size_t* usable_size) {
   MutexLock mu(Thread::Current(), lock_);
   auto it = large_objects_.find(obj);
@@ -374,7 +396,10 @@ FreeListSpace::FreeListSpace(const std::string& name,
                              uint8_t* begin,
                              uint8_t* end)
     : LargeObjectSpace(name, begin, end, "free list space lock"),
-      mem_map_(std::move(mem_map)) {
+      mem_map_(std::move(mem_map)),
+      releasing_begin_(0),
+      releasing_end_(0),
+      release_cond_("free list space release condition variable", lock_) {
   const size_t space_capacity = end - begin;
   free_end_ = space_capacity;
   CHECK_ALIGNED(space_capacity, kAlignment);
@@ -424,6 +449,83 @@ void FreeListSpace::RemoveFreePrev(AllocationInfo* info) {
   free_blocks_.erase(it);
 }
 
+void FreeListSpace::AddPendingRelease(uintptr_t begin, uintptr_t end) {
+  pending_release_bytes_ += end - begin;
+  // Merge with the adjacent ranges, to release them with a single madvise call.
+  auto next = pending_release_.lower_bound(end);
+  if (next != pending_release_.end() && next->first == end) {
+    end = next->second;
+    next = pending_release_.erase(next);
+  }
+  if (next != pending_release_.begin()) {
+    auto prev = std::prev(next);
+    DCHECK_LE(prev->second, begin);
+    if (prev->second == begin) {
+      prev->second = end;
+      return;
+    }
+  }
+  pending_release_.Put(begin, end);
+}
+
+bool FreeListSpace::ClaimPendingRelease(Thread* self, uintptr_t begin, uintptr_t end) {
+  // The pages being released are not on the queue anymore, but the release would wipe the new
+  // object if it happened after the caller started using it.
+  while (releasing_begin_ < end && begin < releasing_end_) {
+    release_cond_.Wait(self);
+  }
+  auto it = pending_release_.lower_bound(begin);
+  if (it != pending_release_.begin() && std::prev(it)->second > begin) {
+    --it;
+  }
+  bool claimed = false;
+  while (it != pending_release_.end() && it->first < end) {
+    const uintptr_t range_begin = it->first;
+    const uintptr_t range_end = it->second;
+    it = pending_release_.erase(it);
+    // Keep the parts outside of the allocation on the queue.
+    if (range_begin < begin) {
+      pending_release_.Put(range_begin, begin);
+    }
+    if (range_end > end) {
+      pending_release_.Put(end, range_end);
+    }
+    pending_release_bytes_ -= std::min(range_end, end) - std::max(range_begin, begin);
+    claimed = true;
+  }
+  return claimed;
+}
+
+size_t FreeListSpace::ReleasePendingPages(Thread* self) {
+  size_t released = 0;
+  MutexLock mu(self, lock_);
+  while (true) {
+    // Only one thread releases at a time.
+    while (releasing_end_ != 0) {
+      release_cond_.Wait(self);
+    }
+    if (pending_release_.empty()) {
+      break;
+    }
+    auto it = pending_release_.begin();
+    const uintptr_t begin = it->first;
+    const uintptr_t end = it->second;
+    pending_release_.erase(it);
+    pending_release_bytes_ -= end - begin;
+    releasing_begin_ = begin;
+    releasing_end_ = end;
+    // madvise the pages without lock, allocations overlapping them wait for us.
+    lock_.ExclusiveUnlock(self);
+    madvise(reinterpret_cast<void*>(begin), end - begin, MADV_DONTNEED);
+    lock_.ExclusiveLock(self);
+    releasing_begin_ = 0;
+    releasing_end_ = 0;
+    release_cond_.Broadcast(self);
+    released += end - begin;
+  }
+  return released;
+}
+
 size_t FreeListSpace::Free(Thread* self, mirror::Object* obj) {
   DCHECK(Contains(obj)) << reinterpret_cast<void*>(Begin()) << " " << obj << " "
                         << reinterpret_cast<void*>(End());
@@ -434,8 +536,6 @@ size_t FreeListSpace::Free(Thread* self, mirror::Object* obj) {
   DCHECK_GT(allocation_size, 0U);
   DCHECK_ALIGNED(allocation_size, kAlignment);
 
-  // madvise the pages without lock
-  madvise(obj, allocation_size, MADV_DONTNEED);
   if (kIsDebugBuild) {
     // Can't disallow reads since we use them to find next chunks during coalescing.
     CheckedCall(mprotect, __FUNCTION__, obj, allocation_size, PROT_READ);
@@ -484,6 +584,9 @@ size_t FreeListSpace::Free(Thread* self, mirror::Object* obj) {
     info->SetByteSize(new_free_size, true);
     DCHECK_EQ(info->GetNextInfo(), new_free_info);
   }
+  // Leave the madvise to ReleasePendingPages(), the pages get zeroed before being reused anyway.
+  const uintptr_t obj_begin = reinterpret_cast<uintptr_t>(obj);
+  AddPendingRelease(obj_begin, obj_begin + allocation_size);
   --num_objects_allocated_;
   DCHECK_LE(allocation_size, num_bytes_allocated_);
   num_bytes_allocated_ -= allocation_size;
@@ -503,58 +606,70 @@ size_t FreeListSpace::AllocationSize(mirror::Object* obj, size_t* usable_size) {
 
 mirror::Object* FreeListSpace::Alloc(Thread* self, size_t num_bytes, size_t* bytes_allocated,
                                      size_t* usable_size, size_t* bytes_tl_bulk_allocated) {
-  MutexLock mu(self, lock_);
   const size_t allocation_size = RoundUp(num_bytes, kAlignment);
-  AllocationInfo temp_info;
-  temp_info.SetPrevFreeBytes(allocation_size);
-  temp_info.SetByteSize(0, false);
-  AllocationInfo* new_info;
-  // Find the smallest chunk at least num_bytes in size.
-  auto it = free_blocks_.lower_bound(&temp_info);
-  if (it != free_blocks_.end()) {
-    AllocationInfo* info = *it;
-    free_blocks_.erase(it);
-    // Fit our object in the previous allocation info free space.
-    new_info = info->GetPrevFreeInfo();
-    // Remove the newly allocated block from the info and update the prev_free_.
-    info->SetPrevFreeBytes(info->GetPrevFreeBytes() - allocation_size);
-    if (info->GetPrevFreeBytes() > 0) {
-      AllocationInfo* new_free = info - info->GetPrevFree();
-      new_free->SetPrevFreeBytes(0);
-      new_free->SetByteSize(info->GetPrevFreeBytes(), true);
-      // If there is remaining space, insert back into the free set.
-      free_blocks_.insert(info);
-    }
-  } else {
-    // Try to steal some memory from the free space at the end of the space.
-    if (LIKELY(free_end_ >= allocation_size)) {
-      // Fit our object at the start of the end free block.
-      new_info = GetAllocationInfoForAddress(reinterpret_cast<uintptr_t>(End()) - free_end_);
-      free_end_ -= allocation_size;
+  mirror::Object* obj;
+  bool needs_release;
+  {
+    MutexLock mu(self, lock_);
+    AllocationInfo temp_info;
+    temp_info.SetPrevFreeBytes(allocation_size);
+    temp_info.SetByteSize(0, false);
+    AllocationInfo* new_info;
+    // Find the smallest chunk at least num_bytes in size.
+    auto it = free_blocks_.lower_bound(&temp_info);
+    if (it != free_blocks_.end()) {
+      AllocationInfo* info = *it;
+      free_blocks_.erase(it);
+      // Fit our object in the previous allocation info free space.
+      new_info = info->GetPrevFreeInfo();
+      // Remove the newly allocated block from the info and update the prev_free_.
+      info->SetPrevFreeBytes(info->GetPrevFreeBytes() - allocation_size);
+      if (info->GetPrevFreeBytes() > 0) {
+        AllocationInfo* new_free = info - info->GetPrevFree();
+        new_free->SetPrevFreeBytes(0);
+        new_free->SetByteSize(info->GetPrevFreeBytes(), true);
+        // If there is remaining space, insert back into the free set.
+        free_blocks_.insert(info);
+      }
     } else {
-      return nullptr;
+      // Try to steal some memory from the free space at the end of the space.
+      if (LIKELY(free_end_ >= allocation_size)) {
+        // Fit our object at the start of the end free block.
+        new_info = GetAllocationInfoForAddress(reinterpret_cast<uintptr_t>(End()) - free_end_);
+        free_end_ -= allocation_size;
+      } else {
+        return nullptr;
+      }
     }
+    DCHECK(bytes_allocated != nullptr);
+    *bytes_allocated = allocation_size;
+    if (usable_size != nullptr) {
+      *usable_size = allocation_size;
+    }
+    DCHECK(bytes_tl_bulk_allocated != nullptr);
+    *bytes_tl_bulk_allocated = allocation_size;
+    // Need to do these inside of the lock.
+    ++num_objects_allocated_;
+    ++total_objects_allocated_;
+    num_bytes_allocated_ += allocation_size;
+    total_bytes_allocated_ += allocation_size;
+    obj = reinterpret_cast<mirror::Object*>(GetAddressForAllocationInfo(new_info));
+    // We always put our object at the start of the free block, there cannot be another free block
+    // before it.
+    if (kIsDebugBuild) {
+      CheckedCall(mprotect, __FUNCTION__, obj, allocation_size, PROT_READ | PROT_WRITE);
+    }
+    new_info->SetPrevFreeBytes(0);
+    new_info->SetByteSize(allocation_size, false);
+    // This may wait for a release with the lock released, so the block must be set up first.
+    const uintptr_t obj_begin = reinterpret_cast<uintptr_t>(obj);
+    needs_release = ClaimPendingRelease(self, obj_begin, obj_begin + allocation_size);
   }
-  DCHECK(bytes_allocated != nullptr);
-  *bytes_allocated = allocation_size;
-  if (usable_size != nullptr) {
-    *usable_size = allocation_size;
-  }
-  DCHECK(bytes_tl_bulk_allocated != nullptr);
-  *bytes_tl_bulk_allocated = allocation_size;
-  // Need to do these inside of the lock.
-  ++num_objects_allocated_;
-  ++total_objects_allocated_;
-  num_bytes_allocated_ += allocation_size;
-  total_bytes_allocated_ += allocation_size;
-  mirror::Object* obj = reinterpret_cast<mirror::Object*>(GetAddressForAllocationInfo(new_info));
-  // We always put our object at the start of the free block, there cannot be another free block
-  // before it.
-  if (kIsDebugBuild) {
-    CheckedCall(mprotect, __FUNCTION__, obj, allocation_size, PROT_READ | PROT_WRITE);
+  if (needs_release) {
+    // Some of the pages were freed since the last release and may be dirty. madvise the pages
+    // without lock, the block is ours.
+    madvise(obj, allocation_size, MADV_DONTNEED);
   }
-  new_info->SetPrevFreeBytes(0);
-  new_info->SetByteSize(allocation_size, false);
   return obj;
 }
 
@@ -613,9 +728,8 @@ void LargeObjectSpace::SweepCallback(size_t num_ptrs, mirror::Object** ptrs, voi
   SweepCallbackContext* context = static_cast<SweepCallbackContext*>(arg);
   space::LargeObjectSpace* space = context->space->AsLargeObjectSpace();
   Thread* self = context->self;
-  Locks::heap_bitmap_lock_->AssertExclusiveHeld(self);
   // If the bitmaps aren't swapped we need to clear the bits since the GC isn't going to re-swap
-  // the bitmaps as an optimization.
+  // the bitmaps as an optimization. Parallel sweeping threads work on separate bitmap words.
   if (!context->swap_bitmaps) {
     accounting::LargeObjectBitmap* bitmap = space->GetLiveBitmap();
     for (size_t i = 0; i < num_ptrs; ++i) {
@@ -626,7 +740,11 @@ void LargeObjectSpace::SweepCallback(size_t num_ptrs, mirror::Object** ptrs, voi
   context->freed.bytes += space->FreeList(self, num_ptrs, ptrs);
 }
 
-collector::ObjectBytePair LargeObjectSpace::Sweep(bool swap_bitmaps) {
+collector::ObjectBytePair LargeObjectSpace::Sweep(bool swap_bitmaps,
+                                                  ThreadPool* thread_pool,
+                                                  size_t thread_count) {
+  Thread* self = Thread::Current();
+  Locks::heap_bitmap_lock_->AssertExclusiveHeld(self);
   if (Begin() >= End()) {
     return collector::ObjectBytePair(0, 0);
   }
@@ -635,14 +753,58 @@ collector::ObjectBytePair LargeObjectSpace::Sweep(bool swap_bitmaps) {
   if (swap_bitmaps) {
     std::swap(live_bitmap, mark_bitmap);
   }
-  AllocSpace::SweepCallbackContext scc(swap_bitmaps, this);
   std::pair<uint8_t*, uint8_t*> range = GetBeginEndAtomic();
-  accounting::LargeObjectBitmap::SweepWalk(*live_bitmap, *mark_bitmap,
-                                           reinterpret_cast<uintptr_t>(range.first),
-                                           reinterpret_cast<uintptr_t>(range.second),
-                                           SweepCallback,
-                                           &scc);
-  return scc.freed;
+  const uintptr_t sweep_begin = reinterpret_cast<uintptr_t>(range.first);
+  const uintptr_t sweep_end = reinterpret_cast<uintptr_t>(range.second);
+  if (thread_pool == nullptr ||
+      thread_count <= 1 ||
+      sweep_end - sweep_begin < kMinParallelSweepBytes) {
+    AllocSpace::SweepCallbackContext scc(swap_bitmaps, this);
+    accounting::LargeObjectBitmap::SweepWalk(*live_bitmap, *mark_bitmap,
+                                             sweep_begin,
+                                             sweep_end,
+                                             SweepCallback,
+                                             &scc);
+    return scc.freed;
+  }
+  // Stripes start on bitmap word boundaries so that clearing the live bits of different stripes
+  // never touches the same word. The threads take the stripes in turn for load balancing, as the
+  // dead objects are usually not spread evenly.
+  constexpr size_t kStripeAlignment = kBitsPerIntPtrT * kLargeObjectAlignment;
+  const uintptr_t heap_begin = live_bitmap->HeapBegin();
+  const uintptr_t stripes_begin = RoundDown(sweep_begin - heap_begin, kStripeAlignment) + heap_begin;
+  const size_t stripe_size = RoundUp(
+      (sweep_end - stripes_begin) / (thread_count * kSweepStripesPerThread), kStripeAlignment);
+  const size_t num_stripes = RoundUp(sweep_end - stripes_begin, stripe_size) / stripe_size;
+  std::atomic<size_t> next_stripe(0);
+  std::vector<collector::ObjectBytePair> freed(thread_count);
+  for (size_t i = 0; i < thread_count; ++i) {
+    thread_pool->AddTask(self, new FunctionTask([&, i](Thread* /*worker*/) {
+      // Created here as the context holds the thread doing the frees.
+      AllocSpace::SweepCallbackContext scc(swap_bitmaps, this);
+      for (size_t stripe = next_stripe.fetch_add(1, std::memory_order_relaxed);
+           stripe < num_stripes;
+           stripe = next_stripe.fetch_add(1, std::memory_order_relaxed)) {
+        const uintptr_t stripe_begin = stripes_begin + stripe * stripe_size;
+        accounting::LargeObjectBitmap::SweepWalk(*live_bitmap, *mark_bitmap,
+                                                 std::max(stripe_begin, sweep_begin),
+                                                 std::min(stripe_begin + stripe_size, sweep_end),
+                                                 SweepCallback,
+                                                 &scc);
+      }
+      freed[i] = scc.freed;
+    }));
+  }
+  thread_pool->SetMaxActiveWorkers(thread_count - 1);
+  thread_pool->StartWorkers(self);
+  thread_pool->Wait(self, /*do_work=*/ true, /*may_hold_locks=*/ true);
+  thread_pool->StopWorkers(self);
+  thread_pool->SetMaxActiveWorkers(thread_pool->GetThreadCount());
+  collector::ObjectBytePair total(0, 0);
+  for (const collector::ObjectBytePair& task_freed : freed) {
+    total.Add(task_freed);
+  }
+  return total;
 }
 
 bool LargeObjectSpace::LogFragmentationAllocFailure(std::ostream& /*os*/,
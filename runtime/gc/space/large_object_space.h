@@ -28,6 +28,9 @@
 #include <vector>
 
 namespace art {
+
+class ThreadPool;
+
 namespace gc {
 namespace space {
 
@@ -80,7 +83,20 @@ class LargeObjectSpace : public DiscontinuousSpace, public AllocSpace {
   AllocSpace* AsAllocSpace() override {
     return this;
   }
-  collector::ObjectBytePair Sweep(bool swap_bitmaps);
+  // Frees the objects which are live but not marked. Large spaces are split into stripes, swept by
+  // `thread_count` threads including the caller, the others coming from `thread_pool`.
+  collector::ObjectBytePair Sweep(bool swap_bitmaps,
+                                  ThreadPool* thread_pool = nullptr,
+                                  size_t thread_count = 1) REQUIRES(Locks::heap_bitmap_lock_);
+  // Freeing an object only queues its pages to be returned to the kernel, so that sweeping doesn't
+  // pay for the madvise or munmap calls. This returns the queued pages, and is meant to be called
+  // lazily from a background thread. Returns the number of bytes released.
+  virtual size_t ReleasePendingPages(Thread* self) REQUIRES(!lock_) = 0;
+  // Number of bytes freed but not yet returned to the kernel.
+  size_t GetPendingReleaseBytes() const REQUIRES(!lock_) {
+    MutexLock mu(Thread::Current(), lock_);
+    return pending_release_bytes_;
+  }
   bool CanMoveObjects() const override {
     return false;
   }
@@ -121,6 +137,11 @@ class LargeObjectSpace : public DiscontinuousSpace, public AllocSpace {
                             const char* lock_name);
   static void SweepCallback(size_t num_ptrs, mirror::Object** ptrs, void* arg);
 
+  // Sweeps below this size are not worth waking up other threads for.
+  static constexpr size_t kMinParallelSweepBytes = 64 * MB;
+  // Number of stripes per sweeping thread, for load balancing.
+  static constexpr size_t kSweepStripesPerThread = 4;
+
   // Used to ensure mutual exclusion when the allocation spaces data structures,
   // including the allocation counters below, are being modified.
   mutable Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
@@ -137,6 +158,9 @@ class LargeObjectSpace : public DiscontinuousSpace, public AllocSpace {
   uint64_t total_bytes_allocated_ GUARDED_BY(lock_);
   uint64_t total_objects_allocated_ GUARDED_BY(lock_);
 
+  // Bytes of the freed objects whose pages are waiting for ReleasePendingPages().
+  size_t pending_release_bytes_ GUARDED_BY(lock_);
+
   // Begin and end, may change as more large objects are allocated.
   uint8_t* begin_;
   uint8_t* end_;
@@ -164,6 +188,7 @@ class LargeObjectMapSpace : public LargeObjectSpace {
   bool Contains(const mirror::Object* obj) const override NO_THREAD_SAFETY_ANALYSIS;
   void ForEachMemMap(std::function<void(const MemMap&)> func) const override REQUIRES(!lock_);
   std::pair<uint8_t*, uint8_t*> GetBeginEndAtomic() const override REQUIRES(!lock_);
+  size_t ReleasePendingPages(Thread* self) override REQUIRES(!lock_);
 
  protected:
   struct LargeObject {
@@ -180,6 +205,8 @@ class LargeObjectMapSpace : public LargeObjectSpace {
 
   AllocationTrackingSafeMap<mirror::Object*, LargeObject, kAllocatorTagLOSMaps> large_objects_
       GUARDED_BY(lock_);
+  // Maps of the freed objects, unmapped by ReleasePendingPages().
+  std::vector<MemMap> pending_release_ GUARDED_BY(lock_);
 };
 
 // A continuous large object space with a free-list to handle holes.
@@ -199,6 +226,7 @@ class FreeListSpace final : public LargeObjectSpace {
   void Dump(std::ostream& os) const override REQUIRES(!lock_);
   void ForEachMemMap(std::function<void(const MemMap&)> func) const override REQUIRES(!lock_);
   std::pair<uint8_t*, uint8_t*> GetBeginEndAtomic() const override REQUIRES(!lock_);
+  size_t ReleasePendingPages(Thread* self) override REQUIRES(!lock_);
 
  protected:
   FreeListSpace(const std::string& name, MemMap&& mem_map, uint8_t* begin, uint8_t* end);
@@ -217,6 +245,11 @@ class FreeListSpace final : public LargeObjectSpace {
   }
   // Removes header from the free blocks set by finding the corresponding iterator and erasing it.
   void RemoveFreePrev(AllocationInfo* info) REQUIRES(lock_);
+  // Queues the pages of a freed range for ReleasePendingPages().
+  void AddPendingRelease(uintptr_t begin, uintptr_t end) REQUIRES(lock_);
+  // Takes the queued pages overlapping a newly allocated range off the queue. Returns true if there
+  // were any, in which case the caller must release them before handing out the memory.
+  bool ClaimPendingRelease(Thread* self, uintptr_t begin, uintptr_t end) REQUIRES(lock_);
   bool IsZygoteLargeObject(Thread* self, mirror::Object* obj) const override;
   void SetAllLargeObjectsAsZygoteObjects(Thread* self, bool set_mark_bit) override
       REQUIRES(!lock_)
@@ -240,6 +273,16 @@ class FreeListSpace final : public LargeObjectSpace {
   // Free bytes at the end of the space.
   size_t free_end_ GUARDED_BY(lock_);
   FreeBlocks free_blocks_ GUARDED_BY(lock_);
+
+  // Freed ranges whose pages are waiting for ReleasePendingPages(), from begin to end address.
+  // Adjacent ranges are merged.
+  AllocationTrackingSafeMap<uintptr_t, uintptr_t, kAllocatorTagLOSFreeList> pending_release_
+      GUARDED_BY(lock_);
+  // Range being released by ReleasePendingPages() without the lock held. Allocations overlapping
+  // it wait on `release_cond_` for the release to be done, as it zeroes the pages.
+  uintptr_t releasing_begin_ GUARDED_BY(lock_);
+  uintptr_t releasing_end_ GUARDED_BY(lock_);
+  ConditionVariable release_cond_ GUARDED_BY(lock_);
 };
 
 }  // namespace space
@@ -17,7 +17,9 @@
 #include "large_object_space.h"
 
 #include "base/time_utils.h"
+#include "gc/accounting/space_bitmap-inl.h"
 #include "space_test.h"
+#include "thread_pool.h"
 
 namespace art {
 namespace gc {
@@ -30,6 +32,10 @@ class LargeObjectSpaceTest : public SpaceTest<CommonRuntimeTest> {
   static constexpr size_t kNumThreads = 10;
   static constexpr size_t kNumIterations = 1000;
   void RaceTest();
+
+  static constexpr size_t kNumSweepObjects = 2048;
+  static constexpr size_t kMaxSweepObjectSize = 128 * KB;
+  void SweepTest();
 };
 
 
@@ -174,6 +180,100 @@ void LargeObjectSpaceTest::RaceTest() {
   }
 }
 
+// Sweeps a space full of objects, three quarters of them dead, first with the calling thread only
+// and then with a thread pool, and reports how long it took. Freed pages must read as zero once
+// reused, whether or not they have been released yet.
+void LargeObjectSpaceTest::SweepTest() {
+  Thread* const self = Thread::Current();
+  size_t rand_seed = 0;
+  ThreadPool thread_pool("Large object space sweep thread pool", kNumThreads);
+  for (size_t los_type = 0; los_type < 2; ++los_type) {
+    LargeObjectSpace* los = nullptr;
+    if (los_type == 0) {
+      los = space::LargeObjectMapSpace::Create("large object space");
+    } else {
+      los = space::FreeListSpace::Create("large object space", 512 * MB);
+    }
+    accounting::LargeObjectBitmap* live_bitmap = los->GetLiveBitmap();
+    accounting::LargeObjectBitmap* mark_bitmap = los->GetMarkBitmap();
+    for (size_t thread_count : {static_cast<size_t>(1), kNumThreads + 1}) {
+      std::vector<std::pair<mirror::Object*, size_t>> live;
+      std::vector<std::pair<mirror::Object*, size_t>> dead;
+      size_t dead_bytes = 0;
+      for (size_t i = 0; i < kNumSweepObjects; ++i) {
+        size_t request_size = kPageSize + test_rand(&rand_seed) % kMaxSweepObjectSize;
+        size_t allocation_size = 0;
+        size_t bytes_tl_bulk_allocated;
+        mirror::Object* obj = los->Alloc(self, request_size, &allocation_size, nullptr,
+                                         &bytes_tl_bulk_allocated);
+        ASSERT_TRUE(obj != nullptr);
+        // Dirty the first and last pages.
+        reinterpret_cast<uint8_t*>(obj)[0] = 0xFF;
+        reinterpret_cast<uint8_t*>(obj)[allocation_size - 1] = 0xFF;
+        live_bitmap->Set(obj);
+        if (test_rand(&rand_seed) % 4 == 0) {
+          mark_bitmap->Set(obj);
+          live.push_back(std::make_pair(obj, allocation_size));
+        } else {
+          dead.push_back(std::make_pair(obj, allocation_size));
+          dead_bytes += allocation_size;
+        }
+      }
+
+      collector::ObjectBytePair freed;
+      const uint64_t start_time = NanoTime();
+      {
+        WriterMutexLock mu(self, *Locks::heap_bitmap_lock_);
+        freed = los->Sweep(/*swap_bitmaps=*/ false, &thread_pool, thread_count);
+      }
+      const uint64_t sweep_time = NanoTime() - start_time;
+      LOG(INFO) << (los_type == 0 ? "Map" : "Free list") << " space sweep of " << dead.size()
+                << " objects with " << thread_count << " threads took "
+                << PrettyDuration(sweep_time);
+      EXPECT_EQ(freed.objects, dead.size());
+      EXPECT_EQ(static_cast<size_t>(freed.bytes), dead_bytes);
+      EXPECT_EQ(los->GetObjectsAllocated(), live.size());
+      for (const auto& pair : dead) {
+        EXPECT_FALSE(live_bitmap->Test(pair.first));
+      }
+      for (const auto& pair : live) {
+        EXPECT_TRUE(live_bitmap->Test(pair.first));
+      }
+      // The pages are only released on request.
+      EXPECT_EQ(los->GetPendingReleaseBytes(), dead_bytes);
+
+      // Reuse some of the freed memory before it is released.
+      std::vector<mirror::Object*> reused;
+      for (size_t i = 0; i < dead.size() / 2; ++i) {
+        size_t allocation_size = 0;
+        size_t bytes_tl_bulk_allocated;
+        mirror::Object* obj = los->Alloc(self, dead[i].second, &allocation_size, nullptr,
+                                         &bytes_tl_bulk_allocated);
+        ASSERT_TRUE(obj != nullptr);
+        ASSERT_EQ(allocation_size, dead[i].second);
+        ASSERT_EQ(reinterpret_cast<uint8_t*>(obj)[0], 0u);
+        ASSERT_EQ(reinterpret_cast<uint8_t*>(obj)[allocation_size - 1], 0u);
+        reused.push_back(obj);
+      }
+      EXPECT_LE(los->GetPendingReleaseBytes(), dead_bytes);
+      los->ReleasePendingPages(self);
+      EXPECT_EQ(los->GetPendingReleaseBytes(), 0u);
+
+      for (mirror::Object* obj : reused) {
+        los->Free(self, obj);
+      }
+      for (const auto& pair : live) {
+        live_bitmap->Clear(pair.first);
+        mark_bitmap->Clear(pair.first);
+        los->Free(self, pair.first);
+      }
+      EXPECT_EQ(los->GetBytesAllocated(), 0u);
+      EXPECT_GT(los->ReleasePendingPages(self), 0u);
+    }
+    delete los;
+  }
+}
+
 TEST_F(LargeObjectSpaceTest, LargeObjectTest) {
   LargeObjectTest();
 }
@@ -182,6 +282,10 @@ TEST_F(LargeObjectSpaceTest, RaceTest) {
   RaceTest();
 }
 
+TEST_F(LargeObjectSpaceTest, SweepTest) {
+  SweepTest();
+}
+
 }  // namespace space
 }  // namespace gc
 }  // namespace art
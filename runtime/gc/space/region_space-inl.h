@@ -61,6 +61,7 @@ inline mirror::Object* RegionSpace::AllocNonvirtual(size_t num_bytes,
     if (LIKELY(obj != nullptr)) {
       return obj;
     }
+    const size_t node_index = CurrentNumaNodeIndex();
     MutexLock mu(Thread::Current(), region_lock_);
     // Retry with current region since another thread may have updated
     // current_region_ or evac_region_.  TODO: fix race.
@@ -71,7 +72,7 @@ inline mirror::Object* RegionSpace::AllocNonvirtual(size_t num_bytes,
     if (LIKELY(obj != nullptr)) {
       return obj;
     }
-    Region* r = AllocateRegion(kForEvac);
+    Region* r = AllocateRegion(kForEvac, node_index);
     if (LIKELY(r != nullptr)) {
       obj = r->Alloc(num_bytes, bytes_allocated, usable_size, bytes_tl_bulk_allocated);
       CHECK(obj != nullptr);
@@ -94,6 +95,22 @@ inline mirror::Object* RegionSpace::AllocNonvirtual(size_t num_bytes,
   return nullptr;
 }
 
+inline mirror::Object* RegionSpace::AllocInEvacTlab(Thread* self,
+                                                    size_t num_bytes,
+                                                    /* out */ size_t* bytes_allocated) {
+  DCHECK_ALIGNED(num_bytes, kAlignment);
+  DCHECK_LE(num_bytes, kRegionSize);
+  if (UNLIKELY(self->TlabSize() < num_bytes)) {
+    const size_t node_index = CurrentNumaNodeIndex();
+    MutexLock mu(self, region_lock_);
+    if (!AllocNewEvacTlab(self, node_index)) {
+      return nullptr;
+    }
+  }
+  *bytes_allocated = num_bytes;
+  return self->AllocTlab(num_bytes);
+}
+
 inline mirror::Object* RegionSpace::Region::Alloc(size_t num_bytes,
                                                   /* out */ size_t* bytes_allocated,
                                                   /* out */ size_t* usable_size,
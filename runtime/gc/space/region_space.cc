@@ -15,11 +15,21 @@
  */
 #include <deque>
 
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "android-base/file.h"
+#include "android-base/parseint.h"
+#include "android-base/stringprintf.h"
+#include "android-base/strings.h"
+
 #include "bump_pointer_space-inl.h"
 #include "bump_pointer_space.h"
 #include "base/dumpable.h"
 #include "base/logging.h"
 #include "gc/accounting/read_barrier_table.h"
+#include "gc/survival_stats.h"
 #include "mirror/class-inl.h"
 #include "mirror/object-inl.h"
 #include "thread_list.h"
@@ -38,6 +48,12 @@ static constexpr bool kProtectClearedRegions = kIsDebugBuild;
 // Wether we poison memory areas occupied by dead objects in unevacuated regions.
 static constexpr bool kPoisonDeadObjectsInUnevacuatedRegions = kIsDebugBuild;
 
+// Memory policy of mbind(2) preferring the given node, from <linux/mempolicy.h>.
+static constexpr int kMpolPreferred = 1;
+
+// Sysfs directory describing the NUMA nodes.
+static constexpr const char* kSysfsNodeDir = "/sys/devices/system/node";
+
 // Special 32-bit value used to poison memory areas occupied by dead
 // objects in unevacuated regions. Dereferencing this value is expected
 // to trigger a memory protection fault, as it is unlikely that it
@@ -94,12 +110,17 @@ MemMap RegionSpace::CreateMemMap(const std::string& name,
   return mem_map;
 }
 
-RegionSpace* RegionSpace::Create(
-    const std::string& name, MemMap&& mem_map, bool use_generational_cc) {
-  return new RegionSpace(name, std::move(mem_map), use_generational_cc);
+RegionSpace* RegionSpace::Create(const std::string& name,
+                                 MemMap&& mem_map,
+                                 bool use_generational_cc,
+                                 bool numa_aware) {
+  return new RegionSpace(name, std::move(mem_map), use_generational_cc, numa_aware);
 }
 
-RegionSpace::RegionSpace(const std::string& name, MemMap&& mem_map, bool use_generational_cc)
+RegionSpace::RegionSpace(const std::string& name,
+                         MemMap&& mem_map,
+                         bool use_generational_cc,
+                         bool numa_aware)
     : ContinuousMemMapAllocSpace(name,
                                  std::move(mem_map),
                                  mem_map.Begin(),
@@ -143,10 +164,129 @@ RegionSpace::RegionSpace(const std::string& name, MemMap&& mem_map, bool use_gen
   DCHECK(full_region_.IsAllocated());
   size_t ignored;
   DCHECK(full_region_.Alloc(kAlignment, &ignored, nullptr, &ignored) == nullptr);
+  if (numa_aware) {
+    InitNumaPartitions();
+  }
   // Protect the whole region space from the start.
   Protect();
 }
 
+bool RegionSpace::ParseSysfsList(const std::string& list, std::vector<uint32_t>* values) {
+  for (const std::string& range : android::base::Split(android::base::Trim(list), ",")) {
+    std::vector<std::string> bounds = android::base::Split(range, "-");
+    uint32_t first;
+    uint32_t last;
+    if (bounds.size() > 2u ||
+        !android::base::ParseUint(bounds.front(), &first) ||
+        !android::base::ParseUint(bounds.back(), &last) ||
+        last < first) {
+      return false;
+    }
+    for (uint32_t value = first; value <= last; ++value) {
+      values->push_back(value);
+    }
+  }
+  return !values->empty();
+}
+
+bool RegionSpace::ReadNumaNodes(const std::string& node_dir,
+                                size_t max_nodes,
+                                std::vector<uint32_t>* node_ids,
+                                std::vector<std::vector<uint32_t>>* node_cpus) {
+  std::string online;
+  std::vector<uint32_t> online_ids;
+  if (!android::base::ReadFileToString(node_dir + "/online", &online) ||
+      !ParseSysfsList(online, &online_ids)) {
+    LOG(WARNING) << "Cannot read the NUMA nodes from " << node_dir;
+    return false;
+  }
+  for (uint32_t node_id : online_ids) {
+    std::string cpu_list;
+    std::vector<uint32_t> cpus;
+    // Memory-only nodes have no CPUs, so no thread would allocate from them.
+    if (node_id < static_cast<uint32_t>(kBitsPerIntPtrT) &&
+        android::base::ReadFileToString(
+            android::base::StringPrintf("%s/node%u/cpulist", node_dir.c_str(), node_id),
+            &cpu_list) &&
+        ParseSysfsList(cpu_list, &cpus)) {
+      node_ids->push_back(node_id);
+      node_cpus->push_back(std::move(cpus));
+    }
+  }
+  if (node_ids->size() < 2u || node_ids->size() > max_nodes) {
+    node_ids->clear();
+    node_cpus->clear();
+    return false;
+  }
+  return true;
+}
+
+void RegionSpace::InitNumaPartitions() {
+  std::vector<uint32_t> node_ids;
+  std::vector<std::vector<uint32_t>> node_cpus;
+  if (!ReadNumaNodes(kSysfsNodeDir, num_regions_, &node_ids, &node_cpus)) {
+    VLOG(heap) << GetName() << " is not NUMA-aware";
+    return;
+  }
+  numa_node_ids_ = std::move(node_ids);
+  numa_node_cpus_ = std::move(node_cpus);
+  // The pages keep the policy when madvised away, so binding once suffices.
+  for (size_t i = 0; i < numa_node_ids_.size(); ++i) {
+    uint8_t* begin = regions_[NumaPartitionBegin(i)].Begin();
+    uint8_t* end = regions_[NumaPartitionBegin(i + 1) - 1].End();
+    uintptr_t node_mask = static_cast<uintptr_t>(1) << numa_node_ids_[i];
+    if (syscall(__NR_mbind,
+                begin,
+                end - begin,
+                kMpolPreferred,
+                &node_mask,
+                kBitsPerIntPtrT + 1,
+                /*flags=*/ 0) != 0) {
+      PLOG(WARNING) << "Failed to bind " << GetName() << " to NUMA node " << numa_node_ids_[i];
+      numa_node_ids_.clear();
+      numa_node_cpus_.clear();
+      return;
+    }
+  }
+  for (size_t i = 0; i < numa_node_cpus_.size(); ++i) {
+    for (uint32_t cpu : numa_node_cpus_[i]) {
+      if (cpu >= numa_cpu_node_indexes_.size()) {
+        numa_cpu_node_indexes_.resize(cpu + 1, 0u);
+      }
+      numa_cpu_node_indexes_[cpu] = i;
+    }
+  }
+  VLOG(heap) << GetName() << " is partitioned over " << numa_node_ids_.size() << " NUMA nodes";
+}
+
+size_t RegionSpace::CurrentNumaNodeIndex() const {
+  if (!IsNumaAware()) {
+    return 0;
+  }
+  // Unlike the getcpu system call, sched_getcpu() is served from the vDSO where available.
+  int cpu = sched_getcpu();
+  if (cpu < 0 || static_cast<size_t>(cpu) >= numa_cpu_node_indexes_.size()) {
+    return 0;
+  }
+  return numa_cpu_node_indexes_[cpu];
+}
+
+void RegionSpace::BindThreadToNumaNode(Thread* thread, size_t node_index) {
+  DCHECK(IsNumaAware());
+  DCHECK_LT(node_index, numa_node_cpus_.size());
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (uint32_t cpu : numa_node_cpus_[node_index]) {
+    if (cpu < CPU_SETSIZE) {
+      CPU_SET(cpu, &cpu_set);
+    }
+  }
+  if (sched_setaffinity(thread->GetTid(), sizeof(cpu_set), &cpu_set) != 0) {
+    PLOG(WARNING) << "Failed to bind " << *thread << " to NUMA node "
+                  << numa_node_ids_[node_index];
+  }
+}
+
 size_t RegionSpace::FromSpaceSize() {
   uint64_t num_regions = 0;
   MutexLock mu(Thread::Current(), region_lock_);
@@ -207,7 +347,7 @@ void RegionSpace::Region::SetAsUnevacFromSpace(bool clear_live_bytes) {
   if (clear_live_bytes) {
     // Reset the live bytes, as we have made a non-evacuation
     // decision (possibly based on the percentage of live bytes).
-    live_bytes_ = 0;
+    live_bytes_.store(0, std::memory_order_relaxed);
   }
 }
 
@@ -238,7 +378,7 @@ inline bool RegionSpace::Region::ShouldBeEvacuated(EvacMode evac_mode) {
   DCHECK(IsAllocated());
   if (is_newly_allocated_) {
     // Invariant: newly allocated regions have an undefined live bytes count.
-    DCHECK_EQ(live_bytes_, static_cast<size_t>(-1));
+    DCHECK_EQ(LiveBytes(), static_cast<size_t>(-1));
     // We always evacuate newly-allocated non-large regions as we
     // believe they contain many dead objects (a very simple form of
     // the generational hypothesis, even before the Sticky-Bit CC
@@ -255,17 +395,18 @@ inline bool RegionSpace::Region::ShouldBeEvacuated(EvacMode evac_mode) {
     // allocated" (see RegionSpace::AllocateRegion).
     return true;
   } else if (evac_mode == kEvacModeLivePercentNewlyAllocated) {
-    bool is_live_percent_valid = (live_bytes_ != static_cast<size_t>(-1));
+    const size_t live_bytes = LiveBytes();
+    bool is_live_percent_valid = (live_bytes != static_cast<size_t>(-1));
     if (is_live_percent_valid) {
       DCHECK(IsInToSpace());
-      DCHECK_NE(live_bytes_, static_cast<size_t>(-1));
-      DCHECK_LE(live_bytes_, BytesAllocated());
+      DCHECK_NE(live_bytes, static_cast<size_t>(-1));
+      DCHECK_LE(live_bytes, BytesAllocated());
       const size_t bytes_allocated = RoundUp(BytesAllocated(), kRegionSize);
-      DCHECK_LE(live_bytes_, bytes_allocated);
+      DCHECK_LE(live_bytes, bytes_allocated);
       // Side node: live_percent == 0 does not necessarily mean
       // there's no live objects due to rounding (there may be a
       // few).
-      return live_bytes_ * 100U < kEvacuateLivePercentThreshold * bytes_allocated;
+      return live_bytes * 100U < kEvacuateLivePercentThreshold * bytes_allocated;
     }
   }
   return false;
@@ -400,6 +541,37 @@ static void ZeroAndProtectRegion(uint8_t* begin, uint8_t* end) {
   }
 }
 
+void RegionSpace::RecordSurvival(SurvivalStats* stats, bool young) {
+  DCHECK(stats->IsEnabled());
+  MutexLock mu(Thread::Current(), region_lock_);
+  // SetFromSpace() already advanced the time for this collection.
+  const uint32_t collection_time = time_ - 1;
+  for (size_t i = 0; i < std::min(num_regions_, non_free_region_index_limit_); ++i) {
+    Region* r = &regions_[i];
+    // Large tails are accounted with their large region.
+    if (r->IsLargeTail() || !(r->IsInFromSpace() || r->IsInUnevacFromSpace())) {
+      continue;
+    }
+    size_t age = collection_time - std::min(r->AllocTime(), collection_time);
+    if (young && age != 0) {
+      continue;
+    }
+    size_t survived_bytes;
+    if (r->IsInFromSpace()) {
+      survived_bytes = r->EvacuatedBytes();
+    } else if (r->LiveBytes() != static_cast<size_t>(-1)) {
+      survived_bytes = r->LiveBytes();
+    } else {
+      continue;
+    }
+    size_t allocated_bytes = std::max(r->BytesAllocated(), survived_bytes);
+    stats->RecordAge(age, allocated_bytes, survived_bytes);
+    if (young) {
+      stats->RecordPromotedBytes(survived_bytes);
+    }
+  }
+}
+
 void RegionSpace::ClearFromSpace(/* out */ uint64_t* cleared_bytes,
                                  /* out */ uint64_t* cleared_objects,
                                  const bool clear_bitmap) {
@@ -844,6 +1016,7 @@ void RegionSpace::RecordAlloc(mirror::Object* ref) {
 bool RegionSpace::AllocNewTlab(Thread* self,
                                const size_t tlab_size,
                                size_t* bytes_tl_bulk_allocated) {
+  const size_t node_index = CurrentNumaNodeIndex();
   MutexLock mu(self, region_lock_);
   RevokeThreadLocalBuffersLocked(self, /*reuse=*/ gc::Heap::kUsePartialTlabs);
   Region* r = nullptr;
@@ -852,8 +1025,15 @@ bool RegionSpace::AllocNewTlab(Thread* self,
   // First attempt to get a partially used TLAB, if available.
   if (tlab_size < kRegionSize) {
     // Fetch the largest partial TLAB. The multimap is ordered in decreasing
-    // size.
+    // size. In NUMA-aware mode, only partial TLABs on the local node qualify.
     auto largest_partial_tlab = partial_tlabs_.begin();
+    if (IsNumaAware()) {
+      while (largest_partial_tlab != partial_tlabs_.end() &&
+             largest_partial_tlab->first >= tlab_size &&
+             NumaNodeIndexOf(largest_partial_tlab->second) != node_index) {
+        ++largest_partial_tlab;
+      }
+    }
     if (largest_partial_tlab != partial_tlabs_.end() && largest_partial_tlab->first >= tlab_size) {
       r = largest_partial_tlab->second;
       pos = r->End() - largest_partial_tlab->first;
@@ -866,7 +1046,7 @@ bool RegionSpace::AllocNewTlab(Thread* self,
   }
   if (r == nullptr) {
     // Fallback to allocating an entire region as TLAB.
-    r = AllocateRegion(/*for_evac=*/ false);
+    r = AllocateRegion(/*for_evac=*/ false, node_index);
   }
   if (r != nullptr) {
     uint8_t* start = pos != nullptr ? pos : r->Begin();
@@ -880,6 +1060,45 @@ bool RegionSpace::AllocNewTlab(Thread* self,
   return false;
 }
 
+bool RegionSpace::AllocNewEvacTlab(Thread* self, size_t node_index) {
+  RevokeEvacTlabLocked(self);
+  // Evacuation TLABs take whole regions, which are not counted as newly
+  // allocated, like `evac_region_`.
+  Region* r = AllocateRegion(/*for_evac=*/ true, node_index);
+  if (r == nullptr) {
+    return false;
+  }
+  r->is_a_tlab_ = true;
+  r->thread_ = self;
+  r->SetTop(r->End());
+  self->SetTlab(r->Begin(), r->End(), r->End());
+  return true;
+}
+
+void RegionSpace::RevokeEvacTlab(Thread* self) {
+  MutexLock mu(self, region_lock_);
+  RevokeEvacTlabLocked(self);
+}
+
+void RegionSpace::RevokeEvacTlabLocked(Thread* self) {
+  uint8_t* tlab_start = self->GetTlabStart();
+  if (tlab_start == nullptr) {
+    return;
+  }
+  Region* r = RefToRegionLocked(reinterpret_cast<mirror::Object*>(tlab_start));
+  DCHECK(r->IsAllocated());
+  DCHECK(r->IsInToSpace());
+  DCHECK_EQ(r->thread_, self);
+  r->is_a_tlab_ = false;
+  r->thread_ = nullptr;
+  // Unlike mutator TLABs, only the used part counts as allocated since
+  // evacuated bytes are accounted from the to-space region tops.
+  r->RecordThreadLocalAllocations(self->GetThreadLocalObjectsAllocated(),
+                                  self->GetTlabPos() - r->Begin());
+  // Not ResetTlab() as evacuation must not be seen by the heap sampler.
+  self->SetTlab(nullptr, nullptr, nullptr);
+}
+
 size_t RegionSpace::RevokeThreadLocalBuffers(Thread* thread) {
   MutexLock mu(Thread::Current(), region_lock_);
   RevokeThreadLocalBuffersLocked(thread, /*reuse=*/ gc::Heap::kUsePartialTlabs);
@@ -951,11 +1170,11 @@ void RegionSpace::Region::Dump(std::ostream& os) const {
      << " type=" << type_
      << " objects_allocated=" << objects_allocated_
      << " alloc_time=" << alloc_time_
-     << " live_bytes=" << live_bytes_;
+     << " live_bytes=" << LiveBytes();
 
-  if (live_bytes_ != static_cast<size_t>(-1)) {
+  if (LiveBytes() != static_cast<size_t>(-1)) {
     os << " ratio over allocated bytes="
-       << (static_cast<float>(live_bytes_) / RoundUp(BytesAllocated(), kRegionSize));
+       << (static_cast<float>(LiveBytes()) / RoundUp(BytesAllocated(), kRegionSize));
     uint64_t longest_consecutive_free_bytes = GetLongestConsecutiveFreeBytes();
     os << " longest_consecutive_free_bytes=" << longest_consecutive_free_bytes
        << " (" << PrettySize(longest_consecutive_free_bytes) << ")";
@@ -1010,7 +1229,8 @@ void RegionSpace::Region::Clear(bool zero_and_release_pages) {
   type_ = RegionType::kRegionTypeNone;
   objects_allocated_.store(0, std::memory_order_relaxed);
   alloc_time_ = 0;
-  live_bytes_ = static_cast<size_t>(-1);
+  live_bytes_.store(static_cast<size_t>(-1), std::memory_order_relaxed);
+  evacuated_bytes_.store(0, std::memory_order_relaxed);
   if (zero_and_release_pages) {
     ZeroAndProtectRegion(begin_, end_);
   }
@@ -1024,10 +1244,21 @@ void RegionSpace::TraceHeapSize() {
   heap->TraceHeapSize(heap->GetBytesAllocated() + EvacBytes());
 }
 
-RegionSpace::Region* RegionSpace::AllocateRegion(bool for_evac) {
+RegionSpace::Region* RegionSpace::AllocateRegion(bool for_evac, size_t node_index) {
   if (!for_evac && (num_non_free_regions_ + 1) * 2 > num_regions_) {
     return nullptr;
   }
+  if (IsNumaAware()) {
+    // Prefer a region bound to the memory of the node the thread runs on.
+    DCHECK_LT(node_index, numa_node_ids_.size());
+    const size_t end = NumaPartitionBegin(node_index + 1);
+    for (size_t i = NumaPartitionBegin(node_index); i < end; ++i) {
+      Region* r = AllocateRegionAt(i, for_evac);
+      if (r != nullptr) {
+        return r;
+      }
+    }
+  }
   for (size_t i = 0; i < num_regions_; ++i) {
     // When using the cyclic region allocation strategy, try to
     // allocate a region starting from the last cyclic allocated
@@ -1036,32 +1267,40 @@ RegionSpace::Region* RegionSpace::AllocateRegion(bool for_evac) {
     size_t region_index = kCyclicRegionAllocation
         ? ((cyclic_alloc_region_index_ + i) % num_regions_)
         : i;
-    Region* r = &regions_[region_index];
-    if (r->IsFree()) {
-      r->Unfree(this, time_);
-      if (use_generational_cc_) {
-        // TODO: Add an explanation for this assertion.
-        DCHECK_IMPLIES(for_evac, !r->is_newly_allocated_);
-      }
-      if (for_evac) {
-        ++num_evac_regions_;
-        TraceHeapSize();
-        // Evac doesn't count as newly allocated.
-      } else {
-        r->SetNewlyAllocated();
-        ++num_non_free_regions_;
-      }
-      if (kCyclicRegionAllocation) {
-        // Move the cyclic allocation region marker to the region
-        // following the one that was just allocated.
-        cyclic_alloc_region_index_ = (region_index + 1) % num_regions_;
-      }
+    Region* r = AllocateRegionAt(region_index, for_evac);
+    if (r != nullptr) {
       return r;
     }
   }
   return nullptr;
 }
 
+RegionSpace::Region* RegionSpace::AllocateRegionAt(size_t region_index, bool for_evac) {
+  Region* r = &regions_[region_index];
+  if (!r->IsFree()) {
+    return nullptr;
+  }
+  r->Unfree(this, time_);
+  if (use_generational_cc_) {
+    // TODO: Add an explanation for this assertion.
+    DCHECK_IMPLIES(for_evac, !r->is_newly_allocated_);
+  }
+  if (for_evac) {
+    ++num_evac_regions_;
+    TraceHeapSize();
+    // Evac doesn't count as newly allocated.
+  } else {
+    r->SetNewlyAllocated();
+    ++num_non_free_regions_;
+  }
+  if (kCyclicRegionAllocation) {
+    // Move the cyclic allocation region marker to the region
+    // following the one that was just allocated.
+    cyclic_alloc_region_index_ = (region_index + 1) % num_regions_;
+  }
+  return r;
+}
+
 void RegionSpace::Region::MarkAsAllocated(RegionSpace* region_space, uint32_t alloc_time) {
   DCHECK(IsFree());
   alloc_time_ = alloc_time;
@@ -24,10 +24,13 @@
 
 #include <functional>
 #include <map>
+#include <vector>
 
 namespace art {
 namespace gc {
 
+class SurvivalStats;
+
 namespace accounting {
 class ReadBarrierTable;
 }  // namespace accounting
@@ -62,7 +65,10 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   // guaranteed to be granted, if it is required, the caller should call Begin on the returned
   // space to confirm the request was granted.
   static MemMap CreateMemMap(const std::string& name, size_t capacity, uint8_t* requested_begin);
-  static RegionSpace* Create(const std::string& name, MemMap&& mem_map, bool use_generational_cc);
+  static RegionSpace* Create(const std::string& name,
+                             MemMap&& mem_map,
+                             bool use_generational_cc,
+                             bool numa_aware = false);
 
   // Allocate `num_bytes`, returns null if the space is full.
   mirror::Object* Alloc(Thread* self,
@@ -321,6 +327,25 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
     reg->AddLiveBytes(alloc_size);
   }
 
+  // Same as AddLiveBytes, but safe to call from multiple GC threads at once.
+  void AtomicAddLiveBytes(mirror::Object* ref, size_t alloc_size) {
+    Region* reg = RefToRegionUnlocked(ref);
+    reg->AtomicAddLiveBytes(alloc_size);
+  }
+
+  // Account for `from_ref` having been copied out of its from-space region. Only used for
+  // -XX:GcSurvivalStats, as evacuated regions otherwise don't track their survivors.
+  void AddEvacuatedBytes(mirror::Object* from_ref, size_t alloc_size) {
+    Region* reg = RefToRegionUnlocked(from_ref);
+    reg->AddEvacuatedBytes(alloc_size);
+  }
+
+  // Record the allocated and surviving bytes of the from-space and unevacuated from-space regions
+  // by age. Must be called once marking is done and before ClearFromSpace(). A young collection
+  // only records the regions allocated since the previous collection, and reports all their
+  // survivors as promoted.
+  void RecordSurvival(SurvivalStats* stats, bool young) REQUIRES(!region_lock_);
+
   void AssertAllRegionLiveBytesZeroOrCleared() REQUIRES(!region_lock_) {
     if (kIsDebugBuild) {
       MutexLock mu(Thread::Current(), region_lock_);
@@ -372,6 +397,16 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   bool AllocNewTlab(Thread* self, const size_t tlab_size, size_t* bytes_tl_bulk_allocated)
       REQUIRES(!region_lock_);
 
+  // Allocate `num_bytes` for an evacuated object from the evacuation TLAB of
+  // `self`, a GC worker thread, refilling the TLAB with a fresh evacuation
+  // region when it runs out. Returns null if no region is available.
+  ALWAYS_INLINE mirror::Object* AllocInEvacTlab(Thread* self,
+                                                size_t num_bytes,
+                                                /* out */ size_t* bytes_allocated)
+      REQUIRES(!region_lock_);
+  // Return the unused part of the evacuation TLAB of `self`, if any.
+  void RevokeEvacTlab(Thread* self) REQUIRES(!region_lock_);
+
   uint32_t Time() {
     return time_;
   }
@@ -384,14 +419,62 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
     return madvise_time_;
   }
 
+  // True if the regions are partitioned over the NUMA nodes of the machine,
+  // each partition being bound to the memory of its node. Regions are then
+  // preferably allocated from the partition of the node the allocating thread
+  // runs on.
+  bool IsNumaAware() const {
+    return !numa_node_ids_.empty();
+  }
+
+  size_t GetNumaNodeCount() const {
+    return numa_node_ids_.size();
+  }
+
+  // Restrict `thread` to the CPUs of the `node_index`-th NUMA node so that it
+  // allocates, and evacuates objects into, regions local to that node.
+  void BindThreadToNumaNode(Thread* thread, size_t node_index);
+
+  // Parse a sysfs list of ranges, like "0-3,8,10-11", appending the values to
+  // `values`. Returns false if the list is malformed or empty.
+  static bool ParseSysfsList(const std::string& list, std::vector<uint32_t>* values);
+  // Read the online NUMA nodes that have CPUs, and their CPUs, from the sysfs
+  // node directory `node_dir` (/sys/devices/system/node). Returns false, with
+  // empty outputs, if they can't be read or if there are fewer than two such
+  // nodes or more than `max_nodes`.
+  static bool ReadNumaNodes(const std::string& node_dir,
+                            size_t max_nodes,
+                            std::vector<uint32_t>* node_ids,
+                            std::vector<std::vector<uint32_t>>* node_cpus);
+
  private:
-  RegionSpace(const std::string& name, MemMap&& mem_map, bool use_generational_cc);
+  RegionSpace(const std::string& name,
+              MemMap&& mem_map,
+              bool use_generational_cc,
+              bool numa_aware);
+
+  // Partition the regions over the NUMA nodes and bind each partition to the
+  // memory of its node. Leaves the space NUMA-unaware if there is only one
+  // node or binding fails.
+  void InitNumaPartitions() NO_THREAD_SAFETY_ANALYSIS;
+  // Index of the first region of the partition of the `node_index`-th NUMA
+  // node. `node_index` may be the node count, for the end of the last partition.
+  size_t NumaPartitionBegin(size_t node_index) const {
+    return node_index * num_regions_ / numa_node_ids_.size();
+  }
+  size_t NumaNodeIndexOf(const Region* r) const {
+    return ((r->Idx() + 1) * numa_node_ids_.size() - 1) / num_regions_;
+  }
+  // Index of the NUMA node the calling thread runs on, or 0 if the space isn't
+  // NUMA-aware. Call it before taking `region_lock_`, for AllocateRegion().
+  size_t CurrentNumaNodeIndex() const;
 
   class Region {
    public:
     Region()
         : idx_(static_cast<size_t>(-1)),
           live_bytes_(static_cast<size_t>(-1)),
+          evacuated_bytes_(0),
           begin_(nullptr),
           thread_(nullptr),
           top_(nullptr),
@@ -412,7 +495,8 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
       type_ = RegionType::kRegionTypeNone;
       objects_allocated_.store(0, std::memory_order_relaxed);
       alloc_time_ = 0;
-      live_bytes_ = static_cast<size_t>(-1);
+      live_bytes_.store(static_cast<size_t>(-1), std::memory_order_relaxed);
+      evacuated_bytes_.store(0, std::memory_order_relaxed);
       is_newly_allocated_ = false;
       is_a_tlab_ = false;
       thread_ = nullptr;
@@ -479,7 +563,7 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
     }
 
     void ZeroLiveBytes() {
-      live_bytes_ = 0;
+      live_bytes_.store(0, std::memory_order_relaxed);
     }
 
     // Large-tail allocated.
@@ -537,7 +621,8 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
       // Set live bytes to an invalid value, as we have made an
       // evacuation decision (possibly based on the percentage of live
       // bytes).
-      live_bytes_ = static_cast<size_t>(-1);
+      live_bytes_.store(static_cast<size_t>(-1), std::memory_order_relaxed);
+      evacuated_bytes_.store(0, std::memory_order_relaxed);
     }
 
     // Set this region as unevacuated from-space. At the end of the
@@ -559,10 +644,32 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
     void AddLiveBytes(size_t live_bytes) {
       DCHECK(GetUseGenerationalCC() || IsInUnevacFromSpace());
       DCHECK(!IsLargeTail());
-      DCHECK_NE(live_bytes_, static_cast<size_t>(-1));
+      DCHECK_NE(LiveBytes(), static_cast<size_t>(-1));
       // For large allocations, we always consider all bytes in the regions live.
-      live_bytes_ += IsLarge() ? Top() - begin_ : live_bytes;
-      DCHECK_LE(live_bytes_, BytesAllocated());
+      live_bytes_.store(LiveBytes() + (IsLarge() ? Top() - begin_ : live_bytes),
+                        std::memory_order_relaxed);
+      DCHECK_LE(LiveBytes(), BytesAllocated());
+    }
+
+    void AtomicAddLiveBytes(size_t live_bytes) {
+      DCHECK(GetUseGenerationalCC() || IsInUnevacFromSpace());
+      DCHECK(!IsLargeTail());
+      DCHECK_NE(LiveBytes(), static_cast<size_t>(-1));
+      live_bytes_.fetch_add(IsLarge() ? Top() - begin_ : live_bytes, std::memory_order_relaxed);
+    }
+
+    void AddEvacuatedBytes(size_t bytes) {
+      DCHECK(IsInFromSpace());
+      // Objects may be copied by mutators as well as by GC threads.
+      evacuated_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    size_t EvacuatedBytes() const {
+      return evacuated_bytes_.load(std::memory_order_relaxed);
+    }
+
+    uint32_t AllocTime() const {
+      return alloc_time_;
     }
 
     bool AllAllocatedBytesAreLive() const {
@@ -570,7 +677,7 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
     }
 
     size_t LiveBytes() const {
-      return live_bytes_;
+      return live_bytes_.load(std::memory_order_relaxed);
     }
 
     // Returns the number of allocated bytes.  "Bulk allocated" bytes in active TLABs are excluded.
@@ -619,8 +726,11 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
     // region is completely empty, and thus can be reclaimed. Reset to zero either at the
     // beginning of MarkingPhase(), or during the flip for a nongenerational GC, where we
     // don't have a separate mark phase. It is then incremented whenever a mark bit in that
-    // region is set.
-    size_t live_bytes_;                 // The live bytes. Used to compute the live percent.
+    // region is set, concurrently by the GC threads when they scan objects in parallel.
+    Atomic<size_t> live_bytes_;         // The live bytes. Used to compute the live percent.
+    // Bytes copied out of this region while it is in from-space, only maintained with
+    // -XX:GcSurvivalStats.
+    Atomic<size_t> evacuated_bytes_;
     uint8_t* begin_;                    // The begin address of the region.
     Thread* thread_;                    // The owning thread if it's a tlab.
     // Note that `top_` can be higher than `end_` in the case of a
@@ -712,8 +822,13 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
     }
   }
 
-  Region* AllocateRegion(bool for_evac) REQUIRES(region_lock_);
+  // In NUMA-aware mode, prefers the partition of the `node_index`-th node.
+  Region* AllocateRegion(bool for_evac, size_t node_index) REQUIRES(region_lock_);
+  // Allocate the region at `region_index` if it is free, otherwise return null.
+  Region* AllocateRegionAt(size_t region_index, bool for_evac) REQUIRES(region_lock_);
   void RevokeThreadLocalBuffersLocked(Thread* thread, bool reuse) REQUIRES(region_lock_);
+  bool AllocNewEvacTlab(Thread* self, size_t node_index) REQUIRES(region_lock_);
+  void RevokeEvacTlabLocked(Thread* self) REQUIRES(region_lock_);
 
   // Scan region range [`begin`, `end`) in increasing order to try to
   // allocate a large region having a size of `num_regs_in_large_region`
@@ -785,6 +900,14 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   // Mark bitmap used by the GC.
   accounting::ContinuousSpaceBitmap mark_bitmap_;
 
+  // Ids of the NUMA nodes the regions are partitioned over, in region order.
+  // Empty unless the NUMA-aware mode is on.
+  std::vector<uint32_t> numa_node_ids_;
+  // CPUs of each of the nodes in `numa_node_ids_`.
+  std::vector<std::vector<uint32_t>> numa_node_cpus_;
+  // Index in `numa_node_ids_` of the node of each CPU, indexed by CPU number.
+  std::vector<uint32_t> numa_cpu_node_indexes_;
+
   DISALLOW_COPY_AND_ASSIGN(RegionSpace);
 };
 
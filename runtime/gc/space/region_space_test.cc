@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "region_space.h"
+
+#include <sys/stat.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "android-base/file.h"
+#include "base/common_art_test.h"
+
+namespace art {
+namespace gc {
+namespace space {
+
+// Reads NUMA nodes from a fake sysfs node directory.
+class RegionSpaceNumaTest : public CommonArtTest {
+ protected:
+  void SetUp() override {
+    CommonArtTest::SetUp();
+    dir_.reset(new ScratchDir());
+  }
+
+  void TearDown() override {
+    dir_.reset();
+    CommonArtTest::TearDown();
+  }
+
+  void SetOnline(const std::string& online) {
+    ASSERT_TRUE(android::base::WriteStringToFile(online, dir_->GetPath() + "online"));
+  }
+
+  void AddNode(uint32_t node_id, const std::string& cpu_list) {
+    std::string node_dir = dir_->GetPath() + "node" + std::to_string(node_id);
+    ASSERT_EQ(0, mkdir(node_dir.c_str(), 0700));
+    ASSERT_TRUE(android::base::WriteStringToFile(cpu_list, node_dir + "/cpulist"));
+  }
+
+  bool ReadNumaNodes(size_t max_nodes = 64) {
+    node_ids_.clear();
+    node_cpus_.clear();
+    return RegionSpace::ReadNumaNodes(dir_->GetPath(), max_nodes, &node_ids_, &node_cpus_);
+  }
+
+  std::unique_ptr<ScratchDir> dir_;
+  std::vector<uint32_t> node_ids_;
+  std::vector<std::vector<uint32_t>> node_cpus_;
+};
+
+TEST(RegionSpaceTest, ParseSysfsList) {
+  std::vector<uint32_t> values;
+  EXPECT_TRUE(RegionSpace::ParseSysfsList("0-3,8,10-11\n", &values));
+  EXPECT_EQ(values, std::vector<uint32_t>({0, 1, 2, 3, 8, 10, 11}));
+  values.clear();
+  EXPECT_TRUE(RegionSpace::ParseSysfsList("5", &values));
+  EXPECT_EQ(values, std::vector<uint32_t>({5}));
+
+  for (const char* list : {"", "\n", "1-", "-1", "3-1", "1-2-3", "a", "1,,2"}) {
+    values.clear();
+    EXPECT_FALSE(RegionSpace::ParseSysfsList(list, &values)) << list;
+  }
+}
+
+TEST_F(RegionSpaceNumaTest, TwoNodes) {
+  SetOnline("0-1\n");
+  AddNode(0, "0-3\n");
+  AddNode(1, "4-5,7\n");
+  ASSERT_TRUE(ReadNumaNodes());
+  EXPECT_EQ(node_ids_, std::vector<uint32_t>({0, 1}));
+  ASSERT_EQ(node_cpus_.size(), 2u);
+  EXPECT_EQ(node_cpus_[0], std::vector<uint32_t>({0, 1, 2, 3}));
+  EXPECT_EQ(node_cpus_[1], std::vector<uint32_t>({4, 5, 7}));
+}
+
+TEST_F(RegionSpaceNumaTest, SkipsMemoryOnlyNodes) {
+  SetOnline("0-2\n");
+  AddNode(0, "0-1\n");
+  // An empty cpulist, as sysfs has for nodes without CPUs.
+  AddNode(1, "\n");
+  AddNode(2, "2-3\n");
+  ASSERT_TRUE(ReadNumaNodes());
+  EXPECT_EQ(node_ids_, std::vector<uint32_t>({0, 2}));
+  ASSERT_EQ(node_cpus_.size(), 2u);
+  EXPECT_EQ(node_cpus_[1], std::vector<uint32_t>({2, 3}));
+}
+
+TEST_F(RegionSpaceNumaTest, NoNodes) {
+  // No "online" file, as on kernels without NUMA support.
+  EXPECT_FALSE(ReadNumaNodes());
+  EXPECT_TRUE(node_ids_.empty());
+  EXPECT_TRUE(node_cpus_.empty());
+
+  SetOnline("garbage\n");
+  EXPECT_FALSE(ReadNumaNodes());
+  EXPECT_TRUE(node_ids_.empty());
+}
+
+TEST_F(RegionSpaceNumaTest, SingleNode) {
+  SetOnline("0\n");
+  AddNode(0, "0-7\n");
+  EXPECT_FALSE(ReadNumaNodes());
+  EXPECT_TRUE(node_ids_.empty());
+  EXPECT_TRUE(node_cpus_.empty());
+}
+
+TEST_F(RegionSpaceNumaTest, SingleNodeWithCpus) {
+  // Node 1 is online but its directory is missing, node 2 has no CPUs.
+  SetOnline("0-2\n");
+  AddNode(0, "0-7\n");
+  AddNode(2, "\n");
+  EXPECT_FALSE(ReadNumaNodes());
+  EXPECT_TRUE(node_ids_.empty());
+  EXPECT_TRUE(node_cpus_.empty());
+}
+
+TEST_F(RegionSpaceNumaTest, MoreNodesThanRegions) {
+  SetOnline("0-2\n");
+  AddNode(0, "0\n");
+  AddNode(1, "1\n");
+  AddNode(2, "2\n");
+  EXPECT_FALSE(ReadNumaNodes(/*max_nodes=*/ 2));
+  EXPECT_TRUE(node_ids_.empty());
+  ASSERT_TRUE(ReadNumaNodes(/*max_nodes=*/ 3));
+  EXPECT_EQ(node_ids_.size(), 3u);
+}
+
+}  // namespace space
+}  // namespace gc
+}  // namespace art
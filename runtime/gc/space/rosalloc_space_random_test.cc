@@ -16,6 +16,14 @@
 
 #include "space_test.h"
 
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "base/time_utils.h"
+#include "gc/allocator/rosalloc.h"
 #include "rosalloc_space.h"
 
 namespace art {
@@ -37,6 +45,100 @@ MallocSpace* CreateRosAllocSpace(const std::string& name,
 
 TEST_SPACE_CREATE_FN_RANDOM(RosAllocSpace, CreateRosAllocSpace)
 
+class RosAllocSpaceThroughputTest : public SpaceTest<CommonRuntimeTest> {};
+
+// Several threads allocate random sizes up to the largest thread-local run bracket. Each frees
+// half of its objects itself and hands the other half to the main thread, which bulk frees them
+// concurrently as the GC would. Logs the allocation throughput.
+TEST_F(RosAllocSpaceThroughputTest, MultiThreadedRandomAllocations) {
+  constexpr size_t kNumThreads = 4;
+  constexpr size_t kNumBatches = 200;
+  constexpr size_t kBatchSize = 512;
+  constexpr size_t kMaxSize = allocator::RosAlloc::kMaxThreadLocalRunBracketSize;
+  MallocSpace* space = CreateRosAllocSpace("test", 16 * MB, 64 * MB, 64 * MB);
+  ASSERT_TRUE(space != nullptr);
+  AddSpace(space);
+  Runtime* runtime = Runtime::Current();
+  Thread* self = Thread::Current();
+  std::mutex to_free_lock;
+  std::vector<std::vector<mirror::Object*>> to_free;
+  std::atomic<size_t> num_running(kNumThreads);
+  std::atomic<size_t> num_failed(0);
+  std::vector<std::thread> threads;
+  uint64_t start = NanoTime();
+  for (size_t t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      CHECK(runtime->AttachCurrentThread("RosAlloc throughput test thread",
+                                         /* as_daemon= */ false,
+                                         /* thread_group= */ nullptr,
+                                         /* create_peer= */ false));
+      Thread* thread_self = Thread::Current();
+      size_t rand_seed = 123456789 + t;
+      {
+        ScopedObjectAccess soa(thread_self);
+        for (size_t i = 0; i < kNumBatches; ++i) {
+          std::vector<mirror::Object*> remote;
+          remote.reserve(kBatchSize / 2);
+          for (size_t j = 0; j < kBatchSize; ++j) {
+            size_t alloc_size = std::max(test_rand(&rand_seed) % (kMaxSize + 1),
+                                         SizeOfZeroLengthByteArray());
+            size_t bytes_allocated;
+            size_t usable_size;
+            size_t bytes_tl_bulk_allocated;
+            mirror::Object* obj = space->Alloc(
+                thread_self, alloc_size, &bytes_allocated, &usable_size, &bytes_tl_bulk_allocated);
+            if (obj == nullptr) {
+              num_failed.fetch_add(1, std::memory_order_relaxed);
+            } else if (j % 2 == 0) {
+              space->Free(thread_self, obj);
+            } else {
+              remote.push_back(obj);
+            }
+          }
+          std::lock_guard<std::mutex> lock(to_free_lock);
+          to_free.push_back(std::move(remote));
+        }
+      }
+      num_running.fetch_sub(1, std::memory_order_release);
+      runtime->DetachCurrentThread();
+    });
+  }
+  {
+    ScopedObjectAccess soa(self);
+    while (true) {
+      bool done = num_running.load(std::memory_order_acquire) == 0;
+      std::vector<std::vector<mirror::Object*>> batches;
+      {
+        std::lock_guard<std::mutex> lock(to_free_lock);
+        batches.swap(to_free);
+      }
+      for (std::vector<mirror::Object*>& batch : batches) {
+        space->FreeList(self, batch.size(), batch.data());
+      }
+      if (done) {
+        break;
+      }
+      if (batches.empty()) {
+        ScopedThreadSuspension sts(self, ThreadState::kNative);
+        std::this_thread::yield();
+      }
+    }
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  uint64_t duration = NanoTime() - start;
+
+  EXPECT_EQ(num_failed.load(), 0u);
+  space->RevokeAllThreadLocalBuffers();
+  EXPECT_EQ(space->GetBytesAllocated(), 0u);
+  constexpr size_t kNumAllocations = kNumThreads * kNumBatches * kBatchSize;
+  LOG(INFO) << kNumAllocations << " allocations of up to " << kMaxSize << " bytes from "
+            << kNumThreads << " threads in " << PrettyDuration(duration) << ": "
+            << kNumAllocations * 1000 / std::max<uint64_t>(duration / MsToNs(1), 1)
+            << " allocations/s";
+}
+
 }  // namespace
 }  // namespace space
 }  // namespace gc
@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "survival_stats.h"
+
+#include <algorithm>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include "base/metrics/metrics.h"
+#include "base/utils.h"
+#include "mirror/class-inl.h"
+#include "thread-current-inl.h"
+
+namespace art {
+namespace gc {
+
+SurvivalStats::SurvivalStats(bool enabled)
+    : enabled_(enabled),
+      survivor_bytes_(0u),
+      lock_("survival stats lock", kGenericBottomLock),
+      young_(false),
+      current_allocated_bytes_(0u),
+      current_survived_bytes_(0u),
+      current_promoted_bytes_(0u),
+      allocated_bytes_(),
+      survived_bytes_(),
+      promoted_bytes_(0u),
+      young_collections_(0u),
+      full_collections_(0u) {}
+
+void SurvivalStats::StartCollection(bool young) {
+  MutexLock mu(Thread::Current(), lock_);
+  young_ = young;
+  current_allocated_bytes_ = 0u;
+  current_survived_bytes_ = 0u;
+  current_promoted_bytes_ = 0u;
+}
+
+void SurvivalStats::RecordAge(size_t age, uint64_t allocated_bytes, uint64_t survived_bytes) {
+  DCHECK_LE(survived_bytes, allocated_bytes);
+  if (age != kUnknownAge) {
+    age = std::min(age, kNumAges - 1);
+  }
+  MutexLock mu(Thread::Current(), lock_);
+  allocated_bytes_[age] += allocated_bytes;
+  survived_bytes_[age] += survived_bytes;
+  current_allocated_bytes_ += allocated_bytes;
+  current_survived_bytes_ += survived_bytes;
+}
+
+void SurvivalStats::RecordPromotedBytes(uint64_t bytes) {
+  MutexLock mu(Thread::Current(), lock_);
+  promoted_bytes_ += bytes;
+  current_promoted_bytes_ += bytes;
+}
+
+void SurvivalStats::SampleClass(mirror::Class* klass) {
+  MutexLock mu(Thread::Current(), lock_);
+  ++sampled_classes_[klass];
+}
+
+void SurvivalStats::ResolveSampledClasses() {
+  Thread* self = Thread::Current();
+  std::unordered_map<mirror::Class*, uint64_t> samples;
+  {
+    MutexLock mu(self, lock_);
+    samples.swap(sampled_classes_);
+  }
+  if (samples.empty()) {
+    return;
+  }
+  // Getting the descriptors may take other locks.
+  std::vector<std::pair<std::string, uint64_t>> resolved;
+  resolved.reserve(samples.size());
+  for (const auto& [klass, count] : samples) {
+    resolved.emplace_back(klass->PrettyDescriptor(), count * kClassSampleInterval);
+  }
+  MutexLock mu(self, lock_);
+  for (const auto& [descriptor, bytes] : resolved) {
+    class_bytes_[descriptor] += bytes;
+  }
+}
+
+void SurvivalStats::FinishCollection(metrics::ArtMetrics* metrics) {
+  MutexLock mu(Thread::Current(), lock_);
+  if (young_) {
+    ++young_collections_;
+  } else {
+    ++full_collections_;
+  }
+  if (metrics == nullptr) {
+    return;
+  }
+  if (current_allocated_bytes_ != 0) {
+    int64_t rate = static_cast<int64_t>(current_survived_bytes_ * 100 / current_allocated_bytes_);
+    if (young_) {
+      metrics->YoungGcSurvivalRate()->Add(rate);
+    } else {
+      metrics->FullGcSurvivalRate()->Add(rate);
+    }
+  }
+  if (young_) {
+    metrics->YoungGcPromotedBytes()->Add(current_promoted_bytes_);
+    metrics->YoungGcPromotedBytesDelta()->Add(current_promoted_bytes_);
+  }
+}
+
+double SurvivalStats::GetSurvivalRate(size_t age) {
+  MutexLock mu(Thread::Current(), lock_);
+  DCHECK_LE(age, kUnknownAge);
+  return allocated_bytes_[age] == 0
+      ? 0.0
+      : static_cast<double>(survived_bytes_[age]) * 100.0 / allocated_bytes_[age];
+}
+
+uint64_t SurvivalStats::GetPromotedBytes() {
+  MutexLock mu(Thread::Current(), lock_);
+  return promoted_bytes_;
+}
+
+std::map<std::string, uint64_t> SurvivalStats::GetSurvivorClasses() {
+  MutexLock mu(Thread::Current(), lock_);
+  return class_bytes_;
+}
+
+void SurvivalStats::Dump(std::ostream& os) {
+  if (!IsEnabled()) {
+    return;
+  }
+  MutexLock mu(Thread::Current(), lock_);
+  os << "Survival stats: " << young_collections_ << " young and " << full_collections_
+     << " full collections, " << PrettySize(promoted_bytes_) << " promoted\n";
+  for (size_t age = 0; age <= kUnknownAge; ++age) {
+    if (allocated_bytes_[age] == 0) {
+      continue;
+    }
+    if (age == kUnknownAge) {
+      os << "  unknown age";
+    } else {
+      os << "  age " << age << (age == kNumAges - 1 ? "+" : "");
+    }
+    os << ": " << PrettySize(survived_bytes_[age]) << " of " << PrettySize(allocated_bytes_[age])
+       << " survived (" << survived_bytes_[age] * 100 / allocated_bytes_[age] << "%)\n";
+  }
+  if (class_bytes_.empty()) {
+    return;
+  }
+  std::vector<std::pair<uint64_t, const std::string*>> top;
+  top.reserve(class_bytes_.size());
+  for (const auto& [descriptor, bytes] : class_bytes_) {
+    top.emplace_back(bytes, &descriptor);
+  }
+  size_t num_top = std::min(top.size(), kNumTopClasses);
+  std::partial_sort(top.begin(), top.begin() + num_top, top.end(), [](auto& a, auto& b) {
+    return a.first > b.first;
+  });
+  os << "  Top surviving classes (sampled):\n";
+  for (size_t i = 0; i < num_top; ++i) {
+    os << "    " << *top[i].second << ": ~" << PrettySize(top[i].first) << "\n";
+  }
+}
+
+}  // namespace gc
+}  // namespace art
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_GC_SURVIVAL_STATS_H_
+#define ART_RUNTIME_GC_SURVIVAL_STATS_H_
+
+#include <stdint.h>
+
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+#include "base/atomic.h"
+#include "base/locks.h"
+#include "base/macros.h"
+#include "base/mutex.h"
+#include "base/units.h"
+
+namespace art {
+
+namespace metrics {
+class ArtMetrics;
+}  // namespace metrics
+
+namespace mirror {
+class Class;
+}  // namespace mirror
+
+namespace gc {
+
+// Optional per-collection instrumentation enabled with -XX:GcSurvivalStats. The collectors report
+// how many bytes were allocated and how many survived, bucketed by the age of the memory that held
+// them, how many bytes were promoted to the old generation, and which classes the survivors belong
+// to. Ages count the collections since a region was filled, so with generational CC age 0 is the
+// young generation. CMC only tells its young generation apart, so its full collections report
+// under kUnknownAge.
+//
+// Survivor classes are sampled once per kClassSampleInterval bytes of survivors so that the hot
+// path stays a single atomic add. All the other methods are called by the thread running the GC,
+// except Dump.
+class SurvivalStats {
+ public:
+  // Ages at or above kNumAges - 1 share the last bucket.
+  static constexpr size_t kNumAges = 8;
+  static constexpr size_t kUnknownAge = kNumAges;
+  static constexpr size_t kClassSampleInterval = 256 * KB;
+  static constexpr size_t kNumTopClasses = 10;
+
+  explicit SurvivalStats(bool enabled);
+
+  bool IsEnabled() const {
+    return enabled_;
+  }
+
+  void StartCollection(bool young);
+
+  // Record `allocated_bytes` of memory of the given age, of which `survived_bytes` survived the
+  // current collection.
+  void RecordAge(size_t age, uint64_t allocated_bytes, uint64_t survived_bytes);
+
+  // Record bytes which survived the current collection and moved to the old generation.
+  void RecordPromotedBytes(uint64_t bytes);
+
+  // Record a surviving object. May be called concurrently by several GC threads. The class must
+  // stay valid until the following ResolveSampledClasses().
+  ALWAYS_INLINE void RecordSurvivor(mirror::Class* klass, size_t bytes) {
+    size_t before = survivor_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+    if (UNLIKELY(before / kClassSampleInterval != (before + bytes) / kClassSampleInterval)) {
+      SampleClass(klass);
+    }
+  }
+
+  // Turn the classes sampled so far into descriptors. Must be called while the sampled classes are
+  // still valid, i.e. before the collector moves or frees them.
+  void ResolveSampledClasses() REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!lock_);
+
+  // Report the current collection to the metrics, which may be null.
+  void FinishCollection(metrics::ArtMetrics* metrics) REQUIRES(!lock_);
+
+  // Survival rate, in percent, of the memory of the given age across all collections so far.
+  double GetSurvivalRate(size_t age) REQUIRES(!lock_);
+  uint64_t GetPromotedBytes() REQUIRES(!lock_);
+  // Estimated bytes of survivors per class descriptor across all collections so far.
+  std::map<std::string, uint64_t> GetSurvivorClasses() REQUIRES(!lock_);
+
+  void Dump(std::ostream& os) REQUIRES(!lock_);
+
+ private:
+  void SampleClass(mirror::Class* klass) REQUIRES(!lock_);
+
+  const bool enabled_;
+  // Bytes of survivors recorded by RecordSurvivor() since the first collection.
+  Atomic<size_t> survivor_bytes_;
+
+  Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  bool young_ GUARDED_BY(lock_);
+  // Totals of the current collection.
+  uint64_t current_allocated_bytes_ GUARDED_BY(lock_);
+  uint64_t current_survived_bytes_ GUARDED_BY(lock_);
+  uint64_t current_promoted_bytes_ GUARDED_BY(lock_);
+  // Totals across all collections, per age.
+  uint64_t allocated_bytes_[kNumAges + 1] GUARDED_BY(lock_);
+  uint64_t survived_bytes_[kNumAges + 1] GUARDED_BY(lock_);
+  uint64_t promoted_bytes_ GUARDED_BY(lock_);
+  uint64_t young_collections_ GUARDED_BY(lock_);
+  uint64_t full_collections_ GUARDED_BY(lock_);
+  // Number of samples per class not resolved yet.
+  std::unordered_map<mirror::Class*, uint64_t> sampled_classes_ GUARDED_BY(lock_);
+  // Estimated survivor bytes per class descriptor.
+  std::map<std::string, uint64_t> class_bytes_ GUARDED_BY(lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(SurvivalStats);
+};
+
+}  // namespace gc
+}  // namespace art
+
+#endif  // ART_RUNTIME_GC_SURVIVAL_STATS_H_
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "survival_stats.h"
+
+#include <sstream>
+
+#include "base/metrics/metrics.h"
+#include "class_linker.h"
+#include "common_runtime_test.h"
+#include "mirror/class-inl.h"
+#include "scoped_thread_state_change-inl.h"
+
+namespace art {
+namespace gc {
+
+class SurvivalStatsTest : public CommonRuntimeTest {};
+
+TEST_F(SurvivalStatsTest, Ages) {
+  SurvivalStats stats(/*enabled=*/ true);
+  metrics::ArtMetrics metrics;
+  stats.StartCollection(/*young=*/ true);
+  stats.RecordAge(0u, 100 * KB, 10 * KB);
+  stats.RecordPromotedBytes(10 * KB);
+  stats.FinishCollection(&metrics);
+  stats.StartCollection(/*young=*/ false);
+  stats.RecordAge(0u, 100 * KB, 30 * KB);
+  stats.RecordAge(1u, 100 * KB, 50 * KB);
+  // Old ages share the last bucket.
+  stats.RecordAge(SurvivalStats::kNumAges + 5, 100 * KB, 90 * KB);
+  stats.RecordAge(SurvivalStats::kUnknownAge, 100 * KB, 100 * KB);
+  stats.FinishCollection(&metrics);
+
+  EXPECT_EQ(stats.GetSurvivalRate(0u), 20.0);
+  EXPECT_EQ(stats.GetSurvivalRate(1u), 50.0);
+  EXPECT_EQ(stats.GetSurvivalRate(2u), 0.0);
+  EXPECT_EQ(stats.GetSurvivalRate(SurvivalStats::kNumAges - 1), 90.0);
+  EXPECT_EQ(stats.GetSurvivalRate(SurvivalStats::kUnknownAge), 100.0);
+  EXPECT_EQ(stats.GetPromotedBytes(), 10 * KB);
+
+  std::ostringstream oss;
+  stats.Dump(oss);
+  EXPECT_NE(oss.str().find("1 young and 1 full collections"), std::string::npos) << oss.str();
+  EXPECT_NE(oss.str().find("unknown age"), std::string::npos) << oss.str();
+}
+
+TEST_F(SurvivalStatsTest, SampledClasses) {
+  ScopedObjectAccess soa(Thread::Current());
+  ObjPtr<mirror::Class> object_class = class_linker_->FindSystemClass(soa.Self(),
+                                                                       "Ljava/lang/Object;");
+  ObjPtr<mirror::Class> string_class = class_linker_->FindSystemClass(soa.Self(),
+                                                                       "Ljava/lang/String;");
+  ASSERT_TRUE(object_class != nullptr);
+  ASSERT_TRUE(string_class != nullptr);
+  SurvivalStats stats(/*enabled=*/ true);
+  stats.StartCollection(/*young=*/ false);
+  // Three quarters of the survivor bytes are strings, in runs of a sample interval each.
+  constexpr size_t kObjectsPerSample = SurvivalStats::kClassSampleInterval / KB;
+  for (size_t i = 0; i < 4 * KB; ++i) {
+    bool is_object = (i / kObjectsPerSample) % 4 == 0;
+    stats.RecordSurvivor((is_object ? object_class : string_class).Ptr(), KB);
+  }
+  stats.ResolveSampledClasses();
+  stats.FinishCollection(/*metrics=*/ nullptr);
+  std::map<std::string, uint64_t> classes = stats.GetSurvivorClasses();
+  ASSERT_EQ(classes.size(), 2u);
+  EXPECT_EQ(classes["java.lang.String"] + classes["java.lang.Object"], 4 * MB);
+  EXPECT_EQ(classes["java.lang.String"], 3 * MB);
+  std::ostringstream oss;
+  stats.Dump(oss);
+  EXPECT_NE(oss.str().find("java.lang.String"), std::string::npos) << oss.str();
+}
+
+TEST_F(SurvivalStatsTest, Disabled) {
+  SurvivalStats stats(/*enabled=*/ false);
+  EXPECT_FALSE(stats.IsEnabled());
+  std::ostringstream oss;
+  stats.Dump(oss);
+  EXPECT_TRUE(oss.str().empty());
+}
+
+}  // namespace gc
+}  // namespace art
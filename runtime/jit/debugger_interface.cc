@@ -332,7 +332,7 @@ static const JITCodeEntry* CreateJITCodeEntryInternal(
 
   // We must insert entries at specific place.  See NativeDebugInfoPreFork().
   const JITCodeEntry* next = descriptor.head_.load(kNonRacingRelaxed);  // Insert at the head.
-  if (descriptor.zygote_head_entry_ != nullptr && Runtime::Current()->IsZygote()) {
+  if (descriptor.zygote_head_entry_ != nullptr && Runtime::Current()->IsSharingJitCode()) {
     next = nullptr;  // Insert zygote entries at the tail.
   }
 
@@ -455,7 +455,7 @@ void RemoveNativeDebugInfoForDex(Thread* self, const DexFile* dexfile) {
 // The benefit is that this makes it fast to read only the new entries.
 //
 void NativeDebugInfoPreFork() {
-  CHECK(Runtime::Current()->IsZygote());
+  CHECK(Runtime::Current()->IsSharingJitCode());
   JITDescriptor& descriptor = JitNativeInfo::Descriptor();
   if (descriptor.zygote_head_entry_ != nullptr) {
     return;  // Already done - we need to do this only on the first fork.
@@ -477,7 +477,7 @@ void NativeDebugInfoPreFork() {
 }
 
 void NativeDebugInfoPostFork() {
-  CHECK(!Runtime::Current()->IsZygote());
+  CHECK(!Runtime::Current()->IsSharingJitCode());
   JITDescriptor& descriptor = JitNativeInfo::Descriptor();
   descriptor.free_entries_ = nullptr;  // Don't reuse zygote's entries.
 }
@@ -493,7 +493,7 @@ static void RepackEntries(bool compress_entries, ArrayRef<const void*> removed)
     return;
   }
   JITDescriptor& descriptor = __jit_debug_descriptor;
-  bool is_zygote = Runtime::Current()->IsZygote();
+  bool is_zygote = Runtime::Current()->IsSharingJitCode();
 
   // Collect entries that we want to pack.
   std::vector<const JITCodeEntry*> entries;
@@ -598,7 +598,7 @@ void AddNativeDebugInfoForJit(const void* code_ptr,
   // We delay compression until after GC since it is more expensive (and saves further ~4x).
   // Always compress zygote, since it does not GC and we want to keep the high-water mark low.
   if (++g_jit_num_unpacked_entries >= kJitRepackFrequency) {
-    bool is_zygote = Runtime::Current()->IsZygote();
+    bool is_zygote = Runtime::Current()->IsSharingJitCode();
     RepackEntries(/*compress_entries=*/ is_zygote, /*removed=*/ ArrayRef<const void*>());
   }
 }
@@ -17,21 +17,32 @@
 #include "jit.h"
 
 #include <dlfcn.h>
+#include <unistd.h>
 
+#include <algorithm>
+
+#include "arch/context.h"
 #include "art_method-inl.h"
+#include "base/bit_utils.h"
+#include "base/bit_utils_iterator.h"
 #include "base/enums.h"
 #include "base/file_utils.h"
 #include "base/logging.h"  // For VLOG.
 #include "base/memfd.h"
 #include "base/memory_tool.h"
+#include "base/os.h"
 #include "base/runtime_debug.h"
 #include "base/scoped_flock.h"
+#include "base/stl_util.h"
 #include "base/utils.h"
+#include "class_linker.h"
 #include "class_root-inl.h"
 #include "compilation_kind.h"
 #include "debugger.h"
+#include "dex/dex_file_loader.h"
 #include "dex/type_lookup_table.h"
 #include "gc/space/image_space.h"
+#include "handle_scope-inl.h"
 #include "entrypoints/entrypoint_utils-inl.h"
 #include "entrypoints/runtime_asm_entrypoints.h"
 #include "image-inl.h"
@@ -39,6 +50,7 @@
 #include "jit-inl.h"
 #include "jit_code_cache.h"
 #include "jni/java_vm_ext.h"
+#include "mirror/dex_cache-inl.h"
 #include "mirror/method_handle_impl.h"
 #include "mirror/var_handle.h"
 #include "oat_file.h"
@@ -61,6 +73,11 @@ namespace jit {
 
 static constexpr bool kEnableOnStackReplacement = true;
 
+// Whether the baseline compiled code goes through the suspend check when it gets hot in a loop,
+// and baseline frames can be replaced by OSR frames.
+static constexpr bool kEnableOnStackReplacementFromBaseline =
+    kRuntimeISA == InstructionSet::kArm64 || kRuntimeISA == InstructionSet::kX86_64;
+
 // Maximum permitted threshold value.
 static constexpr uint32_t kJitMaxThreshold = std::numeric_limits<uint16_t>::max();
 
@@ -95,6 +112,9 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
       options.GetOrDefault(RuntimeArgumentMap::JITCodeCacheInitialCapacity);
   jit_options->code_cache_max_capacity_ =
       options.GetOrDefault(RuntimeArgumentMap::JITCodeCacheMaxCapacity);
+  jit_options->compact_code_ = options.GetOrDefault(RuntimeArgumentMap::JITCompactCode);
+  jit_options->use_huge_pages_ = options.GetOrDefault(RuntimeArgumentMap::JITUseHugePages);
+  jit_options->fork_server_ = options.GetOrDefault(RuntimeArgumentMap::JITForkServer);
   jit_options->dump_info_on_shutdown_ =
       options.Exists(RuntimeArgumentMap::DumpJITInfoOnShutdown);
   jit_options->profile_saver_options_ =
@@ -103,6 +123,11 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
       options.GetOrDefault(RuntimeArgumentMap::JITPoolThreadPthreadPriority);
   jit_options->zygote_thread_pool_pthread_priority_ =
       options.GetOrDefault(RuntimeArgumentMap::JITZygotePoolThreadPthreadPriority);
+  jit_options->thread_pool_thread_count_ =
+      std::max(options.GetOrDefault(RuntimeArgumentMap::JITPoolThreads), 1u);
+  jit_options->warm_start_file_ = options.GetOrDefault(RuntimeArgumentMap::JITWarmStartFile);
+  jit_options->profile_warmup_methods_ =
+      options.GetOrDefault(RuntimeArgumentMap::JITProfileWarmupMethods);
 
   // Set default optimize threshold to aid with checking defaults.
   jit_options->optimize_threshold_ =
@@ -129,6 +154,16 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
   }
   DCHECK_LE(jit_options->warmup_threshold_, kJitMaxThreshold);
 
+  jit_options->adaptive_thresholds_ =
+      options.GetOrDefault(RuntimeArgumentMap::JITAdaptiveThresholds);
+  if (jit_options->adaptive_thresholds_) {
+    // The hotness counters count from the lowest thresholds the controller can pick.
+    jit_options->optimize_threshold_ =
+        JitThresholdController::GetCounterThreshold(jit_options->optimize_threshold_);
+    jit_options->warmup_threshold_ =
+        JitThresholdController::GetCounterThreshold(jit_options->warmup_threshold_);
+  }
+
   if (options.Exists(RuntimeArgumentMap::JITPriorityThreadWeight)) {
     jit_options->priority_thread_weight_ =
         *options.Get(RuntimeArgumentMap::JITPriorityThreadWeight);
@@ -163,6 +198,15 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
 void Jit::DumpInfo(std::ostream& os) {
   code_cache_->Dump(os);
   cumulative_timings_.Dump(os);
+  if (thread_pool_ != nullptr) {
+    thread_pool_->Dump(os);
+  }
+  if (threshold_controller_ != nullptr) {
+    os << "Adaptive thresholds: warmup="
+       << threshold_controller_->GetEffectiveThreshold(options_->GetWarmupThreshold())
+       << " optimize="
+       << threshold_controller_->GetEffectiveThreshold(options_->GetOptimizeThreshold()) << "\n";
+  }
   MutexLock mu(Thread::Current(), lock_);
   memory_use_.PrintMemoryUse(os);
 }
@@ -180,6 +224,7 @@ Jit::Jit(JitCodeCache* code_cache, JitOptions* options)
     : code_cache_(code_cache),
       options_(options),
       boot_completed_lock_("Jit::boot_completed_lock_"),
+      profile_warmup_lock_("Jit::profile_warmup_lock_"),
       cumulative_timings_("JIT timings"),
       memory_use_("Memory used for compilation", 16),
       lock_("JIT memory use lock"),
@@ -227,6 +272,17 @@ Jit* Jit::Create(JitCodeCache* code_cache, JitOptions* options) {
     }
   }
 
+  // The zygote doesn't load the app dex files whose methods the warm start file lists. Its
+  // children load the file in PostForkChildAction().
+  if (!Runtime::Current()->IsZygote()) {
+    jit->LoadWarmStartFile(options->GetWarmStartFile());
+  }
+
+  if (options->UseAdaptiveThresholds() && options->UseJitCompilation()) {
+    jit->threshold_controller_.reset(
+        new JitThresholdController(options->GetThreadPoolThreadCount()));
+  }
+
   // Notify native debugger about the classes already loaded before the creation of the jit.
   jit->DumpTypeInfoForLoadedTypes(Runtime::Current()->GetClassLinker());
   return jit.release();
@@ -324,12 +380,23 @@ bool Jit::CompileMethodInternal(ArtMethod* method,
   VLOG(jit) << "Compiling method "
             << ArtMethod::PrettyMethod(method_to_compile)
             << " kind=" << compilation_kind;
+  uint64_t start_ns = NanoTime();
   bool success = jit_compiler_->CompileMethod(self, region, method_to_compile, compilation_kind);
+  if (threshold_controller_ != nullptr) {
+    threshold_controller_->RecordCompilation(NanoTime() - start_ns);
+  }
   code_cache_->DoneCompiling(method_to_compile, self);
   if (!success) {
     VLOG(jit) << "Failed to compile method "
               << ArtMethod::PrettyMethod(method_to_compile)
               << " kind=" << compilation_kind;
+  } else if (warm_start_ != nullptr &&
+             compilation_kind == CompilationKind::kOptimized &&
+             !method_to_compile->GetDeclaringClass()->IsBootStrapClassLoaded()) {
+    const DexFile* dex_file = method_to_compile->GetDexFile();
+    warm_start_->RecordCompilation(dex_file->GetLocation(),
+                                   dex_file->GetLocationChecksum(),
+                                   method_to_compile->GetDexMethodIndex());
   }
   if (kIsDebugBuild) {
     if (self->IsExceptionPending()) {
@@ -405,6 +472,12 @@ Jit::~Jit() {
     Runtime::Current()->DumpDeoptimizations(LOG_STREAM(INFO));
   }
   DeleteThreadPool();
+  if (warm_start_ != nullptr) {
+    std::string error_msg;
+    if (!warm_start_->Save(&error_msg)) {
+      LOG(WARNING) << "Failed to save JIT warm start file: " << error_msg;
+    }
+  }
   if (jit_compiler_ != nullptr) {
     delete jit_compiler_;
     jit_compiler_ = nullptr;
@@ -609,6 +682,157 @@ bool Jit::MaybeDoOnStackReplacement(Thread* thread,
   return true;
 }
 
+// Copy the callee-save registers spilled by a frame from one context to the other. The highest
+// register of the core spill mask holds the return address, which is not copied.
+static void CopyCalleeSaves(const QuickMethodFrameInfo& frame_info, Context* from, Context* to) {
+  uint32_t core_spills = frame_info.CoreSpillMask();
+  DCHECK_NE(core_spills, 0u);
+  core_spills &= ~HighestOneBitValue(core_spills);
+  for (uint32_t reg : LowToHighBits(core_spills)) {
+    to->SetGPR(reg, from->GetGPR(reg));
+  }
+  for (uint32_t reg : LowToHighBits(frame_info.FpSpillMask())) {
+    to->SetFPR(reg, from->GetFPR(reg));
+  }
+}
+
+void Jit::MaybeDoOnStackReplacementFromBaseline(Thread* self) {
+  if (!kEnableOnStackReplacement || !kEnableOnStackReplacementFromBaseline) {
+    return;
+  }
+
+  // Find the frame calling the suspend check, and read its dex registers while the context
+  // still holds the registers saved by the suspend check entrypoint.
+  Context* context = self->GetLongJumpContext();
+  ArtMethod* method = nullptr;
+  const OatQuickMethodHeader* method_header = nullptr;
+  uint8_t* frame = nullptr;
+  uint32_t dex_pc = dex::kDexNoIndex;
+  std::vector<uint32_t> vregs;
+  StackVisitor::WalkStack(
+      [&](StackVisitor* visitor) REQUIRES_SHARED(Locks::mutator_lock_) {
+        ArtMethod* m = visitor->GetMethod();
+        if (m->IsRuntimeMethod()) {
+          // The suspend check entrypoint.
+          return true;
+        }
+        const OatQuickMethodHeader* header = visitor->GetCurrentOatQuickMethodHeader();
+        if (visitor->GetCurrentQuickFrame() == nullptr ||
+            !header->IsOptimized() ||
+            !CodeInfo::IsBaseline(header->GetOptimizedCodeInfoPtr()) ||
+            !GetCodeCache()->ContainsPc(header->GetCode())) {
+          return false;
+        }
+        // The hotness counter is the one of the outer method, even if the loop was inlined.
+        method = visitor->GetOuterMethod();
+        method_header = header;
+        if (visitor->IsInInlinedFrame() ||
+            (header->HasShouldDeoptimizeFlag() && visitor->GetShouldDeoptimizeFlag() != 0u)) {
+          return false;
+        }
+        CodeInfo code_info(header);
+        StackMap stack_map = code_info.GetStackMapForNativePcOffset(
+            header->NativeQuickPcOffset(visitor->GetCurrentQuickFramePc()));
+        DCHECK(stack_map.IsValid());
+        DexRegisterMap vreg_map = code_info.GetDexRegisterMapOf(stack_map);
+        CodeItemDataAccessor accessor(m->DexInstructionData());
+        std::vector<uint32_t> values(accessor.RegistersSize(), 0u);
+        if (!vreg_map.empty()) {
+          DCHECK_EQ(vreg_map.size(), values.size());
+          for (uint16_t vreg = 0; vreg != values.size(); ++vreg) {
+            // A dead register is never read by the compiled code, leave it null.
+            if (vreg_map[vreg].GetKind() != DexRegisterLocation::Kind::kNone &&
+                !visitor->GetVReg(m, vreg, kIntVReg, &values[vreg], vreg_map[vreg])) {
+              return false;
+            }
+          }
+        }
+        frame = reinterpret_cast<uint8_t*>(visitor->GetCurrentQuickFrame());
+        dex_pc = visitor->GetDexPc();
+        vregs.swap(values);
+        return false;
+      },
+      self,
+      context,
+      StackVisitor::StackWalkKind::kIncludeInlinedFrames);
+  if (method == nullptr) {
+    self->ReleaseLongJumpContext(context);
+    return;
+  }
+
+  // Reset the counter even if the frame cannot be replaced, otherwise the baseline code would
+  // call back here on every back edge.
+  if (GetCodeCache()->HasReachedOptimizeThreshold(method, self)) {
+    if (method->GetEntryPointFromQuickCompiledCode() == method_header->GetEntryPoint()) {
+      EnqueueOptimizedCompilation(method, self);
+    } else {
+      // The method already runs optimized code, but this frame is still looping in the baseline
+      // code.
+      GetCodeCache()->ResetHotnessCounter(method, self);
+      if (thread_pool_ != nullptr &&
+          !options_->UseBaselineCompiler() &&
+          !GetCodeCache()->IsOsrCompiled(method) &&
+          ShouldCompileHotMethod(method)) {
+        AddCompileTask(self, method, CompilationKind::kOsr);
+      }
+    }
+  }
+
+  Runtime* runtime = Runtime::Current();
+  if (frame == nullptr ||
+      runtime->GetInstrumentation()->NeedsSlowInterpreterForMethod(self, method) ||
+      runtime->GetRuntimeCallbacks()->HaveLocalsChanged()) {
+    self->ReleaseLongJumpContext(context);
+    return;
+  }
+
+  // From here, the thread must not suspend until it runs the OSR code, as the JIT code cache
+  // could delete it.
+  OsrData* osr_data = PrepareForOsr(method, dex_pc, vregs.data());
+  // The long jump below skips the destructors of this frame.
+  std::vector<uint32_t>().swap(vregs);
+  if (osr_data == nullptr) {
+    self->ReleaseLongJumpContext(context);
+    return;
+  }
+  QuickMethodFrameInfo frame_info = method_header->GetFrameInfo();
+  QuickMethodFrameInfo osr_frame_info =
+      GetCodeCache()->LookupOsrMethodHeader(method)->GetFrameInfo();
+  DCHECK_EQ(osr_frame_info.FrameSizeInBytes(), osr_data->frame_size);
+  if (osr_frame_info.FrameSizeInBytes() > frame_info.FrameSizeInBytes()) {
+    // The OSR frame replaces the baseline frame in place, it cannot grow into the frames of the
+    // runtime below, which are still in use.
+    VLOG(jit) << "OSR frame of " << method->PrettyMethod() << " is larger than its baseline frame";
+    free(osr_data);
+    self->ReleaseLongJumpContext(context);
+    return;
+  }
+
+  // The OSR code restores the callee-save registers of the caller from its frame when it returns,
+  // and leaves the other ones untouched. Get the values of the caller, which the baseline frame
+  // spilled, into `context`, and spill them in the OSR frame.
+  {
+    std::unique_ptr<Context> baseline_context(Context::Create());
+    baseline_context->FillCalleeSaves(frame, frame_info);
+    CopyCalleeSaves(frame_info, baseline_context.get(), context);
+    std::unique_ptr<Context> osr_context(Context::Create());
+    osr_context->FillCalleeSaves(reinterpret_cast<uint8_t*>(osr_data->memory), osr_frame_info);
+    CopyCalleeSaves(osr_frame_info, context, osr_context.get());
+  }
+  uint8_t* caller_sp = frame + frame_info.FrameSizeInBytes();
+  uint8_t* osr_sp = caller_sp - osr_frame_info.FrameSizeInBytes();
+  memcpy(reinterpret_cast<uint8_t*>(osr_data->memory) + osr_frame_info.GetReturnPcOffset(),
+         frame + frame_info.GetReturnPcOffset(),
+         sizeof(uintptr_t));
+  memcpy(osr_sp, osr_data->memory, osr_frame_info.FrameSizeInBytes());
+  context->SetSP(reinterpret_cast<uintptr_t>(osr_sp));
+  context->SetPC(reinterpret_cast<uintptr_t>(osr_data->native_pc));
+  free(osr_data);
+  VLOG(jit) << "Replaced baseline frame of " << method->PrettyMethod() << " by an OSR frame";
+  self->ReleaseLongJumpContext(context);
+  context->DoLongJump();
+}
+
 void Jit::AddMemoryUsage(ArtMethod* method, size_t bytes) {
   if (bytes > 4 * MB) {
     LOG(INFO) << "Compiler allocated "
@@ -829,6 +1053,8 @@ class JitCompileTask final : public Task {
       }
     }
     ProfileSaver::NotifyJitActivity();
+    Runtime::Current()->GetJit()->MaybeSaveWarmStart();
+    Runtime::Current()->GetJit()->MaybeUpdateThresholds(self);
   }
 
   void Finalize() override {
@@ -844,6 +1070,54 @@ class JitCompileTask final : public Task {
   DISALLOW_IMPLICIT_CONSTRUCTORS(JitCompileTask);
 };
 
+/**
+ * A JIT task marking the methods of newly loaded dex files that previous runs compiled with
+ * optimizing.
+ */
+class JitWarmStartTask final : public Task {
+ public:
+  JitWarmStartTask(const std::vector<std::unique_ptr<const DexFile>>& dex_files,
+                   jobject class_loader) {
+    ScopedObjectAccess soa(Thread::Current());
+    StackHandleScope<1> hs(soa.Self());
+    Handle<mirror::ClassLoader> h_loader(hs.NewHandle(
+        soa.Decode<mirror::ClassLoader>(class_loader)));
+    ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+    for (const auto& dex_file : dex_files) {
+      dex_files_.push_back(dex_file.get());
+      // Register the dex file so that we can guarantee it doesn't get deleted
+      // while reading it during the task.
+      class_linker->RegisterDexFile(*dex_file.get(), h_loader.Get());
+    }
+    class_loader_ = soa.Vm()->AddGlobalRef(soa.Self(), h_loader.Get());
+  }
+
+  void Run(Thread* self) override {
+    ScopedObjectAccess soa(self);
+    StackHandleScope<1> hs(self);
+    Handle<mirror::ClassLoader> loader = hs.NewHandle<mirror::ClassLoader>(
+        soa.Decode<mirror::ClassLoader>(class_loader_));
+    uint32_t marked = Runtime::Current()->GetJit()->MarkWarmMethods(self, dex_files_, loader);
+    VLOG(jit) << "JIT warm start marked " << marked << " methods of "
+              << dex_files_[0]->GetLocation();
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+  ~JitWarmStartTask() {
+    ScopedObjectAccess soa(Thread::Current());
+    soa.Vm()->DeleteGlobalRef(soa.Self(), class_loader_);
+  }
+
+ private:
+  std::vector<const DexFile*> dex_files_;
+  jobject class_loader_;
+
+  DISALLOW_COPY_AND_ASSIGN(JitWarmStartTask);
+};
+
 static std::string GetProfileFile(const std::string& dex_location) {
   // Hardcoded assumption where the profile file is.
   // TODO(ngeoffray): this is brittle and we would need to change change if we
@@ -1062,6 +1336,46 @@ class JitProfileTask final : public Task {
   DISALLOW_COPY_AND_ASSIGN(JitProfileTask);
 };
 
+// Task loading the profiles of the app to compile its hottest methods, see
+// Jit::WarmupFromProfiles. There is one per process, which takes the profiles
+// of all the split APKs registered by the time it runs.
+class JitProfileWarmupTask final : public Task {
+ public:
+  explicit JitProfileWarmupTask(uint32_t max_methods) : max_methods_(max_methods) {}
+
+  void Run(Thread* self) override {
+    std::vector<std::string> code_paths;
+    std::vector<std::string> profile_filenames;
+    Jit* jit = Runtime::Current()->GetJit();
+    jit->TakeProfileWarmupPaths(self, &code_paths, &profile_filenames);
+    ProfileCompilationInfo profile_info;
+    bool loaded = false;
+    for (const std::string& filename : profile_filenames) {
+      if (OS::FileExists(filename.c_str())) {
+        loaded |= profile_info.MergeWith(filename);
+      }
+    }
+    if (!loaded) {
+      VLOG(jit) << "No profile to warm up the JIT";
+      return;
+    }
+    ScopedObjectAccess soa(self);
+    uint32_t added_to_queue =
+        jit->CompileHottestMethodsFromProfile(self, profile_info, code_paths, max_methods_);
+    VLOG(jit) << "Warming up the JIT with " << added_to_queue << " methods from "
+              << profile_filenames.size() << " profiles";
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  const uint32_t max_methods_;
+
+  DISALLOW_COPY_AND_ASSIGN(JitProfileWarmupTask);
+};
+
 static void CopyIfDifferent(void* s1, const void* s2, size_t n) {
   if (memcmp(s1, s2, n) != 0) {
     memcpy(s1, s2, n);
@@ -1203,7 +1517,8 @@ void Jit::CreateThreadPool() {
 
   // We need peers as we may report the JIT thread, e.g., in the debugger.
   constexpr bool kJitPoolNeedsPeers = true;
-  thread_pool_.reset(new ThreadPool("Jit thread pool", 1, kJitPoolNeedsPeers));
+  thread_pool_.reset(JitThreadPool::Create(
+      "Jit thread pool", options_->GetThreadPoolThreadCount(), kJitPoolNeedsPeers));
 
   Runtime* runtime = Runtime::Current();
   thread_pool_->SetPthreadPriority(
@@ -1305,6 +1620,17 @@ void Jit::CreateThreadPool() {
   }
 }
 
+// Whether a method with this entry point has neither AOT nor JIT compiled code.
+static bool HasNoCompiledCode(ClassLinker* class_linker, const void* entry_point) {
+  return class_linker->IsQuickToInterpreterBridge(entry_point) ||
+      class_linker->IsQuickGenericJniStub(entry_point) ||
+      class_linker->IsNterpEntryPoint(entry_point) ||
+      // We explicitly check for the resolution stub, and not the resolution trampoline.
+      // The trampoline is for methods backed by a .oat file that has a compiled version of
+      // the method.
+      (entry_point == GetQuickResolutionStub());
+}
+
 void Jit::RegisterDexFiles(const std::vector<std::unique_ptr<const DexFile>>& dex_files,
                            jobject class_loader) {
   if (dex_files.empty()) {
@@ -1328,6 +1654,232 @@ void Jit::RegisterDexFiles(const std::vector<std::unique_ptr<const DexFile>>& de
     //   system server (though we are in the system server process).
     thread_pool_->AddTask(Thread::Current(), new JitProfileTask(dex_files, class_loader));
   }
+  if (warm_start_ != nullptr && UseJitCompilation() && thread_pool_ != nullptr) {
+    bool has_warm_methods = std::any_of(
+        dex_files.begin(), dex_files.end(), [&](const std::unique_ptr<const DexFile>& dex_file) {
+          return !warm_start_->GetMethods(dex_file->GetLocation(),
+                                          dex_file->GetLocationChecksum()).empty();
+        });
+    if (has_warm_methods) {
+      thread_pool_->AddTask(Thread::Current(), new JitWarmStartTask(dex_files, class_loader));
+    }
+  }
+}
+
+uint32_t Jit::MarkWarmMethods(Thread* self,
+                              const std::vector<const DexFile*>& dex_files,
+                              Handle<mirror::ClassLoader> class_loader) {
+  DCHECK(warm_start_ != nullptr);
+  StackHandleScope<1> hs(self);
+  MutableHandle<mirror::DexCache> dex_cache = hs.NewHandle<mirror::DexCache>(nullptr);
+  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+  uint32_t marked = 0u;
+  for (const DexFile* dex_file : dex_files) {
+    std::vector<uint32_t> method_indexes =
+        warm_start_->GetMethods(dex_file->GetLocation(), dex_file->GetLocationChecksum());
+    if (method_indexes.empty()) {
+      continue;
+    }
+    dex_cache.Assign(class_linker->FindDexCache(self, *dex_file));
+    CHECK(dex_cache != nullptr) << "Could not find dex cache for " << dex_file->GetLocation();
+    for (uint32_t method_idx : method_indexes) {
+      if (method_idx >= dex_file->NumMethodIds()) {
+        continue;
+      }
+      ArtMethod* method = class_linker->ResolveMethodWithoutInvokeType(
+          method_idx, dex_cache, class_loader);
+      if (method == nullptr) {
+        self->ClearException();
+        continue;
+      }
+      if (!method->IsCompilable() ||
+          !method->IsInvokable() ||
+          method->IsAbstract() ||
+          method->IsMemorySharedMethod() ||
+          !HasNoCompiledCode(class_linker, method->GetEntryPointFromQuickCompiledCode())) {
+        continue;
+      }
+      warm_start_->AddWarmMethod(method);
+      // Have the next call of the method, or the next loop back edge, check for compilation.
+      method->SetHotCounter();
+      ++marked;
+    }
+  }
+  return marked;
+}
+
+void Jit::MaybeSaveWarmStart() {
+  if (warm_start_ == nullptr || !warm_start_->NeedsSave()) {
+    return;
+  }
+  std::string error_msg;
+  if (!warm_start_->Save(&error_msg)) {
+    LOG(WARNING) << "Failed to save JIT warm start file: " << error_msg;
+  }
+}
+
+void Jit::MaybeUpdateThresholds(Thread* self) {
+  if (threshold_controller_ == nullptr || thread_pool_ == nullptr) {
+    return;
+  }
+  if (!threshold_controller_->Update(thread_pool_->GetTaskCount(self),
+                                     JitThresholdController::GetAvailableCpus(),
+                                     NanoTime())) {
+    return;
+  }
+  metrics::ArtMetrics* metrics = Runtime::Current()->GetMetrics();
+  metrics->JitWarmupThreshold()->Add(
+      threshold_controller_->GetEffectiveThreshold(options_->GetWarmupThreshold()));
+  metrics->JitOptimizeThreshold()->Add(
+      threshold_controller_->GetEffectiveThreshold(options_->GetOptimizeThreshold()));
+}
+
+void Jit::WarmupFromProfiles(const std::vector<std::string>& code_paths,
+                             const std::string& profile_filename,
+                             const std::string& ref_profile_filename) {
+  uint32_t max_methods = options_->GetProfileWarmupMethods();
+  if (max_methods == 0u ||
+      thread_pool_ == nullptr ||
+      !options_->UseJitCompilation() ||
+      Runtime::Current()->IsJavaDebuggable()) {
+    return;
+  }
+  Thread* self = Thread::Current();
+  {
+    MutexLock mu(self, profile_warmup_lock_);
+    if (profile_warmup_state_ == ProfileWarmupState::kDone) {
+      VLOG(jit) << "JIT warm-up already done, ignoring " << profile_filename;
+      return;
+    }
+    warmup_code_paths_.insert(warmup_code_paths_.end(), code_paths.begin(), code_paths.end());
+    // The reference profile has the methods of the previous runs, which the current profile
+    // may not have yet.
+    for (const std::string& filename : {ref_profile_filename, profile_filename}) {
+      if (!filename.empty()) {
+        warmup_profile_filenames_.push_back(filename);
+      }
+    }
+    if (profile_warmup_state_ == ProfileWarmupState::kScheduled) {
+      // The task takes the profiles of all the split APKs registered until it runs.
+      return;
+    }
+    profile_warmup_state_ = ProfileWarmupState::kScheduled;
+  }
+  thread_pool_->AddTask(self, new JitProfileWarmupTask(max_methods));
+}
+
+void Jit::TakeProfileWarmupPaths(Thread* self,
+                                 std::vector<std::string>* code_paths,
+                                 std::vector<std::string>* profile_filenames) {
+  MutexLock mu(self, profile_warmup_lock_);
+  DCHECK(profile_warmup_state_ == ProfileWarmupState::kScheduled);
+  profile_warmup_state_ = ProfileWarmupState::kDone;
+  *code_paths = std::move(warmup_code_paths_);
+  *profile_filenames = std::move(warmup_profile_filenames_);
+  warmup_code_paths_.clear();
+  warmup_profile_filenames_.clear();
+}
+
+uint32_t Jit::CompileHottestMethodsFromProfile(Thread* self,
+                                               const ProfileCompilationInfo& profile_info,
+                                               const std::vector<std::string>& code_paths,
+                                               uint32_t max_methods) {
+  class CollectDexCacheVisitor : public DexCacheVisitor {
+   public:
+    explicit CollectDexCacheVisitor(VariableSizedHandleScope& handles) : handles_(handles) {}
+
+    void Visit(ObjPtr<mirror::DexCache> dex_cache)
+        REQUIRES_SHARED(Locks::dex_lock_, Locks::mutator_lock_) override {
+      dex_caches_.push_back(handles_.NewHandle(dex_cache));
+    }
+    const std::vector<Handle<mirror::DexCache>>& GetDexCaches() const {
+      return dex_caches_;
+    }
+
+   private:
+    VariableSizedHandleScope& handles_;
+    std::vector<Handle<mirror::DexCache>> dex_caches_;
+  };
+
+  // The methods with their dex cache, ranked by how early they are likely needed.
+  struct ProfileMethod {
+    uint32_t rank;
+    bool is_hot;
+    Handle<mirror::DexCache> dex_cache;
+    uint16_t method_idx;
+  };
+
+  VariableSizedHandleScope handles(self);
+  CollectDexCacheVisitor visitor(handles);
+  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+  {
+    ReaderMutexLock mu(self, *Locks::dex_lock_);
+    class_linker->VisitDexCaches(&visitor);
+  }
+  std::vector<ProfileMethod> methods;
+  for (Handle<mirror::DexCache> dex_cache : visitor.GetDexCaches()) {
+    const DexFile* dex_file = dex_cache->GetDexFile();
+    std::string base_location = DexFileLoader::GetBaseLocation(dex_file->GetLocation());
+    if (std::find(code_paths.begin(), code_paths.end(), base_location) == code_paths.end()) {
+      continue;
+    }
+    std::set<dex::TypeIndex> class_types;
+    std::set<uint16_t> hot_methods;
+    std::set<uint16_t> startup_methods;
+    std::set<uint16_t> post_startup_methods;
+    if (!profile_info.GetClassesAndMethods(*dex_file,
+                                           &class_types,
+                                           &hot_methods,
+                                           &startup_methods,
+                                           &post_startup_methods)) {
+      continue;
+    }
+    for (uint16_t method_idx : hot_methods) {
+      uint32_t rank = ContainsElement(startup_methods, method_idx) ? 0u : 1u;
+      methods.push_back({rank, /* is_hot= */ true, dex_cache, method_idx});
+    }
+    for (uint16_t method_idx : startup_methods) {
+      if (!ContainsElement(hot_methods, method_idx)) {
+        methods.push_back({/* rank= */ 2u, /* is_hot= */ false, dex_cache, method_idx});
+      }
+    }
+  }
+  std::stable_sort(methods.begin(), methods.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.rank < rhs.rank;
+  });
+
+  StackHandleScope<1> hs(self);
+  MutableHandle<mirror::ClassLoader> class_loader = hs.NewHandle<mirror::ClassLoader>(nullptr);
+  uint32_t added_to_queue = 0u;
+  for (const ProfileMethod& profile_method : methods) {
+    if (added_to_queue == max_methods) {
+      break;
+    }
+    class_loader.Assign(profile_method.dex_cache->GetClassLoader());
+    ArtMethod* method = class_linker->ResolveMethodWithoutInvokeType(
+        profile_method.method_idx, profile_method.dex_cache, class_loader);
+    if (method == nullptr) {
+      self->ClearException();
+      continue;
+    }
+    if (!method->IsCompilable() ||
+        !method->IsInvokable() ||
+        method->IsAbstract() ||
+        method->IsMemorySharedMethod() ||
+        !HasNoCompiledCode(class_linker, method->GetEntryPointFromQuickCompiledCode())) {
+      continue;
+    }
+    // Hot methods go straight to optimizing. Methods only run at startup may not deserve it:
+    // compile them with baseline, which still lets them get optimized if they get hot.
+    bool use_baseline = !profile_method.is_hot &&
+                        !method->IsNative() &&
+                        GetCodeCache()->CanAllocateProfilingInfo();
+    CompilationKind compilation_kind =
+        use_baseline ? CompilationKind::kBaseline : CompilationKind::kOptimized;
+    AddCompileTask(self, method, compilation_kind, /* precompile= */ true);
+    ++added_to_queue;
+  }
+  return added_to_queue;
 }
 
 void Jit::AddCompileTask(Thread* self,
@@ -1336,13 +1888,21 @@ void Jit::AddCompileTask(Thread* self,
                          bool precompile) {
   ScopedCompilation sc(this, method, compilation_kind);
   if (!sc.OwnsCompilation()) {
+    // If the compilation is still queued, the method got hot again while waiting: move it ahead.
+    if (thread_pool_ != nullptr) {
+      thread_pool_->CoalesceCompileTask(self, method, compilation_kind);
+    }
     return;
   }
   JitCompileTask::TaskKind task_kind = precompile
       ? JitCompileTask::TaskKind::kPreCompile
       : JitCompileTask::TaskKind::kCompile;
-  thread_pool_->AddTask(
-      self, new JitCompileTask(method, task_kind, compilation_kind, std::move(sc)));
+  size_t queue_depth = thread_pool_->AddCompileTask(
+      self,
+      method,
+      compilation_kind,
+      new JitCompileTask(method, task_kind, compilation_kind, std::move(sc)));
+  Runtime::Current()->GetMetrics()->JitQueueDepth()->Add(queue_depth);
 }
 
 bool Jit::CompileMethodFromProfile(Thread* self,
@@ -1366,14 +1926,7 @@ bool Jit::CompileMethodFromProfile(Thread* self,
     return false;
   }
   CompilationKind compilation_kind = CompilationKind::kOptimized;
-  const void* entry_point = method->GetEntryPointFromQuickCompiledCode();
-  if (class_linker->IsQuickToInterpreterBridge(entry_point) ||
-      class_linker->IsQuickGenericJniStub(entry_point) ||
-      class_linker->IsNterpEntryPoint(entry_point) ||
-      // We explicitly check for the resolution stub, and not the resolution trampoline.
-      // The trampoline is for methods backed by a .oat file that has a compiled version of
-      // the method.
-      (entry_point == GetQuickResolutionStub())) {
+  if (HasNoCompiledCode(class_linker, method->GetEntryPointFromQuickCompiledCode())) {
     VLOG(jit) << "JIT Zygote processing method " << ArtMethod::PrettyMethod(method)
               << " from profile";
     method->SetPreCompiled();
@@ -1529,7 +2082,7 @@ void Jit::EnqueueOptimizedCompilation(ArtMethod* method, Thread* self) {
   // method repeatedly.
   GetCodeCache()->ResetHotnessCounter(method, self);
 
-  if (thread_pool_ == nullptr) {
+  if (thread_pool_ == nullptr || !ShouldCompileHotMethod(method)) {
     return;
   }
   // We arrive here after a baseline compiled code has reached its baseline
@@ -1680,11 +2233,33 @@ void Jit::PostForkChildAction(bool is_system_server, bool is_zygote) {
     code_cache_->SetGarbageCollectCode(false);
   }
 
+  // The zygote itself doesn't load the warm start file. Its children all get the same
+  // -Xjitwarmstartfile, so each app uses a file of its own, named after its uid, and doesn't load
+  // or overwrite the methods of other apps. Children of a JIT fork server share the uid and the
+  // file of the fork server, which keeps saving it, so they don't use warm start at all.
+  if (warm_start_ != nullptr) {
+    warm_start_.reset();
+  } else if (!is_zygote && !options_->GetWarmStartFile().empty()) {
+    LoadWarmStartFile(options_->GetWarmStartFile() + "." + std::to_string(getuid()));
+  }
+
   // We do this here instead of PostZygoteFork, as NativeDebugInfoPostFork only
   // applies to a child.
   NativeDebugInfoPostFork();
 }
 
+void Jit::LoadWarmStartFile(const std::string& filename) {
+  if (filename.empty() || !options_->UseJitCompilation() || warm_start_ != nullptr) {
+    return;
+  }
+  warm_start_.reset(new JitWarmStart(filename, Runtime::Current()->GetBootClassPathChecksums()));
+  std::string error_msg;
+  if (!warm_start_->Load(&error_msg)) {
+    // Expected on the first run. The file gets rewritten with the methods compiled in this run.
+    VLOG(jit) << "Not using JIT warm start file: " << error_msg;
+  }
+}
+
 void Jit::PreZygoteFork() {
   if (thread_pool_ == nullptr) {
     return;
@@ -1792,7 +2367,9 @@ void Jit::MaybeEnqueueCompilation(ArtMethod* method, Thread* self) {
   }
 
   if (GetCodeCache()->ContainsPc(method->GetEntryPointFromQuickCompiledCode())) {
-    if (!method->IsNative() && !code_cache_->IsOsrCompiled(method)) {
+    if (!method->IsNative() &&
+        !code_cache_->IsOsrCompiled(method) &&
+        ShouldCompileHotMethod(method)) {
       // If we already have compiled code for it, nterp may be stuck in a loop.
       // Compile OSR.
       AddCompileTask(self, method, CompilationKind::kOsr);
@@ -1827,7 +2404,14 @@ void Jit::MaybeEnqueueCompilation(ArtMethod* method, Thread* self) {
     }
   }
 
-  if (!method->IsNative() && GetCodeCache()->CanAllocateProfilingInfo()) {
+  if (!ShouldCompileHotMethod(method)) {
+    return;
+  }
+
+  if (warm_start_ != nullptr && warm_start_->TakeWarmMethod(method)) {
+    // A previous run compiled it with optimizing, so it is going to be hot: skip baseline.
+    AddCompileTask(self, method, CompilationKind::kOptimized);
+  } else if (!method->IsNative() && GetCodeCache()->CanAllocateProfilingInfo()) {
     AddCompileTask(self, method, CompilationKind::kBaseline);
   } else {
     AddCompileTask(self, method, CompilationKind::kOptimized);
@@ -29,6 +29,9 @@
 #include "offsets.h"
 #include "interpreter/mterp/nterp.h"
 #include "jit/debugger_interface.h"
+#include "jit/jit_thread_pool.h"
+#include "jit/jit_threshold_controller.h"
+#include "jit/jit_warm_start.h"
 #include "jit/profile_saver_options.h"
 #include "obj_ptr.h"
 #include "thread_pool.h"
@@ -39,6 +42,7 @@ class ArtMethod;
 class ClassLinker;
 class DexFile;
 class OatDexFile;
+class ProfileCompilationInfo;
 struct RuntimeArgumentMap;
 union JValue;
 
@@ -66,6 +70,8 @@ static constexpr int kJitPoolThreadPthreadDefaultPriority = 9;
 // 19 is the lowest background priority on device.
 // See android/os/Process.java.
 static constexpr int kJitZygotePoolThreadPthreadDefaultPriority = 19;
+// How many threads compile methods. Can be raised with -Xjitthreads.
+static constexpr unsigned int kJitPoolDefaultThreadCount = 1;
 
 class JitOptions {
  public:
@@ -115,6 +121,18 @@ class JitOptions {
     return zygote_thread_pool_pthread_priority_;
   }
 
+  size_t GetThreadPoolThreadCount() const {
+    return thread_pool_thread_count_;
+  }
+
+  const std::string& GetWarmStartFile() const {
+    return warm_start_file_;
+  }
+
+  uint32_t GetProfileWarmupMethods() const {
+    return profile_warmup_methods_;
+  }
+
   bool UseJitCompilation() const {
     return use_jit_compilation_;
   }
@@ -123,6 +141,22 @@ class JitOptions {
     return use_profiled_jit_compilation_;
   }
 
+  bool CompactCode() const {
+    return compact_code_;
+  }
+
+  bool UseHugePages() const {
+    return use_huge_pages_;
+  }
+
+  bool UseAdaptiveThresholds() const {
+    return adaptive_thresholds_;
+  }
+
+  bool IsForkServer() const {
+    return fork_server_;
+  }
+
   void SetUseJitCompilation(bool b) {
     use_jit_compilation_ = b;
   }
@@ -158,6 +192,10 @@ class JitOptions {
   bool use_baseline_compiler_;
   size_t code_cache_initial_capacity_;
   size_t code_cache_max_capacity_;
+  bool compact_code_;
+  bool use_huge_pages_;
+  bool adaptive_thresholds_;
+  bool fork_server_;
   uint32_t optimize_threshold_;
   uint32_t warmup_threshold_;
   uint16_t priority_thread_weight_;
@@ -165,6 +203,9 @@ class JitOptions {
   bool dump_info_on_shutdown_;
   int thread_pool_pthread_priority_;
   int zygote_thread_pool_pthread_priority_;
+  size_t thread_pool_thread_count_;
+  std::string warm_start_file_;
+  uint32_t profile_warmup_methods_;
   ProfileSaverOptions profile_saver_options_;
 
   JitOptions()
@@ -173,13 +214,19 @@ class JitOptions {
         use_baseline_compiler_(false),
         code_cache_initial_capacity_(0),
         code_cache_max_capacity_(0),
+        compact_code_(false),
+        use_huge_pages_(false),
+        adaptive_thresholds_(false),
+        fork_server_(false),
         optimize_threshold_(0),
         warmup_threshold_(0),
         priority_thread_weight_(0),
         invoke_transition_weight_(0),
         dump_info_on_shutdown_(false),
         thread_pool_pthread_priority_(kJitPoolThreadPthreadDefaultPriority),
-        zygote_thread_pool_pthread_priority_(kJitZygotePoolThreadPthreadDefaultPriority) {}
+        zygote_thread_pool_pthread_priority_(kJitZygotePoolThreadPthreadDefaultPriority),
+        thread_pool_thread_count_(kJitPoolDefaultThreadCount),
+        profile_warmup_methods_(0) {}
 
   DISALLOW_COPY_AND_ASSIGN(JitOptions);
 };
@@ -194,6 +241,7 @@ class JitCompilerInterface {
   virtual void TypesLoaded(mirror::Class**, size_t count)
       REQUIRES_SHARED(Locks::mutator_lock_) = 0;
   virtual bool GenerateDebugInfo() = 0;
+  virtual bool GenerateAnyDebugInfo() = 0;
   virtual void ParseCompilerOptions() = 0;
   virtual bool IsBaselineCompiler() const = 0;
   virtual void SetDebuggableCompilerOption(bool value) = 0;
@@ -364,10 +412,19 @@ class Jit {
                                         JValue* result)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Called from the suspend check entrypoint. Baseline compiled code also calls it from its loop
+  // back edges once the method reached its optimize threshold. If the calling frame runs baseline
+  // code, queue the optimized compilation of its method, or an OSR compilation if the optimized
+  // code is already in use. If the OSR code exists, replace the baseline frame by an OSR frame and
+  // jump to the OSR code, in which case this method does not return.
+  void MaybeDoOnStackReplacementFromBaseline(Thread* self)
+      REQUIRES(!Locks::jit_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Load the compiler library.
   static bool LoadCompilerLibrary(std::string* error_msg);
 
-  ThreadPool* GetThreadPool() const {
+  JitThreadPool* GetThreadPool() const {
     return thread_pool_.get();
   }
 
@@ -415,6 +472,45 @@ class Jit {
                                          Handle<mirror::ClassLoader> class_loader,
                                          bool add_to_queue);
 
+  // Mark the methods of `dex_files` compiled with optimizing in previous runs as warm, see
+  // JitWarmStart. Returns the number of methods marked.
+  uint32_t MarkWarmMethods(Thread* self,
+                           const std::vector<const DexFile*>& dex_files,
+                           Handle<mirror::ClassLoader> class_loader)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Save the JIT warm start file if enough methods were compiled since the last save.
+  void MaybeSaveWarmStart();
+
+  // With -Xjitadaptivethresholds, adjust the hotness thresholds to the compilation queue and
+  // report them to the metrics.
+  void MaybeUpdateThresholds(Thread* self);
+
+  // With -Xjitprofilewarmup, queue the compilation of the hottest methods recorded in the profiles
+  // of the app, so that they are compiled before their first invocations. Called for each split
+  // APK, but the warm-up is done once per process, from the profiles of all the split APKs
+  // registered by the time it starts.
+  void WarmupFromProfiles(const std::vector<std::string>& code_paths,
+                          const std::string& profile_filename,
+                          const std::string& ref_profile_filename)
+      REQUIRES(!profile_warmup_lock_);
+
+  // Called by the warm-up task to take the code paths and profiles registered so far. Later
+  // registrations are ignored.
+  void TakeProfileWarmupPaths(Thread* self,
+                              std::vector<std::string>* code_paths,
+                              std::vector<std::string>* profile_filenames)
+      REQUIRES(!profile_warmup_lock_);
+
+  // Queue the compilation of at most `max_methods` methods of the loaded dex files of
+  // `code_paths` found in `profile_info`: first the hot startup methods, then the other hot
+  // methods, then the startup methods. Returns the number of compilations queued.
+  uint32_t CompileHottestMethodsFromProfile(Thread* self,
+                                            const ProfileCompilationInfo& profile_info,
+                                            const std::vector<std::string>& code_paths,
+                                            uint32_t max_methods)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Register the dex files to the JIT. This is to perform any compilation/optimization
   // at the point of loading the dex files.
   void RegisterDexFiles(const std::vector<std::unique_ptr<const DexFile>>& dex_files,
@@ -463,11 +559,21 @@ class Jit {
 
   static bool BindCompilerMethods(std::string* error_msg);
 
+  // Load the JIT warm start file at `filename`, derived from -Xjitwarmstartfile, if any and not
+  // loaded yet.
+  void LoadWarmStartFile(const std::string& filename);
+
   void AddCompileTask(Thread* self,
                       ArtMethod* method,
                       CompilationKind compilation_kind,
                       bool precompile = false);
 
+  // Whether a method whose hotness counter expired should be compiled, see
+  // JitThresholdController.
+  bool ShouldCompileHotMethod(ArtMethod* method) {
+    return threshold_controller_ == nullptr || threshold_controller_->ShouldCompile(method);
+  }
+
   bool CompileMethodInternal(ArtMethod* method,
                              Thread* self,
                              CompilationKind compilation_kind,
@@ -484,13 +590,29 @@ class Jit {
   jit::JitCodeCache* const code_cache_;
   const JitOptions* const options_;
 
-  std::unique_ptr<ThreadPool> thread_pool_;
+  std::unique_ptr<JitThreadPool> thread_pool_;
+  // Non-null when -Xjitwarmstartfile is passed.
+  std::unique_ptr<JitWarmStart> warm_start_;
+  // Non-null when -Xjitadaptivethresholds is passed.
+  std::unique_ptr<JitThresholdController> threshold_controller_;
   std::vector<std::unique_ptr<OatDexFile>> type_lookup_tables_;
 
   Mutex boot_completed_lock_;
   bool boot_completed_ GUARDED_BY(boot_completed_lock_) = false;
   std::deque<Task*> tasks_after_boot_ GUARDED_BY(boot_completed_lock_);
 
+  // State of the -Xjitprofilewarmup task of the process.
+  enum class ProfileWarmupState {
+    kNotScheduled,
+    kScheduled,
+    kDone,
+  };
+  Mutex profile_warmup_lock_;
+  ProfileWarmupState profile_warmup_state_ GUARDED_BY(profile_warmup_lock_) =
+      ProfileWarmupState::kNotScheduled;
+  std::vector<std::string> warmup_code_paths_ GUARDED_BY(profile_warmup_lock_);
+  std::vector<std::string> warmup_profile_filenames_ GUARDED_BY(profile_warmup_lock_);
+
   // Performance monitoring.
   CumulativeLogger cumulative_timings_;
   Histogram<uint64_t> memory_use_ GUARDED_BY(lock_);
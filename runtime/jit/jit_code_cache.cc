@@ -229,6 +229,7 @@ JitCodeCache* JitCodeCache::Create(bool used_only_for_profile_data,
                          max_capacity,
                          rwx_memory_allowed,
                          is_zygote,
+                         runtime->GetJITOptions()->UseHugePages(),
                          error_msg)) {
     return nullptr;
   }
@@ -267,6 +268,8 @@ JitCodeCache::JitCodeCache()
       number_of_optimized_compilations_(0),
       number_of_osr_compilations_(0),
       number_of_collections_(0),
+      number_of_compactions_(0),
+      compacted_code_bytes_(0),
       histogram_stack_map_memory_use_("Memory used for stack maps", 16),
       histogram_code_memory_use_("Memory used for compiled code", 16),
       histogram_profiling_info_memory_use_("Memory used for profiling info", 16) {
@@ -455,6 +458,10 @@ void JitCodeCache::SweepRootTables(IsMarkedVisitor* visitor) {
           mirror::Class* new_klass = down_cast<mirror::Class*>(visitor->IsMarked(klass));
           if (new_klass != klass) {
             cache->classes_[j] = GcRoot<mirror::Class>(new_klass);
+            if (new_klass == nullptr) {
+              // The count belongs to the unloaded class.
+              cache->counts_[j] = 0u;
+            }
           }
         }
       }
@@ -498,7 +505,7 @@ void JitCodeCache::FreeAllMethodHeaders(
 
   // Check that the set of compiled methods exactly matches native debug information.
   // Does not check zygote methods since they can change concurrently.
-  if (kIsDebugBuild && !Runtime::Current()->IsZygote()) {
+  if (kIsDebugBuild && !Runtime::Current()->IsSharingJitCode()) {
     std::map<const void*, ArtMethod*> compiled_methods;
     VisitAllMethods([&](const void* addr, ArtMethod* method) {
       if (!IsInZygoteExecSpace(addr)) {
@@ -545,6 +552,7 @@ void JitCodeCache::RemoveMethodsIn(Thread* self, const LinearAlloc& alloc) {
           ++it;
         }
       }
+      size_t old_size = method_code_map_.size();
       for (auto it = method_code_map_.begin(); it != method_code_map_.end();) {
         if (alloc.ContainsUnsafe(it->second)) {
           method_headers.insert(OatQuickMethodHeader::FromCodePointer(it->first));
@@ -554,6 +562,9 @@ void JitCodeCache::RemoveMethodsIn(Thread* self, const LinearAlloc& alloc) {
           ++it;
         }
       }
+      if (method_code_map_.size() != old_size) {
+        code_lookup_table_.Rebuild(method_code_map_);
+      }
     }
     for (auto it = osr_code_map_.begin(); it != osr_code_map_.end();) {
       if (alloc.ContainsUnsafe(it->first)) {
@@ -613,17 +624,22 @@ void JitCodeCache::DisallowInlineCacheAccess() {
 
 void JitCodeCache::CopyInlineCacheInto(
     const InlineCache& ic,
-    /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes) {
+    /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes,
+    /*out*/uint32_t* counts) {
   static_assert(arraysize(ic.classes_) == InlineCache::kIndividualCacheSize);
+  static_assert(arraysize(ic.counts_) == InlineCache::kIndividualCacheSize);
   DCHECK_EQ(classes->NumberOfReferences(), InlineCache::kIndividualCacheSize);
   DCHECK_EQ(classes->RemainingSlots(), InlineCache::kIndividualCacheSize);
   WaitUntilInlineCacheAccessible(Thread::Current());
   // Note that we don't need to lock `lock_` here, the compiler calling
   // this method has already ensured the inline cache will not be deleted.
-  for (const GcRoot<mirror::Class>& root : ic.classes_) {
-    mirror::Class* object = root.Read();
+  for (size_t i = 0; i < InlineCache::kIndividualCacheSize; ++i) {
+    mirror::Class* object = ic.classes_[i].Read();
     if (object != nullptr) {
       DCHECK_NE(classes->RemainingSlots(), 0u);
+      if (counts != nullptr) {
+        counts[InlineCache::kIndividualCacheSize - classes->RemainingSlots()] = ic.counts_[i];
+      }
       classes->NewHandle(object);
     }
   }
@@ -764,6 +780,7 @@ bool JitCodeCache::Commit(Thread* self,
       } else {
         ScopedDebugDisallowReadBarriers sddrb(self);
         method_code_map_.Put(code_ptr, method);
+        code_lookup_table_.Add(code_ptr, method_header->GetCodeSize(), method);
       }
       if (compilation_kind == CompilationKind::kOsr) {
         ScopedDebugDisallowReadBarriers sddrb(self);
@@ -858,6 +875,7 @@ bool JitCodeCache::RemoveMethodLocked(ArtMethod* method, bool release_memory) {
     for (auto it = method_code_map_.begin(); it != method_code_map_.end();) {
       if (it->second == method) {
         in_cache = true;
+        code_lookup_table_.Remove(it->first);
         if (release_memory) {
           FreeCodeAndData(it->first);
         }
@@ -911,6 +929,7 @@ void JitCodeCache::MoveObsoleteMethod(ArtMethod* old_method, ArtMethod* new_meth
       it.second = new_method;
     }
   }
+  code_lookup_table_.Rebuild(method_code_map_);
   // Update osr_code_map_ to point to the new method.
   auto code_map = osr_code_map_.find(old_method);
   if (code_map != osr_code_map_.end()) {
@@ -1238,6 +1257,7 @@ void JitCodeCache::RemoveUnmarkedCode(Thread* self) {
         it = method_code_map_.erase(it);
       }
     }
+    code_lookup_table_.Rebuild(method_code_map_);
     FreeAllMethodHeaders(method_headers);
   }
 }
@@ -1325,9 +1345,16 @@ void JitCodeCache::ResetHotnessCounter(ArtMethod* method, Thread* self) {
   it->second->ResetCounter();
 }
 
+bool JitCodeCache::HasReachedOptimizeThreshold(ArtMethod* method, Thread* self) {
+  ScopedDebugDisallowReadBarriers sddrb(self);
+  MutexLock mu(self, *Locks::jit_lock_);
+  auto it = profiling_infos_.find(method);
+  return it != profiling_infos_.end() && it->second->GetBaselineHotnessCount() == 0u;
+}
 
 void JitCodeCache::DoCollection(Thread* self, bool collect_profiling_info) {
   ScopedTrace trace(__FUNCTION__);
+  size_t retired_lookup_tables = 0u;
   {
     ScopedDebugDisallowReadBarriers sddrb(self);
     MutexLock mu(self, *Locks::jit_lock_);
@@ -1388,11 +1415,20 @@ void JitCodeCache::DoCollection(Thread* self, bool collect_profiling_info) {
     // Empty osr method map, as osr compiled code will be deleted (except the ones
     // on thread stacks).
     osr_code_map_.clear();
+    retired_lookup_tables = code_lookup_table_.GetRetiredTableCount();
   }
 
   // Run a checkpoint on all threads to mark the JIT compiled code they are running.
   MarkCompiledCodeOnThreadStacks(self);
 
+  {
+    // Lookups without the lock are only done by runnable threads, which could not run the
+    // checkpoint in the middle of one. So the lookups which could read the lookup tables retired
+    // before the checkpoint are done.
+    MutexLock mu(self, *Locks::jit_lock_);
+    code_lookup_table_.FreeRetiredTables(retired_lookup_tables);
+  }
+
   // At this point, mutator threads are still running, and entrypoints of methods can
   // change. We do know they cannot change to a code cache entry that is not marked,
   // therefore we can safely remove those entries.
@@ -1400,7 +1436,177 @@ void JitCodeCache::DoCollection(Thread* self, bool collect_profiling_info) {
 
   if (collect_profiling_info) {
     // TODO: Collect unused profiling infos.
+    if (Runtime::Current()->GetJITOptions()->CompactCode()) {
+      CompactCode(self);
+    }
+  }
+}
+
+void JitCodeCache::CompactCode(Thread* self) {
+  ScopedTrace trace(__FUNCTION__);
+  if (Runtime::Current()->GetJit()->GetJitCompiler()->GenerateAnyDebugInfo()) {
+    // The native debug info, including mini-debug-info, is an ELF file built for the code
+    // address of each method. Moving the code would leave stale symbols behind.
+    return;
+  }
+
+  // Entry points are loaded and called without suspending, so once all threads are suspended
+  // only the code on their stacks is referenced from outside of the code cache maps.
+  ScopedThreadSuspension sts(self, ThreadState::kSuspended);
+  ScopedSuspendAll ssa(__FUNCTION__);
+  std::unordered_set<const void*> code_on_stacks;
+  {
+    MutexLock mu(self, *Locks::thread_list_lock_);
+    Runtime::Current()->GetThreadList()->ForEach([&](Thread* thread)
+        REQUIRES_SHARED(Locks::mutator_lock_) {
+      StackVisitor::WalkStack(
+          [&](const art::StackVisitor* stack_visitor) {
+            const OatQuickMethodHeader* method_header =
+                stack_visitor->GetCurrentOatQuickMethodHeader();
+            if (method_header != nullptr && ContainsPc(method_header->GetCode())) {
+              code_on_stacks.insert(method_header->GetCode());
+            }
+            return true;
+          },
+          thread,
+          /* context= */ nullptr,
+          art::StackVisitor::StackWalkKind::kSkipInlinedFrames);
+    });
+  }
+
+  ScopedDebugDisallowReadBarriers sddrb(self);
+  MutexLock mu(self, *Locks::jit_lock_);
+  struct MovedCode {
+    ArtMethod* method;
+    const void* old_code;
+    std::vector<uint8_t> code;
+    const uint8_t* stack_map;
+    bool has_should_deoptimize_flag;
+    bool is_entry_point;
+    bool is_osr;
+    bool is_saved;
+    uint32_t order;
+  };
+  std::vector<MovedCode> moved_code;
+  for (const auto& [code_ptr, method] : method_code_map_) {
+    if (IsInZygoteExecSpace(code_ptr) || code_on_stacks.find(code_ptr) != code_on_stacks.end()) {
+      continue;
+    }
+    const OatQuickMethodHeader* method_header = OatQuickMethodHeader::FromCodePointer(code_ptr);
+    DCHECK(method_header->IsOptimized());
+    bool is_entry_point =
+        method->GetEntryPointFromQuickCompiledCode() == method_header->GetEntryPoint();
+    auto osr_it = osr_code_map_.find(method);
+    bool is_osr = osr_it != osr_code_map_.end() && osr_it->second == code_ptr;
+    auto saved_it = saved_compiled_methods_map_.find(method);
+    bool is_saved = saved_it != saved_compiled_methods_map_.end() && saved_it->second == code_ptr;
+    if (!is_entry_point && !is_osr && !is_saved) {
+      // Don't know who uses the code, leave it where it is.
+      continue;
+    }
+    const uint8_t* code = reinterpret_cast<const uint8_t*>(code_ptr);
+    bool is_baseline = CodeInfo::IsBaseline(method_header->GetOptimizedCodeInfoPtr());
+    moved_code.push_back(MovedCode {
+        method,
+        code_ptr,
+        std::vector<uint8_t>(code, code + method_header->GetCodeSize()),
+        method_header->GetOptimizedCodeInfoPtr(),
+        method_header->HasShouldDeoptimizeFlag(),
+        is_entry_point,
+        is_osr,
+        is_saved,
+        is_baseline ? 2u : (is_osr ? 1u : 0u)});
+  }
+  if (moved_code.empty()) {
+    return;
+  }
+  // Allocating in that order from the coalesced free space lays out the optimized code
+  // contiguously, then the OSR code, then the baseline code.
+  std::stable_sort(moved_code.begin(),
+                   moved_code.end(),
+                   [](const MovedCode& lhs, const MovedCode& rhs) {
+                     return lhs.order != rhs.order
+                         ? lhs.order < rhs.order
+                         : lhs.old_code < rhs.old_code;
+                   });
+
+  {
+    ScopedCodeCacheWrite ccw(private_region_);
+    for (const MovedCode& entry : moved_code) {
+      method_code_map_.erase(entry.old_code);
+      FreeLocked(&private_region_,
+                 reinterpret_cast<const uint8_t*>(FromCodeToAllocation(entry.old_code)),
+                 /* data= */ nullptr);
+    }
+  }
+  size_t moved_bytes = 0u;
+  std::unordered_map<OatQuickMethodHeader*, OatQuickMethodHeader*> moved_headers;
+  std::unordered_set<OatQuickMethodHeader*> dropped_headers;
+  for (const MovedCode& entry : moved_code) {
+    OatQuickMethodHeader* old_header = OatQuickMethodHeader::FromCodePointer(entry.old_code);
+    size_t size = OatQuickMethodHeader::InstructionAlignedSize() + entry.code.size();
+    const uint8_t* allocation;
+    {
+      ScopedCodeCacheWrite ccw(private_region_);
+      allocation = private_region_.AllocateCode(size);
+    }
+    const uint8_t* code = (allocation == nullptr)
+        ? nullptr
+        : private_region_.CommitCode(ArrayRef<const uint8_t>(allocation, size),
+                                     ArrayRef<const uint8_t>(entry.code),
+                                     entry.stack_map,
+                                     entry.has_should_deoptimize_flag);
+    if (code == nullptr) {
+      // The space freed above should fit the code again, but if not, drop the code like a
+      // collection would.
+      if (allocation != nullptr) {
+        ScopedCodeCacheWrite ccw(private_region_);
+        private_region_.FreeCode(allocation);
+      }
+      VLOG(jit) << "JIT failed to move " << entry.method->PrettyMethod();
+      FreeLocked(&private_region_,
+                 /* code= */ nullptr,
+                 entry.stack_map - ComputeRootTableSize(GetNumberOfRoots(entry.stack_map)));
+      dropped_headers.insert(old_header);
+      if (entry.is_entry_point) {
+        Runtime::Current()->GetInstrumentation()->InitializeMethodsCode(
+            entry.method, /*aot_code=*/ nullptr);
+      }
+      if (entry.is_osr) {
+        osr_code_map_.erase(entry.method);
+      }
+      if (entry.is_saved) {
+        saved_compiled_methods_map_.erase(entry.method);
+      }
+      continue;
+    }
+    OatQuickMethodHeader* new_header = OatQuickMethodHeader::FromCodePointer(code);
+    moved_headers.emplace(old_header, new_header);
+    method_code_map_.Put(code, entry.method);
+    if (entry.is_entry_point) {
+      entry.method->SetEntryPointFromQuickCompiledCode(new_header->GetEntryPoint());
+    }
+    if (entry.is_osr) {
+      osr_code_map_.Overwrite(entry.method, code);
+    }
+    if (entry.is_saved) {
+      saved_compiled_methods_map_.Overwrite(entry.method, code);
+    }
+    moved_bytes += entry.code.size();
+  }
+  // All threads are suspended, no lookup can see the table out of sync with the maps.
+  code_lookup_table_.Rebuild(method_code_map_);
+  {
+    MutexLock mu2(self, *Locks::cha_lock_);
+    ClassHierarchyAnalysis* cha = Runtime::Current()->GetClassLinker()->GetClassHierarchyAnalysis();
+    cha->RemoveDependentsWithMethodHeaders(dropped_headers);
+    cha->UpdateDependentMethodHeaders(moved_headers);
   }
+  size_t released_bytes = private_region_.TrimCode();
+  ++number_of_compactions_;
+  compacted_code_bytes_ += moved_bytes;
+  VLOG(jit) << "JIT code cache compaction moved " << moved_code.size() << " methods ("
+            << PrettySize(moved_bytes) << ") and released " << PrettySize(released_bytes);
 }
 
 OatQuickMethodHeader* JitCodeCache::LookupMethodHeader(uintptr_t pc, ArtMethod* method) {
@@ -1420,10 +1626,10 @@ OatQuickMethodHeader* JitCodeCache::LookupMethodHeader(uintptr_t pc, ArtMethod*
 
   Thread* self = Thread::Current();
   ScopedDebugDisallowReadBarriers sddrb(self);
-  MutexLock mu(self, *Locks::jit_lock_);
   OatQuickMethodHeader* method_header = nullptr;
   ArtMethod* found_method = nullptr;  // Only for DCHECK(), not for JNI stubs.
   if (method != nullptr && UNLIKELY(method->IsNative())) {
+    MutexLock mu(self, *Locks::jit_lock_);
     auto it = jni_stubs_map_.find(JniStubKey(method));
     if (it == jni_stubs_map_.end() || !ContainsElement(it->second.GetMethods(), method)) {
       return nullptr;
@@ -1440,23 +1646,40 @@ OatQuickMethodHeader* JitCodeCache::LookupMethodHeader(uintptr_t pc, ArtMethod*
         return OatQuickMethodHeader::FromCodePointer(code_ptr);
       }
     }
-    auto it = method_code_map_.lower_bound(reinterpret_cast<const void*>(pc));
-    if (it != method_code_map_.begin()) {
-      --it;
-      const void* code_ptr = it->first;
-      if (OatQuickMethodHeader::FromCodePointer(code_ptr)->Contains(pc)) {
-        method_header = OatQuickMethodHeader::FromCodePointer(code_ptr);
-        found_method = it->second;
-      }
+    // Stack walks for exceptions and sampling profilers look up compiled code all the time, so
+    // first try without contending on `Locks::jit_lock_` with the compilations. Only runnable
+    // threads can do that: they run the checkpoint after which the retired lookup tables are
+    // freed only once their lookup is done. The GC threads, and the checkpoints run on behalf of
+    // suspended threads by non-runnable threads, take the lock.
+    const void* code_ptr = nullptr;
+    JitCodeLookupTable::LookupResult result = JitCodeLookupTable::LookupResult::kContended;
+    if (self->GetState() == ThreadState::kRunnable) {
+      result = code_lookup_table_.Lookup(pc, &code_ptr, &found_method);
+    }
+    if (result == JitCodeLookupTable::LookupResult::kFound) {
+      method_header = OatQuickMethodHeader::FromCodePointer(code_ptr);
     }
-    if (method_header == nullptr && method == nullptr) {
-      // Scan all compiled JNI stubs as well. This slow search is used only
-      // for checks in debug build, for release builds the `method` is not null.
-      for (auto&& entry : jni_stubs_map_) {
-        const JniStubData& data = entry.second;
-        if (data.IsCompiled() &&
-            OatQuickMethodHeader::FromCodePointer(data.GetCode())->Contains(pc)) {
-          method_header = OatQuickMethodHeader::FromCodePointer(data.GetCode());
+    if (result == JitCodeLookupTable::LookupResult::kContended ||
+        (method_header == nullptr && method == nullptr)) {
+      MutexLock mu(self, *Locks::jit_lock_);
+      auto it = method_code_map_.lower_bound(reinterpret_cast<const void*>(pc));
+      if (it != method_code_map_.begin()) {
+        --it;
+        code_ptr = it->first;
+        if (OatQuickMethodHeader::FromCodePointer(code_ptr)->Contains(pc)) {
+          method_header = OatQuickMethodHeader::FromCodePointer(code_ptr);
+          found_method = it->second;
+        }
+      }
+      if (method_header == nullptr && method == nullptr) {
+        // Scan all compiled JNI stubs as well. This slow search is used only
+        // for checks in debug build, for release builds the `method` is not null.
+        for (auto&& entry : jni_stubs_map_) {
+          const JniStubData& data = entry.second;
+          if (data.IsCompiled() &&
+              OatQuickMethodHeader::FromCodePointer(data.GetCode())->Contains(pc)) {
+            method_header = OatQuickMethodHeader::FromCodePointer(data.GetCode());
+          }
         }
       }
     }
@@ -1865,7 +2088,7 @@ void JitCodeCache::Dump(std::ostream& os) {
      << "Current JIT data cache size (used / resident): "
      << GetCurrentRegion()->GetUsedMemoryForData() / KB << "KB / "
      << GetCurrentRegion()->GetResidentMemoryForData() / KB << "KB\n";
-  if (!Runtime::Current()->IsZygote()) {
+  if (!Runtime::Current()->IsSharingJitCode()) {
     os << "Zygote JIT code cache size (at point of fork): "
        << shared_region_.GetUsedMemoryForCode() / KB << "KB / "
        << shared_region_.GetResidentMemoryForCode() / KB << "KB\n"
@@ -1881,7 +2104,9 @@ void JitCodeCache::Dump(std::ostream& os) {
      << "Total number of JIT optimized compilations: " << number_of_optimized_compilations_ << "\n"
      << "Total number of JIT compilations for on stack replacement: "
         << number_of_osr_compilations_ << "\n"
-     << "Total number of JIT code cache collections: " << number_of_collections_ << std::endl;
+     << "Total number of JIT code cache collections: " << number_of_collections_ << "\n"
+     << "Total number of JIT code cache compactions: " << number_of_compactions_
+        << " (" << PrettySize(compacted_code_bytes_) << " moved)" << std::endl;
   histogram_stack_map_memory_use_.PrintMemoryUse(os);
   histogram_code_memory_use_.PrintMemoryUse(os);
   histogram_profiling_info_memory_use_.PrintMemoryUse(os);
@@ -1917,6 +2142,8 @@ void JitCodeCache::PostForkChildAction(bool is_system_server, bool is_zygote) {
   number_of_optimized_compilations_ = 0;
   number_of_osr_compilations_ = 0;
   number_of_collections_ = 0;
+  number_of_compactions_ = 0;
+  compacted_code_bytes_ = 0;
   histogram_stack_map_memory_use_.Reset();
   histogram_code_memory_use_.Reset();
   histogram_profiling_info_memory_use_.Reset();
@@ -1928,6 +2155,7 @@ void JitCodeCache::PostForkChildAction(bool is_system_server, bool is_zygote) {
                                   max_capacity,
                                   /* rwx_memory_allowed= */ !is_system_server,
                                   is_zygote,
+                                  runtime->GetJITOptions()->UseHugePages(),
                                   &error_msg)) {
     LOG(WARNING) << "Could not create private region after zygote fork: " << error_msg;
   }
@@ -1938,7 +2166,7 @@ void JitCodeCache::PostForkChildAction(bool is_system_server, bool is_zygote) {
 }
 
 JitMemoryRegion* JitCodeCache::GetCurrentRegion() {
-  return Runtime::Current()->IsZygote() ? &shared_region_ : &private_region_;
+  return Runtime::Current()->IsSharingJitCode() ? &shared_region_ : &private_region_;
 }
 
 void JitCodeCache::VisitAllMethods(const std::function<void(const void*, ArtMethod*)>& cb) {
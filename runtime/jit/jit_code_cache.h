@@ -33,6 +33,7 @@
 #include "base/mutex.h"
 #include "base/safe_map.h"
 #include "compilation_kind.h"
+#include "jit_code_lookup_table.h"
 #include "jit_memory_region.h"
 #include "profiling_info.h"
 
@@ -43,6 +44,7 @@ template<class T> class Handle;
 class LinearAlloc;
 class InlineCache;
 class IsMarkedVisitor;
+class JitCodeCacheCompactionTestHelper;
 class JitJniStubTestHelper;
 class OatQuickMethodHeader;
 struct ProfileMethodInfo;
@@ -309,8 +311,11 @@ class JitCodeCache {
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Copy the classes of the inline cache into `classes`. If `counts` is not null, it receives
+  // the number of calls seen for each of the copied classes, in the same order.
   void CopyInlineCacheInto(const InlineCache& ic,
-                           /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes)
+                           /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes,
+                           /*out*/uint32_t* counts = nullptr)
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -405,6 +410,9 @@ class JitCodeCache {
   ProfilingInfo* GetProfilingInfo(ArtMethod* method, Thread* self);
   void ResetHotnessCounter(ArtMethod* method, Thread* self);
 
+  // Return whether the baseline compiled code of `method` counted down its hotness to zero.
+  bool HasReachedOptimizeThreshold(ArtMethod* method, Thread* self);
+
   void VisitRoots(RootVisitor* visitor);
 
   // Return whether `method` is being compiled with the given mode.
@@ -491,6 +499,13 @@ class JitCodeCache {
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Move the compiled code which is not on a thread stack to the start of the private region,
+  // the optimized code first, so that the live code, and the hot code in particular, spans as
+  // few pages as possible. Done after full collections with -Xjitcompactcode:true.
+  void CompactCode(Thread* self)
+      REQUIRES(!Locks::jit_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   void MarkCompiledCodeOnThreadStacks(Thread* self)
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -546,6 +561,10 @@ class JitCodeCache {
   // Holds compiled code associated to the ArtMethod.
   SafeMap<const void*, ArtMethod*> method_code_map_ GUARDED_BY(Locks::jit_lock_);
 
+  // The code ranges of `method_code_map_`, for lookups without `Locks::jit_lock_`. Updated
+  // before the code is freed.
+  JitCodeLookupTable code_lookup_table_;
+
   // Holds compiled code associated to the ArtMethod. Used when pre-jitting
   // methods whose entrypoints have the resolution stub.
   SafeMap<ArtMethod*, const void*> saved_compiled_methods_map_ GUARDED_BY(Locks::jit_lock_);
@@ -596,6 +615,10 @@ class JitCodeCache {
   // Number of code cache collections done throughout the lifetime of the JIT.
   size_t number_of_collections_ GUARDED_BY(Locks::jit_lock_);
 
+  // Number of code cache compactions, and of bytes of code moved by them.
+  size_t number_of_compactions_ GUARDED_BY(Locks::jit_lock_);
+  size_t compacted_code_bytes_ GUARDED_BY(Locks::jit_lock_);
+
   // Histograms for keeping track of stack map size statistics.
   Histogram<uint64_t> histogram_stack_map_memory_use_ GUARDED_BY(Locks::jit_lock_);
 
@@ -605,6 +628,7 @@ class JitCodeCache {
   // Histograms for keeping track of profiling info statistics.
   Histogram<uint64_t> histogram_profiling_info_memory_use_ GUARDED_BY(Locks::jit_lock_);
 
+  friend class art::JitCodeCacheCompactionTestHelper;
   friend class art::JitJniStubTestHelper;
   friend class ScopedCodeCacheWrite;
   friend class MarkCodeClosure;
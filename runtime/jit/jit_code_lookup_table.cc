@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jit_code_lookup_table.h"
+
+#include <algorithm>
+
+#include "base/logging.h"
+#include "oat_quick_method_header.h"
+
+namespace art {
+namespace jit {
+
+JitCodeLookupTable::JitCodeLookupTable()
+    : sequence_(0u), table_(new Table(kInitialCapacity)), size_(0u) {}
+
+JitCodeLookupTable::~JitCodeLookupTable() {
+  delete table_.load(std::memory_order_relaxed);
+}
+
+JitCodeLookupTable::LookupResult JitCodeLookupTable::Lookup(uintptr_t pc,
+                                                            /*out*/ const void** code,
+                                                            /*out*/ ArtMethod** method) const {
+  for (size_t attempt = 0; attempt != kMaxLookupAttempts; ++attempt) {
+    uint32_t sequence = sequence_.load(std::memory_order_acquire);
+    if ((sequence & 1u) != 0u) {
+      // A writer is changing the table.
+      continue;
+    }
+    const Table* table = table_.load(std::memory_order_acquire);
+    // The size may be the one of a bigger table installed since loading `table`.
+    size_t size = std::min(size_.load(std::memory_order_relaxed), table->capacity);
+    const Entry* entries = table->entries.get();
+    // Find the first entry starting after `pc`.
+    size_t low = 0u;
+    size_t high = size;
+    while (low != high) {
+      size_t mid = low + (high - low) / 2u;
+      if (entries[mid].begin.load(std::memory_order_relaxed) <= pc) {
+        low = mid + 1u;
+      } else {
+        high = mid;
+      }
+    }
+    uintptr_t begin = 0u;
+    uintptr_t end = 0u;
+    ArtMethod* found_method = nullptr;
+    if (low != 0u) {
+      begin = entries[low - 1u].begin.load(std::memory_order_relaxed);
+      end = entries[low - 1u].end.load(std::memory_order_relaxed);
+      found_method = entries[low - 1u].method.load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (sequence_.load(std::memory_order_relaxed) != sequence) {
+      continue;
+    }
+    if (low == 0u || pc >= end) {
+      return LookupResult::kNotFound;
+    }
+    *code = reinterpret_cast<const void*>(begin);
+    *method = found_method;
+    return LookupResult::kFound;
+  }
+  return LookupResult::kContended;
+}
+
+void JitCodeLookupTable::BeginWrite() {
+  uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+  DCHECK_EQ(sequence & 1u, 0u);
+  sequence_.store(sequence + 1u, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+}
+
+void JitCodeLookupTable::EndWrite() {
+  uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+  DCHECK_EQ(sequence & 1u, 1u);
+  sequence_.store(sequence + 1u, std::memory_order_release);
+}
+
+JitCodeLookupTable::Table* JitCodeLookupTable::EnsureCapacity(size_t size) {
+  Table* table = table_.load(std::memory_order_relaxed);
+  if (size <= table->capacity) {
+    return table;
+  }
+  size_t capacity = table->capacity;
+  while (capacity < size) {
+    capacity *= 2u;
+  }
+  Table* new_table = new Table(capacity);
+  size_t old_size = size_.load(std::memory_order_relaxed);
+  for (size_t i = 0; i != old_size; ++i) {
+    CopyEntry(&new_table->entries[i], table->entries[i]);
+  }
+  table_.store(new_table, std::memory_order_release);
+  // Lookups may still be reading the old table.
+  retired_tables_.emplace_back(table);
+  return new_table;
+}
+
+void JitCodeLookupTable::Add(const void* code_ptr, size_t code_size, ArtMethod* method) {
+  BeginWrite();
+  size_t size = size_.load(std::memory_order_relaxed);
+  Table* table = EnsureCapacity(size + 1u);
+  Entry* entries = table->entries.get();
+  uintptr_t begin = reinterpret_cast<uintptr_t>(code_ptr);
+  size_t index = size;
+  while (index != 0u && entries[index - 1u].begin.load(std::memory_order_relaxed) > begin) {
+    CopyEntry(&entries[index], entries[index - 1u]);
+    --index;
+  }
+  DCHECK(index == 0u || entries[index - 1u].begin.load(std::memory_order_relaxed) != begin);
+  SetEntry(&entries[index], code_ptr, code_size, method);
+  size_.store(size + 1u, std::memory_order_relaxed);
+  EndWrite();
+}
+
+void JitCodeLookupTable::Remove(const void* code_ptr) {
+  Table* table = table_.load(std::memory_order_relaxed);
+  Entry* entries = table->entries.get();
+  size_t size = size_.load(std::memory_order_relaxed);
+  uintptr_t begin = reinterpret_cast<uintptr_t>(code_ptr);
+  Entry* it = std::lower_bound(entries, entries + size, begin, [](const Entry& entry, uintptr_t b) {
+    return entry.begin.load(std::memory_order_relaxed) < b;
+  });
+  if (it == entries + size || it->begin.load(std::memory_order_relaxed) != begin) {
+    return;
+  }
+  BeginWrite();
+  for (Entry* next = it + 1; next != entries + size; ++it, ++next) {
+    CopyEntry(it, *next);
+  }
+  size_.store(size - 1u, std::memory_order_relaxed);
+  EndWrite();
+}
+
+void JitCodeLookupTable::Rebuild(const SafeMap<const void*, ArtMethod*>& code_map) {
+  BeginWrite();
+  Table* table = EnsureCapacity(code_map.size());
+  Entry* entries = table->entries.get();
+  size_t index = 0u;
+  for (const auto& [code_ptr, method] : code_map) {
+    SetEntry(&entries[index],
+             code_ptr,
+             OatQuickMethodHeader::FromCodePointer(code_ptr)->GetCodeSize(),
+             method);
+    ++index;
+  }
+  size_.store(index, std::memory_order_relaxed);
+  EndWrite();
+}
+
+void JitCodeLookupTable::FreeRetiredTables(size_t count) {
+  DCHECK_LE(count, retired_tables_.size());
+  retired_tables_.erase(retired_tables_.begin(), retired_tables_.begin() + count);
+}
+
+}  // namespace jit
+}  // namespace art
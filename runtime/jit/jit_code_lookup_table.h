@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_JIT_JIT_CODE_LOOKUP_TABLE_H_
+#define ART_RUNTIME_JIT_JIT_CODE_LOOKUP_TABLE_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "base/locks.h"
+#include "base/macros.h"
+#include "base/safe_map.h"
+
+namespace art {
+
+class ArtMethod;
+
+namespace jit {
+
+// A sorted table of the code ranges of JitCodeCache::method_code_map_, to find the code
+// containing a pc without taking Locks::jit_lock_. The JitCodeCache updates it under
+// Locks::jit_lock_ along with method_code_map_.
+//
+// Readers don't write anything: the writers increment a sequence number before and after
+// changing the table, and a reader retries if the sequence number changed while it was searching.
+// The entries are only read through atomics so that a reader racing with a writer just sees
+// inconsistent values, which it then discards. When the table grows, the old one is retired and
+// must stay readable until all the lookups which may have loaded it are done, see
+// FreeRetiredTables().
+class JitCodeLookupTable {
+ public:
+  enum class LookupResult {
+    kFound,
+    kNotFound,
+    // Concurrent updates kept the lookup from getting a consistent result.
+    kContended,
+  };
+
+  static constexpr size_t kInitialCapacity = 256u;
+  static constexpr size_t kMaxLookupAttempts = 16u;
+
+  JitCodeLookupTable();
+  ~JitCodeLookupTable();
+
+  // Find the code containing `pc`. The caller must be runnable, as a thread suspended or running
+  // a checkpoint on behalf of a suspended thread could be in the middle of a lookup when the
+  // checkpoint completes, see FreeRetiredTables().
+  LookupResult Lookup(uintptr_t pc, /*out*/ const void** code, /*out*/ ArtMethod** method) const;
+
+  // Add the code `code_ptr` of `method`.
+  void Add(const void* code_ptr, size_t code_size, ArtMethod* method) REQUIRES(Locks::jit_lock_);
+
+  // Remove the code `code_ptr`, if present.
+  void Remove(const void* code_ptr) REQUIRES(Locks::jit_lock_);
+
+  // Replace the entries with the content of `code_map`, for changes of many entries at once. The
+  // OatQuickMethodHeaders of the code give the code sizes.
+  void Rebuild(const SafeMap<const void*, ArtMethod*>& code_map) REQUIRES(Locks::jit_lock_);
+
+  size_t Size() const {
+    return size_.load(std::memory_order_relaxed);
+  }
+
+  // The tables replaced by bigger ones can be freed once all the threads went through a suspend
+  // point, for example after a checkpoint, as lookups don't suspend. Get the number of retired
+  // tables before the checkpoint, and free that many after it.
+  size_t GetRetiredTableCount() const REQUIRES(Locks::jit_lock_) {
+    return retired_tables_.size();
+  }
+  void FreeRetiredTables(size_t count) REQUIRES(Locks::jit_lock_);
+
+ private:
+  struct Entry {
+    std::atomic<uintptr_t> begin;
+    std::atomic<uintptr_t> end;
+    std::atomic<ArtMethod*> method;
+  };
+
+  struct Table {
+    explicit Table(size_t table_capacity)
+        : capacity(table_capacity), entries(new Entry[table_capacity]()) {}
+
+    const size_t capacity;
+    const std::unique_ptr<Entry[]> entries;
+  };
+
+  // Make sure the table can hold `size` entries. Must be called between BeginWrite() and
+  // EndWrite().
+  Table* EnsureCapacity(size_t size) REQUIRES(Locks::jit_lock_);
+
+  void BeginWrite() REQUIRES(Locks::jit_lock_);
+  void EndWrite() REQUIRES(Locks::jit_lock_);
+
+  static void CopyEntry(Entry* dest, const Entry& src) {
+    dest->begin.store(src.begin.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    dest->end.store(src.end.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    dest->method.store(src.method.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  }
+
+  static void SetEntry(Entry* dest, const void* code_ptr, size_t code_size, ArtMethod* method) {
+    uintptr_t begin = reinterpret_cast<uintptr_t>(code_ptr);
+    dest->begin.store(begin, std::memory_order_relaxed);
+    dest->end.store(begin + code_size, std::memory_order_relaxed);
+    dest->method.store(method, std::memory_order_relaxed);
+  }
+
+  // Odd while a writer changes the table.
+  std::atomic<uint32_t> sequence_;
+  std::atomic<Table*> table_;
+  std::atomic<size_t> size_;
+  std::vector<std::unique_ptr<Table>> retired_tables_ GUARDED_BY(Locks::jit_lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(JitCodeLookupTable);
+};
+
+}  // namespace jit
+}  // namespace art
+
+#endif  // ART_RUNTIME_JIT_JIT_CODE_LOOKUP_TABLE_H_
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jit_code_lookup_table.h"
+
+#include "base/mutex.h"
+#include "common_runtime_test.h"
+#include "thread-current-inl.h"
+
+namespace art {
+namespace jit {
+
+class JitCodeLookupTableTest : public CommonRuntimeTest {
+ protected:
+  // The table never dereferences the code and the methods.
+  static const void* FakeCode(uintptr_t address) {
+    return reinterpret_cast<const void*>(address);
+  }
+
+  static ArtMethod* FakeMethod(uintptr_t id) {
+    return reinterpret_cast<ArtMethod*>(id * sizeof(void*));
+  }
+};
+
+TEST_F(JitCodeLookupTableTest, AddAndRemove) {
+  Thread* self = Thread::Current();
+  MutexLock mu(self, *Locks::jit_lock_);
+  JitCodeLookupTable table;
+  table.Add(FakeCode(0x3000), 0x100, FakeMethod(3));
+  table.Add(FakeCode(0x1000), 0x100, FakeMethod(1));
+  table.Add(FakeCode(0x2000), 0x80, FakeMethod(2));
+  EXPECT_EQ(table.Size(), 3u);
+
+  const void* code = nullptr;
+  ArtMethod* method = nullptr;
+  EXPECT_EQ(table.Lookup(0x2010, &code, &method), JitCodeLookupTable::LookupResult::kFound);
+  EXPECT_EQ(code, FakeCode(0x2000));
+  EXPECT_EQ(method, FakeMethod(2));
+  EXPECT_EQ(table.Lookup(0x30ff, &code, &method), JitCodeLookupTable::LookupResult::kFound);
+  EXPECT_EQ(method, FakeMethod(3));
+  // Before the first code, between two codes and after the last code.
+  EXPECT_EQ(table.Lookup(0x800, &code, &method), JitCodeLookupTable::LookupResult::kNotFound);
+  EXPECT_EQ(table.Lookup(0x2080, &code, &method), JitCodeLookupTable::LookupResult::kNotFound);
+  EXPECT_EQ(table.Lookup(0x3100, &code, &method), JitCodeLookupTable::LookupResult::kNotFound);
+
+  table.Remove(FakeCode(0x2000));
+  // Not in the table.
+  table.Remove(FakeCode(0x2000));
+  EXPECT_EQ(table.Size(), 2u);
+  EXPECT_EQ(table.Lookup(0x2010, &code, &method), JitCodeLookupTable::LookupResult::kNotFound);
+  EXPECT_EQ(table.Lookup(0x1010, &code, &method), JitCodeLookupTable::LookupResult::kFound);
+  EXPECT_EQ(method, FakeMethod(1));
+
+  table.Rebuild(SafeMap<const void*, ArtMethod*>());
+  EXPECT_EQ(table.Size(), 0u);
+  EXPECT_EQ(table.Lookup(0x1010, &code, &method), JitCodeLookupTable::LookupResult::kNotFound);
+}
+
+TEST_F(JitCodeLookupTableTest, Grow) {
+  Thread* self = Thread::Current();
+  MutexLock mu(self, *Locks::jit_lock_);
+  JitCodeLookupTable table;
+  constexpr size_t kCount = 2u * JitCodeLookupTable::kInitialCapacity + 1u;
+  // Add in decreasing order, each addition moves all the entries.
+  for (size_t i = kCount; i != 0u; --i) {
+    table.Add(FakeCode(i * 0x100), 0x10, FakeMethod(i));
+  }
+  EXPECT_EQ(table.Size(), kCount);
+  // Growing twice retired two tables.
+  EXPECT_EQ(table.GetRetiredTableCount(), 2u);
+  for (size_t i = 1u; i <= kCount; ++i) {
+    const void* code = nullptr;
+    ArtMethod* method = nullptr;
+    ASSERT_EQ(table.Lookup(i * 0x100 + 0x8, &code, &method),
+              JitCodeLookupTable::LookupResult::kFound);
+    EXPECT_EQ(method, FakeMethod(i));
+  }
+  table.FreeRetiredTables(1u);
+  EXPECT_EQ(table.GetRetiredTableCount(), 1u);
+  table.FreeRetiredTables(1u);
+  EXPECT_EQ(table.GetRetiredTableCount(), 0u);
+}
+
+}  // namespace jit
+}  // namespace art
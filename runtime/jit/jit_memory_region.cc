@@ -17,8 +17,11 @@
 #include "jit_memory_region.h"
 
 #include <fcntl.h>
+#include <sys/mman.h>
 #include <unistd.h>
 
+#include <algorithm>
+
 #include <android-base/unique_fd.h>
 #include <log/log.h>
 #include "base/bit_utils.h"  // For RoundDown, RoundUp
@@ -46,14 +49,25 @@ bool JitMemoryRegion::Initialize(size_t initial_capacity,
                                  size_t max_capacity,
                                  bool rwx_memory_allowed,
                                  bool is_zygote,
+                                 bool use_huge_pages,
                                  std::string* error_msg) {
   ScopedTrace trace(__PRETTY_FUNCTION__);
 
   CHECK_GE(max_capacity, initial_capacity);
   CHECK(max_capacity <= 1 * GB) << "The max supported size for JIT code cache is 1GB";
+  if (use_huge_pages && (is_zygote || max_capacity < 2 * kPMDSize)) {
+    // The zygote memory is shared with the apps and can't be remapped. A cache smaller than
+    // a huge page for code and one for data wouldn't benefit from huge pages.
+    VLOG(jit) << "Not using huge pages for the JIT code cache";
+    use_huge_pages = false;
+  }
   // Align both capacities to page size, as that's the unit mspaces use.
+  // With huge pages, the data and code portions must each start on a huge page boundary of the
+  // memory file and address space.
+  max_capacity_ = RoundDown(max_capacity, 2 * (use_huge_pages ? kPMDSize : kPageSize));
+  // Rounding down the max capacity to huge pages can take it below the initial capacity.
+  initial_capacity = std::min(initial_capacity, max_capacity_);
   initial_capacity_ = RoundDown(initial_capacity, 2 * kPageSize);
-  max_capacity_ = RoundDown(max_capacity, 2 * kPageSize);
   current_capacity_ = initial_capacity,
   data_end_ = initial_capacity / kCodeAndDataCapacityDivider;
   exec_end_ = initial_capacity - data_end_;
@@ -75,7 +89,7 @@ bool JitMemoryRegion::Initialize(size_t initial_capacity,
   if (is_zygote) {
     android_errorWriteLog(0x534e4554, "200284993");  // Report to SafetyNet.
     // Because we are not going to GC code generated by the zygote, just use all available.
-    current_capacity_ = max_capacity;
+    current_capacity_ = max_capacity_;
     mem_fd = unique_fd(CreateZygoteMemory(capacity, error_msg));
     if (mem_fd.get() < 0) {
       return false;
@@ -192,15 +206,42 @@ bool JitMemoryRegion::Initialize(size_t initial_capacity,
     // We could do PC-relative addressing to avoid this problem, but that
     // would require reserving code and data area before submitting, which
     // means more windows for the code memory to be RWX.
-    data_pages = MemMap::MapFile(
-        data_capacity + exec_capacity,
-        kProtR,
-        base_flags,
-        mem_fd,
-        /* start= */ 0,
-        /* low_4gb= */ true,
-        data_cache_name.c_str(),
-        &error_str);
+    MemMap reservation;
+    if (use_huge_pages) {
+      // A shared mapping can't be aligned directly, so reserve an aligned range to map into.
+      reservation = MemMap::MapAnonymousAligned(data_cache_name.c_str(),
+                                                data_capacity + exec_capacity,
+                                                kProtNone,
+                                                /* low_4gb= */ true,
+                                                kPMDSize,
+                                                &error_str);
+      if (!reservation.IsValid()) {
+        VLOG(jit) << "Failed to reserve aligned JIT code cache: " << error_str;
+      }
+    }
+    if (reservation.IsValid()) {
+      data_pages = MemMap::MapFileAtAddress(reservation.Begin(),
+                                            data_capacity + exec_capacity,
+                                            kProtR,
+                                            base_flags,
+                                            mem_fd,
+                                            /* start= */ 0,
+                                            /* low_4gb= */ true,
+                                            data_cache_name.c_str(),
+                                            /* reuse= */ false,
+                                            &reservation,
+                                            &error_str);
+    } else {
+      data_pages = MemMap::MapFile(
+          data_capacity + exec_capacity,
+          kProtR,
+          base_flags,
+          mem_fd,
+          /* start= */ 0,
+          /* low_4gb= */ true,
+          data_cache_name.c_str(),
+          &error_str);
+    }
   } else {
     // Single view of JIT code cache case. Create an initial mapping of data pages large enough
     // for data and JIT code pages. The mappings will look like:
@@ -217,12 +258,22 @@ bool JitMemoryRegion::Initialize(size_t initial_capacity,
     // and the executable view of the code cache transitions RX to RWX for the update and then
     // back to RX after the update.
     base_flags = MAP_PRIVATE | MAP_ANON;
-    data_pages = MemMap::MapAnonymous(
-        data_cache_name.c_str(),
-        data_capacity + exec_capacity,
-        kProtRW,
-        /* low_4gb= */ true,
-        &error_str);
+    if (use_huge_pages) {
+      data_pages = MemMap::MapAnonymousAligned(
+          data_cache_name.c_str(),
+          data_capacity + exec_capacity,
+          kProtRW,
+          /* low_4gb= */ true,
+          kPMDSize,
+          &error_str);
+    } else {
+      data_pages = MemMap::MapAnonymous(
+          data_cache_name.c_str(),
+          data_capacity + exec_capacity,
+          kProtRW,
+          /* low_4gb= */ true,
+          &error_str);
+    }
   }
 
   if (!data_pages.IsValid()) {
@@ -258,6 +309,9 @@ bool JitMemoryRegion::Initialize(size_t initial_capacity,
   exec_pages_ = std::move(exec_pages);
   non_exec_pages_ = std::move(non_exec_pages);
   writable_data_pages_ = std::move(writable_data_pages);
+  if (use_huge_pages) {
+    AdviseHugePages();
+  }
 
   VLOG(jit) << "Created JitMemoryRegion"
             << ": data_pages=" << reinterpret_cast<void*>(data_pages_.Begin())
@@ -312,6 +366,40 @@ void JitMemoryRegion::SetFootprintLimit(size_t new_footprint) {
   }
 }
 
+void JitMemoryRegion::AdviseHugePages() {
+  // With the dual view, the pages of the memory file are first touched through the writable
+  // views, so all views are advised.
+  for (const MemMap* map : {&data_pages_, &writable_data_pages_, &exec_pages_, &non_exec_pages_}) {
+    if (map->IsValid() && madvise(map->Begin(), map->Size(), MADV_HUGEPAGE) != 0) {
+      PLOG(WARNING) << "Failed to use huge pages for " << map->GetName();
+    }
+  }
+}
+
+size_t JitMemoryRegion::TrimCode() {
+  size_t old_end = exec_end_;
+  {
+    // Trimming writes the mspace bookkeeping that lives in the code pages.
+    ScopedCodeCacheWrite scc(*this);
+    mspace_trim(exec_mspace_, 0);
+  }
+  DCHECK_LE(exec_end_, old_end);
+  size_t begin = RoundUp(exec_end_, kPageSize);
+  if (begin >= old_end) {
+    return 0u;
+  }
+  size_t length = RoundUp(old_end, kPageSize) - begin;
+  uint8_t* start = GetUpdatableCodeMapping()->Begin() + begin;
+  // With dual mappings, the code lives in a shared memory file whose pages are only released by
+  // removing them from the file.
+  int advice = HasDualCodeMapping() ? MADV_REMOVE : MADV_DONTNEED;
+  if (madvise(start, length, advice) != 0) {
+    PLOG(WARNING) << "Failed to release JIT code pages";
+    return 0u;
+  }
+  return length;
+}
+
 bool JitMemoryRegion::IncreaseCodeCacheCapacity() {
   if (current_capacity_ == max_capacity_) {
     return false;
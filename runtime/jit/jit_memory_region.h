@@ -65,10 +65,14 @@ class JitMemoryRegion {
         data_mspace_(nullptr),
         exec_mspace_(nullptr) {}
 
+  // With `use_huge_pages`, the mappings are aligned for and advised to use transparent huge pages.
+  // For the dual view, this requires the kernel to enable them for shared memory, see
+  // /sys/kernel/mm/transparent_hugepage/shmem_enabled.
   bool Initialize(size_t initial_capacity,
                   size_t max_capacity,
                   bool rwx_memory_allowed,
                   bool is_zygote,
+                  bool use_huge_pages,
                   std::string* error_msg)
       REQUIRES(Locks::jit_lock_);
 
@@ -79,6 +83,10 @@ class JitMemoryRegion {
   // Set the footprint limit of the code cache.
   void SetFootprintLimit(size_t new_footprint) REQUIRES(Locks::jit_lock_);
 
+  // Give the free memory at the end of the code space back to the kernel. Returns the number of
+  // bytes released.
+  size_t TrimCode() REQUIRES(Locks::jit_lock_);
+
   const uint8_t* AllocateCode(size_t code_size) REQUIRES(Locks::jit_lock_);
   void FreeCode(const uint8_t* code) REQUIRES(Locks::jit_lock_);
   const uint8_t* AllocateData(size_t data_size) REQUIRES(Locks::jit_lock_);
@@ -234,6 +242,9 @@ class JitMemoryRegion {
     return TranslateAddress(src_ptr, exec_pages_, non_exec_pages_);
   }
 
+  // Advise the kernel to back the mappings with transparent huge pages.
+  void AdviseHugePages();
+
   static int CreateZygoteMemory(size_t capacity, std::string* error_msg);
   static bool ProtectZygoteMemory(int fd, std::string* error_msg);
 
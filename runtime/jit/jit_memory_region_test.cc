@@ -577,5 +577,26 @@ TEST_F(TestZygoteMemory, TestVmMayWriteAfter) {
 
 #endif  // defined (__BIONIC__)
 
+class JitMemoryRegionTest : public CommonRuntimeTest {};
+
+TEST_F(JitMemoryRegionTest, HugePagesCapacity) {
+  Thread* self = Thread::Current();
+  MutexLock mu(self, *Locks::jit_lock_);
+  JitMemoryRegion region;
+  std::string error_msg;
+  // The max capacity is rounded down to a huge page for the code and one for the data, below the
+  // initial capacity.
+  ASSERT_TRUE(region.Initialize(/* initial_capacity= */ 3 * kPMDSize,
+                                /* max_capacity= */ 3 * kPMDSize,
+                                /* rwx_memory_allowed= */ true,
+                                /* is_zygote= */ false,
+                                /* use_huge_pages= */ true,
+                                &error_msg)) << error_msg;
+  EXPECT_EQ(region.GetMaxCapacity(), 2 * kPMDSize);
+  EXPECT_EQ(region.GetCurrentCapacity(), region.GetMaxCapacity());
+  // The whole region can be used.
+  EXPECT_FALSE(region.IncreaseCodeCacheCapacity());
+}
+
 }  // namespace jit
 }  // namespace art
@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jit_thread_pool.h"
+
+#include <algorithm>
+#include <ostream>
+#include <vector>
+
+#include "thread-current-inl.h"
+
+namespace art {
+namespace jit {
+
+static uint32_t GetKindRank(CompilationKind kind) {
+  switch (kind) {
+    case CompilationKind::kOsr:
+      return 2u;
+    case CompilationKind::kOptimized:
+      return 1u;
+    case CompilationKind::kBaseline:
+      return 0u;
+  }
+}
+
+bool JitThreadPool::ComparePriority::operator()(const CompileRequest* lhs,
+                                                const CompileRequest* rhs) const {
+  uint32_t lhs_rank = GetKindRank(lhs->kind);
+  uint32_t rhs_rank = GetKindRank(rhs->kind);
+  if (lhs_rank != rhs_rank) {
+    return lhs_rank > rhs_rank;
+  }
+  if (lhs->hotness != rhs->hotness) {
+    return lhs->hotness > rhs->hotness;
+  }
+  return lhs->sequence < rhs->sequence;
+}
+
+JitThreadPool* JitThreadPool::Create(const char* name, size_t num_threads, bool create_peers) {
+  JitThreadPool* pool = new JitThreadPool(name, num_threads, create_peers);
+  pool->CreateThreads();
+  return pool;
+}
+
+JitThreadPool::JitThreadPool(const char* name, size_t num_threads, bool create_peers)
+    : ThreadPool(name,
+                 num_threads,
+                 create_peers,
+                 ThreadPoolWorker::kDefaultStackSize,
+                 /*create_threads=*/ false),
+      next_sequence_(0u),
+      max_queued_compilations_(0u),
+      coalesced_count_(0u),
+      dropped_count_(0u) {}
+
+JitThreadPool::~JitThreadPool() {
+  // The base class destructor can't see the compilations, so stop the workers and finalize the
+  // queued compilations here.
+  DeleteThreads();
+  RemoveAllTasks(Thread::Current());
+}
+
+void JitThreadPool::RemoveAllTasks(Thread* self) {
+  std::vector<Task*> tasks;
+  {
+    MutexLock mu(self, task_queue_lock_);
+    tasks.reserve(compile_queue_.size());
+    while (!compile_queue_.empty()) {
+      tasks.push_back(RemoveLocked(*compile_queue_.begin()));
+    }
+  }
+  for (Task* task : tasks) {
+    task->Finalize();
+  }
+  ThreadPool::RemoveAllTasks(self);
+}
+
+size_t JitThreadPool::AddCompileTask(Thread* self,
+                                     ArtMethod* method,
+                                     CompilationKind kind,
+                                     Task* task) {
+  Task* dropped_task = nullptr;
+  size_t queued;
+  {
+    MutexLock mu(self, task_queue_lock_);
+    auto key = std::make_pair(method, kind);
+    DCHECK(queued_compilations_.find(key) == queued_compilations_.end())
+        << "Compilation queued twice";
+    CompileRequest* request = new CompileRequest{method, kind, 1u, next_sequence_++, task};
+    compile_queue_.insert(request);
+    queued_compilations_.emplace(key, request);
+    if (kind == CompilationKind::kOptimized) {
+      // The baseline code would only be used to collect a profile for the optimized code.
+      auto it = queued_compilations_.find(std::make_pair(method, CompilationKind::kBaseline));
+      if (it != queued_compilations_.end()) {
+        dropped_task = RemoveLocked(it->second);
+        ++dropped_count_;
+      }
+    }
+    queued = compile_queue_.size();
+    max_queued_compilations_ = std::max(max_queued_compilations_, queued);
+    SignalWorkerLocked(self);
+  }
+  if (dropped_task != nullptr) {
+    // Finalizing a compilation task ends the compilation, which takes the JIT lock, so it can't be
+    // done with the task queue lock held.
+    dropped_task->Finalize();
+  }
+  return queued;
+}
+
+bool JitThreadPool::CoalesceCompileTask(Thread* self, ArtMethod* method, CompilationKind kind) {
+  MutexLock mu(self, task_queue_lock_);
+  auto it = queued_compilations_.find(std::make_pair(method, kind));
+  if (it == queued_compilations_.end()) {
+    return false;
+  }
+  // The priority is part of the set's ordering, so take the request out while updating it.
+  CompileRequest* request = it->second;
+  compile_queue_.erase(request);
+  ++request->hotness;
+  compile_queue_.insert(request);
+  ++coalesced_count_;
+  return true;
+}
+
+Task* JitThreadPool::RemoveLocked(CompileRequest* request) {
+  Task* task = request->task;
+  compile_queue_.erase(request);
+  queued_compilations_.erase(std::make_pair(request->method, request->kind));
+  delete request;
+  return task;
+}
+
+Task* JitThreadPool::TryGetTaskLocked() {
+  if (!started_) {
+    return nullptr;
+  }
+  if (!tasks_.empty()) {
+    Task* task = tasks_.front();
+    tasks_.pop_front();
+    return task;
+  }
+  if (!compile_queue_.empty()) {
+    return RemoveLocked(*compile_queue_.begin());
+  }
+  return nullptr;
+}
+
+bool JitThreadPool::HasOutstandingTasks() const {
+  return started_ && (!tasks_.empty() || !compile_queue_.empty());
+}
+
+size_t JitThreadPool::GetTaskCount(Thread* self) {
+  MutexLock mu(self, task_queue_lock_);
+  return tasks_.size() + compile_queue_.size();
+}
+
+void JitThreadPool::Dump(std::ostream& os) {
+  MutexLock mu(Thread::Current(), task_queue_lock_);
+  os << "JIT thread pool: " << GetThreadCount() << " workers, "
+     << compile_queue_.size() << " compilations queued (max " << max_queued_compilations_
+     << "), " << coalesced_count_ << " requests coalesced, "
+     << dropped_count_ << " baseline compilations dropped\n";
+}
+
+}  // namespace jit
+}  // namespace art
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_JIT_JIT_THREAD_POOL_H_
+#define ART_RUNTIME_JIT_JIT_THREAD_POOL_H_
+
+#include <iosfwd>
+#include <map>
+#include <set>
+#include <utility>
+
+#include "base/macros.h"
+#include "base/mutex.h"
+#include "compilation_kind.h"
+#include "thread_pool.h"
+
+namespace art {
+
+class ArtMethod;
+
+namespace jit {
+
+// The thread pool running the JIT tasks. On top of the first-in first-out queue of ThreadPool,
+// which holds the zygote and profile tasks, it keeps the method compilations in a priority queue:
+// OSR compilations come first, then optimized ones, then baseline ones, and for a given kind the
+// hottest methods come first. The hotness of a queued compilation is the number of times it was
+// requested: a request for a compilation which is already queued is coalesced into it and makes
+// it hotter. Queuing an optimized compilation of a method drops its queued baseline compilation,
+// if any.
+//
+// The generic tasks are run before the compilations.
+class JitThreadPool final : public ThreadPool {
+ public:
+  static JitThreadPool* Create(const char* name, size_t num_threads, bool create_peers);
+
+  ~JitThreadPool();
+
+  // Queue `task`, which compiles `method` as `kind`. The pool owns the task until it runs it or
+  // drops it, in both cases calling Task::Finalize(). Returns the number of compilations queued,
+  // including this one.
+  size_t AddCompileTask(Thread* self, ArtMethod* method, CompilationKind kind, Task* task)
+      REQUIRES(!task_queue_lock_);
+
+  // Make the queued compilation of `method` as `kind` hotter. Returns false if there is no such
+  // compilation queued, e.g. because it is already running.
+  bool CoalesceCompileTask(Thread* self, ArtMethod* method, CompilationKind kind)
+      REQUIRES(!task_queue_lock_);
+
+  // Unlike the generic tasks, the queued compilations are removed even if the workers are stopped.
+  void RemoveAllTasks(Thread* self) override REQUIRES(!task_queue_lock_);
+
+  size_t GetTaskCount(Thread* self) override REQUIRES(!task_queue_lock_);
+
+  void Dump(std::ostream& os) REQUIRES(!task_queue_lock_);
+
+ protected:
+  Task* TryGetTaskLocked() override REQUIRES(task_queue_lock_);
+  bool HasOutstandingTasks() const override REQUIRES(task_queue_lock_);
+
+ private:
+  struct CompileRequest {
+    ArtMethod* method;
+    CompilationKind kind;
+    // Number of times this compilation was requested.
+    uint32_t hotness;
+    // Order in which the compilations were first requested, for ties.
+    uint64_t sequence;
+    Task* task;
+  };
+
+  struct ComparePriority {
+    bool operator()(const CompileRequest* lhs, const CompileRequest* rhs) const;
+  };
+
+  JitThreadPool(const char* name, size_t num_threads, bool create_peers);
+
+  // Take `request` out of the queue and return its task. Deletes the request.
+  Task* RemoveLocked(CompileRequest* request) REQUIRES(task_queue_lock_);
+
+  std::set<CompileRequest*, ComparePriority> compile_queue_ GUARDED_BY(task_queue_lock_);
+  std::map<std::pair<ArtMethod*, CompilationKind>, CompileRequest*> queued_compilations_
+      GUARDED_BY(task_queue_lock_);
+  uint64_t next_sequence_ GUARDED_BY(task_queue_lock_);
+
+  // Statistics.
+  size_t max_queued_compilations_ GUARDED_BY(task_queue_lock_);
+  uint64_t coalesced_count_ GUARDED_BY(task_queue_lock_);
+  uint64_t dropped_count_ GUARDED_BY(task_queue_lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(JitThreadPool);
+};
+
+}  // namespace jit
+}  // namespace art
+
+#endif  // ART_RUNTIME_JIT_JIT_THREAD_POOL_H_
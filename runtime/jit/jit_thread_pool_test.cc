@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jit_thread_pool.h"
+
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include "common_runtime_test.h"
+#include "thread-inl.h"
+
+namespace art {
+namespace jit {
+
+// Records the order in which the tasks ran. The pool runs them on a single worker.
+class RecordingTask : public Task {
+ public:
+  RecordingTask(size_t id, std::vector<size_t>* run_order, size_t* finalized)
+      : id_(id), run_order_(run_order), finalized_(finalized) {}
+
+  void Run([[maybe_unused]] Thread* self) override {
+    run_order_->push_back(id_);
+  }
+
+  void Finalize() override {
+    ++*finalized_;
+    delete this;
+  }
+
+ private:
+  const size_t id_;
+  std::vector<size_t>* const run_order_;
+  size_t* const finalized_;
+};
+
+class JitThreadPoolTest : public CommonRuntimeTest {
+ protected:
+  // The pool never dereferences the methods.
+  static ArtMethod* FakeMethod(uintptr_t id) {
+    return reinterpret_cast<ArtMethod*>(id * kPointerSize);
+  }
+
+  static constexpr size_t kPointerSize = sizeof(void*);
+};
+
+TEST_F(JitThreadPoolTest, Priority) {
+  Thread* self = Thread::Current();
+  // The pool finalizes the tasks left when destroyed, so it is declared last.
+  std::vector<size_t> run_order;
+  size_t finalized = 0u;
+  std::unique_ptr<JitThreadPool> pool(
+      JitThreadPool::Create("Jit thread pool test", /*num_threads=*/ 1, /*create_peers=*/ false));
+  auto new_task = [&](size_t id) { return new RecordingTask(id, &run_order, &finalized); };
+
+  EXPECT_EQ(pool->AddCompileTask(self, FakeMethod(1), CompilationKind::kBaseline, new_task(0)), 1u);
+  EXPECT_EQ(pool->AddCompileTask(self, FakeMethod(2), CompilationKind::kBaseline, new_task(1)), 2u);
+  EXPECT_EQ(pool->AddCompileTask(self, FakeMethod(3), CompilationKind::kOptimized, new_task(2)),
+            3u);
+  EXPECT_EQ(pool->AddCompileTask(self, FakeMethod(4), CompilationKind::kOsr, new_task(3)), 4u);
+  // The second baseline compilation gets hotter than the first one.
+  EXPECT_TRUE(pool->CoalesceCompileTask(self, FakeMethod(2), CompilationKind::kBaseline));
+  EXPECT_FALSE(pool->CoalesceCompileTask(self, FakeMethod(1), CompilationKind::kOptimized));
+  // Queuing the optimized compilation drops the baseline one.
+  EXPECT_EQ(pool->AddCompileTask(self, FakeMethod(1), CompilationKind::kOptimized, new_task(4)),
+            4u);
+  EXPECT_EQ(finalized, 1u);
+  EXPECT_EQ(pool->GetTaskCount(self), 4u);
+
+  pool->StartWorkers(self);
+  pool->Wait(self, /*do_work=*/ false, /*may_hold_locks=*/ false);
+  EXPECT_EQ(run_order, std::vector<size_t>({3u, 2u, 4u, 1u}));
+  EXPECT_EQ(finalized, 5u);
+
+  std::ostringstream oss;
+  pool->Dump(oss);
+  EXPECT_NE(oss.str().find("1 requests coalesced"), std::string::npos) << oss.str();
+  EXPECT_NE(oss.str().find("1 baseline compilations dropped"), std::string::npos) << oss.str();
+}
+
+TEST_F(JitThreadPoolTest, RemoveAllTasks) {
+  Thread* self = Thread::Current();
+  // The pool finalizes the tasks left when destroyed, so it is declared last.
+  std::vector<size_t> run_order;
+  size_t finalized = 0u;
+  std::unique_ptr<JitThreadPool> pool(
+      JitThreadPool::Create("Jit thread pool test", /*num_threads=*/ 2, /*create_peers=*/ false));
+  pool->AddCompileTask(self,
+                       FakeMethod(1),
+                       CompilationKind::kBaseline,
+                       new RecordingTask(0, &run_order, &finalized));
+  pool->AddCompileTask(self,
+                       FakeMethod(2),
+                       CompilationKind::kOptimized,
+                       new RecordingTask(1, &run_order, &finalized));
+  // The workers were never started, but the compilations still get finalized.
+  pool->RemoveAllTasks(self);
+  EXPECT_EQ(finalized, 2u);
+  EXPECT_EQ(pool->GetTaskCount(self), 0u);
+  EXPECT_TRUE(run_order.empty());
+  // The compilations can be queued again.
+  EXPECT_FALSE(pool->CoalesceCompileTask(self, FakeMethod(1), CompilationKind::kBaseline));
+  EXPECT_EQ(pool->AddCompileTask(self,
+                                 FakeMethod(1),
+                                 CompilationKind::kBaseline,
+                                 new RecordingTask(2, &run_order, &finalized)),
+            1u);
+}
+
+}  // namespace jit
+}  // namespace art
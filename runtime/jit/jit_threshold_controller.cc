@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jit_threshold_controller.h"
+
+#include <sched.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "thread-current-inl.h"
+
+namespace art {
+namespace jit {
+
+JitThresholdController::JitThresholdController(size_t thread_count)
+    : thread_count_(thread_count),
+      level_(kInitialLevel),
+      lock_("JIT threshold controller lock"),
+      average_compile_time_ns_(0u),
+      last_update_ns_(0u) {}
+
+bool JitThresholdController::ShouldCompile(const void* method) {
+  uint32_t level = level_.load(std::memory_order_relaxed);
+  MutexLock mu(Thread::Current(), lock_);
+  auto it = pending_expirations_.find(method);
+  uint32_t expirations = (it == pending_expirations_.end()) ? 1u : it->second + 1u;
+  if (expirations >= (1u << level)) {
+    if (it != pending_expirations_.end()) {
+      pending_expirations_.erase(it);
+    }
+    return true;
+  }
+  if (it != pending_expirations_.end()) {
+    it->second = expirations;
+  } else {
+    if (pending_expirations_.size() == kMaxPendingMethods) {
+      pending_expirations_.clear();
+    }
+    pending_expirations_.emplace(method, expirations);
+  }
+  return false;
+}
+
+void JitThresholdController::RecordCompilation(uint64_t duration_ns) {
+  MutexLock mu(Thread::Current(), lock_);
+  average_compile_time_ns_ = (average_compile_time_ns_ == 0u)
+      ? duration_ns
+      : (average_compile_time_ns_ * 7u + duration_ns) / 8u;
+}
+
+bool JitThresholdController::Update(size_t queue_length, size_t available_cpus, uint64_t now_ns) {
+  MutexLock mu(Thread::Current(), lock_);
+  if (last_update_ns_ != 0u && now_ns - last_update_ns_ < kUpdateIntervalNs) {
+    return false;
+  }
+  last_update_ns_ = now_ns;
+  size_t workers = std::max<size_t>(std::min(thread_count_, available_cpus), 1u);
+  uint64_t backlog_ns = queue_length * average_compile_time_ns_ / workers;
+  // Only go below the requested thresholds if the JIT threads don't take cores from the app.
+  uint32_t min_level = (available_cpus > thread_count_) ? 0u : kInitialLevel;
+  uint32_t level = level_.load(std::memory_order_relaxed);
+  if (backlog_ns > 2u * kTargetBacklogNs) {
+    level = std::min(level + 1u, kMaxLevel);
+  } else if (backlog_ns < kTargetBacklogNs / 2u && level != 0u) {
+    --level;
+  }
+  level_.store(std::max(level, min_level), std::memory_order_relaxed);
+  return true;
+}
+
+size_t JitThresholdController::GetAvailableCpus() {
+#if defined(__linux__)
+  cpu_set_t cpu_set;
+  if (sched_getaffinity(/* pid= */ 0, sizeof(cpu_set), &cpu_set) == 0) {
+    return CPU_COUNT(&cpu_set);
+  }
+#endif
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  return (cpus > 0) ? static_cast<size_t>(cpus) : 1u;
+}
+
+}  // namespace jit
+}  // namespace art
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_JIT_JIT_THRESHOLD_CONTROLLER_H_
+#define ART_RUNTIME_JIT_JIT_THRESHOLD_CONTROLLER_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <unordered_map>
+
+#include "base/locks.h"
+#include "base/macros.h"
+#include "base/mutex.h"
+#include "base/time_utils.h"
+
+namespace art {
+namespace jit {
+
+// Scales the JIT hotness thresholds with -Xjitadaptivethresholds: up when the compilations queue
+// faster than the JIT threads can compile them, down when the JIT threads are idle and have cores
+// to run on.
+//
+// The hotness counters keep counting from fixed thresholds, as a counter which still has its
+// initial value tells that the method was never run. With adaptive thresholds, these fixed
+// thresholds are half the requested ones, the lowest the controller can go, and a method only gets
+// compiled once its own hotness counters expired 2^level times. The requested thresholds are at
+// kInitialLevel.
+class JitThresholdController {
+ public:
+  static constexpr uint32_t kMaxLevel = 4u;
+  static constexpr uint32_t kInitialLevel = 1u;
+  // How much the counter thresholds are lowered from the requested thresholds.
+  static constexpr uint32_t kThresholdShift = kInitialLevel;
+  static constexpr uint64_t kUpdateIntervalNs = MsToNs(50);
+  // The time the queued compilations should take on the JIT threads. Beyond twice that, the
+  // thresholds go up. Below half of it, they go down.
+  static constexpr uint64_t kTargetBacklogNs = MsToNs(20);
+  // How many methods can have expirations not yet followed by a compilation. Beyond that, the
+  // expirations are forgotten, which only delays the compilation of these methods.
+  static constexpr size_t kMaxPendingMethods = 4096u;
+
+  explicit JitThresholdController(size_t thread_count);
+
+  // The counter threshold for a requested threshold.
+  static uint32_t GetCounterThreshold(uint32_t threshold) {
+    return (threshold + (1u << kThresholdShift) - 1u) >> kThresholdShift;
+  }
+
+  // Record the time a compilation took.
+  void RecordCompilation(uint64_t duration_ns) REQUIRES(!lock_);
+
+  // Adjust the level from the number of queued compilations and the number of cores the process
+  // can run on. Does nothing and returns false if the last update is less than kUpdateIntervalNs
+  // old.
+  bool Update(size_t queue_length, size_t available_cpus, uint64_t now_ns) REQUIRES(!lock_);
+
+  // Whether the expiration of a hotness counter of `method` should lead to a compilation.
+  bool ShouldCompile(const void* method) REQUIRES(!lock_);
+
+  uint32_t GetLevel() const {
+    return level_.load(std::memory_order_relaxed);
+  }
+
+  // The threshold effectively in use for a counter threshold.
+  uint32_t GetEffectiveThreshold(uint32_t counter_threshold) const {
+    return counter_threshold << GetLevel();
+  }
+
+  // The number of cores in the affinity mask of the process.
+  static size_t GetAvailableCpus();
+
+ private:
+  const size_t thread_count_;
+  std::atomic<uint32_t> level_;
+
+  Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  // The number of hotness counter expirations of the methods which still need more of them.
+  std::unordered_map<const void*, uint32_t> pending_expirations_ GUARDED_BY(lock_);
+  // Moving average of the compilation times.
+  uint64_t average_compile_time_ns_ GUARDED_BY(lock_);
+  uint64_t last_update_ns_ GUARDED_BY(lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(JitThresholdController);
+};
+
+}  // namespace jit
+}  // namespace art
+
+#endif  // ART_RUNTIME_JIT_JIT_THRESHOLD_CONTROLLER_H_
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jit_threshold_controller.h"
+
+#include "common_runtime_test.h"
+
+namespace art {
+namespace jit {
+
+class JitThresholdControllerTest : public CommonRuntimeTest {};
+
+TEST_F(JitThresholdControllerTest, CounterThreshold) {
+  EXPECT_EQ(JitThresholdController::GetCounterThreshold(0u), 0u);
+  EXPECT_EQ(JitThresholdController::GetCounterThreshold(1u), 1u);
+  EXPECT_EQ(JitThresholdController::GetCounterThreshold(0xffffu), 0x8000u);
+  JitThresholdController controller(/* thread_count= */ 1u);
+  // The requested threshold is used until the first update.
+  EXPECT_EQ(controller.GetEffectiveThreshold(JitThresholdController::GetCounterThreshold(1000u)),
+            1000u);
+}
+
+TEST_F(JitThresholdControllerTest, ShouldCompile) {
+  JitThresholdController controller(/* thread_count= */ 1u);
+  ASSERT_EQ(controller.GetLevel(), JitThresholdController::kInitialLevel);
+  constexpr uint32_t kExpirations = 1u << JitThresholdController::kInitialLevel;
+  static_assert(kExpirations == 2u);
+  int method1 = 0;
+  int method2 = 0;
+  // Methods which expire alternately each get compiled after their own expirations.
+  EXPECT_FALSE(controller.ShouldCompile(&method1));
+  EXPECT_FALSE(controller.ShouldCompile(&method2));
+  EXPECT_TRUE(controller.ShouldCompile(&method1));
+  EXPECT_TRUE(controller.ShouldCompile(&method2));
+  // A compilation starts the count over.
+  EXPECT_FALSE(controller.ShouldCompile(&method1));
+  EXPECT_TRUE(controller.ShouldCompile(&method1));
+}
+
+TEST_F(JitThresholdControllerTest, ShouldCompileAtLevelZero) {
+  JitThresholdController controller(/* thread_count= */ 1u);
+  // An empty queue with spare cores goes to the lowest thresholds.
+  ASSERT_TRUE(controller.Update(/* queue_length= */ 0u,
+                                /* available_cpus= */ 8u,
+                                JitThresholdController::kUpdateIntervalNs));
+  ASSERT_EQ(controller.GetLevel(), 0u);
+  int method = 0;
+  EXPECT_TRUE(controller.ShouldCompile(&method));
+  EXPECT_TRUE(controller.ShouldCompile(&method));
+}
+
+TEST_F(JitThresholdControllerTest, Update) {
+  constexpr uint64_t kInterval = JitThresholdController::kUpdateIntervalNs;
+  JitThresholdController controller(/* thread_count= */ 2u);
+  controller.RecordCompilation(MsToNs(10));
+  uint64_t now = kInterval;
+  // 10 compilations of 10ms on 2 threads are above the target backlog.
+  EXPECT_TRUE(controller.Update(/* queue_length= */ 10u, /* available_cpus= */ 8u, now));
+  EXPECT_EQ(controller.GetLevel(), JitThresholdController::kInitialLevel + 1u);
+  // Too early for another update.
+  EXPECT_FALSE(controller.Update(/* queue_length= */ 10u, /* available_cpus= */ 8u, now + 1u));
+  EXPECT_EQ(controller.GetLevel(), JitThresholdController::kInitialLevel + 1u);
+  for (size_t i = 0; i != JitThresholdController::kMaxLevel + 1u; ++i) {
+    now += kInterval;
+    EXPECT_TRUE(controller.Update(/* queue_length= */ 10u, /* available_cpus= */ 8u, now));
+  }
+  EXPECT_EQ(controller.GetLevel(), JitThresholdController::kMaxLevel);
+  // Empty queue with spare cores: the thresholds go below the requested ones.
+  for (size_t i = 0; i != JitThresholdController::kMaxLevel + 1u; ++i) {
+    now += kInterval;
+    EXPECT_TRUE(controller.Update(/* queue_length= */ 0u, /* available_cpus= */ 8u, now));
+  }
+  EXPECT_EQ(controller.GetLevel(), 0u);
+  // Without spare cores, they go back to the requested ones.
+  now += kInterval;
+  EXPECT_TRUE(controller.Update(/* queue_length= */ 0u, /* available_cpus= */ 2u, now));
+  EXPECT_EQ(controller.GetLevel(), JitThresholdController::kInitialLevel);
+}
+
+TEST_F(JitThresholdControllerTest, AvailableCpus) {
+  EXPECT_GE(JitThresholdController::GetAvailableCpus(), 1u);
+}
+
+}  // namespace jit
+}  // namespace art
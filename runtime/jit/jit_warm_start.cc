@@ -0,0 +1,204 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jit_warm_start.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <string_view>
+
+#include "android-base/file.h"
+#include "android-base/parseint.h"
+#include "android-base/stringprintf.h"
+#include "android-base/strings.h"
+#include "thread-current-inl.h"
+
+namespace art {
+namespace jit {
+
+using android::base::StringPrintf;
+
+// The file is made of lines:
+//   art-jit-warm-start <version>
+//   boot <boot class path checksums>
+// followed, for each dex file, by:
+//   dex <checksum> <location>
+//   <method index> <method index> ...
+static constexpr const char* kMagic = "art-jit-warm-start";
+static constexpr uint32_t kVersion = 1u;
+static constexpr const char* kBootPrefix = "boot ";
+static constexpr const char* kDexPrefix = "dex ";
+
+JitWarmStart::JitWarmStart(const std::string& filename,
+                           const std::string& boot_class_path_checksums)
+    : filename_(filename),
+      boot_class_path_checksums_(boot_class_path_checksums),
+      saving_(false),
+      lock_("JIT warm start lock"),
+      unsaved_compilations_(0u) {}
+
+bool JitWarmStart::Load(std::string* error_msg) {
+  std::string content;
+  if (!android::base::ReadFileToString(filename_, &content)) {
+    *error_msg = StringPrintf("Could not read %s", filename_.c_str());
+    return false;
+  }
+  std::vector<std::string> lines = android::base::Split(content, "\n");
+  if (lines.size() < 2u || lines[0] != StringPrintf("%s %u", kMagic, kVersion)) {
+    *error_msg = StringPrintf("Unsupported JIT warm start file %s", filename_.c_str());
+    return false;
+  }
+  if (lines[1] != kBootPrefix + boot_class_path_checksums_) {
+    *error_msg = StringPrintf("Boot class path of %s does not match", filename_.c_str());
+    return false;
+  }
+  // The file ends with a newline, hence an empty last line.
+  if (lines.size() % 2u != 1u || !lines.back().empty()) {
+    *error_msg = StringPrintf("Corrupt JIT warm start file %s", filename_.c_str());
+    return false;
+  }
+  std::map<std::pair<std::string, uint32_t>, std::set<uint32_t>> methods;
+  for (size_t i = 2u; i + 1u < lines.size(); i += 2u) {
+    std::string_view dex(lines[i]);
+    size_t space = dex.find(' ', strlen(kDexPrefix));
+    uint32_t checksum;
+    if (!android::base::StartsWith(dex, kDexPrefix) ||
+        space == std::string_view::npos ||
+        !android::base::ParseUint(
+            std::string(dex.substr(strlen(kDexPrefix), space - strlen(kDexPrefix))), &checksum)) {
+      *error_msg = StringPrintf("Corrupt JIT warm start file %s", filename_.c_str());
+      return false;
+    }
+    std::set<uint32_t>& method_indexes =
+        methods[std::make_pair(std::string(dex.substr(space + 1u)), checksum)];
+    for (const std::string& index : android::base::Split(lines[i + 1u], " ")) {
+      uint32_t method_idx;
+      if (!android::base::ParseUint(index, &method_idx)) {
+        *error_msg = StringPrintf("Corrupt JIT warm start file %s", filename_.c_str());
+        return false;
+      }
+      method_indexes.insert(method_idx);
+    }
+  }
+  MutexLock mu(Thread::Current(), lock_);
+  methods_.swap(methods);
+  unsaved_compilations_ = 0u;
+  return true;
+}
+
+bool JitWarmStart::Save(std::string* error_msg) {
+  if (saving_.exchange(true, std::memory_order_acquire)) {
+    // Another JIT worker is saving. The compilations recorded since it took its snapshot still
+    // count as unsaved, so the next save picks them up.
+    return true;
+  }
+  std::string content = StringPrintf("%s %u\n%s%s\n",
+                                     kMagic,
+                                     kVersion,
+                                     kBootPrefix,
+                                     boot_class_path_checksums_.c_str());
+  {
+    // Only snapshot the methods under the lock, mutators take it to check for warm methods.
+    MutexLock mu(Thread::Current(), lock_);
+    for (const auto& [dex, method_indexes] : methods_) {
+      content += StringPrintf("%s%u %s\n", kDexPrefix, dex.second, dex.first.c_str());
+      content += android::base::Join(method_indexes, ' ');
+      content += '\n';
+    }
+    unsaved_compilations_ = 0u;
+  }
+  bool success = WriteFile(content, error_msg);
+  saving_.store(false, std::memory_order_release);
+  return success;
+}
+
+bool JitWarmStart::WriteFile(const std::string& content, std::string* error_msg) {
+  // Write to a temporary file of our own in the same directory and rename it, so that an
+  // interrupted save never leaves a truncated file behind, and other processes saving the same
+  // file can't write to it at the same time.
+  std::string temp_filename = filename_ + ".XXXXXX";
+  int fd = mkstemp(temp_filename.data());
+  if (fd == -1) {
+    *error_msg = StringPrintf("Could not create %s: %s", temp_filename.c_str(), strerror(errno));
+    return false;
+  }
+  bool written = android::base::WriteStringToFd(content, fd);
+  if (close(fd) != 0 || !written) {
+    *error_msg = StringPrintf("Could not write %s", temp_filename.c_str());
+    unlink(temp_filename.c_str());
+    return false;
+  }
+  if (rename(temp_filename.c_str(), filename_.c_str()) != 0) {
+    *error_msg = StringPrintf("Could not rename %s to %s: %s",
+                              temp_filename.c_str(),
+                              filename_.c_str(),
+                              strerror(errno));
+    unlink(temp_filename.c_str());
+    return false;
+  }
+  return true;
+}
+
+void JitWarmStart::RecordCompilation(const std::string& dex_location,
+                                     uint32_t dex_checksum,
+                                     uint32_t method_idx) {
+  MutexLock mu(Thread::Current(), lock_);
+  auto key = std::make_pair(dex_location, dex_checksum);
+  auto it = methods_.find(key);
+  if (it == methods_.end()) {
+    // The methods of an older version of the dex file are of no use anymore.
+    for (auto other = methods_.lower_bound(std::make_pair(dex_location, 0u));
+         other != methods_.end() && other->first.first == dex_location;) {
+      other = methods_.erase(other);
+    }
+    it = methods_.emplace(key, std::set<uint32_t>()).first;
+  }
+  if (it->second.insert(method_idx).second) {
+    ++unsaved_compilations_;
+  }
+}
+
+bool JitWarmStart::NeedsSave() {
+  MutexLock mu(Thread::Current(), lock_);
+  return unsaved_compilations_ >= kSaveInterval;
+}
+
+std::vector<uint32_t> JitWarmStart::GetMethods(const std::string& dex_location,
+                                               uint32_t dex_checksum) {
+  MutexLock mu(Thread::Current(), lock_);
+  auto it = methods_.find(std::make_pair(dex_location, dex_checksum));
+  if (it == methods_.end()) {
+    return {};
+  }
+  return std::vector<uint32_t>(it->second.begin(), it->second.end());
+}
+
+void JitWarmStart::AddWarmMethod(ArtMethod* method) {
+  MutexLock mu(Thread::Current(), lock_);
+  warm_methods_.insert(method);
+}
+
+bool JitWarmStart::TakeWarmMethod(ArtMethod* method) {
+  MutexLock mu(Thread::Current(), lock_);
+  return warm_methods_.erase(method) != 0u;
+}
+
+}  // namespace jit
+}  // namespace art
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_JIT_JIT_WARM_START_H_
+#define ART_RUNTIME_JIT_JIT_WARM_START_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "base/atomic.h"
+#include "base/locks.h"
+#include "base/macros.h"
+#include "base/mutex.h"
+
+namespace art {
+
+class ArtMethod;
+
+namespace jit {
+
+// The methods compiled with optimizing in previous runs, persisted with -Xjitwarmstartfile so that
+// a restarted process compiles them with optimizing as soon as they are first called, instead of
+// waiting for them to get hot and going through baseline compilation first. When their dex file is
+// loaded, these methods are resolved and marked warm; the first call of a warm method then queues
+// its optimized compilation.
+//
+// The methods are identified by their dex file location and checksum, and the file is only used
+// if it was written with the same boot class path checksums. A method whose dex file changed is
+// simply not found. Any other mismatch or corruption discards the whole file.
+class JitWarmStart {
+ public:
+  // Save after that many new compilations, so that a process which doesn't shut down cleanly
+  // still leaves a useful file.
+  static constexpr size_t kSaveInterval = 32;
+
+  JitWarmStart(const std::string& filename, const std::string& boot_class_path_checksums);
+
+  // Load the methods saved by a previous run. Returns false if the file can't be used.
+  bool Load(std::string* error_msg) REQUIRES(!lock_);
+
+  // Write the loaded and recorded methods to the file. Does nothing if another thread is saving.
+  bool Save(std::string* error_msg) REQUIRES(!lock_);
+
+  // Record that a method was compiled with optimizing. Drops the methods recorded for other
+  // versions of the dex file.
+  void RecordCompilation(const std::string& dex_location,
+                         uint32_t dex_checksum,
+                         uint32_t method_idx) REQUIRES(!lock_);
+
+  // Whether enough compilations were recorded since the last save to save again.
+  bool NeedsSave() REQUIRES(!lock_);
+
+  // The methods of the given dex file compiled with optimizing in previous runs.
+  std::vector<uint32_t> GetMethods(const std::string& dex_location, uint32_t dex_checksum)
+      REQUIRES(!lock_);
+
+  // Mark a method resolved from GetMethods(). The method is taken out by the first
+  // TakeWarmMethod() for it.
+  void AddWarmMethod(ArtMethod* method) REQUIRES(!lock_);
+  bool TakeWarmMethod(ArtMethod* method) REQUIRES(!lock_);
+
+  const std::string& GetFilename() const {
+    return filename_;
+  }
+
+ private:
+  bool WriteFile(const std::string& content, std::string* error_msg) REQUIRES(!lock_);
+
+  const std::string filename_;
+  const std::string boot_class_path_checksums_;
+
+  // Set while a thread saves, which doesn't hold lock_ while writing the file.
+  Atomic<bool> saving_;
+  Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  // Method indexes keyed by dex file location and checksum.
+  std::map<std::pair<std::string, uint32_t>, std::set<uint32_t>> methods_ GUARDED_BY(lock_);
+  size_t unsaved_compilations_ GUARDED_BY(lock_);
+  // Methods from the file which didn't get hot yet in this run.
+  std::unordered_set<ArtMethod*> warm_methods_ GUARDED_BY(lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(JitWarmStart);
+};
+
+}  // namespace jit
+}  // namespace art
+
+#endif  // ART_RUNTIME_JIT_JIT_WARM_START_H_
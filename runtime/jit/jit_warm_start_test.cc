@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jit_warm_start.h"
+
+#include <string>
+#include <vector>
+
+#include "android-base/file.h"
+#include "common_runtime_test.h"
+
+namespace art {
+namespace jit {
+
+class JitWarmStartTest : public CommonRuntimeTest {
+ protected:
+  static constexpr const char* kBootChecksums = "i;1/abcdef01";
+  static constexpr const char* kDexLocation = "/data/app/base.apk";
+};
+
+TEST_F(JitWarmStartTest, SaveAndLoad) {
+  ScratchDir dir;
+  std::string filename = dir.GetPath() + "warm_start";
+  {
+    JitWarmStart warm_start(filename, kBootChecksums);
+    std::string error_msg;
+    // No file yet.
+    EXPECT_FALSE(warm_start.Load(&error_msg));
+    warm_start.RecordCompilation(kDexLocation, 0x1234u, 42u);
+    warm_start.RecordCompilation(kDexLocation, 0x1234u, 7u);
+    warm_start.RecordCompilation(kDexLocation, 0x1234u, 42u);
+    warm_start.RecordCompilation("/data/app/base.apk!classes2.dex", 0x5678u, 3u);
+    ASSERT_TRUE(warm_start.Save(&error_msg)) << error_msg;
+  }
+  JitWarmStart warm_start(filename, kBootChecksums);
+  std::string error_msg;
+  ASSERT_TRUE(warm_start.Load(&error_msg)) << error_msg;
+  EXPECT_EQ(warm_start.GetMethods(kDexLocation, 0x1234u), std::vector<uint32_t>({7u, 42u}));
+  EXPECT_EQ(warm_start.GetMethods("/data/app/base.apk!classes2.dex", 0x5678u),
+            std::vector<uint32_t>({3u}));
+  // A different version of the dex file has no methods.
+  EXPECT_TRUE(warm_start.GetMethods(kDexLocation, 0x4321u).empty());
+}
+
+TEST_F(JitWarmStartTest, Mismatch) {
+  ScratchDir dir;
+  std::string filename = dir.GetPath() + "warm_start";
+  {
+    JitWarmStart warm_start(filename, kBootChecksums);
+    warm_start.RecordCompilation(kDexLocation, 0x1234u, 42u);
+    std::string error_msg;
+    ASSERT_TRUE(warm_start.Save(&error_msg)) << error_msg;
+  }
+  {
+    // The boot class path changed.
+    JitWarmStart warm_start(filename, "i;1/12345678");
+    std::string error_msg;
+    EXPECT_FALSE(warm_start.Load(&error_msg));
+    EXPECT_TRUE(warm_start.GetMethods(kDexLocation, 0x1234u).empty());
+  }
+  std::string content;
+  ASSERT_TRUE(android::base::ReadFileToString(filename, &content));
+  ASSERT_TRUE(android::base::WriteStringToFile(content + "dex 12 /data/app/other.apk\nx\n",
+                                               filename));
+  JitWarmStart warm_start(filename, kBootChecksums);
+  std::string error_msg;
+  EXPECT_FALSE(warm_start.Load(&error_msg));
+  EXPECT_TRUE(warm_start.GetMethods(kDexLocation, 0x1234u).empty());
+}
+
+TEST_F(JitWarmStartTest, NewDexFileVersion) {
+  JitWarmStart warm_start("/nonexistent", kBootChecksums);
+  warm_start.RecordCompilation(kDexLocation, 0x1234u, 42u);
+  warm_start.RecordCompilation(kDexLocation, 0x4321u, 7u);
+  EXPECT_TRUE(warm_start.GetMethods(kDexLocation, 0x1234u).empty());
+  EXPECT_EQ(warm_start.GetMethods(kDexLocation, 0x4321u), std::vector<uint32_t>({7u}));
+}
+
+TEST_F(JitWarmStartTest, NeedsSave) {
+  ScratchDir dir;
+  JitWarmStart warm_start(dir.GetPath() + "warm_start", kBootChecksums);
+  for (uint32_t i = 0; i + 1 < JitWarmStart::kSaveInterval; ++i) {
+    warm_start.RecordCompilation(kDexLocation, 0x1234u, i);
+  }
+  EXPECT_FALSE(warm_start.NeedsSave());
+  // Recompilations don't count.
+  warm_start.RecordCompilation(kDexLocation, 0x1234u, 0u);
+  EXPECT_FALSE(warm_start.NeedsSave());
+  warm_start.RecordCompilation(kDexLocation, 0x1234u, JitWarmStart::kSaveInterval);
+  EXPECT_TRUE(warm_start.NeedsSave());
+  std::string error_msg;
+  ASSERT_TRUE(warm_start.Save(&error_msg)) << error_msg;
+  EXPECT_FALSE(warm_start.NeedsSave());
+}
+
+TEST_F(JitWarmStartTest, WarmMethods) {
+  JitWarmStart warm_start("/nonexistent", kBootChecksums);
+  ArtMethod* method = reinterpret_cast<ArtMethod*>(sizeof(void*));
+  EXPECT_FALSE(warm_start.TakeWarmMethod(method));
+  warm_start.AddWarmMethod(method);
+  EXPECT_TRUE(warm_start.TakeWarmMethod(method));
+  EXPECT_FALSE(warm_start.TakeWarmMethod(method));
+}
+
+}  // namespace jit
+}  // namespace art
@@ -41,6 +41,12 @@ class Class;
 
 // Structure to store the classes seen at runtime for a specific instruction.
 // Once the classes_ array is full, we consider the INVOKE to be megamorphic.
+//
+// Along with each class, we count how many times the instruction was executed with a receiver of
+// that class, so that the compiler can tell a dominant receiver apart. The counts are updated
+// without synchronization by the baseline compiled code and art_quick_update_inline_cache, so they
+// are only an approximation. Once the cache is megamorphic, the last entry holds whichever class
+// was seen last and its count is for all the classes which didn't fit in the other entries.
 class InlineCache {
  public:
   // This is hard coded in the assembly stub art_quick_update_inline_cache.
@@ -50,9 +56,14 @@ class InlineCache {
     return MemberOffset(OFFSETOF_MEMBER(InlineCache, classes_));
   }
 
+  static constexpr MemberOffset CountsOffset() {
+    return MemberOffset(OFFSETOF_MEMBER(InlineCache, counts_));
+  }
+
  private:
   uint32_t dex_pc_;
   GcRoot<mirror::Class> classes_[kIndividualCacheSize];
+  uint32_t counts_[kIndividualCacheSize];
 
   friend class jit::JitCodeCache;
   friend class ProfilingInfo;
@@ -192,6 +192,16 @@ constexpr std::optional<int32_t> EncodeDatumId(DatumId datum_id) {
       return std::make_optional(
           statsd::
               ART_DATUM_DELTA_REPORTED__KIND__ART_DATUM_DELTA_GC_FULL_HEAP_COLLECTION_DURATION_MS);
+    // The survival statistics (-XX:GcSurvivalStats) have no statsd atom yet.
+    case DatumId::kYoungGcSurvivalRate:
+    case DatumId::kFullGcSurvivalRate:
+    case DatumId::kYoungGcPromotedBytes:
+    case DatumId::kYoungGcPromotedBytesDelta:
+    // Neither do the JIT queue depth and the adaptive JIT thresholds.
+    case DatumId::kJitQueueDepth:
+    case DatumId::kJitWarmupThreshold:
+    case DatumId::kJitOptimizeThreshold:
+      return std::nullopt;
   }
 }
 
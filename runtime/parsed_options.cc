@@ -224,12 +224,26 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-XX:LongGCLogThreshold=_")  // in ms
           .WithType<MillisecondsToNanoseconds>()  // store as ns
           .IntoKey(M::LongGCLogThreshold)
+      .Define("-XX:GcPauseTimeGoalMs=_")  // in ms
+          .WithHelp("Target for the longest GC pause. The heap tunes when concurrent GCs start "
+                    "and how often it runs full GCs to meet it.")
+          .WithType<MillisecondsToNanoseconds>()  // store as ns
+          .IntoKey(M::GcPauseTimeGoal)
+      .Define("-XX:GcCpuGoalPercent=_")
+          .WithHelp("Target for the percentage of time spent in GC. The heap grows more when GC "
+                    "runs above it.")
+          .WithType<unsigned int>()
+          .IntoKey(M::GcCpuGoalPercent)
       .Define("-XX:DumpGCPerformanceOnShutdown")
           .IntoKey(M::DumpGCPerformanceOnShutdown)
       .Define("-XX:DumpRegionInfoBeforeGC")
           .IntoKey(M::DumpRegionInfoBeforeGC)
       .Define("-XX:DumpRegionInfoAfterGC")
           .IntoKey(M::DumpRegionInfoAfterGC)
+      .Define("-XX:GcSurvivalStats")
+          .WithHelp("Track how much memory survives each GC by age, how much is promoted and "
+                    "which classes survive. Shown in the SIGQUIT dump and reported as metrics.")
+          .IntoKey(M::GcSurvivalStats)
       .Define("-XX:DumpJITInfoOnShutdown")
           .IntoKey(M::DumpJITInfoOnShutdown)
       .Define("-XX:IgnoreMaxFootprint")
@@ -277,6 +291,22 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-Xjitmaxsize:_")
           .WithType<MemoryKiB>()
           .IntoKey(M::JITCodeCacheMaxCapacity)
+      .Define("-Xjitcompactcode:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::JITCompactCode)
+      .Define("-Xjithugepages:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::JITUseHugePages)
+      .Define("-Xjitadaptivethresholds:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::JITAdaptiveThresholds)
+      .Define("-Xjitforkserver:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::JITForkServer)
       .Define("-Xjitwarmupthreshold:_")
           .WithType<unsigned int>()
           .IntoKey(M::JITWarmupThreshold)
@@ -292,6 +322,15 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-Xjitzygotepthreadpriority:_")
           .WithType<int>()
           .IntoKey(M::JITZygotePoolThreadPthreadPriority)
+      .Define("-Xjitthreads:_")
+          .WithType<unsigned int>()
+          .IntoKey(M::JITPoolThreads)
+      .Define("-Xjitwarmstartfile:_")
+          .WithType<std::string>()
+          .IntoKey(M::JITWarmStartFile)
+      .Define("-Xjitprofilewarmup:_")
+          .WithType<unsigned int>()
+          .IntoKey(M::JITProfileWarmupMethods)
       .Define("-Xjitsaveprofilinginfo")
           .WithType<ProfileSaverOptions>()
           .AppendValues()
@@ -152,6 +152,180 @@ TEST_F(ParsedOptionsTest, ParsedOptionsGenerationalCC) {
   ASSERT_TRUE(xgc.generational_cc);
 }
 
+TEST_F(ParsedOptionsTest, ParsedOptionsGenerationalCMC) {
+  {
+    // Nothing set, should be disabled.
+    RuntimeOptions options;
+    RuntimeArgumentMap map;
+    bool parsed = ParsedOptions::Parse(options, false, &map);
+    ASSERT_TRUE(parsed);
+    XGcOption xgc = map.GetOrDefault(RuntimeArgumentMap::GcOption);
+    EXPECT_FALSE(xgc.generational_cmc);
+  }
+  {
+    RuntimeOptions options;
+    options.push_back(std::make_pair("-Xgc:CMC,generational_cmc", nullptr));
+    RuntimeArgumentMap map;
+    bool parsed = ParsedOptions::Parse(options, false, &map);
+    ASSERT_TRUE(parsed);
+    XGcOption xgc = map.GetOrDefault(RuntimeArgumentMap::GcOption);
+    EXPECT_EQ(gc::kCollectorTypeCMC, xgc.collector_type_);
+    EXPECT_TRUE(xgc.generational_cmc);
+  }
+  {
+    RuntimeOptions options;
+    options.push_back(std::make_pair("-Xgc:generational_cmc,nogenerational_cmc", nullptr));
+    RuntimeArgumentMap map;
+    bool parsed = ParsedOptions::Parse(options, false, &map);
+    ASSERT_TRUE(parsed);
+    XGcOption xgc = map.GetOrDefault(RuntimeArgumentMap::GcOption);
+    EXPECT_FALSE(xgc.generational_cmc);
+  }
+}
+
+TEST_F(ParsedOptionsTest, ParsedOptionsNumaAware) {
+  {
+    // Nothing set, should be disabled.
+    RuntimeOptions options;
+    RuntimeArgumentMap map;
+    bool parsed = ParsedOptions::Parse(options, false, &map);
+    ASSERT_TRUE(parsed);
+    XGcOption xgc = map.GetOrDefault(RuntimeArgumentMap::GcOption);
+    EXPECT_FALSE(xgc.numa_aware_);
+  }
+  {
+    RuntimeOptions options;
+    options.push_back(std::make_pair("-Xgc:numa", nullptr));
+    RuntimeArgumentMap map;
+    bool parsed = ParsedOptions::Parse(options, false, &map);
+    ASSERT_TRUE(parsed);
+    XGcOption xgc = map.GetOrDefault(RuntimeArgumentMap::GcOption);
+    EXPECT_TRUE(xgc.numa_aware_);
+  }
+}
+
+TEST_F(ParsedOptionsTest, ParsedOptionsGcGoals) {
+  {
+    // Nothing set, no goals.
+    RuntimeOptions options;
+    RuntimeArgumentMap map;
+    bool parsed = ParsedOptions::Parse(options, false, &map);
+    ASSERT_TRUE(parsed);
+    EXPECT_EQ(0u, map.GetOrDefault(RuntimeArgumentMap::GcPauseTimeGoal).GetNanoseconds());
+    EXPECT_EQ(0u, map.GetOrDefault(RuntimeArgumentMap::GcCpuGoalPercent));
+  }
+  {
+    RuntimeOptions options;
+    options.push_back(std::make_pair("-XX:GcPauseTimeGoalMs=2", nullptr));
+    options.push_back(std::make_pair("-XX:GcCpuGoalPercent=10", nullptr));
+    RuntimeArgumentMap map;
+    bool parsed = ParsedOptions::Parse(options, false, &map);
+    ASSERT_TRUE(parsed);
+    EXPECT_EQ(MsToNs(2), map.GetOrDefault(RuntimeArgumentMap::GcPauseTimeGoal).GetNanoseconds());
+    EXPECT_EQ(10u, map.GetOrDefault(RuntimeArgumentMap::GcCpuGoalPercent));
+  }
+}
+
+TEST_F(ParsedOptionsTest, ParsedOptionsGcSurvivalStats) {
+  {
+    RuntimeOptions options;
+    RuntimeArgumentMap map;
+    bool parsed = ParsedOptions::Parse(options, false, &map);
+    ASSERT_TRUE(parsed);
+    EXPECT_FALSE(map.Exists(RuntimeArgumentMap::GcSurvivalStats));
+  }
+  {
+    RuntimeOptions options;
+    options.push_back(std::make_pair("-XX:GcSurvivalStats", nullptr));
+    RuntimeArgumentMap map;
+    bool parsed = ParsedOptions::Parse(options, false, &map);
+    ASSERT_TRUE(parsed);
+    EXPECT_TRUE(map.Exists(RuntimeArgumentMap::GcSurvivalStats));
+  }
+}
+
+TEST_F(ParsedOptionsTest, ParsedOptionsJitThreads) {
+  {
+    RuntimeOptions options;
+    RuntimeArgumentMap map;
+    bool parsed = ParsedOptions::Parse(options, false, &map);
+    ASSERT_TRUE(parsed);
+    EXPECT_EQ(jit::kJitPoolDefaultThreadCount,
+              map.GetOrDefault(RuntimeArgumentMap::JITPoolThreads));
+  }
+  {
+    RuntimeOptions options;
+    options.push_back(std::make_pair("-Xjitthreads:4", nullptr));
+    RuntimeArgumentMap map;
+    bool parsed = ParsedOptions::Parse(options, false, &map);
+    ASSERT_TRUE(parsed);
+    EXPECT_EQ(4u, map.GetOrDefault(RuntimeArgumentMap::JITPoolThreads));
+  }
+}
+
+TEST_F(ParsedOptionsTest, ParsedOptionsJitCompactCode) {
+  {
+    RuntimeOptions options;
+    RuntimeArgumentMap map;
+    bool parsed = ParsedOptions::Parse(options, false, &map);
+    ASSERT_TRUE(parsed);
+    EXPECT_FALSE(map.GetOrDefault(RuntimeArgumentMap::JITCompactCode));
+  }
+  {
+    RuntimeOptions options;
+    options.push_back(std::make_pair("-Xjitcompactcode:true", nullptr));
+    RuntimeArgumentMap map;
+    bool parsed = ParsedOptions::Parse(options, false, &map);
+    ASSERT_TRUE(parsed);
+    EXPECT_TRUE(map.GetOrDefault(RuntimeArgumentMap::JITCompactCode));
+  }
+}
+
+TEST_F(ParsedOptionsTest, ParsedOptionsJitHugePages) {
+  RuntimeOptions options;
+  options.push_back(std::make_pair("-Xjithugepages:true", nullptr));
+  RuntimeArgumentMap map;
+  bool parsed = ParsedOptions::Parse(options, false, &map);
+  ASSERT_TRUE(parsed);
+  EXPECT_TRUE(map.GetOrDefault(RuntimeArgumentMap::JITUseHugePages));
+}
+
+TEST_F(ParsedOptionsTest, ParsedOptionsJitAdaptiveThresholds) {
+  RuntimeOptions options;
+  options.push_back(std::make_pair("-Xjitadaptivethresholds:true", nullptr));
+  RuntimeArgumentMap map;
+  bool parsed = ParsedOptions::Parse(options, false, &map);
+  ASSERT_TRUE(parsed);
+  EXPECT_TRUE(map.GetOrDefault(RuntimeArgumentMap::JITAdaptiveThresholds));
+}
+
+TEST_F(ParsedOptionsTest, ParsedOptionsJitForkServer) {
+  RuntimeOptions options;
+  options.push_back(std::make_pair("-Xjitforkserver:true", nullptr));
+  RuntimeArgumentMap map;
+  bool parsed = ParsedOptions::Parse(options, false, &map);
+  ASSERT_TRUE(parsed);
+  EXPECT_TRUE(map.GetOrDefault(RuntimeArgumentMap::JITForkServer));
+}
+
+TEST_F(ParsedOptionsTest, ParsedOptionsJitProfileWarmup) {
+  RuntimeOptions options;
+  options.push_back(std::make_pair("-Xjitprofilewarmup:200", nullptr));
+  RuntimeArgumentMap map;
+  bool parsed = ParsedOptions::Parse(options, false, &map);
+  ASSERT_TRUE(parsed);
+  EXPECT_EQ(200u, map.GetOrDefault(RuntimeArgumentMap::JITProfileWarmupMethods));
+}
+
+TEST_F(ParsedOptionsTest, ParsedOptionsJitWarmStartFile) {
+  RuntimeOptions options;
+  options.push_back(std::make_pair("-Xjitwarmstartfile:/data/misc/warm_start", nullptr));
+  RuntimeArgumentMap map;
+  bool parsed = ParsedOptions::Parse(options, false, &map);
+  ASSERT_TRUE(parsed);
+  EXPECT_EQ("/data/misc/warm_start", map.GetOrDefault(RuntimeArgumentMap::JITWarmStartFile));
+}
+
 TEST_F(ParsedOptionsTest, ParsedOptionsInstructionSet) {
   using Opt = RuntimeArgumentMap;
 
@@ -245,6 +245,7 @@ Runtime::Runtime()
       compiler_callbacks_(nullptr),
       is_zygote_(false),
       is_primary_zygote_(false),
+      is_jit_fork_server_(false),
       is_system_server_(false),
       must_relocate_(false),
       is_concurrent_gc_enabled_(true),
@@ -781,6 +782,31 @@ void Runtime::PostZygoteFork() {
   ResetStats(0xFFFFFFFF);
 }
 
+void Runtime::PreForkServerFork() {
+  CHECK(is_jit_fork_server_) << "runtime instance not started with -Xjitforkserver";
+  if (GetJit() != nullptr) {
+    GetJit()->PreZygoteFork();
+  }
+}
+
+void Runtime::PostForkServerFork(bool is_child) {
+  jit::Jit* jit = GetJit();
+  if (is_child) {
+    // Set the runtime state first, the JIT checks it to know which code cache region to use.
+    is_jit_fork_server_ = false;
+    // Our system thread ID has changed.
+    Thread::Current()->InitAfterFork();
+    if (jit != nullptr) {
+      jit->GetCodeCache()->PostForkChildAction(/* is_system_server= */ false,
+                                               /* is_zygote= */ false);
+      jit->PostForkChildAction(/* is_system_server= */ false, /* is_zygote= */ false);
+    }
+  }
+  if (jit != nullptr) {
+    jit->PostZygoteFork();
+  }
+}
+
 void Runtime::CallExitHook(jint status) {
   if (exit_ != nullptr) {
     ScopedThreadStateChange tsc(Thread::Current(), ThreadState::kNative);
@@ -1615,6 +1641,8 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
 
   // Generational CC collection is currently only compatible with Baker read barriers.
   bool use_generational_cc = kUseBakerReadBarrier && xgc_option.generational_cc;
+  // Generational CMC is only meaningful when the userfaultfd GC is in use.
+  bool use_generational_cmc = gUseUserfaultfd && xgc_option.generational_cmc;
 
   // Cache the apex versions.
   InitializeApexVersions();
@@ -1651,6 +1679,8 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
                        runtime_options.Exists(Opt::LowMemoryMode),
                        runtime_options.GetOrDefault(Opt::LongPauseLogThreshold),
                        runtime_options.GetOrDefault(Opt::LongGCLogThreshold),
+                       runtime_options.GetOrDefault(Opt::GcPauseTimeGoal),
+                       runtime_options.GetOrDefault(Opt::GcCpuGoalPercent),
                        runtime_options.Exists(Opt::IgnoreMaxFootprint),
                        runtime_options.GetOrDefault(Opt::AlwaysLogExplicitGcs),
                        runtime_options.GetOrDefault(Opt::UseTLAB),
@@ -1664,9 +1694,12 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
                        xgc_option.measure_,
                        runtime_options.GetOrDefault(Opt::EnableHSpaceCompactForOOM),
                        use_generational_cc,
+                       use_generational_cmc,
+                       xgc_option.numa_aware_,
                        runtime_options.GetOrDefault(Opt::HSpaceCompactForOOMMinIntervalsMs),
                        runtime_options.Exists(Opt::DumpRegionInfoBeforeGC),
-                       runtime_options.Exists(Opt::DumpRegionInfoAfterGC));
+                       runtime_options.Exists(Opt::DumpRegionInfoAfterGC),
+                       runtime_options.Exists(Opt::GcSurvivalStats));
 
   dump_gc_performance_on_shutdown_ = runtime_options.Exists(Opt::DumpGCPerformanceOnShutdown);
 
@@ -1712,6 +1745,8 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
     jit_options_->SetUseJitCompilation(false);
     jit_options_->SetSaveProfilingInfo(false);
   }
+  // The zygote already shares its JIT code with the processes it forks.
+  is_jit_fork_server_ = jit_options_->IsForkServer() && !is_zygote_;
 
   // Use MemMap arena pool for jit, malloc otherwise. Malloc arenas are faster to allocate but
   // can't be trimmed as easily.
@@ -2787,6 +2822,8 @@ void Runtime::RegisterAppInfo(const std::string& package_name,
     return;
   }
 
+  // The JIT warms up once per process, from the profiles of all the split APKs registered so far.
+  jit_->WarmupFromProfiles(code_paths, profile_output_filename, ref_profile_filename);
   jit_->StartProfileSaver(profile_output_filename, code_paths, ref_profile_filename);
 }
 
@@ -3057,7 +3094,7 @@ void Runtime::CreateJit() {
   bool profiling_only = !jit_options_->UseJitCompilation();
   jit_code_cache_.reset(jit::JitCodeCache::Create(profiling_only,
                                                   /*rwx_memory_allowed=*/ true,
-                                                  IsZygote(),
+                                                  IsSharingJitCode(),
                                                   &error_msg));
   if (jit_code_cache_.get() == nullptr) {
     LOG(WARNING) << "Failed to create JIT Code Cache: " << error_msg;
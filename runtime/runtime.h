@@ -196,6 +196,12 @@ class Runtime {
     return is_primary_zygote_;
   }
 
+  // Whether the JIT compiles code to share with the processes forked from this one, like the
+  // zygote does. This is the case in the zygote and in a fork server started with -Xjitforkserver.
+  bool IsSharingJitCode() const {
+    return is_zygote_ || is_jit_fork_server_;
+  }
+
   bool IsSystemServer() const {
     return is_system_server_;
   }
@@ -594,6 +600,15 @@ class Runtime {
 
   void PreZygoteFork();
   void PostZygoteFork();
+
+  // The fork server equivalent of the zygote fork hooks for the JIT: with -Xjitforkserver, the
+  // children run the code the JIT compiled in the fork server, and compile new code in their own
+  // code cache. Call PreForkServerFork() just before fork(), and PostForkServerFork() right after
+  // it in the fork server and in the child. Like for the zygote, the fork server must not run
+  // other threads when forking.
+  void PreForkServerFork();
+  void PostForkServerFork(bool is_child);
+
   void InitNonZygoteOrPostFork(
       JNIEnv* env,
       bool is_system_server,
@@ -1256,6 +1271,7 @@ class Runtime {
   CompilerCallbacks* compiler_callbacks_;
   bool is_zygote_;
   bool is_primary_zygote_;
+  bool is_jit_fork_server_;
   bool is_system_server_;
   bool must_relocate_;
   bool is_concurrent_gc_enabled_;
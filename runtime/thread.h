@@ -188,8 +188,8 @@ enum class WeakRefAccessState : int32_t {
   kDisabled
 };
 
-// This should match RosAlloc::kNumThreadLocalSizeBrackets.
-static constexpr size_t kNumRosAllocThreadLocalSizeBracketsInThread = 16;
+// This should match RosAlloc::kNumThreadLocalRunSizeBrackets.
+static constexpr size_t kNumRosAllocThreadLocalSizeBracketsInThread = 40;
 
 static constexpr size_t kSharedMethodHotnessThreshold = 0x1fff;
 
@@ -2081,7 +2081,7 @@ class Thread {
     JniEntryPoints jni_entrypoints;
     QuickEntryPoints quick_entrypoints;
 
-    // There are RosAlloc::kNumThreadLocalSizeBrackets thread-local size brackets per thread.
+    // There are RosAlloc::kNumThreadLocalRunSizeBrackets thread-local size brackets per thread.
     void* rosalloc_runs[kNumRosAllocThreadLocalSizeBracketsInThread];
 
     // Thread-local allocation stack data/routines.
@@ -150,9 +150,7 @@ void ThreadPool::AddTask(Thread* self, Task* task) {
   MutexLock mu(self, task_queue_lock_);
   tasks_.push_back(task);
   // If we have any waiters, signal one.
-  if (started_ && waiting_count_ != 0) {
-    task_queue_condition_.Signal(self);
-  }
+  SignalWorkerLocked(self);
 }
 
 void ThreadPool::RemoveAllTasks(Thread* self) {
@@ -170,6 +168,13 @@ ThreadPool::ThreadPool(const char* name,
                        size_t num_threads,
                        bool create_peers,
                        size_t worker_stack_size)
+  : ThreadPool(name, num_threads, create_peers, worker_stack_size, /*create_threads=*/ true) {}
+
+ThreadPool::ThreadPool(const char* name,
+                       size_t num_threads,
+                       bool create_peers,
+                       size_t worker_stack_size,
+                       bool create_threads)
   : name_(name),
     task_queue_lock_("task queue lock", kGenericBottomLock),
     task_queue_condition_("task queue condition", task_queue_lock_),
@@ -183,7 +188,9 @@ ThreadPool::ThreadPool(const char* name,
     max_active_workers_(num_threads),
     create_peers_(create_peers),
     worker_stack_size_(worker_stack_size) {
-  CreateThreads();
+  if (create_threads) {
+    CreateThreads();
+  }
 }
 
 void ThreadPool::CreateThreads() {
@@ -131,7 +131,7 @@ class ThreadPool {
   void AddTask(Thread* self, Task* task) REQUIRES(!task_queue_lock_);
 
   // Remove all tasks in the queue.
-  void RemoveAllTasks(Thread* self) REQUIRES(!task_queue_lock_);
+  virtual void RemoveAllTasks(Thread* self) REQUIRES(!task_queue_lock_);
 
   // Create a named thread pool with the given number of threads.
   //
@@ -155,7 +155,7 @@ class ThreadPool {
   // When the pool was created with peers for workers, do_work must not be true (see ThreadPool()).
   void Wait(Thread* self, bool do_work, bool may_hold_locks) REQUIRES(!task_queue_lock_);
 
-  size_t GetTaskCount(Thread* self) REQUIRES(!task_queue_lock_);
+  virtual size_t GetTaskCount(Thread* self) REQUIRES(!task_queue_lock_);
 
   // Returns the total amount of workers waited for tasks.
   uint64_t GetWaitTime() const {
@@ -177,22 +177,37 @@ class ThreadPool {
   void WaitForWorkersToBeCreated();
 
  protected:
+  // For subclasses which need to be fully constructed before their workers start looking for
+  // tasks. They must call CreateThreads() themselves.
+  ThreadPool(const char* name,
+             size_t num_threads,
+             bool create_peers,
+             size_t worker_stack_size,
+             bool create_threads);
+
   // get a task to run, blocks if there are no tasks left
   virtual Task* GetTask(Thread* self) REQUIRES(!task_queue_lock_);
 
   // Try to get a task, returning null if there is none available.
   Task* TryGetTask(Thread* self) REQUIRES(!task_queue_lock_);
-  Task* TryGetTaskLocked() REQUIRES(task_queue_lock_);
+  virtual Task* TryGetTaskLocked() REQUIRES(task_queue_lock_);
 
   // Are we shutting down?
   bool IsShuttingDown() const REQUIRES(task_queue_lock_) {
     return shutting_down_;
   }
 
-  bool HasOutstandingTasks() const REQUIRES(task_queue_lock_) {
+  virtual bool HasOutstandingTasks() const REQUIRES(task_queue_lock_) {
     return started_ && !tasks_.empty();
   }
 
+  // Wake up a waiting worker, if any, after adding work to the queue.
+  void SignalWorkerLocked(Thread* self) REQUIRES(task_queue_lock_) {
+    if (started_ && waiting_count_ != 0) {
+      task_queue_condition_.Signal(self);
+    }
+  }
+
   const std::string name_;
   Mutex task_queue_lock_;
   ConditionVariable task_queue_condition_ GUARDED_BY(task_queue_lock_);
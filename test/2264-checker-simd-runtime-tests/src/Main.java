@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Tests vectorization of loops which need a != b runtime tests on several pairs of arrays.
+ */
+public class Main {
+  static final int SIZE = 100;
+
+  // The loop writes a[i + 1] and reads b[i] and c[i], which needs the a != b and a != c tests.
+  // If one of them fails, the sequential loop does all the iterations.
+  //
+  /// CHECK-START-X86_64: void Main.$noinline$addShifted(int[], int[], int[], int) loop_optimization (after)
+  /// CHECK-DAG: <<Test1:z\d+>> NotEqual [{{l\d+}},{{l\d+}}]      loop:none
+  /// CHECK-DAG: <<Test2:z\d+>> NotEqual [{{l\d+}},{{l\d+}}]      loop:none
+  /// CHECK-DAG:                Select [{{i\d+}},{{i\d+}},<<Test1>>] loop:none
+  /// CHECK-DAG:                Select [{{i\d+}},{{i\d+}},<<Test2>>] loop:none
+  /// CHECK-DAG:                VecStore                        loop:{{B\d+}}
+  //
+  /// CHECK-START-ARM64: void Main.$noinline$addShifted(int[], int[], int[], int) loop_optimization (after)
+  /// CHECK-NOT: VecStore
+  private static void $noinline$addShifted(int[] a, int[] b, int[] c, int n) {
+    for (int i = 0; i < n; i++) {
+      a[i + 1] = b[i] + c[i];
+    }
+  }
+
+  private static void testDisjoint() {
+    int[] a = new int[SIZE + 1];
+    int[] b = new int[SIZE];
+    int[] c = new int[SIZE];
+    for (int i = 0; i < SIZE; i++) {
+      b[i] = i;
+      c[i] = 2 * i;
+    }
+    $noinline$addShifted(a, b, c, SIZE);
+    expectEquals(0, a[0]);
+    for (int i = 0; i < SIZE; i++) {
+      expectEquals(3 * i, a[i + 1]);
+    }
+  }
+
+  private static void testAliased() {
+    // With a == b, each iteration reads the value stored by the previous one.
+    int[] a = new int[SIZE + 1];
+    int[] c = new int[SIZE];
+    for (int i = 0; i < SIZE; i++) {
+      c[i] = 1;
+    }
+    $noinline$addShifted(a, a, c, SIZE);
+    for (int i = 0; i <= SIZE; i++) {
+      expectEquals(i, a[i]);
+    }
+    // With a == c.
+    int[] b = new int[SIZE];
+    a = new int[SIZE + 1];
+    for (int i = 0; i < SIZE; i++) {
+      b[i] = 2;
+    }
+    $noinline$addShifted(a, b, a, SIZE);
+    for (int i = 0; i <= SIZE; i++) {
+      expectEquals(2 * i, a[i]);
+    }
+  }
+
+  public static void main(String[] args) {
+    testDisjoint();
+    testAliased();
+    System.out.println("passed");
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
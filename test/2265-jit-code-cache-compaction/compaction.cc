@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <jni.h>
+
+#include "art_method-inl.h"
+#include "jit/jit.h"
+#include "jit/jit_code_cache.h"
+#include "jni/jni_internal.h"
+#include "nativehelper/ScopedUtfChars.h"
+#include "oat_quick_method_header.h"
+#include "runtime.h"
+#include "scoped_thread_state_change-inl.h"
+
+namespace art {
+
+// Local class declared as a friend of JitCodeCache so that we can access its internals.
+class JitCodeCacheCompactionTestHelper {
+ public:
+  static size_t Compact(Thread* self) REQUIRES_SHARED(Locks::mutator_lock_) {
+    jit::JitCodeCache* cache = Runtime::Current()->GetJit()->GetCodeCache();
+    cache->CompactCode(self);
+    MutexLock mu(self, *Locks::jit_lock_);
+    return cache->number_of_compactions_;
+  }
+
+  static ArtMethod* GetMethodForCode(Thread* self, const void* code)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    jit::JitCodeCache* cache = Runtime::Current()->GetJit()->GetCodeCache();
+    MutexLock mu(self, *Locks::jit_lock_);
+    auto it = cache->method_code_map_.find(code);
+    return (it == cache->method_code_map_.end()) ? nullptr : it->second;
+  }
+};
+
+static ArtMethod* GetStaticMethod(JNIEnv* env, jclass cls, jstring method_name) {
+  ScopedUtfChars chars(env, method_name);
+  CHECK(chars.c_str() != nullptr);
+  jmethodID method_id = env->GetStaticMethodID(cls, chars.c_str(), "()I");
+  CHECK(method_id != nullptr) << chars.c_str();
+  return jni::DecodeArtMethod(method_id);
+}
+
+// Returns whether a compaction was done.
+extern "C" JNIEXPORT jboolean JNICALL Java_Main_compactJitCode(JNIEnv*, jclass) {
+  ScopedObjectAccess soa(Thread::Current());
+  size_t compactions = JitCodeCacheCompactionTestHelper::Compact(soa.Self());
+  return compactions != 0u ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C" JNIEXPORT jlong JNICALL Java_Main_getEntryPoint(JNIEnv* env,
+                                                          jclass,
+                                                          jclass cls,
+                                                          jstring method_name) {
+  ScopedObjectAccess soa(Thread::Current());
+  ArtMethod* method = GetStaticMethod(env, cls, method_name);
+  return reinterpret_cast<jlong>(method->GetEntryPointFromQuickCompiledCode());
+}
+
+// Checks that the JIT code the method enters is known to the code cache, and that a pc in
+// that code resolves to it.
+extern "C" JNIEXPORT jboolean JNICALL Java_Main_isJitCodeReachable(JNIEnv* env,
+                                                                  jclass,
+                                                                  jclass cls,
+                                                                  jstring method_name) {
+  ScopedObjectAccess soa(Thread::Current());
+  ArtMethod* method = GetStaticMethod(env, cls, method_name);
+  jit::JitCodeCache* cache = Runtime::Current()->GetJit()->GetCodeCache();
+  const void* entry_point = method->GetEntryPointFromQuickCompiledCode();
+  if (!cache->ContainsPc(entry_point)) {
+    return JNI_FALSE;
+  }
+  const OatQuickMethodHeader* header = OatQuickMethodHeader::FromEntryPoint(entry_point);
+  if (JitCodeCacheCompactionTestHelper::GetMethodForCode(soa.Self(), header->GetCode()) !=
+          method) {
+    return JNI_FALSE;
+  }
+  // Look up a pc in the middle of the code, as a return address on the stack would be.
+  uintptr_t pc = reinterpret_cast<uintptr_t>(header->GetCode()) + header->GetCodeSize() / 2u;
+  return cache->LookupMethodHeader(pc, method) == header ? JNI_TRUE : JNI_FALSE;
+}
+
+}  // namespace art
@@ -0,0 +1,28 @@
+#!/bin/bash
+#
+# Copyright (C) 2026 The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+def run(ctx, args):
+  # Compaction is skipped when native debug info is generated, which includes the
+  # mini-debug-info generated by default on target.
+  # -Xjitinitialsize:32M makes sure no code is collected behind the test's back.
+  ctx.default_run(
+      args,
+      prebuild=False,
+      runtime_option=[
+          "-Xcompiler-option --no-generate-mini-debug-info",
+          "-Xjitinitialsize:32M",
+      ])
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  private static final String[] METHODS = {
+    "$noinline$baseline1", "$noinline$baseline2", "$noinline$optimized1", "$noinline$optimized2"
+  };
+
+  public static void main(String[] args) throws Exception {
+    System.loadLibrary(args[0]);
+    if (isAotCompiled(Main.class, "hasJit")) {
+      throw new Error("This test must be run with --no-prebuild!");
+    }
+    if (!hasJit()) {
+      return;
+    }
+
+    // Compaction lays out the optimized code first, so compiling the baseline code first
+    // makes it move.
+    ensureJitBaselineCompiled(Main.class, "$noinline$baseline1");
+    ensureJitBaselineCompiled(Main.class, "$noinline$baseline2");
+    ensureJitCompiled(Main.class, "$noinline$optimized1");
+    ensureJitCompiled(Main.class, "$noinline$optimized2");
+    long[] entryPoints = new long[METHODS.length];
+    for (int i = 0; i < METHODS.length; ++i) {
+      assertTrue(hasJitCompiledEntrypoint(Main.class, METHODS[i]));
+      assertTrue(isJitCodeReachable(Main.class, METHODS[i]));
+      entryPoints[i] = getEntryPoint(Main.class, METHODS[i]);
+    }
+
+    if (!compactJitCode()) {
+      // Native debug info is generated, the code cannot move.
+      return;
+    }
+
+    int moved = 0;
+    for (int i = 0; i < METHODS.length; ++i) {
+      // The entry points must have been updated to the moved code.
+      assertTrue(hasJitCompiledEntrypoint(Main.class, METHODS[i]));
+      assertTrue(isJitCodeReachable(Main.class, METHODS[i]));
+      if (getEntryPoint(Main.class, METHODS[i]) != entryPoints[i]) {
+        ++moved;
+      }
+    }
+    assertTrue(moved != 0);
+
+    // The moved code still runs.
+    assertEquals(1, $noinline$baseline1());
+    assertEquals(2, $noinline$baseline2());
+    assertEquals(3, $noinline$optimized1());
+    assertEquals(4, $noinline$optimized2());
+  }
+
+  public static int $noinline$baseline1() {
+    return 1;
+  }
+
+  public static int $noinline$baseline2() {
+    return 2;
+  }
+
+  public static int $noinline$optimized1() {
+    return 3;
+  }
+
+  public static int $noinline$optimized2() {
+    return 4;
+  }
+
+  public static void assertTrue(boolean value) {
+    if (!value) {
+      throw new Error("Expected true");
+    }
+  }
+
+  public static void assertEquals(int expected, int actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+
+  public static native boolean isAotCompiled(Class<?> cls, String methodName);
+  public static native boolean hasJit();
+  public static native boolean hasJitCompiledEntrypoint(Class<?> cls, String methodName);
+  public static native void ensureJitCompiled(Class<?> cls, String methodName);
+  public static native void ensureJitBaselineCompiled(Class<?> cls, String methodName);
+  public static native boolean compactJitCode();
+  public static native long getEntryPoint(Class<?> cls, String methodName);
+  public static native boolean isJitCodeReachable(Class<?> cls, String methodName);
+}
@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <jni.h>
+
+#include "arch/instruction_set.h"
+#include "jit/jit.h"
+#include "runtime.h"
+
+namespace art {
+
+// Whether hot loops of baseline compiled code are expected to transition to OSR code.
+extern "C" JNIEXPORT jboolean JNICALL Java_Main_hasOsrFromBaseline(JNIEnv*, jclass) {
+  if (kRuntimeISA != InstructionSet::kArm64 && kRuntimeISA != InstructionSet::kX86_64) {
+    return JNI_FALSE;
+  }
+  Runtime* runtime = Runtime::Current();
+  jit::Jit* jit = runtime->GetJit();
+  return (jit != nullptr &&
+          runtime->UseJitCompilation() &&
+          !runtime->IsJavaDebuggable() &&
+          !jit->GetJitCompiler()->IsBaselineCompiler()) ? JNI_TRUE : JNI_FALSE;
+}
+
+}  // namespace art
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  private static final long TIMEOUT_NS = 60_000_000_000L;
+
+  public static void main(String[] args) throws Exception {
+    System.loadLibrary(args[0]);
+    if (!hasOsrFromBaseline()) {
+      return;
+    }
+
+    ensureJitBaselineCompiled(Main.class, "$noinline$loop");
+    assertTrue(hasJitCompiledEntrypoint(Main.class, "$noinline$loop"));
+    $noinline$loop();
+  }
+
+  // Loops in the baseline code until its back edges get the method compiled optimized, then
+  // OSR compiled, and the baseline frame is replaced by an OSR frame.
+  public static void $noinline$loop() {
+    long start = System.nanoTime();
+    long sum = 0;
+    int i = 0;
+    while (true) {
+      sum += i;
+      ++i;
+      if ((i & 0xfff) == 0) {
+        if (isInOsrCode("$noinline$loop")) {
+          break;
+        }
+        if (System.nanoTime() - start > TIMEOUT_NS) {
+          throw new Error("The baseline loop did not transition to OSR code");
+        }
+      }
+    }
+    // The values of the baseline frame have been carried over to the OSR frame.
+    long expected = (long) i * (i - 1) / 2;
+    if (sum != expected) {
+      throw new Error("Expected " + expected + ", got " + sum);
+    }
+  }
+
+  public static void assertTrue(boolean value) {
+    if (!value) {
+      throw new Error("Expected true");
+    }
+  }
+
+  public static native boolean hasOsrFromBaseline();
+  public static native boolean hasJitCompiledEntrypoint(Class<?> cls, String methodName);
+  public static native void ensureJitBaselineCompiled(Class<?> cls, String methodName);
+  public static native boolean isInOsrCode(String methodName);
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// Test the x86-64 heuristics of scalar loop peeling and unrolling. Unlike the default ones, they
+// accept loops with long instructions, and unroll them if the unrolled loop fits in the loop
+// stream decoder: 28 instructions, or 56 on cores with AVX2.
+public class Main {
+
+  static final int LENGTH = 4 * 1024;
+
+  // A small loop with long instructions is unrolled.
+  //
+  /// CHECK-START-X86_64: void Main.unrollingClearLongs(long[]) loop_optimization (before)
+  /// CHECK:                      ArraySet
+  /// CHECK-NOT:                  ArraySet
+
+  /// CHECK-START-X86_64: void Main.unrollingClearLongs(long[]) loop_optimization (after)
+  /// CHECK-DAG: <<Const0:i\d+>>   IntConstant 0                             loop:none
+  /// CHECK-DAG: <<Const1:i\d+>>   IntConstant 1                             loop:none
+  /// CHECK-DAG: <<Limit:i\d+>>    IntConstant 4096                          loop:none
+  /// CHECK-DAG: <<PhiI:i\d+>>     Phi [<<Const0>>,{{i\d+}}]                 loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG: <<Check:z\d+>>    GreaterThanOrEqual [<<PhiI>>,<<Limit>>]   loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG:                   If [<<Check>>]                            loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG:                   ArraySet                                  loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG: <<AddI:i\d+>>     Add [<<PhiI>>,<<Const1>>]                 loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG:                   ArraySet                                  loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG:                   Add [<<AddI>>,<<Const1>>]                 loop:<<Loop>>      outer_loop:none
+
+  /// CHECK-START-X86_64: void Main.unrollingClearLongs(long[]) loop_optimization (after)
+  /// CHECK:                      ArraySet
+  /// CHECK:                      ArraySet
+  /// CHECK-NOT:                  ArraySet
+  private static final void unrollingClearLongs(long[] a) {
+    for (int i = 0; i < LENGTH; i++) {
+      if (a[i] != 0L) {
+        a[i] = 0L;
+      }
+    }
+  }
+
+  // A bigger loop with long instructions is only unrolled if AVX2 tells a bigger LSD.
+  //
+  /// CHECK-START-X86_64: void Main.unrollingSwapLongElements(long[]) loop_optimization (before)
+  /// CHECK:                      ArraySet
+  /// CHECK:                      ArraySet
+  /// CHECK-NOT:                  ArraySet
+
+  /// CHECK-START-X86_64: void Main.unrollingSwapLongElements(long[]) loop_optimization (after)
+  /// CHECK-IF:     hasIsaFeature("avx2")
+  //
+  ///     CHECK:                      ArraySet
+  ///     CHECK:                      ArraySet
+  ///     CHECK:                      ArraySet
+  ///     CHECK:                      ArraySet
+  ///     CHECK-NOT:                  ArraySet
+  //
+  /// CHECK-ELSE:
+  //
+  ///     CHECK:                      ArraySet
+  ///     CHECK:                      ArraySet
+  ///     CHECK-NOT:                  ArraySet
+  //
+  /// CHECK-FI:
+  private static final void unrollingSwapLongElements(long[] array) {
+    for (int i = 0; i < LENGTH - 2; i++) {
+      if (array[i] > array[i + 1]) {
+        long temp = array[i + 1];
+        array[i + 1] = array[i] >> 1;
+        array[i] = temp << 1;
+      }
+    }
+  }
+
+  // A loop with long instructions and a loop invariant exit is peeled.
+  //
+  /// CHECK-START-X86_64: void Main.peelingLongs(long[], boolean) loop_optimization (before)
+  /// CHECK:                      ArraySet
+  /// CHECK-NOT:                  ArraySet
+
+  /// CHECK-START-X86_64: void Main.peelingLongs(long[], boolean) loop_optimization (after)
+  /// CHECK-DAG: <<Param:z\d+>>     ParameterValue                            loop:none
+  /// CHECK-DAG:                    If [<<Param>>]                            loop:none
+  /// CHECK-DAG:                    ArraySet                                  loop:none
+  /// CHECK-DAG: <<Phi:i\d+>>       Phi                                       loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG:                    ArraySet                                  loop:<<Loop>>      outer_loop:none
+
+  /// CHECK-START-X86_64: void Main.peelingLongs(long[], boolean) dead_code_elimination$before_codegen (after)
+  /// CHECK-DAG: <<Param:z\d+>>     ParameterValue                            loop:none
+  /// CHECK-DAG:                    If [<<Param>>]                            loop:none
+  /// CHECK-DAG: <<Phi:i\d+>>       Phi                                       loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-NOT:                    If [<<Param>>]                            loop:<<Loop>>      outer_loop:none
+  private static final void peelingLongs(long[] a, boolean f) {
+    for (int i = 0; i < LENGTH; i++) {
+      if (f) {
+        break;
+      }
+      a[i] += 1L;
+    }
+  }
+
+  private static void expectEquals(long expected, long result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  public static void main(String[] args) {
+    long[] a = new long[LENGTH];
+    for (int i = 0; i < LENGTH; i++) {
+      a[i] = i;
+    }
+    unrollingClearLongs(a);
+    for (int i = 0; i < LENGTH; i++) {
+      expectEquals(0L, a[i]);
+    }
+
+    long[] b = new long[LENGTH];
+    for (int i = 0; i < LENGTH; i++) {
+      b[i] = (i * 7) % 13;
+    }
+    unrollingSwapLongElements(b);
+    long sum = 0;
+    for (int i = 0; i < LENGTH; i++) {
+      sum += b[i];
+    }
+    expectEquals(20793L, sum);
+    expectEquals(2L, b[1]);
+    expectEquals(8L, b[7]);
+    expectEquals(6L, b[LENGTH - 2]);
+
+    long[] c = new long[LENGTH];
+    peelingLongs(c, false);
+    peelingLongs(c, true);
+    for (int i = 0; i < LENGTH; i++) {
+      expectEquals(1L, c[i]);
+    }
+
+    System.out.println("passed");
+  }
+}
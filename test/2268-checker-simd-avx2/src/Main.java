@@ -0,0 +1,487 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// Test the vector lengths picked for x86-64 and the results of the vector loops. With AVX2, the
+// vectors take the full 256-bit YMM registers, otherwise the 128-bit XMM registers. The loop
+// bounds are such that the vector loops, their reductions and the cleanup loops all run.
+public class Main {
+
+  static final int LENGTH = 1027;
+
+  /// CHECK-START-X86_64: void Main.addBytes(byte[], byte[], byte[]) loop_optimization (after)
+  /// CHECK-IF:     hasIsaFeature("avx2")
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>    IntConstant 32                             loop:none
+  ///     CHECK-DAG: <<Op:d\d+>>    VecAdd [{{d\d+}},{{d\d+}}]                 loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG:               VecStore [{{l\d+}},<<I:i\d+>>,<<Op>>]      loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                         loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-ELSE:
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>    IntConstant 16                             loop:none
+  ///     CHECK-DAG: <<Op:d\d+>>    VecAdd [{{d\d+}},{{d\d+}}]                 loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG:               VecStore [{{l\d+}},<<I:i\d+>>,<<Op>>]      loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                         loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-FI:
+  private static void addBytes(byte[] a, byte[] b, byte[] c) {
+    int minLength = Math.min(a.length, Math.min(b.length, c.length));
+    for (int i = 0; i < minLength; i++) {
+      a[i] = (byte) (b[i] + c[i]);
+    }
+  }
+
+  /// CHECK-START-X86_64: void Main.addShorts(short[], short[], short[]) loop_optimization (after)
+  /// CHECK-IF:     hasIsaFeature("avx2")
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>    IntConstant 16                             loop:none
+  ///     CHECK-DAG: <<Op:d\d+>>    VecAdd [{{d\d+}},{{d\d+}}]                 loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG:               VecStore [{{l\d+}},<<I:i\d+>>,<<Op>>]      loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                         loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-ELSE:
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>    IntConstant 8                              loop:none
+  ///     CHECK-DAG: <<Op:d\d+>>    VecAdd [{{d\d+}},{{d\d+}}]                 loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG:               VecStore [{{l\d+}},<<I:i\d+>>,<<Op>>]      loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                         loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-FI:
+  private static void addShorts(short[] a, short[] b, short[] c) {
+    int minLength = Math.min(a.length, Math.min(b.length, c.length));
+    for (int i = 0; i < minLength; i++) {
+      a[i] = (short) (b[i] + c[i]);
+    }
+  }
+
+  /// CHECK-START-X86_64: void Main.addInts(int[], int[], int[]) loop_optimization (after)
+  /// CHECK-IF:     hasIsaFeature("avx2")
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>    IntConstant 8                              loop:none
+  ///     CHECK-DAG: <<Op:d\d+>>    VecAdd [{{d\d+}},{{d\d+}}]                 loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG:               VecStore [{{l\d+}},<<I:i\d+>>,<<Op>>]      loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                         loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-ELSE:
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>    IntConstant 4                              loop:none
+  ///     CHECK-DAG: <<Op:d\d+>>    VecAdd [{{d\d+}},{{d\d+}}]                 loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG:               VecStore [{{l\d+}},<<I:i\d+>>,<<Op>>]      loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                         loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-FI:
+  private static void addInts(int[] a, int[] b, int[] c) {
+    int minLength = Math.min(a.length, Math.min(b.length, c.length));
+    for (int i = 0; i < minLength; i++) {
+      a[i] = b[i] + c[i];
+    }
+  }
+
+  /// CHECK-START-X86_64: void Main.addLongs(long[], long[], long[]) loop_optimization (after)
+  /// CHECK-IF:     hasIsaFeature("avx2")
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>    IntConstant 4                              loop:none
+  ///     CHECK-DAG: <<Op:d\d+>>    VecAdd [{{d\d+}},{{d\d+}}]                 loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG:               VecStore [{{l\d+}},<<I:i\d+>>,<<Op>>]      loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                         loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-ELSE:
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>    IntConstant 2                              loop:none
+  ///     CHECK-DAG: <<Op:d\d+>>    VecAdd [{{d\d+}},{{d\d+}}]                 loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG:               VecStore [{{l\d+}},<<I:i\d+>>,<<Op>>]      loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                         loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-FI:
+  private static void addLongs(long[] a, long[] b, long[] c) {
+    int minLength = Math.min(a.length, Math.min(b.length, c.length));
+    for (int i = 0; i < minLength; i++) {
+      a[i] = b[i] + c[i];
+    }
+  }
+
+  /// CHECK-START-X86_64: void Main.addFloats(float[], float[], float[]) loop_optimization (after)
+  /// CHECK-IF:     hasIsaFeature("avx2")
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>    IntConstant 8                              loop:none
+  ///     CHECK-DAG: <<Op:d\d+>>    VecAdd [{{d\d+}},{{d\d+}}]                 loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG:               VecStore [{{l\d+}},<<I:i\d+>>,<<Op>>]      loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                         loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-ELSE:
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>    IntConstant 4                              loop:none
+  ///     CHECK-DAG: <<Op:d\d+>>    VecAdd [{{d\d+}},{{d\d+}}]                 loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG:               VecStore [{{l\d+}},<<I:i\d+>>,<<Op>>]      loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                         loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-FI:
+  private static void addFloats(float[] a, float[] b, float[] c) {
+    int minLength = Math.min(a.length, Math.min(b.length, c.length));
+    for (int i = 0; i < minLength; i++) {
+      a[i] = b[i] + c[i];
+    }
+  }
+
+  /// CHECK-START-X86_64: void Main.addDoubles(double[], double[], double[]) loop_optimization (after)
+  /// CHECK-IF:     hasIsaFeature("avx2")
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>    IntConstant 4                              loop:none
+  ///     CHECK-DAG: <<Op:d\d+>>    VecAdd [{{d\d+}},{{d\d+}}]                 loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG:               VecStore [{{l\d+}},<<I:i\d+>>,<<Op>>]      loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                         loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-ELSE:
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>    IntConstant 2                              loop:none
+  ///     CHECK-DAG: <<Op:d\d+>>    VecAdd [{{d\d+}},{{d\d+}}]                 loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG:               VecStore [{{l\d+}},<<I:i\d+>>,<<Op>>]      loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                         loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-FI:
+  private static void addDoubles(double[] a, double[] b, double[] c) {
+    int minLength = Math.min(a.length, Math.min(b.length, c.length));
+    for (int i = 0; i < minLength; i++) {
+      a[i] = b[i] + c[i];
+    }
+  }
+
+  /// CHECK-START-X86_64: void Main.mulShorts(short[], short[], short[]) loop_optimization (after)
+  /// CHECK-IF:     hasIsaFeature("avx2")
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>    IntConstant 16                             loop:none
+  ///     CHECK-DAG: <<Op:d\d+>>    VecMul [{{d\d+}},{{d\d+}}]                 loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG:               VecStore [{{l\d+}},<<I:i\d+>>,<<Op>>]      loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                         loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-ELSE:
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>    IntConstant 8                              loop:none
+  ///     CHECK-DAG: <<Op:d\d+>>    VecMul [{{d\d+}},{{d\d+}}]                 loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG:               VecStore [{{l\d+}},<<I:i\d+>>,<<Op>>]      loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                         loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-FI:
+  private static void mulShorts(short[] a, short[] b, short[] c) {
+    int minLength = Math.min(a.length, Math.min(b.length, c.length));
+    for (int i = 0; i < minLength; i++) {
+      a[i] = (short) (b[i] * c[i]);
+    }
+  }
+
+  /// CHECK-START-X86_64: void Main.mulInts(int[], int[], int[]) loop_optimization (after)
+  /// CHECK-IF:     hasIsaFeature("avx2")
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>    IntConstant 8                              loop:none
+  ///     CHECK-DAG: <<Op:d\d+>>    VecMul [{{d\d+}},{{d\d+}}]                 loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG:               VecStore [{{l\d+}},<<I:i\d+>>,<<Op>>]      loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                         loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-ELSE:
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>    IntConstant 4                              loop:none
+  ///     CHECK-DAG: <<Op:d\d+>>    VecMul [{{d\d+}},{{d\d+}}]                 loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG:               VecStore [{{l\d+}},<<I:i\d+>>,<<Op>>]      loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                         loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-FI:
+  private static void mulInts(int[] a, int[] b, int[] c) {
+    int minLength = Math.min(a.length, Math.min(b.length, c.length));
+    for (int i = 0; i < minLength; i++) {
+      a[i] = b[i] * c[i];
+    }
+  }
+
+  /// CHECK-START-X86_64: void Main.mulFloats(float[], float[], float[]) loop_optimization (after)
+  /// CHECK-IF:     hasIsaFeature("avx2")
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>    IntConstant 8                              loop:none
+  ///     CHECK-DAG: <<Op:d\d+>>    VecMul [{{d\d+}},{{d\d+}}]                 loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG:               VecStore [{{l\d+}},<<I:i\d+>>,<<Op>>]      loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                         loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-ELSE:
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>    IntConstant 4                              loop:none
+  ///     CHECK-DAG: <<Op:d\d+>>    VecMul [{{d\d+}},{{d\d+}}]                 loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG:               VecStore [{{l\d+}},<<I:i\d+>>,<<Op>>]      loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                         loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-FI:
+  private static void mulFloats(float[] a, float[] b, float[] c) {
+    int minLength = Math.min(a.length, Math.min(b.length, c.length));
+    for (int i = 0; i < minLength; i++) {
+      a[i] = b[i] * c[i];
+    }
+  }
+
+  /// CHECK-START-X86_64: void Main.mulDoubles(double[], double[], double[]) loop_optimization (after)
+  /// CHECK-IF:     hasIsaFeature("avx2")
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>    IntConstant 4                              loop:none
+  ///     CHECK-DAG: <<Op:d\d+>>    VecMul [{{d\d+}},{{d\d+}}]                 loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG:               VecStore [{{l\d+}},<<I:i\d+>>,<<Op>>]      loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                         loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-ELSE:
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>    IntConstant 2                              loop:none
+  ///     CHECK-DAG: <<Op:d\d+>>    VecMul [{{d\d+}},{{d\d+}}]                 loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG:               VecStore [{{l\d+}},<<I:i\d+>>,<<Op>>]      loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                         loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-FI:
+  private static void mulDoubles(double[] a, double[] b, double[] c) {
+    int minLength = Math.min(a.length, Math.min(b.length, c.length));
+    for (int i = 0; i < minLength; i++) {
+      a[i] = b[i] * c[i];
+    }
+  }
+
+  /// CHECK-START-X86_64: int Main.sumInts(int[]) loop_optimization (after)
+  /// CHECK-IF:     hasIsaFeature("avx2")
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>    IntConstant 8                              loop:none
+  ///     CHECK-DAG: <<Set:d\d+>>   VecSetScalars [{{i\d+}}]                   loop:none
+  ///     CHECK-DAG: <<Phi:d\d+>>   Phi [<<Set>>,{{d\d+}}]                     loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG: <<Load:d\d+>>  VecLoad [{{l\d+}},<<I:i\d+>>]              loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               VecAdd [<<Phi>>,<<Load>>]                  loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                         loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG: <<Red:d\d+>>   VecReduce [<<Phi>>]                        loop:none
+  ///     CHECK-DAG:               VecExtractScalar [<<Red>>]                 loop:none
+  //
+  /// CHECK-ELSE:
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>    IntConstant 4                              loop:none
+  ///     CHECK-DAG: <<Set:d\d+>>   VecSetScalars [{{i\d+}}]                   loop:none
+  ///     CHECK-DAG: <<Phi:d\d+>>   Phi [<<Set>>,{{d\d+}}]                     loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG: <<Load:d\d+>>  VecLoad [{{l\d+}},<<I:i\d+>>]              loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               VecAdd [<<Phi>>,<<Load>>]                  loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                         loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG: <<Red:d\d+>>   VecReduce [<<Phi>>]                        loop:none
+  ///     CHECK-DAG:               VecExtractScalar [<<Red>>]                 loop:none
+  //
+  /// CHECK-FI:
+  private static int sumInts(int[] x) {
+    int sum = 0;
+    for (int i = 0; i < x.length; i++) {
+      sum += x[i];
+    }
+    return sum;
+  }
+
+  /// CHECK-START-X86_64: long Main.sumLongs(long[]) loop_optimization (after)
+  /// CHECK-IF:     hasIsaFeature("avx2")
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>    IntConstant 4                              loop:none
+  ///     CHECK-DAG: <<Set:d\d+>>   VecSetScalars [{{j\d+}}]                   loop:none
+  ///     CHECK-DAG: <<Phi:d\d+>>   Phi [<<Set>>,{{d\d+}}]                     loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG: <<Load:d\d+>>  VecLoad [{{l\d+}},<<I:i\d+>>]              loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               VecAdd [<<Phi>>,<<Load>>]                  loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                         loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG: <<Red:d\d+>>   VecReduce [<<Phi>>]                        loop:none
+  ///     CHECK-DAG:               VecExtractScalar [<<Red>>]                 loop:none
+  //
+  /// CHECK-ELSE:
+  //
+  ///     CHECK-DAG: <<Vl:i\d+>>    IntConstant 2                              loop:none
+  ///     CHECK-DAG: <<Set:d\d+>>   VecSetScalars [{{j\d+}}]                   loop:none
+  ///     CHECK-DAG: <<Phi:d\d+>>   Phi [<<Set>>,{{d\d+}}]                     loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG: <<Load:d\d+>>  VecLoad [{{l\d+}},<<I:i\d+>>]              loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               VecAdd [<<Phi>>,<<Load>>]                  loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:               Add [<<I>>,<<Vl>>]                         loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG: <<Red:d\d+>>   VecReduce [<<Phi>>]                        loop:none
+  ///     CHECK-DAG:               VecExtractScalar [<<Red>>]                 loop:none
+  //
+  /// CHECK-FI:
+  private static long sumLongs(long[] x) {
+    long sum = 0;
+    for (int i = 0; i < x.length; i++) {
+      sum += x[i];
+    }
+    return sum;
+  }
+
+  // The loop optimizer does not vectorize Math.min() and Math.max(). Check that the scalar loops
+  // compute the same results as the vector loops around them.
+  //
+  /// CHECK-START-X86_64: void Main.minInts(int[], int[], int[]) loop_optimization (after)
+  /// CHECK-NOT: VecMin
+  private static void minInts(int[] a, int[] b, int[] c) {
+    int minLength = Math.min(a.length, Math.min(b.length, c.length));
+    for (int i = 0; i < minLength; i++) {
+      a[i] = Math.min(b[i], c[i]);
+    }
+  }
+
+  /// CHECK-START-X86_64: void Main.maxInts(int[], int[], int[]) loop_optimization (after)
+  /// CHECK-NOT: VecMax
+  private static void maxInts(int[] a, int[] b, int[] c) {
+    int minLength = Math.min(a.length, Math.min(b.length, c.length));
+    for (int i = 0; i < minLength; i++) {
+      a[i] = Math.max(b[i], c[i]);
+    }
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  private static void expectEquals(long expected, long result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  private static void expectEquals(float expected, float result) {
+    if (Float.floatToRawIntBits(expected) != Float.floatToRawIntBits(result)) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  private static void expectEquals(double expected, double result) {
+    if (Double.doubleToRawLongBits(expected) != Double.doubleToRawLongBits(result)) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  private static void testBytes(int n) {
+    byte[] a = new byte[n];
+    byte[] b = new byte[n];
+    byte[] c = new byte[n];
+    for (int i = 0; i < n; i++) {
+      b[i] = (byte) (i * 3);
+      c[i] = (byte) (100 - i);
+    }
+    addBytes(a, b, c);
+    for (int i = 0; i < n; i++) {
+      expectEquals((byte) (b[i] + c[i]), a[i]);
+    }
+  }
+
+  private static void testShorts(int n) {
+    short[] a = new short[n];
+    short[] b = new short[n];
+    short[] c = new short[n];
+    for (int i = 0; i < n; i++) {
+      b[i] = (short) (i * 211);
+      c[i] = (short) (3 - i * 7);
+    }
+    addShorts(a, b, c);
+    for (int i = 0; i < n; i++) {
+      expectEquals((short) (b[i] + c[i]), a[i]);
+    }
+    mulShorts(a, b, c);
+    for (int i = 0; i < n; i++) {
+      expectEquals((short) (b[i] * c[i]), a[i]);
+    }
+  }
+
+  private static void testInts(int n) {
+    int[] a = new int[n];
+    int[] b = new int[n];
+    int[] c = new int[n];
+    for (int i = 0; i < n; i++) {
+      b[i] = i * 3 - 500;
+      c[i] = 0x12345 - i * 0x10001;
+    }
+    addInts(a, b, c);
+    for (int i = 0; i < n; i++) {
+      expectEquals(b[i] + c[i], a[i]);
+    }
+    mulInts(a, b, c);
+    for (int i = 0; i < n; i++) {
+      expectEquals(b[i] * c[i], a[i]);
+    }
+    minInts(a, b, c);
+    for (int i = 0; i < n; i++) {
+      expectEquals(Math.min(b[i], c[i]), a[i]);
+    }
+    maxInts(a, b, c);
+    for (int i = 0; i < n; i++) {
+      expectEquals(Math.max(b[i], c[i]), a[i]);
+    }
+    expectEquals(3 * n * (n - 1) / 2 - 500 * n, sumInts(b));
+  }
+
+  private static void testLongs(int n) {
+    long[] a = new long[n];
+    long[] b = new long[n];
+    long[] c = new long[n];
+    for (int i = 0; i < n; i++) {
+      b[i] = i * 0x100000001L;
+      c[i] = -i;
+    }
+    addLongs(a, b, c);
+    for (int i = 0; i < n; i++) {
+      expectEquals(b[i] + c[i], a[i]);
+    }
+    expectEquals(0x100000001L * n * (n - 1) / 2, sumLongs(b));
+  }
+
+  private static void testFloats(int n) {
+    float[] a = new float[n];
+    float[] b = new float[n];
+    float[] c = new float[n];
+    for (int i = 0; i < n; i++) {
+      b[i] = i * 0.5f;
+      c[i] = 1.25f - i;
+    }
+    addFloats(a, b, c);
+    for (int i = 0; i < n; i++) {
+      expectEquals(b[i] + c[i], a[i]);
+    }
+    mulFloats(a, b, c);
+    for (int i = 0; i < n; i++) {
+      expectEquals(b[i] * c[i], a[i]);
+    }
+  }
+
+  private static void testDoubles(int n) {
+    double[] a = new double[n];
+    double[] b = new double[n];
+    double[] c = new double[n];
+    for (int i = 0; i < n; i++) {
+      b[i] = i * 0.25;
+      c[i] = 3.5 - i;
+    }
+    addDoubles(a, b, c);
+    for (int i = 0; i < n; i++) {
+      expectEquals(b[i] + c[i], a[i]);
+    }
+    mulDoubles(a, b, c);
+    for (int i = 0; i < n; i++) {
+      expectEquals(b[i] * c[i], a[i]);
+    }
+  }
+
+  public static void main(String[] args) {
+    // Lengths below one vector, between one and two vectors, and with a long vector loop.
+    int[] lengths = { 0, 7, 45, LENGTH };
+    for (int n : lengths) {
+      testBytes(n);
+      testShorts(n);
+      testInts(n);
+      testLongs(n);
+      testFloats(n);
+      testDoubles(n);
+    }
+    System.out.println("passed");
+  }
+}
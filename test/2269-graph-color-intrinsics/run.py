@@ -0,0 +1,29 @@
+#!/bin/bash
+#
+# Copyright (C) 2026 The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+def run(ctx, args):
+  # Graph coloring for all the compiled code, AOT and JIT.
+  ctx.default_run(
+      args, Xcompiler_option=["--register-allocation-strategy=graph-color"])
+
+  # Graph coloring for the AOT code compiled with the speed filter only.
+  ctx.default_run(
+      args,
+      Xcompiler_option=[
+          "--register-allocation-strategy=graph-color-for-speed",
+          "--compiler-filter=speed"
+      ])
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.util.concurrent.atomic.AtomicInteger;
+import java.util.concurrent.atomic.AtomicLong;
+import java.util.concurrent.atomic.AtomicReference;
+
+// Intrinsics with fixed input, output and temporary registers, and with calls on the main or slow
+// paths, compiled with the graph coloring register allocator. Other values are live across them,
+// so that the allocator has to keep them out of the fixed registers.
+public class Main {
+
+  static final int ITERATIONS = 10000;
+
+  // String.indexOf() and String.compareTo() use fixed registers on x86-64, and calls elsewhere.
+  private static int $noinline$indexOfs(String s, int a, int b, int c) {
+    int i = s.indexOf('o');
+    int j = s.indexOf('o', i + 1);
+    int k = s.indexOf("wor");
+    return a * i + b * j + c * k + a + b + c;
+  }
+
+  // String.equals() uses fixed temporaries on x86-64.
+  private static int $noinline$compares(String s1, String s2, int a, int b) {
+    int cmp = s1.compareTo(s2);
+    boolean eq1 = s1.equals(s2);
+    boolean eq2 = s1.equals(new String(s1.toCharArray()));
+    return a * cmp + (eq1 ? b : 0) + (eq2 ? 2 * b : 0) + a + b;
+  }
+
+  // String.getChars() and System.arraycopy() on chars use fixed registers on x86-64.
+  private static int $noinline$copies(String s, char[] dst, int a, int b) {
+    s.getChars(0, s.length(), dst, 0);
+    System.arraycopy(dst, 0, dst, a, b);
+    return a + b + dst[a] + dst[a + b - 1];
+  }
+
+  // Compare-and-set uses a fixed register for the expected value on x86-64, and temporaries
+  // elsewhere.
+  private static long $noinline$atomics(AtomicInteger ai,
+                                        AtomicLong al,
+                                        AtomicReference<String> ar,
+                                        int x,
+                                        long y) {
+    boolean b1 = ai.compareAndSet(x, x + 1);
+    boolean b2 = ai.compareAndSet(x, x + 2);
+    boolean b3 = al.compareAndSet(y, y * 2);
+    int old = ai.getAndAdd(x);
+    boolean b4 = ar.compareAndSet("a", "b");
+    return (b1 ? 1 : 0) + (b2 ? 2 : 0) + (b3 ? 4 : 0) + (b4 ? 8 : 0) + old + ai.get() + al.get()
+        + x + y;
+  }
+
+  // Bit manipulation intrinsics, variable rotations and divisions, which use fixed registers on
+  // x86-64.
+  private static long $noinline$bits(int i, long l, int shift) {
+    long r = Long.rotateLeft(l, shift) ^ Long.reverseBytes(l);
+    int c = Long.bitCount(l) + Integer.numberOfLeadingZeros(i) + Long.numberOfTrailingZeros(l);
+    int rev = Integer.reverse(i);
+    int div = i / shift + i % shift;
+    return r + c + rev + div + Integer.rotateRight(i, shift) + Long.highestOneBit(l);
+  }
+
+  // Math intrinsics with temporaries, and Math.pow() which calls into the runtime.
+  private static double $noinline$math(double d, float f, int n) {
+    long r1 = Math.round(d);
+    int r2 = Math.round(f);
+    double s = Math.sqrt(d * d);
+    double m = Math.max(d, -d) + Math.min(f, -f);
+    double p = Math.pow(d, 2.0);
+    return r1 + r2 + s + m + p + Math.abs(n);
+  }
+
+  // More live values than registers around the intrinsics in a loop.
+  private static int $noinline$pressure(String s, int n) {
+    int a0 = 0, a1 = 1, a2 = 2, a3 = 3, a4 = 4, a5 = 5, a6 = 6, a7 = 7;
+    for (int i = 0; i < n; i++) {
+      int idx = s.indexOf('w', i & 3);
+      int cmp = s.compareTo("hello");
+      a0 += cmp;
+      a1 += idx + 1;
+      a2 += cmp + 2;
+      a3 += idx + 3;
+      a4 += cmp + 4;
+      a5 += idx + 5;
+      a6 += cmp + 6;
+      a7 += idx + 7;
+    }
+    return a0 + a1 + a2 + a3 + a4 + a5 + a6 + a7;
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  private static void expectEquals(long expected, long result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  private static void expectEquals(double expected, double result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  public static void main(String[] args) {
+    // Run the methods often enough for the JIT to compile them too.
+    for (int i = 0; i < ITERATIONS; i++) {
+      expectEquals(785, $noinline$indexOfs("hello world", 1, 10, 100));
+      expectEquals(15, $noinline$compares("abc", "abd", 3, 5));
+      expectEquals(236, $noinline$copies("hello world", new char[32], 16, 5));
+      expectEquals(3298534883383L,
+                   $noinline$atomics(new AtomicInteger(10),
+                                     new AtomicLong(1L << 40),
+                                     new AtomicReference<String>("a"),
+                                     10,
+                                     1L << 40));
+      expectEquals(-2550212679460749491L, $noinline$bits(0x12345678, 0x0123456789ABCDEFL, 12));
+      expectEquals(18.75, $noinline$math(2.5, -1.5f, -7));
+    }
+    expectEquals(76028, $noinline$pressure("hello world", 1000));
+    System.out.println("passed");
+  }
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+class Point {
+  int x;
+  long y;
+  Object tag;
+}
+
+// Test partial load-store elimination on objects which escape only on a cold path. The allocation
+// moves to that path, and the loads after it become predicated loads: they read the field of the
+// object if it was allocated, and take the known value otherwise.
+public class Main {
+
+  static final int ITERATIONS = 10000;
+
+  static Object sTag = new Object();
+  static Point sEscaped;
+
+  /// CHECK-START: long Main.$noinline$coldEscape(boolean, int, long) load_store_elimination (before)
+  /// CHECK:                     NewInstance
+  /// CHECK:                     InstanceFieldSet
+  /// CHECK:                     InstanceFieldSet
+  /// CHECK:                     InstanceFieldSet
+  /// CHECK:                     InvokeStaticOrDirect method_name:Main.$noinline$escape
+  /// CHECK:                     InstanceFieldGet
+  /// CHECK:                     InstanceFieldGet
+  /// CHECK:                     InstanceFieldGet
+
+  /// CHECK-START: long Main.$noinline$coldEscape(boolean, int, long) load_store_elimination (after)
+  /// CHECK-DAG: <<X:i\d+>>      ParameterValue
+  /// CHECK-DAG: <<Y:j\d+>>      ParameterValue
+  /// CHECK-DAG: <<Tag:l\d+>>    StaticFieldGet field_name:Main.sTag
+  /// CHECK-DAG: <<Obj:l\d+>>    NewInstance
+  /// CHECK-DAG:                 InstanceFieldSet [<<Obj>>,<<X>>] field_name:Point.x
+  /// CHECK-DAG:                 InstanceFieldSet [<<Obj>>,<<Y>>] field_name:Point.y
+  /// CHECK-DAG:                 InstanceFieldSet [<<Obj>>,<<Tag>>] field_name:Point.tag
+  /// CHECK-DAG:                 InvokeStaticOrDirect [<<Obj>>{{(,[ij]\d+)?}}] method_name:Main.$noinline$escape
+  /// CHECK-DAG: <<Merge:l\d+>>  Phi [{{l\d+}},{{l\d+}}]
+  /// CHECK-DAG:                 PredicatedInstanceFieldGet [<<X>>,<<Merge>>] field_name:Point.x
+  /// CHECK-DAG:                 PredicatedInstanceFieldGet [<<Y>>,<<Merge>>] field_name:Point.y
+  /// CHECK-DAG:                 PredicatedInstanceFieldGet [<<Tag>>,<<Merge>>] field_name:Point.tag
+
+  /// CHECK-START: long Main.$noinline$coldEscape(boolean, int, long) load_store_elimination (after)
+  /// CHECK:                     NewInstance
+  /// CHECK-NOT:                 NewInstance
+
+  // The predicated loads of int, long and reference fields go through the code generators.
+  //
+  /// CHECK-START-{X86_64,ARM64}: long Main.$noinline$coldEscape(boolean, int, long) disassembly (after)
+  /// CHECK-DAG:                 PredicatedInstanceFieldGet field_name:Point.x
+  /// CHECK-DAG:                 PredicatedInstanceFieldGet field_name:Point.y
+  /// CHECK-DAG:                 PredicatedInstanceFieldGet field_name:Point.tag
+  private static long $noinline$coldEscape(boolean escape, int x, long y) {
+    Point p = new Point();
+    p.x = x;
+    p.y = y;
+    p.tag = sTag;
+    if (escape) {
+      $noinline$escape(p);
+    }
+    return p.x + p.y + (p.tag == sTag ? 0 : 1000);
+  }
+
+  private static void $noinline$escape(Point p) {
+    sEscaped = p;
+    p.x += 10;
+    p.y += 100;
+    p.tag = null;
+  }
+
+  private static void expectEquals(long expected, long result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  public static void main(String[] args) {
+    for (int i = 0; i < ITERATIONS; i++) {
+      boolean escape = (i % 1000) == 999;
+      long result = $noinline$coldEscape(escape, i, 1L << 33);
+      if (escape) {
+        expectEquals(i + 10 + (1L << 33) + 100 + 1000, result);
+        expectEquals(i + 10, sEscaped.x);
+      } else {
+        expectEquals(i + (1L << 33), result);
+      }
+    }
+    System.out.println("passed");
+  }
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <jni.h>
+
+#include "art_method-inl.h"
+#include "jit/jit.h"
+#include "runtime.h"
+#include "scoped_thread_state_change-inl.h"
+#include "stack.h"
+#include "thread-current-inl.h"
+
+namespace art {
+
+// Whether the JIT compiles optimized code which inlines from the inline caches.
+extern "C" JNIEXPORT jboolean JNICALL Java_Main_hasJitInlining(JNIEnv*, jclass) {
+  Runtime* runtime = Runtime::Current();
+  jit::Jit* jit = runtime->GetJit();
+  return (jit != nullptr &&
+          runtime->UseJitCompilation() &&
+          !runtime->IsJavaDebuggable() &&
+          !jit->GetJitCompiler()->IsBaselineCompiler()) ? JNI_TRUE : JNI_FALSE;
+}
+
+// Whether the Java method calling this native method was inlined into its caller.
+extern "C" JNIEXPORT jboolean JNICALL Java_Main_isCallerInlined(JNIEnv*, jclass) {
+  ScopedObjectAccess soa(Thread::Current());
+  bool is_inlined = false;
+  StackVisitor::WalkStack(
+      [&](const art::StackVisitor* stack_visitor) REQUIRES_SHARED(Locks::mutator_lock_) {
+        ArtMethod* method = stack_visitor->GetMethod();
+        if (method->IsRuntimeMethod() || method->IsNative()) {
+          return true;
+        }
+        is_inlined = stack_visitor->IsInInlinedFrame();
+        return false;
+      },
+      soa.Self(),
+      /* context= */ nullptr,
+      art::StackVisitor::StackWalkKind::kIncludeInlinedFrames);
+  return is_inlined ? JNI_TRUE : JNI_FALSE;
+}
+
+}  // namespace art
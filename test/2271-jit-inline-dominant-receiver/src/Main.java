@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+abstract class Base {
+  abstract int value(boolean checkInlined);
+}
+
+class Dominant extends Base {
+  int value(boolean checkInlined) {
+    if (checkInlined && !Main.isCallerInlined()) {
+      throw new Error("Dominant.value() is not inlined");
+    }
+    return 1;
+  }
+}
+
+class Other1 extends Base {
+  int value(boolean checkInlined) {
+    return 2;
+  }
+}
+
+class Other2 extends Base {
+  int value(boolean checkInlined) {
+    return 3;
+  }
+}
+
+class Other3 extends Base {
+  int value(boolean checkInlined) {
+    return 4;
+  }
+}
+
+class Other4 extends Base {
+  int value(boolean checkInlined) {
+    return 5;
+  }
+}
+
+class Other5 extends Base {
+  int value(boolean checkInlined) {
+    return 6;
+  }
+}
+
+public class Main {
+  // Enough calls for the inliner to trust the receiver type counts.
+  private static final int CALLS = 1000;
+
+  public static void main(String[] args) {
+    System.loadLibrary(args[0]);
+    if (!hasJitInlining()) {
+      return;
+    }
+
+    ensureJitBaselineCompiled(Main.class, "$noinline$callValue");
+
+    // Make the call site megamorphic. The dominant type comes first, so that it gets its own
+    // inline cache entry, and is then seen in 95% of the calls.
+    Base dominant = new Dominant();
+    Base[] others = { new Other1(), new Other2(), new Other3(), new Other4(), new Other5() };
+    int sum = $noinline$callValue(dominant, false);
+    for (Base other : others) {
+      sum += $noinline$callValue(other, false);
+    }
+    for (int i = 0; i < CALLS; ++i) {
+      Base receiver = (i % 20 == 0) ? others[(i / 20) % others.length] : dominant;
+      sum += $noinline$callValue(receiver, false);
+    }
+    // 951 calls return 1, and the other types are seen 11 times each.
+    expectEquals(951 + 11 * (2 + 3 + 4 + 5 + 6), sum);
+
+    // The optimized code guards the dominant type and inlines its method, and keeps the virtual
+    // call for the other types.
+    ensureJitCompiled(Main.class, "$noinline$callValue");
+    expectEquals(1, $noinline$callValue(dominant, true));
+    for (int i = 0; i < others.length; ++i) {
+      expectEquals(i + 2, $noinline$callValue(others[i], true));
+    }
+  }
+
+  public static int $noinline$callValue(Base receiver, boolean checkInlined) {
+    return receiver.value(checkInlined);
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  public static native boolean hasJitInlining();
+  public static native boolean isCallerInlined();
+  public static native void ensureJitBaselineCompiled(Class<?> cls, String methodName);
+  public static native void ensureJitCompiled(Class<?> cls, String methodName);
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <jni.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "art_method-inl.h"
+#include "jit/jit.h"
+#include "jit/jit_code_cache.h"
+#include "jni/jni_internal.h"
+#include "runtime.h"
+#include "scoped_thread_state_change-inl.h"
+#include "thread-current-inl.h"
+
+namespace art {
+
+// Exit codes of the child, for the parent to report what went wrong.
+static constexpr int kChildOk = 0;
+static constexpr int kChildNotShared = 1;
+static constexpr int kChildWrongResult = 2;
+static constexpr int kChildRecompiled = 3;
+
+static const void* GetEntryPoint(JNIEnv* env, jmethodID method_id) {
+  ScopedObjectAccess soa(env);
+  return jni::DecodeArtMethod(method_id)->GetEntryPointFromQuickCompiledCode();
+}
+
+// Whether the static `int name(int)` method of `cls` runs code from the shared JIT code region.
+extern "C" JNIEXPORT jboolean JNICALL Java_Main_isInSharedJitCode(JNIEnv* env,
+                                                                  jclass,
+                                                                  jclass cls,
+                                                                  jstring name) {
+  jit::Jit* jit = Runtime::Current()->GetJit();
+  if (jit == nullptr) {
+    return JNI_FALSE;
+  }
+  const char* chars = env->GetStringUTFChars(name, nullptr);
+  jmethodID method_id = env->GetStaticMethodID(cls, chars, "(I)I");
+  env->ReleaseStringUTFChars(name, chars);
+  return jit->GetCodeCache()->IsInZygoteExecSpace(GetEntryPoint(env, method_id))
+      ? JNI_TRUE
+      : JNI_FALSE;
+}
+
+// Forks a child which calls the static `int name(int)` method of `cls` `calls` times with
+// `arg`, and checks that it runs the code the parent compiled and gets `expected`. Returns the
+// exit status of the child, see the kChild* codes.
+extern "C" JNIEXPORT jint JNICALL Java_Main_forkAndCall(JNIEnv* env,
+                                                        jclass,
+                                                        jclass cls,
+                                                        jstring name,
+                                                        jint arg,
+                                                        jint expected,
+                                                        jint calls) {
+  Runtime* runtime = Runtime::Current();
+  const char* chars = env->GetStringUTFChars(name, nullptr);
+  jmethodID method_id = env->GetStaticMethodID(cls, chars, "(I)I");
+  env->ReleaseStringUTFChars(name, chars);
+  const void* entry_point = GetEntryPoint(env, method_id);
+
+  runtime->PreForkServerFork();
+  pid_t pid = fork();
+  if (pid < 0) {
+    PLOG(FATAL) << "Fork failed";
+  }
+  runtime->PostForkServerFork(/* is_child= */ pid == 0);
+  if (pid == 0) {
+    // Only use _exit() in the child, so that it doesn't flush the output buffered in the parent.
+    jit::JitCodeCache* code_cache = runtime->GetJit()->GetCodeCache();
+    if (!code_cache->IsInZygoteExecSpace(GetEntryPoint(env, method_id))) {
+      _exit(kChildNotShared);
+    }
+    for (jint i = 0; i < calls; ++i) {
+      if (env->CallStaticIntMethod(cls, method_id, arg) != expected) {
+        _exit(kChildWrongResult);
+      }
+    }
+    // Let the JIT finish any compilation the calls could have triggered.
+    runtime->GetJit()->WaitForCompilationToFinish(Thread::Current());
+    if (GetEntryPoint(env, method_id) != entry_point) {
+      _exit(kChildRecompiled);
+    }
+    _exit(kChildOk);
+  }
+
+  int status;
+  if (TEMP_FAILURE_RETRY(waitpid(pid, &status, 0)) != pid) {
+    PLOG(FATAL) << "Failed to wait for the child";
+  }
+  return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+}  // namespace art
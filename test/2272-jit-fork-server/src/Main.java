@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  // Enough calls for the method to be compiled again, were the child not running the code of
+  // the parent.
+  private static final int CALLS = 100000;
+
+  public static void main(String[] args) {
+    System.loadLibrary(args[0]);
+    if (!hasJit()) {
+      return;
+    }
+
+    ensureJitCompiled(Main.class, "$noinline$sumOfSquares");
+    if (!isInSharedJitCode(Main.class, "$noinline$sumOfSquares")) {
+      throw new Error("Expected $noinline$sumOfSquares to be compiled in the shared region");
+    }
+    int status = forkAndCall(Main.class, "$noinline$sumOfSquares", 10, 285, CALLS);
+    if (status != 0) {
+      throw new Error("Child failed with status " + status);
+    }
+    // The parent still runs the shared code.
+    if (!isInSharedJitCode(Main.class, "$noinline$sumOfSquares")) {
+      throw new Error("Expected $noinline$sumOfSquares to be compiled in the shared region");
+    }
+    if ($noinline$sumOfSquares(10) != 285) {
+      throw new Error("Wrong result in the parent");
+    }
+  }
+
+  public static int $noinline$sumOfSquares(int n) {
+    int sum = 0;
+    for (int i = 0; i < n; ++i) {
+      sum += i * i;
+    }
+    return sum;
+  }
+
+  private static native boolean hasJit();
+  private static native void ensureJitCompiled(Class<?> cls, String name);
+  private static native boolean isInSharedJitCode(Class<?> cls, String name);
+  private static native int forkAndCall(
+      Class<?> cls, String name, int arg, int expected, int calls);
+}
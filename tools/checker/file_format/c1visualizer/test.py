@@ -145,6 +145,15 @@ class C1visualizerParser_Test(unittest.TestCase):
       (ImmutableDict({"feature1": True, "feature2": False}), [
         ("MyMethod1 pass1", ["foo", "bar"])
       ]))
+    self.assertParsesTo(
+      """
+        begin_compilation
+          name "isa:x86_64 isa_features:ssse3,sse4.1,-avx,avx2"
+          method "isa:x86_64 isa_features:ssse3,sse4.1,-avx,avx2"
+          date 1234
+        end_compilation
+      """,
+      (ImmutableDict({"ssse3": True, "sse4.1": True, "avx": False, "avx2": True}), []))
     self.assertParsesTo(
       """
         begin_compilation